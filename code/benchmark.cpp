@@ -0,0 +1,376 @@
+
+//
+// NOTE: Light Benchmark
+//
+
+inline void LightBenchmarkBegin(light_benchmark* Benchmark, scenario_runner* Runner, u32 WarmupFrames, u32 MeasureFrames)
+{
+    // NOTE: The scenario runner replaces the scene every frame, so light counts would get measured on whatever scenario it is on
+    if (Runner->Running)
+    {
+        return;
+    }
+    
+    *Benchmark = {};
+    Benchmark->Running = true;
+    Benchmark->WarmupFrames = WarmupFrames;
+    Benchmark->MeasureFrames = MeasureFrames;
+}
+
+inline void LightBenchmarkPopulate(light_benchmark* Benchmark, render_scene* Scene)
+{
+    if (!Benchmark->Running)
+    {
+        return;
+    }
+
+    // NOTE: Same light cloud every frame of a step so that the timings are comparable
+    random_series Series = RandomSeriesCreate(Benchmark->CurrStep + 1);
+    SceneGenLightCloud(Scene, &Series, V3(-4.5f), V3(4.5f), LightBenchmarkCounts[Benchmark->CurrStep], 0.1f, 0.5f);
+}
+
+inline void LightBenchmarkWriteResults(light_benchmark* Benchmark, const char* FileName)
+{
+    FILE* File = fopen(FileName, "wb");
+    if (File)
+    {
+        fprintf(File, "NumLights, CullMs, ShadeMs, FrameMs\n");
+        for (u32 StepId = 0; StepId < ArrayCount(Benchmark->Results); ++StepId)
+        {
+            light_benchmark_result* Result = Benchmark->Results + StepId;
+            fprintf(File, "%u, %f, %f, %f\n", Result->NumLights, Result->CullMs, Result->ShadeMs, Result->FrameMs);
+        }
+        fclose(File);
+    }
+}
+
+inline void LightBenchmarkUpdate(light_benchmark* Benchmark, gpu_timers* Timers)
+{
+    if (!Benchmark->Running)
+    {
+        return;
+    }
+
+    light_benchmark_result* Result = Benchmark->Results + Benchmark->CurrStep;
+    Result->NumLights = LightBenchmarkCounts[Benchmark->CurrStep];
+    if (Benchmark->CurrFrame >= Benchmark->WarmupFrames)
+    {
+        f32 Weight = 1.0f / f32(Benchmark->MeasureFrames);
+        Result->CullMs += Weight * GpuTimerGetMs(Timers, GpuTimer_LightCull);
+        Result->ShadeMs += Weight * GpuTimerGetMs(Timers, GpuTimer_Lighting);
+        Result->FrameMs += Weight * GpuTimerGetMs(Timers, GpuTimer_Frame);
+    }
+
+    Benchmark->CurrFrame += 1;
+    if (Benchmark->CurrFrame == Benchmark->WarmupFrames + Benchmark->MeasureFrames)
+    {
+        Benchmark->CurrFrame = 0;
+        Benchmark->CurrStep += 1;
+        if (Benchmark->CurrStep == ArrayCount(LightBenchmarkCounts))
+        {
+            LightBenchmarkWriteResults(Benchmark, "light_benchmark.csv");
+            Benchmark->Running = false;
+        }
+    }
+}
+
+//
+// NOTE: Scenario Benchmark
+//
+
+inline void ScenarioRunnerBegin(scenario_runner* Runner, light_benchmark* Benchmark, u32 WarmupFrames)
+{
+    Assert(ArrayCount(BenchmarkScenarios) <= MAX_NUM_SCENARIOS);
+
+    // NOTE: The light benchmark adds its light cloud on top of every scene, so scenarios would get measured with extra lights
+    if (Benchmark->Running)
+    {
+        return;
+    }
+    
+    *Runner = {};
+    Runner->Running = true;
+    Runner->WarmupFrames = WarmupFrames;
+}
+
+inline void ScenarioCameraApply(benchmark_scenario* Scenario, u32 FrameId, camera* Camera)
+{
+    camera_keyframe KeyFrame = ScenarioCameraGet(Scenario, FrameId);
+    *Camera = CameraFpsCreate(KeyFrame.Pos, Normalize(KeyFrame.Target - KeyFrame.Pos), Camera->AspectRatio, 0.001f, 1000.0f,
+                              SCENE_CAMERA_FOV, 1.0f, 0.005f);
+}
+
+inline void ScenarioRunnerWriteResults(scenario_runner* Runner, const char* FileName)
+{
+    FILE* File = fopen(FileName, "wb");
+    if (File)
+    {
+        fprintf(File, "Renderer, Scenario, Frames, Lights, Instances, Triangles, FullTriangles, FrameMs, MaxFrameMs, GBufferMs, CullMs, ShadeMs\n");
+        for (u32 RendererId = 0; RendererId < RendererType_Count; ++RendererId)
+        {
+            for (u32 ScenarioId = 0; ScenarioId < ArrayCount(BenchmarkScenarios); ++ScenarioId)
+            {
+                scenario_result* Result = Runner->Results[RendererId] + ScenarioId;
+                fprintf(File, "%s, %s, %u, %u, %u, %llu, %llu, %f, %f, %f, %f, %f\n", RendererTypeNames[RendererId],
+                        BenchmarkScenarios[ScenarioId].Name, Result->NumFrames, Result->NumPointLights, Result->NumOpaqueInstances,
+                        Result->NumOpaqueTriangles, Result->NumOpaqueFullTriangles, Result->FrameMs, Result->MaxFrameMs, Result->GBufferMs,
+                        Result->CullMs, Result->ShadeMs);
+            }
+        }
+        fclose(File);
+    }
+}
+
+inline void ScenarioRunnerUpdate(scenario_runner* Runner, gpu_timers* Timers, render_scene* Scene)
+{
+    // NOTE: Called at the start of a frame, timers hold the previous frame which used the same scenario unless we are warming up
+    if (!Runner->Running)
+    {
+        return;
+    }
+
+    benchmark_scenario* Scenario = BenchmarkScenarios + Runner->CurrScenario;
+    scenario_result* Result = Runner->Results[Runner->CurrRenderer] + Runner->CurrScenario;
+    if (Runner->CurrFrame >= Runner->WarmupFrames)
+    {
+        f32 Weight = 1.0f / f32(Scenario->NumFrames);
+        f32 FrameMs = GpuTimerGetMs(Timers, GpuTimer_Frame);
+        Result->NumFrames += 1;
+        Result->NumPointLights = Scene->PointLights.NumItems;
+        Result->NumOpaqueInstances = Scene->OpaqueInstances.NumItems;
+        Result->NumOpaqueTriangles = Scene->NumOpaqueTriangles;
+        Result->NumOpaqueFullTriangles = Scene->NumOpaqueFullTriangles;
+        Result->FrameMs += Weight * FrameMs;
+        Result->MaxFrameMs = Max(Result->MaxFrameMs, FrameMs);
+        Result->GBufferMs += Weight * GpuTimerGetMs(Timers, GpuTimer_GBuffer);
+        Result->CullMs += Weight * GpuTimerGetMs(Timers, GpuTimer_LightCull);
+        Result->ShadeMs += Weight * GpuTimerGetMs(Timers, GpuTimer_Lighting);
+    }
+
+    Runner->CurrFrame += 1;
+    if (Runner->CurrFrame == Runner->WarmupFrames + Scenario->NumFrames)
+    {
+        Runner->CurrFrame = 0;
+        Runner->CurrScenario += 1;
+        if (Runner->CurrScenario == ArrayCount(BenchmarkScenarios))
+        {
+            Runner->CurrScenario = 0;
+            Runner->CurrRenderer = renderer_type(Runner->CurrRenderer + 1);
+            if (Runner->CurrRenderer == RendererType_Count)
+            {
+                ScenarioRunnerWriteResults(Runner, "scenario_benchmark.csv");
+                Runner->Running = false;
+                Runner->CurrRenderer = renderer_type(0);
+            }
+        }
+    }
+
+    // NOTE: The frame we are about to render gets measured by the next update exactly when CurrFrame >= WarmupFrames, so the camera
+    // uses the same index. Warmup frames sit at the start of the path and measured frames walk it from 0 to NumFrames - 1
+    Runner->PathFrameId = Runner->CurrFrame >= Runner->WarmupFrames ? Runner->CurrFrame - Runner->WarmupFrames : 0;
+}
+
+inline u32 ScenarioRunnerFrameId(scenario_runner* Runner)
+{
+    u32 Result = Runner->PathFrameId;
+    return Result;
+}
+
+//
+// NOTE: Tile Size Tuner
+//
+
+inline u32 TileSizeTunerCandidateNext(u32 CandidateId)
+{
+    // NOTE: Skips tile sizes the device can't run, returns the candidate count when none are left
+    while (CandidateId < ArrayCount(TileSizeCandidates) && !TileSizeSupported(TileSizeCandidates[CandidateId]))
+    {
+        CandidateId += 1;
+    }
+    return CandidateId;
+}
+
+inline void TileSizeTunerBegin(tile_size_tuner* Tuner, u32 WarmupFrames, u32 MeasureFrames)
+{
+    *Tuner = {};
+    Tuner->Running = true;
+    Tuner->WarmupFrames = WarmupFrames;
+    Tuner->MeasureFrames = MeasureFrames;
+    Tuner->CurrCandidate = TileSizeTunerCandidateNext(0);
+    Tuner->TileSize = TileSizeCandidates[Tuner->CurrCandidate];
+}
+
+inline void TileSizeTunerWriteResults(tile_size_tuner* Tuner, const char* FileName)
+{
+    FILE* File = fopen(FileName, "wb");
+    if (File)
+    {
+        fprintf(File, "TileSize, FrameMs\n");
+        for (u32 CandidateId = 0; CandidateId < ArrayCount(TileSizeCandidates); ++CandidateId)
+        {
+            if (TileSizeSupported(TileSizeCandidates[CandidateId]))
+            {
+                fprintf(File, "%u, %f\n", TileSizeCandidates[CandidateId], Tuner->FrameMs[CandidateId]);
+            }
+            else
+            {
+                fprintf(File, "%u, unsupported\n", TileSizeCandidates[CandidateId]);
+            }
+        }
+        fprintf(File, "Picked, %u\n", Tuner->TileSize);
+        fclose(File);
+    }
+}
+
+inline void TileSizeTunerUpdate(tile_size_tuner* Tuner, gpu_timers* Timers)
+{
+    // NOTE: Called at the start of a frame, timers hold the previous frame which was rendered with the current candidate
+    if (!Tuner->Running)
+    {
+        return;
+    }
+
+    if (Tuner->CurrFrame >= Tuner->WarmupFrames)
+    {
+        Tuner->FrameMs[Tuner->CurrCandidate] += GpuTimerGetMs(Timers, GpuTimer_Frame) / f32(Tuner->MeasureFrames);
+    }
+
+    Tuner->CurrFrame += 1;
+    if (Tuner->CurrFrame == Tuner->WarmupFrames + Tuner->MeasureFrames)
+    {
+        Tuner->CurrFrame = 0;
+        Tuner->CurrCandidate = TileSizeTunerCandidateNext(Tuner->CurrCandidate + 1);
+        if (Tuner->CurrCandidate == ArrayCount(TileSizeCandidates))
+        {
+            u32 BestCandidate = TileSizeTunerCandidateNext(0);
+            for (u32 CandidateId = TileSizeTunerCandidateNext(BestCandidate + 1); CandidateId < ArrayCount(TileSizeCandidates);
+                 CandidateId = TileSizeTunerCandidateNext(CandidateId + 1))
+            {
+                if (Tuner->FrameMs[CandidateId] < Tuner->FrameMs[BestCandidate])
+                {
+                    BestCandidate = CandidateId;
+                }
+            }
+
+            Tuner->TileSize = TileSizeCandidates[BestCandidate];
+            Tuner->Running = false;
+            TileSizeTunerWriteResults(Tuner, "tile_size_tuner.csv");
+        }
+        else
+        {
+            Tuner->TileSize = TileSizeCandidates[Tuner->CurrCandidate];
+        }
+    }
+}
+
+//
+// NOTE: Light Test Comparison
+//
+
+inline void LightTestCompareBegin(light_test_compare* Compare, u32 WarmupFrames, u32 MeasureFrames)
+{
+    *Compare = {};
+    Compare->Running = true;
+    Compare->WarmupFrames = WarmupFrames;
+    Compare->MeasureFrames = MeasureFrames;
+    Compare->Mode = TiledLightTestMode_Frustum;
+}
+
+inline void LightTestCompareWriteResults(light_test_compare* Compare, const char* FileName)
+{
+    FILE* File = fopen(FileName, "wb");
+    if (File)
+    {
+        // NOTE: Reductions are relative to the frustum test
+        light_test_compare_result* Baseline = Compare->Results + TiledLightTestMode_Frustum;
+        fprintf(File, "Mode, PixelMeanLightsOpaque, MeanLightsOpaque, MaxLightsOpaque, MeanLightsTransparent, CullMs, ShadeMs, "
+                "PixelLightReduction, ShadeMsReduction\n");
+        for (u32 ModeId = 0; ModeId < TiledLightTestMode_Count; ++ModeId)
+        {
+            light_test_compare_result* Result = Compare->Results + ModeId;
+            f32 PixelLightReduction = Baseline->PixelMeanLights_O > 0.0f ? 1.0f - Result->PixelMeanLights_O / Baseline->PixelMeanLights_O : 0.0f;
+            f32 ShadeMsReduction = Baseline->ShadeMs > 0.0f ? 1.0f - Result->ShadeMs / Baseline->ShadeMs : 0.0f;
+            fprintf(File, "%s, %f, %f, %u, %f, %f, %f, %f, %f\n", TiledLightTestModeNames[ModeId], Result->PixelMeanLights_O,
+                    Result->MeanLights_O, Result->MaxLights_O, Result->MeanLights_T, Result->CullMs, Result->ShadeMs, PixelLightReduction,
+                    ShadeMsReduction);
+        }
+        fclose(File);
+    }
+}
+
+inline void LightTestCompareUpdate(light_test_compare* Compare, gpu_timers* Timers, light_grid_stats* Stats)
+{
+    // NOTE: Called at the start of a frame. Timers hold the previous frame and the stats the one before it, the warmup frames make sure
+    // both were rendered with the current mode
+    if (!Compare->Running)
+    {
+        return;
+    }
+
+    light_test_compare_result* Result = Compare->Results + Compare->Mode;
+    if (Compare->CurrFrame >= Compare->WarmupFrames)
+    {
+        f32 Weight = 1.0f / f32(Compare->MeasureFrames);
+        Result->CullMs += Weight * GpuTimerGetMs(Timers, GpuTimer_LightCull);
+        Result->ShadeMs += Weight * GpuTimerGetMs(Timers, GpuTimer_Lighting);
+
+        // NOTE: Stats can still come from a frame of another mode (or be left over from one that skipped them), those don't count
+        if (Stats->StatsLightTestMode == u32(Compare->Mode))
+        {
+            Result->NumStatsSamples += 1;
+            Result->PixelMeanLights_O += Stats->Opaque.PixelMeanLights;
+            Result->MeanLights_O += Stats->Opaque.MeanLights;
+            Result->MaxLights_O = Max(Result->MaxLights_O, Stats->Opaque.MaxLights);
+            Result->MeanLights_T += Stats->Transparent.MeanLights;
+        }
+    }
+
+    Compare->CurrFrame += 1;
+    if (Compare->CurrFrame == Compare->WarmupFrames + Compare->MeasureFrames)
+    {
+        if (Result->NumStatsSamples > 0)
+        {
+            f32 InvNumSamples = 1.0f / f32(Result->NumStatsSamples);
+            Result->PixelMeanLights_O *= InvNumSamples;
+            Result->MeanLights_O *= InvNumSamples;
+            Result->MeanLights_T *= InvNumSamples;
+        }
+        
+        Compare->CurrFrame = 0;
+        Compare->Mode = tiled_light_test_mode(Compare->Mode + 1);
+        if (Compare->Mode == TiledLightTestMode_Count)
+        {
+            Compare->Mode = TiledLightTestMode_Frustum;
+            Compare->Running = false;
+            LightTestCompareWriteResults(Compare, "light_test_compare.csv");
+        }
+    }
+}
+
+inline void LightTestCompareSettingsApply(light_test_compare* Compare, tiled_deferred_state* TiledDeferred)
+{
+    // NOTE: Call every frame before recording. Forces the settings the comparison needs while it runs and puts the previous ones back
+    // once it is done
+    tiled_light_data* Tiled = &TiledDeferred->Tiled;
+    if (Compare->Running)
+    {
+        if (!Compare->SettingsSaved)
+        {
+            Compare->SettingsSaved = true;
+            Compare->SavedLightListMode = Tiled->LightListMode;
+            Compare->SavedLightTestMode = Tiled->LightTestMode;
+            Compare->SavedFusedLighting = TiledDeferred->FusedLighting;
+        }
+
+        Tiled->LightTestMode = Compare->Mode;
+        Tiled->LightListMode = TiledLightListMode_IndexList;
+        TiledDeferred->FusedLighting = false;
+    }
+    else if (Compare->SettingsSaved)
+    {
+        Compare->SettingsSaved = false;
+        Tiled->LightListMode = Compare->SavedLightListMode;
+        Tiled->LightTestMode = Compare->SavedLightTestMode;
+        TiledDeferred->FusedLighting = Compare->SavedFusedLighting;
+    }
+}
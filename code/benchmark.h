@@ -0,0 +1,145 @@
+#pragma once
+
+#include <stdio.h>
+
+/*
+
+  NOTE: Light count sweep. We step through a list of light counts, let each step warm up for a few frames (timer results lag a frame
+        behind and the first frames after a change are noisy) and then average the GPU timers of the culling and shading passes.
+        Results get written to a text file once the sweep finishes.
+  
+ */
+
+#define LIGHT_BENCHMARK 0
+
+global u32 LightBenchmarkCounts[] =
+{
+    1000,
+    5000,
+    10000,
+    25000,
+    50000,
+    100000,
+    128*1024,
+};
+
+struct light_benchmark_result
+{
+    u32 NumLights;
+    f32 CullMs;
+    f32 ShadeMs;
+    f32 FrameMs;
+};
+
+struct light_benchmark
+{
+    b32 Running;
+    u32 WarmupFrames;
+    u32 MeasureFrames;
+    
+    u32 CurrStep;
+    u32 CurrFrame;
+    light_benchmark_result Results[ArrayCount(LightBenchmarkCounts)];
+};
+
+/*
+
+  NOTE: Scenario suite. Runs every scenario in BenchmarkScenarios along its camera path, once per renderer type, and averages the GPU
+        timers per scenario. The scenes and the camera are fully determined by the scenario so two runs of the same build should give
+        the same numbers within timing noise.
+  
+ */
+
+#define SCENARIO_BENCHMARK 0
+#define MAX_NUM_SCENARIOS 16
+
+struct scenario_result
+{
+    u32 NumFrames;
+    u32 NumPointLights;
+    u32 NumOpaqueInstances;
+    u64 NumOpaqueTriangles;
+    u64 NumOpaqueFullTriangles; // NOTE: What we would draw without lods
+    f32 FrameMs;
+    f32 GBufferMs;
+    f32 CullMs;
+    f32 ShadeMs;
+    f32 MaxFrameMs;
+};
+
+struct scenario_runner
+{
+    b32 Running;
+    u32 WarmupFrames;
+    
+    renderer_type CurrRenderer;
+    u32 CurrScenario;
+    u32 CurrFrame;
+    u32 PathFrameId; // NOTE: Camera path frame of the frame being rendered
+    scenario_result Results[RendererType_Count][MAX_NUM_SCENARIOS];
+};
+
+/*
+
+  NOTE: Tile size auto tuner. Renders the startup scene with every tile size in TileSizeCandidates the device supports, averages the frame time of each
+        and keeps the fastest. Changing the tile size recreates the light grids, so the tuner only records which size it wants and the
+        main loop applies it before it starts recording the next frame.
+  
+ */
+
+#define TILE_SIZE_AUTO_TUNE 0
+
+struct tile_size_tuner
+{
+    b32 Running;
+    u32 WarmupFrames;
+    u32 MeasureFrames;
+
+    u32 CurrCandidate;
+    u32 CurrFrame;
+    f32 FrameMs[ArrayCount(TileSizeCandidates)];
+
+    // NOTE: Tile size the tiled renderers should be using
+    u32 TileSize;
+};
+
+/*
+
+  NOTE: Light test comparison. Renders the startup scene with every tiled_light_test_mode and averages the light grid stats and the
+        culling and lighting timers of each, so we see what a tighter test saves in the lighting pass against what it costs in culling.
+        The stats only understand the index list, so while it runs the tiled deferred renderer is kept on the index list without fused
+        lighting. Results get written to a text file once every mode ran.
+  
+ */
+
+#define LIGHT_TEST_COMPARE 0
+
+struct light_test_compare_result
+{
+    u32 NumStatsSamples;
+    f32 PixelMeanLights_O;
+    f32 MeanLights_O;
+    u32 MaxLights_O;
+    f32 MeanLights_T;
+    f32 CullMs;
+    f32 ShadeMs;
+};
+
+struct light_test_compare
+{
+    b32 Running;
+    u32 WarmupFrames;
+    u32 MeasureFrames;
+
+    u32 CurrFrame;
+    light_test_compare_result Results[TiledLightTestMode_Count];
+
+    // NOTE: Light test the tiled deferred renderer should be using
+    tiled_light_test_mode Mode;
+
+    // NOTE: Tiled deferred settings from before the comparison, they get restored once it finishes
+    b32 SettingsSaved;
+    tiled_light_list_mode SavedLightListMode;
+    tiled_light_test_mode SavedLightTestMode;
+    b32 SavedFusedLighting;
+};
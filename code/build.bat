@@ -25,10 +25,41 @@ del *.pdb > NUL 2> NUL
 REM USING GLSL IN VK USING GLSLANGVALIDATOR
 call glslangValidator -DGRID_FRUSTUM=1 -S comp -e main -g -V -o %DataDir%\shader_tiled_deferred_grid_frustum.spv %CodeDir%\tiled_deferred_shaders.cpp
 call glslangValidator -DLIGHT_CULLING=1 -S comp -e main -g -V -o %DataDir%\shader_tiled_deferred_light_culling.spv %CodeDir%\tiled_deferred_shaders.cpp
+call glslangValidator -DLIGHT_CULLING_BIT_MASK=1 -S comp -e main -g -V -o %DataDir%\shader_tiled_deferred_light_culling_bit_mask.spv %CodeDir%\tiled_deferred_shaders.cpp
+call glslangValidator -DLIGHT_CULLING_COARSE=1 -S comp -e main -g -V -o %DataDir%\shader_tiled_deferred_light_culling_coarse.spv %CodeDir%\tiled_deferred_shaders.cpp
+call glslangValidator -DLIGHTING_FUSED=1 -S comp -e main -g -V -o %DataDir%\shader_tiled_deferred_lighting_fused.spv %CodeDir%\tiled_deferred_shaders.cpp
 call glslangValidator -DGBUFFER_VERT=1 -S vert -e main -g -V -o %DataDir%\shader_tiled_deferred_gbuffer_vert.spv %CodeDir%\tiled_deferred_shaders.cpp
 call glslangValidator -DGBUFFER_FRAG=1 -S frag -e main -g -V -o %DataDir%\shader_tiled_deferred_gbuffer_frag.spv %CodeDir%\tiled_deferred_shaders.cpp
+call glslangValidator -DGBUFFER_VERT=1 -DBINDLESS_MATERIALS=1 -S vert -e main -g -V -o %DataDir%\shader_tiled_deferred_gbuffer_bindless_vert.spv %CodeDir%\tiled_deferred_shaders.cpp
+call glslangValidator -DGBUFFER_FRAG=1 -DBINDLESS_MATERIALS=1 -S frag -e main -g -V -o %DataDir%\shader_tiled_deferred_gbuffer_bindless_frag.spv %CodeDir%\tiled_deferred_shaders.cpp
+call glslangValidator -DGBUFFER_VERT=1 -DQUANTIZED_VERTICES=1 -S vert -e main -g -V -o %DataDir%\shader_tiled_deferred_gbuffer_quantized_vert.spv %CodeDir%\tiled_deferred_shaders.cpp
+call glslangValidator -DGBUFFER_VERT=1 -DBINDLESS_MATERIALS=1 -DQUANTIZED_VERTICES=1 -S vert -e main -g -V -o %DataDir%\shader_tiled_deferred_gbuffer_bindless_quantized_vert.spv %CodeDir%\tiled_deferred_shaders.cpp
+call glslangValidator -DGBUFFER_VERT=1 -DOCCLUSION_CULLED=1 -S vert -e main -g -V -o %DataDir%\shader_tiled_deferred_gbuffer_culled_vert.spv %CodeDir%\tiled_deferred_shaders.cpp
+call glslangValidator -DGBUFFER_VERT=1 -DBINDLESS_MATERIALS=1 -DOCCLUSION_CULLED=1 -S vert -e main -g -V -o %DataDir%\shader_tiled_deferred_gbuffer_bindless_culled_vert.spv %CodeDir%\tiled_deferred_shaders.cpp
+call glslangValidator -DGBUFFER_VERT=1 -DQUANTIZED_VERTICES=1 -DOCCLUSION_CULLED=1 -S vert -e main -g -V -o %DataDir%\shader_tiled_deferred_gbuffer_quantized_culled_vert.spv %CodeDir%\tiled_deferred_shaders.cpp
+call glslangValidator -DGBUFFER_VERT=1 -DBINDLESS_MATERIALS=1 -DQUANTIZED_VERTICES=1 -DOCCLUSION_CULLED=1 -S vert -e main -g -V -o %DataDir%\shader_tiled_deferred_gbuffer_bindless_quantized_culled_vert.spv %CodeDir%\tiled_deferred_shaders.cpp
 call glslangValidator -DTILED_DEFERRED_LIGHTING_VERT=1 -S vert -e main -g -V -o %DataDir%\shader_tiled_deferred_lighting_vert.spv %CodeDir%\tiled_deferred_shaders.cpp
 call glslangValidator -DTILED_DEFERRED_LIGHTING_FRAG=1 -S frag -e main -g -V -o %DataDir%\shader_tiled_deferred_lighting_frag.spv %CodeDir%\tiled_deferred_shaders.cpp
+call glslangValidator -DTRANSPARENT_VERT=1 -S vert -e main -g -V -o %DataDir%\shader_tiled_deferred_transparent_vert.spv %CodeDir%\tiled_deferred_shaders.cpp
+call glslangValidator -DTRANSPARENT_FRAG=1 -S frag -e main -g -V -o %DataDir%\shader_tiled_deferred_transparent_frag.spv %CodeDir%\tiled_deferred_shaders.cpp
+call glslangValidator -DTRANSPARENT_COMPOSITE_FRAG=1 -S frag -e main -g -V -o %DataDir%\shader_tiled_deferred_transparent_composite_frag.spv %CodeDir%\tiled_deferred_shaders.cpp
+
+call glslangValidator -DOCCLUSION_CULL=1 -S comp -e main -g -V -o %DataDir%\shader_occlusion_cull.spv %CodeDir%\occlusion_cull_shaders.cpp
+call glslangValidator -DHIZ_BUILD=1 -DFROM_DEPTH=1 -S comp -e main -g -V -o %DataDir%\shader_occlusion_hiz_depth.spv %CodeDir%\occlusion_cull_shaders.cpp
+call glslangValidator -DHIZ_BUILD=1 -S comp -e main -g -V -o %DataDir%\shader_occlusion_hiz.spv %CodeDir%\occlusion_cull_shaders.cpp
+
+call glslangValidator -DTILED_FORWARD_VERT=1 -S vert -e main -g -V -o %DataDir%\shader_tiled_forward_vert.spv %CodeDir%\tiled_forward_shaders.cpp
+call glslangValidator -DTILED_FORWARD_FRAG=1 -S frag -e main -g -V -o %DataDir%\shader_tiled_forward_frag.spv %CodeDir%\tiled_forward_shaders.cpp
+
+call glslangValidator -DFORWARD_VERT=1 -S vert -e main -g -V -o %DataDir%\shader_forward_vert.spv %CodeDir%\forward_shaders.cpp
+call glslangValidator -DFORWARD_FRAG=1 -S frag -e main -g -V -o %DataDir%\shader_forward_frag.spv %CodeDir%\forward_shaders.cpp
+
+call glslangValidator -DGBUFFER_VERT=1 -S vert -e main -g -V -o %DataDir%\shader_deferred_gbuffer_vert.spv %CodeDir%\deferred_shaders.cpp
+call glslangValidator -DGBUFFER_FRAG=1 -S frag -e main -g -V -o %DataDir%\shader_deferred_gbuffer_frag.spv %CodeDir%\deferred_shaders.cpp
+call glslangValidator -DDIRECTIONAL_LIGHT_VERT=1 -S vert -e main -g -V -o %DataDir%\shader_deferred_directional_light_vert.spv %CodeDir%\deferred_shaders.cpp
+call glslangValidator -DDIRECTIONAL_LIGHT_FRAG=1 -S frag -e main -g -V -o %DataDir%\shader_deferred_directional_light_frag.spv %CodeDir%\deferred_shaders.cpp
+call glslangValidator -DPOINT_LIGHT_VERT=1 -S vert -e main -g -V -o %DataDir%\shader_deferred_point_light_vert.spv %CodeDir%\deferred_shaders.cpp
+call glslangValidator -DPOINT_LIGHT_FRAG=1 -S frag -e main -g -V -o %DataDir%\shader_deferred_point_light_frag.spv %CodeDir%\deferred_shaders.cpp
 
 call glslangValidator -DSTANDARD_SSAO=1 -S frag -e main -g -V -o %DataDir%\shader_standard_ssao_frag.spv %CodeDir%\ssao_shader.cpp
 
@@ -44,4 +75,7 @@ cl %CommonCompilerFlags% %CodeDir%\ssao_demo.cpp -Fmssao_demo.map -LD /link %Com
 del lock.tmp
 call cl %CommonCompilerFlags% -DDLL_NAME=ssao_demo -Fessao_demo.exe %LibsDir%\framework_vulkan\win32_main.cpp -Fmssao_demo.map /link %CommonLinkerFlags%
 
+REM Headless software raster, runs on machines without a GPU
+call cl %CommonCompilerFlags% -Fesoftware_raster.exe %CodeDir%\software_raster_main.cpp -Fmsoftware_raster.map /link %CommonLinkerFlags% -PDB:software_raster.pdb
+
 popd
@@ -0,0 +1,124 @@
+#if CPU_PROFILER
+
+inline u64 CpuProfilerTicksGet()
+{
+    LARGE_INTEGER Ticks;
+    QueryPerformanceCounter(&Ticks);
+    return u64(Ticks.QuadPart);
+}
+
+inline void CpuProfilerInit(cpu_profiler* Profiler, linear_arena* Arena)
+{
+    *Profiler = {};
+
+    LARGE_INTEGER Frequency;
+    QueryPerformanceFrequency(&Frequency);
+    Profiler->TicksPerSecond = u64(Frequency.QuadPart);
+    Profiler->StartTicks = CpuProfilerTicksGet();
+
+    // NOTE: Rings are allocated here so recording never allocates
+    for (u32 ThreadId = 0; ThreadId < CPU_PROFILER_MAX_THREADS; ++ThreadId)
+    {
+        Profiler->Threads[ThreadId].Events = PushArray(Arena, cpu_profiler_event, CPU_PROFILER_EVENTS_PER_THREAD);
+    }
+
+    Profiler->Initialized = true;
+}
+
+inline void CpuProfilerReset(cpu_profiler* Profiler)
+{
+    // NOTE: Event names point into the loaded dll, so they have to go when the code gets reloaded
+    for (u32 ThreadId = 0; ThreadId < CPU_PROFILER_MAX_THREADS; ++ThreadId)
+    {
+        Profiler->Threads[ThreadId].NumEvents = 0;
+    }
+}
+
+inline cpu_profiler_thread* CpuProfilerThreadGet(cpu_profiler* Profiler)
+{
+    cpu_profiler_thread* Result = 0;
+
+    u32 ThreadId = GetCurrentThreadId();
+    u32 NumThreads = Min(u32(Profiler->NumThreads), u32(CPU_PROFILER_MAX_THREADS));
+    for (u32 SlotId = 0; SlotId < NumThreads; ++SlotId)
+    {
+        if (Profiler->Threads[SlotId].ThreadId == ThreadId)
+        {
+            Result = Profiler->Threads + SlotId;
+            break;
+        }
+    }
+
+    if (!Result)
+    {
+        // NOTE: First event on this thread, claim a ring. Threads past the max are dropped
+        u32 SlotId = u32(InterlockedIncrement(&Profiler->NumThreads) - 1);
+        if (SlotId < CPU_PROFILER_MAX_THREADS)
+        {
+            Result = Profiler->Threads + SlotId;
+            Result->ThreadId = ThreadId;
+        }
+    }
+
+    return Result;
+}
+
+cpu_timed_block::cpu_timed_block(const char* BlockName)
+{
+    Name = BlockName;
+    StartTicks = CpuProfilerTicksGet();
+}
+
+cpu_timed_block::~cpu_timed_block()
+{
+    u64 EndTicks = CpuProfilerTicksGet();
+
+    // NOTE: Blocks can start before the profiler exists (top of Init), they still get recorded if it exists by the time they end
+    if (DemoState && DemoState->CpuProfiler.Initialized)
+    {
+        cpu_profiler_thread* Thread = CpuProfilerThreadGet(&DemoState->CpuProfiler);
+        if (Thread)
+        {
+            cpu_profiler_event* Event = Thread->Events + (Thread->NumEvents & (CPU_PROFILER_EVENTS_PER_THREAD - 1));
+            Event->Name = Name;
+            Event->StartTicks = StartTicks;
+            Event->EndTicks = EndTicks;
+            Thread->NumEvents += 1;
+        }
+    }
+}
+
+inline void CpuProfilerExport(cpu_profiler* Profiler, const char* FileName)
+{
+    FILE* File = fopen(FileName, "wb");
+    if (!File)
+    {
+        return;
+    }
+
+    f64 TicksToUs = 1000000.0 / f64(Profiler->TicksPerSecond);
+    b32 FirstEvent = true;
+    
+    fprintf(File, "{\"traceEvents\":[\n");
+    u32 NumThreads = Min(u32(Profiler->NumThreads), u32(CPU_PROFILER_MAX_THREADS));
+    for (u32 SlotId = 0; SlotId < NumThreads; ++SlotId)
+    {
+        cpu_profiler_thread* Thread = Profiler->Threads + SlotId;
+        u64 StartEventId = Thread->NumEvents > CPU_PROFILER_EVENTS_PER_THREAD ? Thread->NumEvents - CPU_PROFILER_EVENTS_PER_THREAD : 0;
+        for (u64 EventId = StartEventId; EventId < Thread->NumEvents; ++EventId)
+        {
+            cpu_profiler_event* Event = Thread->Events + (EventId & (CPU_PROFILER_EVENTS_PER_THREAD - 1));
+            u64 StartTicks = Event->StartTicks > Profiler->StartTicks ? Event->StartTicks - Profiler->StartTicks : 0;
+            f64 StartUs = f64(StartTicks) * TicksToUs;
+            f64 DurationUs = f64(Event->EndTicks - Event->StartTicks) * TicksToUs;
+            fprintf(File, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u}", FirstEvent ? "" : ",\n",
+                    Event->Name, StartUs, DurationUs, Thread->ThreadId);
+            FirstEvent = false;
+        }
+    }
+    fprintf(File, "\n]}\n");
+
+    fclose(File);
+}
+
+#endif
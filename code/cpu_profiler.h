@@ -0,0 +1,59 @@
+#pragma once
+
+/*
+
+  NOTE: Scoped CPU profiler. A timed block records one complete event (name, start and end ticks) into the ring buffer of the thread it
+        ran on when it goes out of scope, so the hot path is two QueryPerformanceCounter calls and a store. Rings are allocated up front,
+        wrap around and keep the most recent events. Export writes them out as a Chrome trace (load it in chrome://tracing or
+        ui.perfetto.dev).
+
+        Names have to be string literals since we only store the pointer. With CPU_PROFILER set to 0 the timed block macro expands to
+        nothing and the profiler types, functions and the demo state member don't exist, so callers have to be wrapped too.
+
+ */
+
+#define CPU_PROFILER 0
+#define CPU_PROFILER_MAX_THREADS 4
+#define CPU_PROFILER_EVENTS_PER_THREAD 16384 // NOTE: Has to be a power of 2
+#define CPU_PROFILER_FILE_NAME "cpu_trace.json"
+
+#if CPU_PROFILER
+
+struct cpu_profiler_event
+{
+    const char* Name;
+    u64 StartTicks;
+    u64 EndTicks;
+};
+
+struct cpu_profiler_thread
+{
+    u32 ThreadId;
+    u64 NumEvents; // NOTE: Total written, the ring holds the last CPU_PROFILER_EVENTS_PER_THREAD of them
+    cpu_profiler_event* Events;
+};
+
+struct cpu_profiler
+{
+    b32 Initialized;
+    u64 TicksPerSecond;
+    u64 StartTicks;
+    volatile LONG NumThreads;
+    cpu_profiler_thread Threads[CPU_PROFILER_MAX_THREADS];
+};
+
+struct cpu_timed_block
+{
+    const char* Name;
+    u64 StartTicks;
+
+    cpu_timed_block(const char* BlockName);
+    ~cpu_timed_block();
+};
+
+#define CPU_TIMED_BLOCK_NAME_(Line) CpuTimedBlock_##Line
+#define CPU_TIMED_BLOCK_NAME(Line) CPU_TIMED_BLOCK_NAME_(Line)
+#define CPU_TIMED_BLOCK(Name) cpu_timed_block CPU_TIMED_BLOCK_NAME(__LINE__)(Name)
+#else
+#define CPU_TIMED_BLOCK(Name)
+#endif
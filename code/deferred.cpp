@@ -0,0 +1,369 @@
+
+inline void DeferredSwapChainChange(deferred_state* State, u32 Width, u32 Height, VkFormat ColorFormat, render_scene* Scene)
+{
+    b32 ReCreate = State->RenderTargetArena.Used != 0;
+    VkArenaClear(&State->RenderTargetArena);
+    MemoryStatsArenaClear(&DemoState->MemoryStats, &State->RenderTargetArena.Used);
+
+    TaggedRenderTargetEntryReCreate("deferred", &State->RenderTargetArena, Width, Height, VK_FORMAT_R32G32B32A32_SFLOAT,
+                                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                    VK_IMAGE_ASPECT_COLOR_BIT, &State->GBufferPositionImage, &State->GBufferPositionEntry);
+    TaggedRenderTargetEntryReCreate("deferred", &State->RenderTargetArena, Width, Height, VK_FORMAT_R32G32B32A32_SFLOAT,
+                                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                    VK_IMAGE_ASPECT_COLOR_BIT, &State->GBufferNormalImage, &State->GBufferNormalEntry);
+    TaggedRenderTargetEntryReCreate("deferred", &State->RenderTargetArena, Width, Height, VK_FORMAT_R32G32B32A32_SFLOAT,
+                                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                    VK_IMAGE_ASPECT_COLOR_BIT, &State->GBufferColorImage, &State->GBufferColorEntry);
+    TaggedRenderTargetEntryReCreate("deferred", &State->RenderTargetArena, Width, Height, VK_FORMAT_D32_SFLOAT,
+                                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                    VK_IMAGE_ASPECT_DEPTH_BIT, &State->DepthImage, &State->DepthEntry);
+    TaggedRenderTargetEntryReCreate("deferred", &State->RenderTargetArena, Width, Height, ColorFormat,
+                                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                    VK_IMAGE_ASPECT_COLOR_BIT, &State->OutColorImage, &State->OutColorEntry);
+
+    if (ReCreate)
+    {
+        RenderTargetUpdateEntries(FrameArenaGet(&DemoState->FrameArena), &State->GBufferPass);
+        RenderTargetUpdateEntries(FrameArenaGet(&DemoState->FrameArena), &State->LightingPass);
+    }
+
+    VkDescriptorImageWrite(&RenderState->DescriptorManager, State->DeferredDescriptor, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                           State->GBufferPositionEntry.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    VkDescriptorImageWrite(&RenderState->DescriptorManager, State->DeferredDescriptor, 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                           State->GBufferNormalEntry.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    VkDescriptorImageWrite(&RenderState->DescriptorManager, State->DeferredDescriptor, 2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                           State->GBufferColorEntry.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    VkDescriptorManagerFlush(RenderState->Device, &RenderState->DescriptorManager);
+}
+
+inline void DeferredCreate(renderer_create_info CreateInfo, deferred_state* Result)
+{
+    *Result = {};
+
+    u64 HeapSize = MegaBytes(512);
+    Result->RenderTargetArena = VkLinearArenaCreate(VkMemoryAllocate(RenderState->Device, RenderState->LocalMemoryId, HeapSize), HeapSize);
+    MemoryStatsArenaAdd(&DemoState->MemoryStats, "deferred_targets", true, &Result->RenderTargetArena.Used, HeapSize);
+
+    {
+        vk_descriptor_layout_builder Builder = VkDescriptorLayoutBegin(&Result->DeferredDescLayout);
+        VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
+        VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
+        VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
+        VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
+        VkDescriptorLayoutEnd(RenderState->Device, &Builder);
+
+        Result->DeferredDescriptor = VkDescriptorSetAllocate(RenderState->Device, RenderState->DescriptorPool, Result->DeferredDescLayout);
+
+        GrowableBufferCreate(&Result->LightVolumeIds, "deferred", VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, sizeof(u32),
+                             GROWABLE_BUFFER_MIN_CAPACITY);
+        VkDescriptorBufferWrite(&RenderState->DescriptorManager, Result->DeferredDescriptor, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Result->LightVolumeIds.Buffer);
+    }
+    
+    DeferredSwapChainChange(Result, CreateInfo.Width, CreateInfo.Height, CreateInfo.ColorFormat, CreateInfo.Scene);
+
+    // NOTE: GBuffer Pass
+    {
+        // NOTE: RT
+        {
+            render_target_builder Builder = RenderTargetBuilderBegin(&DemoState->Arena, &DemoState->TempArena, CreateInfo.Width, CreateInfo.Height);
+            RenderTargetAddTarget(&Builder, &Result->GBufferPositionEntry, VkClearColorCreate(0, 0, 0, 1));
+            RenderTargetAddTarget(&Builder, &Result->GBufferNormalEntry, VkClearColorCreate(0, 0, 0, 1));
+            RenderTargetAddTarget(&Builder, &Result->GBufferColorEntry, VkClearColorCreate(0, 0, 0, 1));
+            RenderTargetAddTarget(&Builder, &Result->DepthEntry, VkClearDepthStencilCreate(0, 0));
+                            
+            vk_render_pass_builder RpBuilder = VkRenderPassBuilderBegin(&DemoState->TempArena);
+
+            u32 GBufferPositionId = VkRenderPassAttachmentAdd(&RpBuilder, Result->GBufferPositionEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                              VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            u32 GBufferNormalId = VkRenderPassAttachmentAdd(&RpBuilder, Result->GBufferNormalEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                            VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            u32 GBufferColorId = VkRenderPassAttachmentAdd(&RpBuilder, Result->GBufferColorEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                           VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            u32 DepthId = VkRenderPassAttachmentAdd(&RpBuilder, Result->DepthEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                    VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+
+            VkRenderPassSubPassBegin(&RpBuilder, VK_PIPELINE_BIND_POINT_GRAPHICS);
+            VkRenderPassColorRefAdd(&RpBuilder, GBufferPositionId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            VkRenderPassColorRefAdd(&RpBuilder, GBufferNormalId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            VkRenderPassColorRefAdd(&RpBuilder, GBufferColorId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            VkRenderPassDepthRefAdd(&RpBuilder, DepthId, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+            VkRenderPassSubPassEnd(&RpBuilder);
+
+            Result->GBufferPass = RenderTargetBuilderEnd(&Builder, VkRenderPassBuilderEnd(&RpBuilder, RenderState->Device));
+        }
+
+        // NOTE: Pipeline
+        {
+            vk_pipeline_builder Builder = VkPipelineBuilderBegin(&DemoState->TempArena);
+
+            // NOTE: Shaders
+            VkPipelineShaderAdd(&Builder, "shader_deferred_gbuffer_vert.spv", "main", VK_SHADER_STAGE_VERTEX_BIT);
+            VkPipelineShaderAdd(&Builder, "shader_deferred_gbuffer_frag.spv", "main", VK_SHADER_STAGE_FRAGMENT_BIT);
+                
+            // NOTE: Specify input vertex data format
+            VkPipelineVertexBindingBegin(&Builder);
+            VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, sizeof(v3));
+            VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, sizeof(v3));
+            VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32_SFLOAT, sizeof(v2));
+            VkPipelineVertexBindingEnd(&Builder);
+
+            VkPipelineInputAssemblyAdd(&Builder, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
+            VkPipelineDepthStateAdd(&Builder, VK_TRUE, VK_TRUE, VK_COMPARE_OP_GREATER);
+
+            VkPipelineColorAttachmentAdd(&Builder, VK_FALSE, VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO,
+                                         VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO);
+            VkPipelineColorAttachmentAdd(&Builder, VK_FALSE, VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO,
+                                         VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO);
+            VkPipelineColorAttachmentAdd(&Builder, VK_FALSE, VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO,
+                                         VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO);
+
+            VkDescriptorSetLayout DescriptorLayouts[] =
+                {
+                    Result->DeferredDescLayout,
+                    CreateInfo.SceneDescLayout,
+                    CreateInfo.MaterialDescLayout,
+                };
+            
+            Result->GBufferPipeline = VkPipelineBuilderEnd(&Builder, RenderState->Device, &RenderState->PipelineManager,
+                                                           Result->GBufferPass.RenderPass, 0, DescriptorLayouts, ArrayCount(DescriptorLayouts));
+        }
+    }
+
+    // NOTE: Lighting Pass
+    {
+        // NOTE: RT
+        {
+            render_target_builder Builder = RenderTargetBuilderBegin(&DemoState->Arena, &DemoState->TempArena, CreateInfo.Width, CreateInfo.Height);
+            RenderTargetAddTarget(&Builder, &Result->OutColorEntry, VkClearColorCreate(0, 0, 0, 1));
+            RenderTargetAddTarget(&Builder, &Result->DepthEntry, VkClearDepthStencilCreate(0, 0));
+                            
+            vk_render_pass_builder RpBuilder = VkRenderPassBuilderBegin(&DemoState->TempArena);
+
+            u32 OutColorId = VkRenderPassAttachmentAdd(&RpBuilder, Result->OutColorEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                       VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            // NOTE: GBuffer depth is only tested against by the light volumes
+            u32 DepthId = VkRenderPassAttachmentAdd(&RpBuilder, Result->DepthEntry.Format, VK_ATTACHMENT_LOAD_OP_LOAD,
+                                                    VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+                                                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+
+            VkRenderPassSubPassBegin(&RpBuilder, VK_PIPELINE_BIND_POINT_GRAPHICS);
+            VkRenderPassColorRefAdd(&RpBuilder, OutColorId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            VkRenderPassDepthRefAdd(&RpBuilder, DepthId, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+            VkRenderPassSubPassEnd(&RpBuilder);
+
+            Result->LightingPass = RenderTargetBuilderEnd(&Builder, VkRenderPassBuilderEnd(&RpBuilder, RenderState->Device));
+        }
+
+        VkDescriptorSetLayout DescriptorLayouts[] =
+            {
+                Result->DeferredDescLayout,
+                CreateInfo.SceneDescLayout,
+            };
+        
+        // NOTE: Directional Light Pipeline
+        {
+            vk_pipeline_builder Builder = VkPipelineBuilderBegin(&DemoState->TempArena);
+
+            // NOTE: Shaders
+            VkPipelineShaderAdd(&Builder, "shader_deferred_directional_light_vert.spv", "main", VK_SHADER_STAGE_VERTEX_BIT);
+            VkPipelineShaderAdd(&Builder, "shader_deferred_directional_light_frag.spv", "main", VK_SHADER_STAGE_FRAGMENT_BIT);
+                
+            // NOTE: Specify input vertex data format
+            VkPipelineVertexBindingBegin(&Builder);
+            VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, 2*sizeof(v3) + sizeof(v2));
+            VkPipelineVertexBindingEnd(&Builder);
+
+            VkPipelineInputAssemblyAdd(&Builder, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
+            VkPipelineColorAttachmentAdd(&Builder, VK_FALSE, VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO,
+                                         VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO);
+
+            Result->DirectionalLightPipeline = VkPipelineBuilderEnd(&Builder, RenderState->Device, &RenderState->PipelineManager,
+                                                                    Result->LightingPass.RenderPass, 0, DescriptorLayouts, ArrayCount(DescriptorLayouts));
+        }
+
+        // NOTE: Point Light Pipelines
+        for (u32 PipelineId = 0; PipelineId < 2; ++PipelineId)
+        {
+            b32 CameraInside = PipelineId == 1;
+            vk_pipeline_builder Builder = VkPipelineBuilderBegin(&DemoState->TempArena);
+
+            // NOTE: Shaders
+            VkPipelineShaderAdd(&Builder, "shader_deferred_point_light_vert.spv", "main", VK_SHADER_STAGE_VERTEX_BIT);
+            VkPipelineShaderAdd(&Builder, "shader_deferred_point_light_frag.spv", "main", VK_SHADER_STAGE_FRAGMENT_BIT);
+                
+            // NOTE: Specify input vertex data format
+            VkPipelineVertexBindingBegin(&Builder);
+            VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, 2*sizeof(v3) + sizeof(v2));
+            VkPipelineVertexBindingEnd(&Builder);
+
+            VkPipelineInputAssemblyAdd(&Builder, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
+            if (CameraInside)
+            {
+                // NOTE: Back faces that are behind or on the surface (reverse z so smaller is further away)
+                VkPipelineRasterizationStateSet(&Builder, VK_FALSE, VK_FALSE, VK_POLYGON_MODE_FILL, VK_CULL_MODE_FRONT_BIT,
+                                                VK_FRONT_FACE_COUNTER_CLOCKWISE);
+                VkPipelineDepthStateAdd(&Builder, VK_TRUE, VK_FALSE, VK_COMPARE_OP_LESS_OR_EQUAL);
+            }
+            else
+            {
+                // NOTE: Front faces that are in front of or on the surface
+                VkPipelineRasterizationStateSet(&Builder, VK_FALSE, VK_FALSE, VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT,
+                                                VK_FRONT_FACE_COUNTER_CLOCKWISE);
+                VkPipelineDepthStateAdd(&Builder, VK_TRUE, VK_FALSE, VK_COMPARE_OP_GREATER_OR_EQUAL);
+            }
+            VkPipelineColorAttachmentAdd(&Builder, VK_TRUE, VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ONE,
+                                         VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ONE);
+
+            vk_pipeline* Pipeline = VkPipelineBuilderEnd(&Builder, RenderState->Device, &RenderState->PipelineManager,
+                                                         Result->LightingPass.RenderPass, 0, DescriptorLayouts, ArrayCount(DescriptorLayouts));
+            if (CameraInside)
+            {
+                Result->PointLightInsidePipeline = Pipeline;
+            }
+            else
+            {
+                Result->PointLightOutsidePipeline = Pipeline;
+            }
+        }
+    }
+}
+
+inline void DeferredAddMeshes(deferred_state* State, render_mesh* QuadMesh, render_mesh* SphereMesh)
+{
+    State->QuadMesh = QuadMesh;
+    State->SphereMesh = SphereMesh;
+}
+
+inline void DeferredLightVolumesPush(deferred_state* State, render_scene* Scene)
+{
+    // NOTE: Light ids index the sorted lights the same way PointLights and PointLightTransforms do on the GPU
+    State->NumOutsideLights = 0;
+    State->NumInsideLights = 0;
+    if (Scene->PointLights.NumItems == 0)
+    {
+        return;
+    }
+    
+    if (GrowableBufferReserve(&State->LightVolumeIds, Scene->PointLights.NumItems))
+    {
+        VkDescriptorBufferWrite(&RenderState->DescriptorManager, State->DeferredDescriptor, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, State->LightVolumeIds.Buffer);
+        VkDescriptorManagerFlush(RenderState->Device, &RenderState->DescriptorManager);
+    }
+    
+    u32* LightIds = StagingRingPushWriteArray(&DemoState->StagingRing, State->LightVolumeIds.Buffer, u32, Scene->PointLights.NumItems,
+                                              VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);
+
+    // NOTE: Outside lights fill from the front, inside lights from the back so both groups stay contiguous
+    m4 VTransform = CameraGetV(&Scene->Camera);
+    for (u32 LightId = 0; LightId < Scene->PointLights.NumItems; ++LightId)
+    {
+        point_light* CurrLight = ScenePointLightAt(Scene, Scene->PointLightSortIds[LightId]);
+        v3 ViewPos = (VTransform * V4(CurrLight->Pos, 1.0f)).xyz;
+        // NOTE: Matches LIGHT_VOLUME_SCALE in the shader
+        f32 VolumeRadius = 1.05f*CurrLight->MaxDistance;
+
+        if (ViewPos.z + VolumeRadius < 0.0f)
+        {
+            // NOTE: Volume is fully behind the camera
+            continue;
+        }
+
+        // NOTE: Pad by more than the near plane so front faces never get clipped away while we treat the camera as outside
+        if (Length(ViewPos) < VolumeRadius + 0.01f)
+        {
+            State->NumInsideLights += 1;
+            LightIds[Scene->PointLights.NumItems - State->NumInsideLights] = LightId;
+        }
+        else
+        {
+            LightIds[State->NumOutsideLights++] = LightId;
+        }
+    }
+}
+
+inline void DeferredRender(vk_commands Commands, deferred_state* State, render_scene* Scene)
+{
+    GpuTimerBegin(Commands, &DemoState->GpuTimers, GpuTimer_GBuffer);
+    RenderTargetPassBegin(&State->GBufferPass, Commands, RenderTargetRenderPass_SetViewPort | RenderTargetRenderPass_SetScissor);
+    // NOTE: GBuffer Pass
+    {
+        vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->GBufferPipeline->Handle);
+        {
+            VkDescriptorSet DescriptorSets[] =
+                {
+                    State->DeferredDescriptor,
+                    Scene->SceneDescriptor,
+                };
+            vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->GBufferPipeline->Layout, 0,
+                                    ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
+        }
+
+        for (u32 InstanceId = 0; InstanceId < Scene->OpaqueInstances.NumItems; ++InstanceId)
+        {
+            instance_entry* CurrInstance = SceneOpaqueInstanceAt(Scene, InstanceId);
+            render_mesh* CurrMesh = SceneMeshGet(Scene, CurrInstance->Mesh);
+
+            vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->GBufferPipeline->Layout, 2, 1,
+                                    &CurrMesh->MaterialDescriptor, 0, 0);
+            
+            VkDeviceSize Offset = 0;
+            vkCmdBindVertexBuffers(Commands.Buffer, 0, 1, &CurrMesh->VertexBuffer, &Offset);
+            vkCmdBindIndexBuffer(Commands.Buffer, CurrMesh->IndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+            vkCmdDrawIndexed(Commands.Buffer, CurrMesh->NumIndices, 1, 0, 0, InstanceId);
+        }
+    }
+    RenderTargetPassEnd(Commands);
+    GpuTimerEnd(Commands, &DemoState->GpuTimers, GpuTimer_GBuffer);
+
+    GpuTimerBegin(Commands, &DemoState->GpuTimers, GpuTimer_Lighting);
+    RenderTargetPassBegin(&State->LightingPass, Commands, RenderTargetRenderPass_SetViewPort | RenderTargetRenderPass_SetScissor);
+    {
+        VkDescriptorSet DescriptorSets[] =
+            {
+                State->DeferredDescriptor,
+                Scene->SceneDescriptor,
+            };
+        VkDeviceSize Offset = 0;
+        
+        // NOTE: Directional Light
+        {
+            vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->DirectionalLightPipeline->Handle);
+            vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->DirectionalLightPipeline->Layout, 0,
+                                    ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
+            vkCmdBindVertexBuffers(Commands.Buffer, 0, 1, &State->QuadMesh->VertexBuffer, &Offset);
+            vkCmdBindIndexBuffer(Commands.Buffer, State->QuadMesh->IndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+            vkCmdDrawIndexed(Commands.Buffer, State->QuadMesh->NumIndices, 1, 0, 0, 0);
+        }
+
+        // NOTE: Point Lights, the instance id indexes LightVolumeIds so the inside group starts at the back of the array
+        if (State->NumOutsideLights + State->NumInsideLights > 0)
+        {
+            vkCmdBindVertexBuffers(Commands.Buffer, 0, 1, &State->SphereMesh->VertexBuffer, &Offset);
+            vkCmdBindIndexBuffer(Commands.Buffer, State->SphereMesh->IndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+        }
+        
+        if (State->NumOutsideLights > 0)
+        {
+            vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->PointLightOutsidePipeline->Handle);
+            vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->PointLightOutsidePipeline->Layout, 0,
+                                    ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
+            vkCmdDrawIndexed(Commands.Buffer, State->SphereMesh->NumIndices, State->NumOutsideLights, 0, 0, 0);
+        }
+
+        if (State->NumInsideLights > 0)
+        {
+            vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->PointLightInsidePipeline->Handle);
+            vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->PointLightInsidePipeline->Layout, 0,
+                                    ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
+            vkCmdDrawIndexed(Commands.Buffer, State->SphereMesh->NumIndices, State->NumInsideLights, 0, 0,
+                             Scene->PointLights.NumItems - State->NumInsideLights);
+        }
+    }
+    RenderTargetPassEnd(Commands);
+    GpuTimerEnd(Commands, &DemoState->GpuTimers, GpuTimer_Lighting);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+/*
+
+  NOTE: Classic deferred renderer. We fill a GBuffer, then draw a full screen pass for the directional light and one light volume per
+        point light that additively blends its contribution into the output.
+
+        Light volumes are rejected with the GBuffer depth. If the camera is outside of a volume we draw its front faces and keep the
+        pixels where the volume is in front of the surface, if the camera is inside we draw its back faces and keep the pixels where
+        the surface is in front of the volume. Lights get split into those two groups on the CPU each frame.
+  
+ */
+
+struct deferred_state
+{
+    vk_linear_arena RenderTargetArena;
+
+    // NOTE: GBuffer
+    VkImage GBufferPositionImage;
+    render_target_entry GBufferPositionEntry;
+    VkImage GBufferNormalImage;
+    render_target_entry GBufferNormalEntry;
+    VkImage GBufferColorImage;
+    render_target_entry GBufferColorEntry;
+    VkImage DepthImage;
+    render_target_entry DepthEntry;
+    VkImage OutColorImage;
+    render_target_entry OutColorEntry;
+    render_target GBufferPass;
+    render_target LightingPass;
+
+    VkDescriptorSetLayout DeferredDescLayout;
+    VkDescriptorSet DeferredDescriptor;
+
+    // NOTE: Light volume ids, lights the camera is outside of come first
+    growable_buffer LightVolumeIds;
+    u32 NumOutsideLights;
+    u32 NumInsideLights;
+
+    render_mesh* QuadMesh;
+    render_mesh* SphereMesh;
+    
+    vk_pipeline* GBufferPipeline;
+    vk_pipeline* DirectionalLightPipeline;
+    vk_pipeline* PointLightOutsidePipeline;
+    vk_pipeline* PointLightInsidePipeline;
+};
@@ -0,0 +1,168 @@
+#version 450
+
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_GOOGLE_include_directive : enable
+
+#include "shader_descriptor_layouts.cpp"
+#include "shader_blinn_phong_lighting.cpp"
+
+//
+// NOTE: Descriptor Sets
+//
+
+layout(set = 0, binding = 0) uniform sampler2D GBufferPositionTexture;
+layout(set = 0, binding = 1) uniform sampler2D GBufferNormalTexture;
+layout(set = 0, binding = 2) uniform sampler2D GBufferColorTexture;
+layout(set = 0, binding = 3) buffer light_volume_ids
+{
+    uint LightVolumeIds[];
+};
+
+SCENE_DESCRIPTOR_LAYOUT(1)
+MATERIAL_DESCRIPTOR_LAYOUT(2)
+
+//
+// NOTE: GBuffer Vertex
+//
+
+#if GBUFFER_VERT
+
+layout(location = 0) in vec3 InPos;
+layout(location = 1) in vec3 InNormal;
+layout(location = 2) in vec2 InUv;
+
+layout(location = 0) out vec3 OutWorldPos;
+layout(location = 1) out vec3 OutWorldNormal;
+layout(location = 2) out vec2 OutUv;
+
+void main()
+{
+    instance_entry Entry = InstanceBuffer[gl_InstanceIndex];
+    
+    gl_Position = Entry.WVPTransform * vec4(InPos, 1);
+    OutWorldPos = (Entry.WTransform * vec4(InPos, 1)).xyz;
+    OutWorldNormal = (Entry.WTransform * vec4(InNormal, 0)).xyz;
+    OutUv = InUv;
+}
+
+#endif
+
+//
+// NOTE: GBuffer Fragment
+//
+
+#if GBUFFER_FRAG
+
+layout(location = 0) in vec3 InWorldPos;
+layout(location = 1) in vec3 InWorldNormal;
+layout(location = 2) in vec2 InUv;
+
+layout(location = 0) out vec4 OutWorldPos;
+layout(location = 1) out vec4 OutWorldNormal;
+layout(location = 2) out vec4 OutColor;
+
+void main()
+{
+    OutWorldPos = vec4(InWorldPos, 0);
+    OutWorldNormal = vec4(normalize(InWorldNormal), 0);
+    OutColor = texture(ColorTexture, InUv);
+}
+
+#endif
+
+//
+// NOTE: Directional Light Vert
+//
+
+#if DIRECTIONAL_LIGHT_VERT
+
+layout(location = 0) in vec3 InPos;
+
+void main()
+{
+    gl_Position = vec4(2.0*InPos, 1);
+}
+
+#endif
+
+//
+// NOTE: Directional Light Frag
+//
+
+#if DIRECTIONAL_LIGHT_FRAG
+
+layout(location = 0) out vec4 OutColor;
+
+void main()
+{
+    ivec2 PixelPos = ivec2(gl_FragCoord.xy);
+    vec3 SurfacePos = (SceneBuffer.VTransform * vec4(texelFetch(GBufferPositionTexture, PixelPos, 0).xyz, 1)).xyz;
+    vec3 SurfaceNormal = (SceneBuffer.VTransform * vec4(texelFetch(GBufferNormalTexture, PixelPos, 0).xyz, 0)).xyz;
+    vec3 SurfaceColor = texelFetch(GBufferColorTexture, PixelPos, 0).rgb;
+    vec3 View = normalize(-SurfacePos);
+
+    vec3 LightDir = (SceneBuffer.VTransform * vec4(DirectionalLight.Dir, 0)).xyz;
+    vec3 Color = BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, DirectionalLight.Color);
+    Color += DirectionalLight.AmbientLight * SurfaceColor;
+    
+    OutColor = vec4(Color, 1);
+}
+
+#endif
+
+//
+// NOTE: Point Light Vert
+//
+
+#if POINT_LIGHT_VERT
+
+// NOTE: The sphere mesh has a radius of 0.5 and its faces sit inside of the true sphere, so we grow it a bit to stay conservative
+#define LIGHT_VOLUME_SCALE (2.0 * 1.05)
+
+layout(location = 0) in vec3 InPos;
+
+layout(location = 0) out flat uint OutLightId;
+
+void main()
+{
+    uint LightId = LightVolumeIds[gl_InstanceIndex];
+    gl_Position = PointLightTransforms[LightId] * vec4(LIGHT_VOLUME_SCALE * InPos, 1);
+    OutLightId = LightId;
+}
+
+#endif
+
+//
+// NOTE: Point Light Frag
+//
+
+#if POINT_LIGHT_FRAG
+
+layout(location = 0) in flat uint InLightId;
+
+layout(location = 0) out vec4 OutColor;
+
+void main()
+{
+    ivec2 PixelPos = ivec2(gl_FragCoord.xy);
+    vec3 SurfacePos = (SceneBuffer.VTransform * vec4(texelFetch(GBufferPositionTexture, PixelPos, 0).xyz, 1)).xyz;
+    vec3 SurfaceNormal = (SceneBuffer.VTransform * vec4(texelFetch(GBufferNormalTexture, PixelPos, 0).xyz, 0)).xyz;
+    vec3 SurfaceColor = texelFetch(GBufferColorTexture, PixelPos, 0).rgb;
+    vec3 View = normalize(-SurfacePos);
+
+    point_light CurrLight = PointLights[InLightId];
+
+    // NOTE: Depth only rejects pixels along the view ray, the surface can still be outside of the light to the side of the volume
+    vec3 LightToSurface = SurfacePos - CurrLight.Pos;
+    if (dot(LightToSurface, LightToSurface) > CurrLight.MaxDistance*CurrLight.MaxDistance)
+    {
+        discard;
+    }
+    
+    vec3 LightDir = normalize(SurfacePos - CurrLight.Pos);
+    vec3 Color = BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, PointLightAttenuate(SurfacePos, CurrLight));
+    
+    OutColor = vec4(Color, 0);
+}
+
+#endif
@@ -0,0 +1,124 @@
+
+inline void DeletionEntryDestroy(deletion_queue* Queue, deletion_entry* Entry)
+{
+    switch (Entry->Type)
+    {
+        case DeletionEntry_Buffer:
+        {
+            vkDestroyBuffer(RenderState->Device, Entry->Buffer, 0);
+        } break;
+
+        case DeletionEntry_Image:
+        {
+            vkDestroyImage(RenderState->Device, Entry->Image, 0);
+        } break;
+
+        case DeletionEntry_ImageView:
+        {
+            vkDestroyImageView(RenderState->Device, Entry->ImageView, 0);
+        } break;
+
+        default:
+        {
+            InvalidCodePath;
+        } break;
+    }
+
+    Queue->NumDeleted += 1;
+}
+
+inline void DeletionQueueCollect(deletion_queue* Queue)
+{
+    while (Queue->NumEntries > 0)
+    {
+        deletion_entry* Entry = Queue->Entries + Queue->FirstEntry;
+        if (Entry->FrameId > Queue->LastCompletedFrameId)
+        {
+            break;
+        }
+
+        DeletionEntryDestroy(Queue, Entry);
+        Queue->FirstEntry = (Queue->FirstEntry + 1) % DELETION_QUEUE_MAX_ENTRIES;
+        Queue->NumEntries -= 1;
+    }
+}
+
+inline void DeletionQueueFrameBegin(deletion_queue* Queue, VkFence CompletedFence)
+{
+    // NOTE: Call right after waiting on a fence. Frames complete in order, so everything older than the newest match is done too
+    u32 NumRetired = 0;
+    for (u32 FrameId = 0; FrameId < Queue->NumFrames; ++FrameId)
+    {
+        if (Queue->Frames[(Queue->FirstFrame + FrameId) % DELETION_QUEUE_MAX_FRAMES].Fence == CompletedFence)
+        {
+            NumRetired = FrameId + 1;
+        }
+    }
+
+    for (u32 FrameId = 0; FrameId < NumRetired; ++FrameId)
+    {
+        Queue->LastCompletedFrameId = Queue->Frames[Queue->FirstFrame].FrameId;
+        Queue->FirstFrame = (Queue->FirstFrame + 1) % DELETION_QUEUE_MAX_FRAMES;
+        Queue->NumFrames -= 1;
+    }
+
+    DeletionQueueCollect(Queue);
+}
+
+inline void DeletionQueueFrameEnd(deletion_queue* Queue, VkFence SubmitFence)
+{
+    // NOTE: Call right after submitting the frame that SubmitFence guards
+    Assert(Queue->NumFrames < DELETION_QUEUE_MAX_FRAMES);
+    deletion_queue_frame* Frame = Queue->Frames + (Queue->FirstFrame + Queue->NumFrames) % DELETION_QUEUE_MAX_FRAMES;
+    Queue->NumFrames += 1;
+    Frame->FrameId = ++Queue->LastSubmittedFrameId;
+    Frame->Fence = SubmitFence;
+}
+
+inline deletion_entry* DeletionQueuePush(deletion_queue* Queue, deletion_entry_type Type)
+{
+    // NOTE: Make room with whatever already completed before we give up
+    if (Queue->NumEntries == DELETION_QUEUE_MAX_ENTRIES)
+    {
+        DeletionQueueCollect(Queue);
+    }
+    Assert(Queue->NumEntries < DELETION_QUEUE_MAX_ENTRIES);
+
+    deletion_entry* Result = Queue->Entries + (Queue->FirstEntry + Queue->NumEntries) % DELETION_QUEUE_MAX_ENTRIES;
+    Queue->NumEntries += 1;
+    Result->Type = Type;
+    Result->FrameId = Queue->LastSubmittedFrameId;
+    return Result;
+}
+
+inline void DeletionQueueBufferPush(deletion_queue* Queue, VkBuffer Buffer)
+{
+    if (Buffer != VK_NULL_HANDLE)
+    {
+        DeletionQueuePush(Queue, DeletionEntry_Buffer)->Buffer = Buffer;
+    }
+}
+
+inline void DeletionQueueImagePush(deletion_queue* Queue, VkImage Image)
+{
+    if (Image != VK_NULL_HANDLE)
+    {
+        DeletionQueuePush(Queue, DeletionEntry_Image)->Image = Image;
+    }
+}
+
+inline void DeletionQueueImageViewPush(deletion_queue* Queue, VkImageView ImageView)
+{
+    if (ImageView != VK_NULL_HANDLE)
+    {
+        DeletionQueuePush(Queue, DeletionEntry_ImageView)->ImageView = ImageView;
+    }
+}
+
+inline void DeletionQueueFlush(deletion_queue* Queue)
+{
+    // IMPORTANT: Only call once the device is idle
+    Queue->LastCompletedFrameId = Queue->LastSubmittedFrameId;
+    Queue->NumFrames = 0;
+    DeletionQueueCollect(Queue);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+/*
+
+  NOTE: Deferred deletion. Resources we replace while the GPU may still be using them (render targets and tile buffers on a resize or
+        tile size change) get pushed here instead of destroyed. Every submitted frame records the fence that guards it, and once we
+        know that fence was signaled everything retired up to that frame gets destroyed. Entries are tagged with the last frame that
+        was submitted when they were retired, since that is the newest frame that can still reference them.
+
+        Same fence bookkeeping as the staging ring: fences get reset once they are waited on, so DeletionQueueFrameBegin has to be
+        called right after every wait.
+
+        Only destroying the handles is deferred, not reusing their memory. Render targets and tile buffers get recreated out of their
+        render target arena right after it gets cleared, so the replacements alias the retired resources. That only works because the
+        demo has a single frame in flight and replaces them after waiting on it.
+
+ */
+
+#define DELETION_QUEUE_MAX_ENTRIES 256
+#define DELETION_QUEUE_MAX_FRAMES 8
+
+enum deletion_entry_type
+{
+    DeletionEntry_Buffer,
+    DeletionEntry_Image,
+    DeletionEntry_ImageView,
+};
+
+struct deletion_entry
+{
+    deletion_entry_type Type;
+    u64 FrameId;
+    union
+    {
+        VkBuffer Buffer;
+        VkImage Image;
+        VkImageView ImageView;
+    };
+};
+
+struct deletion_queue_frame
+{
+    u64 FrameId;
+    VkFence Fence;
+};
+
+struct deletion_queue
+{
+    // NOTE: Frame ids start at 1, 0 means nothing was submitted yet
+    u64 LastSubmittedFrameId;
+    u64 LastCompletedFrameId;
+
+    u32 FirstFrame;
+    u32 NumFrames;
+    deletion_queue_frame Frames[DELETION_QUEUE_MAX_FRAMES];
+
+    // NOTE: Entries are retired in frame order, so this is a FIFO
+    u32 FirstEntry;
+    u32 NumEntries;
+    deletion_entry Entries[DELETION_QUEUE_MAX_ENTRIES];
+
+    u64 NumDeleted;
+};
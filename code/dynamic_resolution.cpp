@@ -0,0 +1,84 @@
+
+inline void DynamicResolutionSizeUpdate(dynamic_resolution* Resolution)
+{
+    // NOTE: Round to the size step but never past the targets
+    u32 Step = DYNAMIC_RESOLUTION_SIZE_STEP;
+    u32 Width = Max(Step, (u32(f32(Resolution->MaxWidth) * Resolution->Scale) + Step / 2) / Step * Step);
+    u32 Height = Max(Step, (u32(f32(Resolution->MaxHeight) * Resolution->Scale) + Step / 2) / Step * Step);
+    Width = Min(Width, Resolution->MaxWidth);
+    Height = Min(Height, Resolution->MaxHeight);
+
+    if (Width != Resolution->Width || Height != Resolution->Height)
+    {
+        Resolution->Stats.NumResizes += 1;
+    }
+    Resolution->Width = Width;
+    Resolution->Height = Height;
+}
+
+inline void DynamicResolutionCreate(dynamic_resolution* Resolution, b32 Enabled, f32 TargetMs, u32 MaxWidth, u32 MaxHeight)
+{
+    *Resolution = {};
+    Resolution->Enabled = Enabled;
+    Resolution->TargetMs = TargetMs;
+    Resolution->Scale = DYNAMIC_RESOLUTION_MAX_SCALE;
+    Resolution->MaxWidth = MaxWidth;
+    Resolution->MaxHeight = MaxHeight;
+    Resolution->Stats.MinScale = Resolution->Scale;
+    DynamicResolutionSizeUpdate(Resolution);
+    Resolution->Stats.NumResizes = 0;
+}
+
+inline void DynamicResolutionResize(dynamic_resolution* Resolution, u32 MaxWidth, u32 MaxHeight)
+{
+    // NOTE: Window resizes reallocate the targets, we keep the scale and just apply it to the new size
+    Resolution->MaxWidth = MaxWidth;
+    Resolution->MaxHeight = MaxHeight;
+    DynamicResolutionSizeUpdate(Resolution);
+}
+
+inline void DynamicResolutionUpdate(dynamic_resolution* Resolution, gpu_timers* Timers)
+{
+    // NOTE: Called at the start of a frame, timers hold the previous frame which was rendered at the current scale
+    f32 FrameMs = GpuTimerGetMs(Timers, GpuTimer_Frame);
+    if (!Resolution->Enabled || FrameMs <= 0.0f)
+    {
+        return;
+    }
+
+    dynamic_resolution_stats* Stats = &Resolution->Stats;
+    Stats->NumFrames += 1;
+    Stats->NumOverBudgetFrames += FrameMs > Resolution->TargetMs ? 1 : 0;
+    Stats->SumScale += Resolution->Scale;
+    Stats->MinScale = Min(Stats->MinScale, Resolution->Scale);
+    Stats->SumFrameMs += FrameMs;
+    Stats->MaxFrameMs = Max(Stats->MaxFrameMs, FrameMs);
+
+    f32 Error = (FrameMs - Resolution->TargetMs) / Resolution->TargetMs;
+    if (Error > DYNAMIC_RESOLUTION_DEAD_BAND || Error < -DYNAMIC_RESOLUTION_DEAD_BAND)
+    {
+        f32 WantedScale = Resolution->Scale * sqrtf(Resolution->TargetMs / FrameMs);
+        f32 NewScale = Resolution->Scale + DYNAMIC_RESOLUTION_DAMPING * (WantedScale - Resolution->Scale);
+        Resolution->Scale = Min(Max(NewScale, DYNAMIC_RESOLUTION_MIN_SCALE), DYNAMIC_RESOLUTION_MAX_SCALE);
+        DynamicResolutionSizeUpdate(Resolution);
+    }
+}
+
+inline void DynamicResolutionStatsDump(dynamic_resolution* Resolution, const char* FileName)
+{
+    dynamic_resolution_stats* Stats = &Resolution->Stats;
+    if (!Resolution->Enabled || Stats->NumFrames == 0)
+    {
+        return;
+    }
+
+    FILE* File = fopen(FileName, "wb");
+    if (File)
+    {
+        fprintf(File, "TargetMs, Frames, OverBudgetFrames, Resizes, AvgScale, MinScale, AvgFrameMs, MaxFrameMs\n");
+        fprintf(File, "%f, %llu, %llu, %llu, %f, %f, %f, %f\n", Resolution->TargetMs, Stats->NumFrames, Stats->NumOverBudgetFrames,
+                Stats->NumResizes, Stats->SumScale / f32(Stats->NumFrames), Stats->MinScale, Stats->SumFrameMs / f32(Stats->NumFrames),
+                Stats->MaxFrameMs);
+        fclose(File);
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+/*
+
+  NOTE: Dynamic resolution. The tiled deferred targets stay allocated at the window size, and every frame the GBuffer, SSAO and
+        lighting passes only render into the top left Width x Height rectangle of them. The copy to swap pass scales its uvs to that
+        rectangle and upscales bilinearly. Changing the scale only changes the viewport, the grid size in the tiled globals and the
+        grid frustums, so nothing gets reallocated and we never have to wait for the device to go idle.
+
+        The scale is driven by the GPU frame time of the previous frame. Frame time is roughly proportional to the pixel count, so the
+        scale we would need is Scale * sqrt(TargetMs / FrameMs). We only move part of the way there each frame and ignore errors
+        inside DYNAMIC_RESOLUTION_DEAD_BAND so the scale doesn't jitter on timing noise. Render sizes are rounded to
+        DYNAMIC_RESOLUTION_SIZE_STEP pixels, which also limits how often the grid frustums get rebuilt.
+
+        Only the tiled deferred renderer supports this, the other renderers always render at full size.
+
+ */
+
+#define DYNAMIC_RESOLUTION 0
+#define DYNAMIC_RESOLUTION_TARGET_MS 16.0f
+#define DYNAMIC_RESOLUTION_MIN_SCALE 0.5f
+#define DYNAMIC_RESOLUTION_MAX_SCALE 1.0f
+#define DYNAMIC_RESOLUTION_DEAD_BAND 0.05f
+#define DYNAMIC_RESOLUTION_DAMPING 0.25f
+#define DYNAMIC_RESOLUTION_SIZE_STEP 8
+#define DYNAMIC_RESOLUTION_FILE_NAME "dynamic_resolution.csv"
+
+struct dynamic_resolution_stats
+{
+    u64 NumFrames;
+    u64 NumOverBudgetFrames;
+    u64 NumResizes;
+    f32 SumScale;
+    f32 MinScale;
+    f32 SumFrameMs;
+    f32 MaxFrameMs;
+};
+
+struct dynamic_resolution
+{
+    b32 Enabled;
+    f32 TargetMs;
+    f32 Scale;
+
+    // NOTE: Size of the targets vs. size we render at this frame
+    u32 MaxWidth;
+    u32 MaxHeight;
+    u32 Width;
+    u32 Height;
+
+    dynamic_resolution_stats Stats;
+};
+
+// NOTE: Read by the copy to swap pass, the output rectangle in uv space of the renderers output target
+struct copy_to_swap_globals
+{
+    v2 UvScale;
+    v2 UvMax;
+};
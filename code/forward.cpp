@@ -0,0 +1,109 @@
+
+inline void ForwardSwapChainChange(forward_state* State, u32 Width, u32 Height, VkFormat ColorFormat, render_scene* Scene)
+{
+    b32 ReCreate = State->RenderTargetArena.Used != 0;
+    VkArenaClear(&State->RenderTargetArena);
+    MemoryStatsArenaClear(&DemoState->MemoryStats, &State->RenderTargetArena.Used);
+
+    TaggedRenderTargetEntryReCreate("forward", &State->RenderTargetArena, Width, Height, VK_FORMAT_D32_SFLOAT, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                                    VK_IMAGE_ASPECT_DEPTH_BIT, &State->DepthImage, &State->DepthEntry);
+    TaggedRenderTargetEntryReCreate("forward", &State->RenderTargetArena, Width, Height, ColorFormat,
+                                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                    VK_IMAGE_ASPECT_COLOR_BIT, &State->OutColorImage, &State->OutColorEntry);
+
+    if (ReCreate)
+    {
+        RenderTargetUpdateEntries(FrameArenaGet(&DemoState->FrameArena), &State->ForwardPass);
+    }
+}
+
+inline void ForwardCreate(renderer_create_info CreateInfo, forward_state* Result)
+{
+    *Result = {};
+
+    u64 HeapSize = MegaBytes(256);
+    Result->RenderTargetArena = VkLinearArenaCreate(VkMemoryAllocate(RenderState->Device, RenderState->LocalMemoryId, HeapSize), HeapSize);
+    MemoryStatsArenaAdd(&DemoState->MemoryStats, "forward_targets", true, &Result->RenderTargetArena.Used, HeapSize);
+
+    ForwardSwapChainChange(Result, CreateInfo.Width, CreateInfo.Height, CreateInfo.ColorFormat, CreateInfo.Scene);
+    
+    // NOTE: RT
+    {
+        render_target_builder Builder = RenderTargetBuilderBegin(&DemoState->Arena, &DemoState->TempArena, CreateInfo.Width, CreateInfo.Height);
+        RenderTargetAddTarget(&Builder, &Result->OutColorEntry, VkClearColorCreate(0, 0, 0, 1));
+        RenderTargetAddTarget(&Builder, &Result->DepthEntry, VkClearDepthStencilCreate(0, 0));
+                            
+        vk_render_pass_builder RpBuilder = VkRenderPassBuilderBegin(&DemoState->TempArena);
+
+        u32 OutColorId = VkRenderPassAttachmentAdd(&RpBuilder, Result->OutColorEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                   VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        u32 DepthId = VkRenderPassAttachmentAdd(&RpBuilder, Result->DepthEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+
+        VkRenderPassSubPassBegin(&RpBuilder, VK_PIPELINE_BIND_POINT_GRAPHICS);
+        VkRenderPassColorRefAdd(&RpBuilder, OutColorId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        VkRenderPassDepthRefAdd(&RpBuilder, DepthId, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+        VkRenderPassSubPassEnd(&RpBuilder);
+
+        Result->ForwardPass = RenderTargetBuilderEnd(&Builder, VkRenderPassBuilderEnd(&RpBuilder, RenderState->Device));
+    }
+
+    // NOTE: Forward Pipeline
+    {
+        vk_pipeline_builder Builder = VkPipelineBuilderBegin(&DemoState->TempArena);
+
+        // NOTE: Shaders
+        VkPipelineShaderAdd(&Builder, "shader_forward_vert.spv", "main", VK_SHADER_STAGE_VERTEX_BIT);
+        VkPipelineShaderAdd(&Builder, "shader_forward_frag.spv", "main", VK_SHADER_STAGE_FRAGMENT_BIT);
+                
+        // NOTE: Specify input vertex data format
+        VkPipelineVertexBindingBegin(&Builder);
+        VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, sizeof(v3));
+        VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, sizeof(v3));
+        VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32_SFLOAT, sizeof(v2));
+        VkPipelineVertexBindingEnd(&Builder);
+
+        VkPipelineInputAssemblyAdd(&Builder, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
+        VkPipelineDepthStateAdd(&Builder, VK_TRUE, VK_TRUE, VK_COMPARE_OP_GREATER);
+        VkPipelineColorAttachmentAdd(&Builder, VK_FALSE, VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO,
+                                     VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO);
+
+        VkDescriptorSetLayout DescriptorLayouts[] =
+            {
+                CreateInfo.SceneDescLayout,
+                CreateInfo.MaterialDescLayout,
+            };
+            
+        Result->ForwardPipeline = VkPipelineBuilderEnd(&Builder, RenderState->Device, &RenderState->PipelineManager,
+                                                       Result->ForwardPass.RenderPass, 0, DescriptorLayouts, ArrayCount(DescriptorLayouts));
+    }
+}
+
+inline void ForwardRender(vk_commands Commands, forward_state* State, render_scene* Scene)
+{
+    GpuTimerBegin(Commands, &DemoState->GpuTimers, GpuTimer_Lighting);
+    RenderTargetPassBegin(&State->ForwardPass, Commands, RenderTargetRenderPass_SetViewPort | RenderTargetRenderPass_SetScissor);
+    {
+        vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->ForwardPipeline->Handle);
+        vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->ForwardPipeline->Layout, 0, 1,
+                                &Scene->SceneDescriptor, 0, 0);
+
+        for (u32 InstanceId = 0; InstanceId < Scene->OpaqueInstances.NumItems; ++InstanceId)
+        {
+            instance_entry* CurrInstance = SceneOpaqueInstanceAt(Scene, InstanceId);
+            render_mesh* CurrMesh = SceneMeshGet(Scene, CurrInstance->Mesh);
+
+            vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->ForwardPipeline->Layout, 1, 1,
+                                    &CurrMesh->MaterialDescriptor, 0, 0);
+            
+            VkDeviceSize Offset = 0;
+            vkCmdBindVertexBuffers(Commands.Buffer, 0, 1, &CurrMesh->VertexBuffer, &Offset);
+            vkCmdBindIndexBuffer(Commands.Buffer, CurrMesh->IndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+            vkCmdDrawIndexed(Commands.Buffer, CurrMesh->NumIndices, 1, 0, 0, InstanceId);
+        }
+    }
+    RenderTargetPassEnd(Commands);
+    GpuTimerEnd(Commands, &DemoState->GpuTimers, GpuTimer_Lighting);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+/*
+
+  NOTE: Plain forward renderer. Every pixel shades every point light in the scene, this is the baseline the tiled renderers get compared
+        against.
+  
+ */
+
+struct forward_state
+{
+    vk_linear_arena RenderTargetArena;
+
+    VkImage DepthImage;
+    render_target_entry DepthEntry;
+    VkImage OutColorImage;
+    render_target_entry OutColorEntry;
+    render_target ForwardPass;
+
+    vk_pipeline* ForwardPipeline;
+};
@@ -0,0 +1,82 @@
+#version 450
+
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_GOOGLE_include_directive : enable
+
+#include "shader_descriptor_layouts.cpp"
+#include "shader_blinn_phong_lighting.cpp"
+
+//
+// NOTE: Descriptor Sets
+//
+
+SCENE_DESCRIPTOR_LAYOUT(0)
+MATERIAL_DESCRIPTOR_LAYOUT(1)
+
+//
+// NOTE: Forward Vertex
+//
+
+#if FORWARD_VERT
+
+layout(location = 0) in vec3 InPos;
+layout(location = 1) in vec3 InNormal;
+layout(location = 2) in vec2 InUv;
+
+layout(location = 0) out vec3 OutViewPos;
+layout(location = 1) out vec3 OutViewNormal;
+layout(location = 2) out vec2 OutUv;
+
+void main()
+{
+    instance_entry Entry = InstanceBuffer[gl_InstanceIndex];
+    
+    gl_Position = Entry.WVPTransform * vec4(InPos, 1);
+    OutViewPos = (SceneBuffer.VTransform * Entry.WTransform * vec4(InPos, 1)).xyz;
+    OutViewNormal = (SceneBuffer.VTransform * Entry.WTransform * vec4(InNormal, 0)).xyz;
+    OutUv = InUv;
+}
+
+#endif
+
+//
+// NOTE: Forward Fragment
+//
+
+#if FORWARD_FRAG
+
+layout(location = 0) in vec3 InViewPos;
+layout(location = 1) in vec3 InViewNormal;
+layout(location = 2) in vec2 InUv;
+
+layout(location = 0) out vec4 OutColor;
+
+void main()
+{
+    // NOTE: We light in view space since that is the space point lights are stored in
+    vec3 SurfacePos = InViewPos;
+    vec3 SurfaceNormal = normalize(InViewNormal);
+    vec3 SurfaceColor = texture(ColorTexture, InUv).rgb;
+    vec3 View = normalize(-SurfacePos);
+
+    vec3 Color = vec3(0);
+
+    // NOTE: Calculate lighting for point lights
+    for (uint LightId = 0; LightId < SceneBuffer.NumPointLights; ++LightId)
+    {
+        point_light CurrLight = PointLights[LightId];
+        vec3 LightDir = normalize(SurfacePos - CurrLight.Pos);
+        Color += BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, PointLightAttenuate(SurfacePos, CurrLight));
+    }
+
+    // NOTE: Calculate lighting for directional lights
+    {
+        vec3 LightDir = (SceneBuffer.VTransform * vec4(DirectionalLight.Dir, 0)).xyz;
+        Color += BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, DirectionalLight.Color);
+        Color += DirectionalLight.AmbientLight * SurfaceColor;
+    }
+
+    OutColor = vec4(Color, 1);
+}
+
+#endif
@@ -0,0 +1,113 @@
+inline void FrameArenaCreate(frame_arena* FrameArena, linear_arena* Arena)
+{
+    *FrameArena = {};
+
+    SYSTEM_INFO SystemInfo = {};
+    GetSystemInfo(&SystemInfo);
+    FrameArena->NumThreads = Min(Max(u32(SystemInfo.dwNumberOfProcessors), 1u), u32(FRAME_ARENA_MAX_THREADS));
+
+    for (u32 SlotId = 0; SlotId < FRAME_ARENA_MAX_FRAMES; ++SlotId)
+    {
+        frame_arena_slot* Slot = FrameArena->Slots + SlotId;
+        for (u32 ThreadId = 0; ThreadId < FrameArena->NumThreads; ++ThreadId)
+        {
+            Slot->Arenas[ThreadId] = LinearSubArena(Arena, ThreadId == 0 ? FRAME_ARENA_SIZE : FRAME_ARENA_THREAD_SIZE);
+        }
+    }
+}
+
+inline void FrameArenaRetire(frame_arena* FrameArena, u64 FrameId)
+{
+    // NOTE: Frames complete in order, so every frame up to FrameId is done
+    for (u32 SlotId = 0; SlotId < FRAME_ARENA_MAX_FRAMES; ++SlotId)
+    {
+        frame_arena_slot* Slot = FrameArena->Slots + SlotId;
+        if (Slot->InFlight && Slot->FrameId <= FrameId)
+        {
+            Slot->InFlight = false;
+        }
+    }
+}
+
+inline void FrameArenaFrameBegin(frame_arena* FrameArena, VkFence CompletedFence)
+{
+    // NOTE: Call right after waiting on a fence, every frame it guards has to be retired here or we would wait on it again later
+    u64 CompletedFrameId = 0;
+    for (u32 SlotId = 0; SlotId < FRAME_ARENA_MAX_FRAMES; ++SlotId)
+    {
+        frame_arena_slot* Slot = FrameArena->Slots + SlotId;
+        if (Slot->InFlight && Slot->Fence == CompletedFence)
+        {
+            CompletedFrameId = Max(CompletedFrameId, Slot->FrameId);
+        }
+    }
+    FrameArenaRetire(FrameArena, CompletedFrameId);
+
+    FrameArena->CurrSlot = (FrameArena->CurrSlot + 1) % FRAME_ARENA_MAX_FRAMES;
+    frame_arena_slot* Slot = FrameArena->Slots + FrameArena->CurrSlot;
+    if (Slot->InFlight)
+    {
+        // NOTE: Backpressure, the frame that last used this arena may still reference it
+        VkCheckResult(vkWaitForFences(RenderState->Device, 1, &Slot->Fence, VK_TRUE, UINT64_MAX));
+        FrameArenaRetire(FrameArena, Slot->FrameId);
+        FrameArena->Stats.NumWaits += 1;
+    }
+
+    for (u32 ThreadId = 0; ThreadId < FrameArena->NumThreads; ++ThreadId)
+    {
+        Slot->Arenas[ThreadId].Used = 0;
+    }
+}
+
+inline void FrameArenaFrameEnd(frame_arena* FrameArena, VkFence SubmitFence)
+{
+    // NOTE: Call right after submitting the frame that SubmitFence guards. Nothing allocates from the frame after this, so this is
+    // where the arenas hold the most
+    frame_arena_slot* Slot = FrameArena->Slots + FrameArena->CurrSlot;
+    for (u32 ThreadId = 0; ThreadId < FrameArena->NumThreads; ++ThreadId)
+    {
+        FrameArena->Stats.PeakUsed[ThreadId] = Max(FrameArena->Stats.PeakUsed[ThreadId], Slot->Arenas[ThreadId].Used);
+    }
+
+    Slot->InFlight = true;
+    Slot->FrameId = ++FrameArena->LastSubmittedFrameId;
+    Slot->Fence = SubmitFence;
+    FrameArena->Stats.NumFrames += 1;
+}
+
+inline linear_arena* FrameArenaThreadGet(frame_arena* FrameArena, u32 ThreadId)
+{
+    Assert(ThreadId < FrameArena->NumThreads);
+    linear_arena* Result = FrameArena->Slots[FrameArena->CurrSlot].Arenas + ThreadId;
+    return Result;
+}
+
+inline linear_arena* FrameArenaGet(frame_arena* FrameArena)
+{
+    linear_arena* Result = FrameArenaThreadGet(FrameArena, 0);
+    return Result;
+}
+
+inline void FrameArenaStatsDump(frame_arena* FrameArena, const char* FileName)
+{
+    FILE* File = fopen(FileName, "wb");
+    if (!File)
+    {
+        return;
+    }
+
+    frame_arena_stats* Stats = &FrameArena->Stats;
+    f32 MegaByte = 1024.0f*1024.0f;
+
+    fprintf(File, "Frames, Waits\n");
+    fprintf(File, "%llu, %llu\n", Stats->NumFrames, Stats->NumWaits);
+
+    fprintf(File, "\nThread, SizeMb, PeakMb\n");
+    for (u32 ThreadId = 0; ThreadId < FrameArena->NumThreads; ++ThreadId)
+    {
+        fprintf(File, "%u, %f, %f\n", ThreadId, f32(FrameArena->Slots[0].Arenas[ThreadId].Size) / MegaByte,
+                f32(Stats->PeakUsed[ThreadId]) / MegaByte);
+    }
+
+    fclose(File);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+/*
+
+  NOTE: Frame arenas for CPU scratch memory that only has to live for one frame (render target entry updates, swap chain recreation).
+        TempArena never gets reset since init allocations in it stay referenced, so anything we pushed there every frame would
+        eventually run it out. Instead every frame in flight gets its own arena, and a frame only starts reusing an arena once the fence
+        of the frame that last used it is known to be signaled, so whatever we hand to the driver stays valid until the GPU is done.
+
+        Same fence bookkeeping as the staging ring: fences get reset once they are waited on, so FrameArenaFrameBegin has to be called
+        right after every wait. If the next arena is still in flight we wait on its fence (backpressure) and count it.
+
+        Worker threads get their own arena per frame, indexed by the same thread ids the software raster hands out (0 is the main
+        thread and gets the big one), so they never have to synchronize to allocate. Workers have to be done before the next frame
+        begins.
+
+        Arenas get reset with every frame, so their used size is only interesting right before that. We keep the high water mark of
+        every frame and thread arena and write it out on shutdown to size FRAME_ARENA_SIZE and FRAME_ARENA_THREAD_SIZE.
+
+ */
+
+#define FRAME_ARENA_MAX_FRAMES 2
+#define FRAME_ARENA_MAX_THREADS 16
+#define FRAME_ARENA_SIZE MegaBytes(4)
+#define FRAME_ARENA_THREAD_SIZE MegaBytes(1)
+#define FRAME_ARENA_FILE_NAME "frame_arena_stats.csv"
+
+struct frame_arena_slot
+{
+    b32 InFlight;
+    u64 FrameId;
+    VkFence Fence;
+    linear_arena Arenas[FRAME_ARENA_MAX_THREADS];
+};
+
+struct frame_arena_stats
+{
+    u64 NumFrames;
+    u64 NumWaits;
+    u64 PeakUsed[FRAME_ARENA_MAX_THREADS];
+};
+
+struct frame_arena
+{
+    u32 NumThreads;
+    u32 CurrSlot;
+
+    // NOTE: Frame ids start at 1, 0 means nothing was submitted yet
+    u64 LastSubmittedFrameId;
+    frame_arena_slot Slots[FRAME_ARENA_MAX_FRAMES];
+
+    frame_arena_stats Stats;
+};
@@ -0,0 +1,495 @@
+
+//
+// NOTE: Image Files
+//
+
+inline void GoldenTestFileName(char* Buffer, u32 BufferSize, const char* Prefix, const char* Name, const char* Suffix)
+{
+    snprintf(Buffer, BufferSize, "%s%s%s", Prefix, Name, Suffix);
+}
+
+inline void GoldenTestPfmWrite(const char* FileName, f32* Texels, u32 NumChannels, u32 Width, u32 Height)
+{
+    // NOTE: Float PFMs keep occlusion and HDR color exact, "Pf" holds 1 channel and "PF" 3. Rows are stored bottom to top, negative
+    // scale means little endian
+    Assert(NumChannels == 1 || NumChannels == 3);
+    FILE* File = fopen(FileName, "wb");
+    if (!File)
+    {
+        return;
+    }
+
+    fprintf(File, "%s\n%u %u\n-1.0\n", NumChannels == 1 ? "Pf" : "PF", Width, Height);
+    u32 RowSize = NumChannels * Width;
+    for (u32 Y = 0; Y < Height; ++Y)
+    {
+        fwrite(Texels + (Height - 1 - Y) * RowSize, sizeof(f32) * RowSize, 1, File);
+    }
+    fclose(File);
+}
+
+inline f32* GoldenTestPfmRead(linear_arena* Arena, const char* FileName, u32 NumChannels, u32* Width, u32* Height)
+{
+    // NOTE: Only reads what GoldenTestPfmWrite writes with the same number of channels, rows come back top to bottom
+    f32* Result = 0;
+    FILE* File = fopen(FileName, "rb");
+    if (File)
+    {
+        char Type[3] = {};
+        f32 Scale = 0.0f;
+        if (fscanf(File, "%2s %u %u %f", Type, Width, Height, &Scale) == 4 && strcmp(Type, NumChannels == 1 ? "Pf" : "PF") == 0 &&
+            Scale < 0.0f && fgetc(File) != EOF)
+        {
+            u32 RowSize = NumChannels * *Width;
+            Result = PushArray(Arena, f32, u64(RowSize) * u64(*Height));
+            for (u32 Y = 0; Y < *Height; ++Y)
+            {
+                if (fread(Result + (*Height - 1 - Y) * RowSize, sizeof(f32) * RowSize, 1, File) != 1)
+                {
+                    Result = 0;
+                    break;
+                }
+            }
+        }
+        fclose(File);
+    }
+
+    return Result;
+}
+
+inline b32 GoldenTestTimingsRead(const char* FileName, f32* BaselineMs)
+{
+    // NOTE: One "Pass Ms" line per entry of GoldenTestPasses, passes missing from the file keep a baseline of 0 and aren't checked
+    FILE* File = fopen(FileName, "rb");
+    if (!File)
+    {
+        return false;
+    }
+
+    char PassName[64];
+    f32 Ms = 0.0f;
+    while (fscanf(File, "%63s %f", PassName, &Ms) == 2)
+    {
+        for (u32 PassId = 0; PassId < ArrayCount(GoldenTestPasses); ++PassId)
+        {
+            if (strcmp(PassName, GoldenTestPasses[PassId].Name) == 0)
+            {
+                BaselineMs[PassId] = Ms;
+            }
+        }
+    }
+    fclose(File);
+
+    return true;
+}
+
+inline void GoldenTestTimingsWrite(const char* FileName, f32* PassMs)
+{
+    FILE* File = fopen(FileName, "wb");
+    if (File)
+    {
+        for (u32 PassId = 0; PassId < ArrayCount(GoldenTestPasses); ++PassId)
+        {
+            fprintf(File, "%s %f\n", GoldenTestPasses[PassId].Name, PassMs[PassId]);
+        }
+        fclose(File);
+    }
+}
+
+//
+// NOTE: Comparison
+//
+
+inline f32 GoldenTestLabF(f32 T)
+{
+    f32 Result = T > 0.008856f ? cbrtf(T) : 7.787f * T + 16.0f / 116.0f;
+    return Result;
+}
+
+inline f32 GoldenTestF16ToF32(u16 Value)
+{
+    f32 Result = 0.0f;
+    u32 Sign = u32(Value & 0x8000) << 16;
+    u32 Exponent = (Value >> 10) & 0x1F;
+    u32 Mantissa = Value & 0x3FF;
+    if (Exponent == 0)
+    {
+        // NOTE: Denormals are the mantissa times 2^-24
+        Result = f32(Mantissa) * (1.0f / 16777216.0f);
+        Result = Sign ? -Result : Result;
+    }
+    else
+    {
+        u32 Bits = Sign | (Exponent == 31 ? (0xFFu << 23) : ((Exponent + 112) << 23)) | (Mantissa << 13);
+        Copy(&Bits, &Result, sizeof(Result));
+    }
+
+    return Result;
+}
+
+inline u32 GoldenTestColorTexelSize(VkFormat Format)
+{
+    u32 Result = 0;
+    switch (Format)
+    {
+        case VK_FORMAT_R8G8B8A8_UNORM: { Result = 4; } break;
+        case VK_FORMAT_R16G16B16A16_SFLOAT: { Result = 8; } break;
+        default: InvalidCodePath;
+    }
+
+    return Result;
+}
+
+inline f32* GoldenTestColorDecode(linear_arena* Arena, u8* Texels, VkFormat Format, u32 NumPixels)
+{
+    // NOTE: Returns linear rgb floats, alpha gets dropped. UNORM targets hold linear values too, so there is no sRGB curve to undo
+    f32* Result = PushArray(Arena, f32, 3 * u64(NumPixels));
+    for (u32 PixelId = 0; PixelId < NumPixels; ++PixelId)
+    {
+        for (u32 ChannelId = 0; ChannelId < 3; ++ChannelId)
+        {
+            f32 Value = 0.0f;
+            switch (Format)
+            {
+                case VK_FORMAT_R8G8B8A8_UNORM: { Value = f32(Texels[4 * PixelId + ChannelId]) / 255.0f; } break;
+                case VK_FORMAT_R16G16B16A16_SFLOAT: { Value = GoldenTestF16ToF32(((u16*)Texels)[4 * PixelId + ChannelId]); } break;
+                default: InvalidCodePath;
+            }
+            Result[3 * PixelId + ChannelId] = Value;
+        }
+    }
+
+    return Result;
+}
+
+inline v3 GoldenTestLinearToLab(f32* Texel)
+{
+    // NOTE: Lighting can go above 1, Lab handles that fine, L just goes past 100
+    f32 R = Max(Texel[0], 0.0f);
+    f32 G = Max(Texel[1], 0.0f);
+    f32 B = Max(Texel[2], 0.0f);
+
+    // NOTE: Linear sRGB to XYZ, normalized by the D65 white point
+    f32 X = (0.4124f * R + 0.3576f * G + 0.1805f * B) / 0.95047f;
+    f32 Y = 0.2126f * R + 0.7152f * G + 0.0722f * B;
+    f32 Z = (0.0193f * R + 0.1192f * G + 0.9505f * B) / 1.08883f;
+
+    f32 Fx = GoldenTestLabF(X);
+    f32 Fy = GoldenTestLabF(Y);
+    f32 Fz = GoldenTestLabF(Z);
+    v3 Result = V3(116.0f * Fy - 16.0f, 500.0f * (Fx - Fy), 200.0f * (Fy - Fz));
+    return Result;
+}
+
+inline golden_test_image_result GoldenTestImageResultEnd(golden_test_image_result Result, f64 SumError, u32 NumPixels)
+{
+    Result.MeanError = f32(SumError / f64(NumPixels));
+    Result.Status = f32(Result.NumBadPixels) > GOLDEN_TEST_MAX_BAD_PIXEL_RATIO * f32(NumPixels) ? GoldenTestStatus_Fail : GoldenTestStatus_Pass;
+    return Result;
+}
+
+inline golden_test_image_result GoldenTestColorCompare(f32* Curr, f32* Golden, u32 NumPixels)
+{
+    // NOTE: Both are linear rgb floats
+    golden_test_image_result Result = {};
+    f64 SumError = 0.0;
+    for (u32 PixelId = 0; PixelId < NumPixels; ++PixelId)
+    {
+        f32 DeltaE = Length(GoldenTestLinearToLab(Curr + 3 * PixelId) - GoldenTestLinearToLab(Golden + 3 * PixelId));
+        SumError += DeltaE;
+        Result.MaxError = Max(Result.MaxError, DeltaE);
+        Result.NumBadPixels += DeltaE > GOLDEN_TEST_COLOR_TOLERANCE ? 1 : 0;
+    }
+
+    Result = GoldenTestImageResultEnd(Result, SumError, NumPixels);
+    return Result;
+}
+
+inline golden_test_image_result GoldenTestSsaoCompare(f32* Curr, f32* Golden, u32 NumPixels)
+{
+    golden_test_image_result Result = {};
+    f64 SumError = 0.0;
+    for (u32 PixelId = 0; PixelId < NumPixels; ++PixelId)
+    {
+        f32 Error = fabsf(Curr[PixelId] - Golden[PixelId]);
+        SumError += Error;
+        Result.MaxError = Max(Result.MaxError, Error);
+        Result.NumBadPixels += Error > GOLDEN_TEST_SSAO_TOLERANCE ? 1 : 0;
+    }
+
+    Result = GoldenTestImageResultEnd(Result, SumError, NumPixels);
+    return Result;
+}
+
+inline void GoldenTestScenarioFinish(golden_test* Test, golden_test_result* Result, benchmark_scenario* Scenario)
+{
+    // NOTE: Called once the frame with the copy finished, so the readback holds this scenarios images
+    Test->Arena.Used = 0;
+    u32 Width = Test->CaptureWidth;
+    u32 Height = Test->CaptureHeight;
+    u32 NumPixels = Width * Height;
+    u64 ColorSize = u64(GoldenTestColorTexelSize(Test->CaptureFormat)) * NumPixels;
+    f32* CurrColor = GoldenTestColorDecode(&Test->Arena, Test->Readback.Ptr, Test->CaptureFormat, NumPixels);
+    f32* CurrSsao = (f32*)(Test->Readback.Ptr + ColorSize);
+    Result->Width = Width;
+    Result->Height = Height;
+
+    char ColorFileName[256];
+    char SsaoFileName[256];
+    char TimingsFileName[256];
+    GoldenTestFileName(ColorFileName, sizeof(ColorFileName), GOLDEN_TEST_DIRECTORY, Scenario->Name, "_color.pfm");
+    GoldenTestFileName(SsaoFileName, sizeof(SsaoFileName), GOLDEN_TEST_DIRECTORY, Scenario->Name, "_ssao.pfm");
+    GoldenTestFileName(TimingsFileName, sizeof(TimingsFileName), GOLDEN_TEST_DIRECTORY, Scenario->Name, "_timings.txt");
+
+    // NOTE: Color
+    {
+        u32 GoldenWidth = 0;
+        u32 GoldenHeight = 0;
+        f32* Golden = GoldenTestPfmRead(&Test->Arena, ColorFileName, 3, &GoldenWidth, &GoldenHeight);
+        if (!Golden && Test->UpdateGoldens)
+        {
+            GoldenTestPfmWrite(ColorFileName, CurrColor, 3, Width, Height);
+            Result->Color.Status = GoldenTestStatus_New;
+        }
+        else if (!Golden)
+        {
+            Result->Color.Status = GoldenTestStatus_Missing;
+        }
+        else if (GoldenWidth != Width || GoldenHeight != Height)
+        {
+            Result->Color.Status = GoldenTestStatus_Fail;
+            Result->Color.NumBadPixels = NumPixels;
+        }
+        else
+        {
+            Result->Color = GoldenTestColorCompare(CurrColor, Golden, NumPixels);
+        }
+    }
+
+    // NOTE: SSAO
+    {
+        u32 GoldenWidth = 0;
+        u32 GoldenHeight = 0;
+        f32* Golden = GoldenTestPfmRead(&Test->Arena, SsaoFileName, 1, &GoldenWidth, &GoldenHeight);
+        if (!Golden && Test->UpdateGoldens)
+        {
+            GoldenTestPfmWrite(SsaoFileName, CurrSsao, 1, Width, Height);
+            Result->Ssao.Status = GoldenTestStatus_New;
+        }
+        else if (!Golden)
+        {
+            Result->Ssao.Status = GoldenTestStatus_Missing;
+        }
+        else if (GoldenWidth != Width || GoldenHeight != Height)
+        {
+            Result->Ssao.Status = GoldenTestStatus_Fail;
+            Result->Ssao.NumBadPixels = NumPixels;
+        }
+        else
+        {
+            Result->Ssao = GoldenTestSsaoCompare(CurrSsao, Golden, NumPixels);
+        }
+    }
+
+    // NOTE: Timings
+    if (!GoldenTestTimingsRead(TimingsFileName, Result->BaselineMs))
+    {
+        if (Test->UpdateGoldens)
+        {
+            GoldenTestTimingsWrite(TimingsFileName, Result->PassMs);
+            Copy(Result->PassMs, Result->BaselineMs, sizeof(Result->PassMs));
+            Result->PerfStatus = GoldenTestStatus_New;
+        }
+        else
+        {
+            Result->PerfStatus = GoldenTestStatus_Missing;
+        }
+    }
+    else
+    {
+        Result->PerfStatus = GoldenTestStatus_Pass;
+        for (u32 PassId = 0; PassId < ArrayCount(GoldenTestPasses); ++PassId)
+        {
+            // NOTE: Passes that didn't run when the baseline was taken have nothing to compare against
+            f32 BaselineMs = Result->BaselineMs[PassId];
+            if (BaselineMs > 0.0f && Result->PassMs[PassId] > BaselineMs * GoldenTestPasses[PassId].MaxRatio + GOLDEN_TEST_PERF_SLACK_MS)
+            {
+                Result->PerfStatus = GoldenTestStatus_Fail;
+            }
+        }
+    }
+
+    b32 ImageFailed = (Result->Color.Status == GoldenTestStatus_Fail || Result->Color.Status == GoldenTestStatus_Missing ||
+                       Result->Ssao.Status == GoldenTestStatus_Fail || Result->Ssao.Status == GoldenTestStatus_Missing);
+    if (ImageFailed)
+    {
+        GoldenTestFileName(ColorFileName, sizeof(ColorFileName), "golden_test_", Scenario->Name, "_color.pfm");
+        GoldenTestFileName(SsaoFileName, sizeof(SsaoFileName), "golden_test_", Scenario->Name, "_ssao.pfm");
+        GoldenTestPfmWrite(ColorFileName, CurrColor, 3, Width, Height);
+        GoldenTestPfmWrite(SsaoFileName, CurrSsao, 1, Width, Height);
+    }
+
+    // NOTE: Missing goldens fail too, otherwise a run without any goldens would pass
+    if (ImageFailed || Result->PerfStatus == GoldenTestStatus_Fail || Result->PerfStatus == GoldenTestStatus_Missing)
+    {
+        Test->Failed = true;
+    }
+}
+
+//
+// NOTE: Runner
+//
+
+inline void GoldenTestBegin(golden_test* Test, u32 WarmupFrames, u32 MeasureFrames, b32 UpdateGoldens)
+{
+    Assert(ArrayCount(BenchmarkScenarios) <= MAX_NUM_SCENARIOS);
+
+    *Test = {};
+    Test->Running = true;
+    Test->UpdateGoldens = UpdateGoldens;
+    Test->WarmupFrames = WarmupFrames;
+    Test->MeasureFrames = MeasureFrames;
+
+    // NOTE: Holds the goldens we load and the decoded capture, big enough for 4k targets
+    void* Memory = VirtualAlloc(0, GOLDEN_TEST_ARENA_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    Assert(Memory);
+    Test->Arena = LinearArenaCreate(Memory, GOLDEN_TEST_ARENA_SIZE);
+
+    // NOTE: Fails when the directory already exists, which is fine
+    CreateDirectoryA(GOLDEN_TEST_DIRECTORY, 0);
+}
+
+inline void GoldenTestWriteResults(golden_test* Test, const char* FileName)
+{
+    FILE* File = fopen(FileName, "wb");
+    if (File)
+    {
+        fprintf(File, "Scenario, Width, Height, Color, ColorBadPixels, ColorMeanDeltaE, ColorMaxDeltaE, Ssao, SsaoBadPixels, SsaoMeanError, "
+                "SsaoMaxError, Perf");
+        for (u32 PassId = 0; PassId < ArrayCount(GoldenTestPasses); ++PassId)
+        {
+            fprintf(File, ", %sMs, %sBaselineMs", GoldenTestPasses[PassId].Name, GoldenTestPasses[PassId].Name);
+        }
+        fprintf(File, "\n");
+
+        for (u32 ScenarioId = 0; ScenarioId < ArrayCount(BenchmarkScenarios); ++ScenarioId)
+        {
+            golden_test_result* Result = Test->Results + ScenarioId;
+            fprintf(File, "%s, %u, %u, %s, %u, %f, %f, %s, %u, %f, %f, %s", BenchmarkScenarios[ScenarioId].Name, Result->Width, Result->Height,
+                    GoldenTestStatusNames[Result->Color.Status], Result->Color.NumBadPixels, Result->Color.MeanError, Result->Color.MaxError,
+                    GoldenTestStatusNames[Result->Ssao.Status], Result->Ssao.NumBadPixels, Result->Ssao.MeanError, Result->Ssao.MaxError,
+                    GoldenTestStatusNames[Result->PerfStatus]);
+            for (u32 PassId = 0; PassId < ArrayCount(GoldenTestPasses); ++PassId)
+            {
+                fprintf(File, ", %f, %f", Result->PassMs[PassId], Result->BaselineMs[PassId]);
+            }
+            fprintf(File, "\n");
+        }
+
+        fprintf(File, "Result, %s\n", Test->Failed ? "FAIL" : "PASS");
+        fclose(File);
+    }
+}
+
+inline void GoldenTestUpdate(golden_test* Test, gpu_timers* Timers)
+{
+    // NOTE: Called at the start of a frame, timers and the readback hold the previous frame which used the same scenario. Frames of a
+    // scenario go warmup, measure and then a single capture frame that we don't time since it also does the copies
+    if (!Test->Running)
+    {
+        return;
+    }
+
+    golden_test_result* Result = Test->Results + Test->CurrScenario;
+    Test->CaptureFrame = false;
+    if (Test->CapturePending)
+    {
+        Test->CapturePending = false;
+        GoldenTestScenarioFinish(Test, Result, BenchmarkScenarios + Test->CurrScenario);
+
+        Test->CurrFrame = 0;
+        Test->CurrScenario += 1;
+        if (Test->CurrScenario == ArrayCount(BenchmarkScenarios))
+        {
+            GoldenTestWriteResults(Test, GOLDEN_TEST_FILE_NAME);
+            Test->Running = false;
+            return;
+        }
+    }
+    else if (Test->CurrFrame > Test->WarmupFrames)
+    {
+        f32 Weight = 1.0f / f32(Test->MeasureFrames);
+        for (u32 PassId = 0; PassId < ArrayCount(GoldenTestPasses); ++PassId)
+        {
+            Result->PassMs[PassId] += Weight * GpuTimerGetMs(Timers, GoldenTestPasses[PassId].TimerId);
+        }
+    }
+
+    Test->CaptureFrame = Test->CurrFrame == Test->WarmupFrames + Test->MeasureFrames;
+    Test->CurrFrame += 1;
+}
+
+inline void GoldenTestCapture(vk_commands Commands, golden_test* Test, tiled_deferred_state* State)
+{
+    // NOTE: Record after TiledDeferredRender, both targets are in shader read only layout at that point
+    if (!Test->CaptureFrame)
+    {
+        return;
+    }
+
+    u32 Width = State->RenderWidth;
+    u32 Height = State->RenderHeight;
+    VkFormat ColorFormat = State->OutColorEntry.Format;
+    u64 ColorSize = u64(GoldenTestColorTexelSize(ColorFormat)) * u64(Width) * u64(Height);
+    u64 Size = ColorSize + sizeof(f32) * u64(Width) * u64(Height);
+    if (Test->Readback.Size < Size)
+    {
+        // NOTE: The last copy got compared at the start of this frame, so the GPU is done with the old buffer
+        ReadbackBufferDestroy(&Test->Readback);
+        Test->Readback = ReadbackBufferCreate(Size);
+    }
+
+    VkBarrierImageAdd(&RenderState->BarrierManager, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                      VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                      VK_IMAGE_ASPECT_COLOR_BIT, State->OutColorImage);
+    VkBarrierImageAdd(&RenderState->BarrierManager, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, State->SsaoImage);
+    VkBarrierManagerFlush(&RenderState->BarrierManager, Commands.Buffer);
+
+    VkBufferImageCopy ImageCopy = {};
+    ImageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    ImageCopy.imageSubresource.layerCount = 1;
+    ImageCopy.imageExtent = { Width, Height, 1 };
+    ImageCopy.bufferOffset = 0;
+    vkCmdCopyImageToBuffer(Commands.Buffer, State->OutColorImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, Test->Readback.Buffer, 1, &ImageCopy);
+    ImageCopy.bufferOffset = ColorSize;
+    vkCmdCopyImageToBuffer(Commands.Buffer, State->SsaoImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, Test->Readback.Buffer, 1, &ImageCopy);
+
+    // NOTE: Copy to swap samples the output next
+    VkBarrierImageAdd(&RenderState->BarrierManager, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                      VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                      VK_IMAGE_ASPECT_COLOR_BIT, State->OutColorImage);
+    VkBarrierImageAdd(&RenderState->BarrierManager, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                      VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                      VK_IMAGE_ASPECT_COLOR_BIT, State->SsaoImage);
+    VkBarrierManagerFlush(&RenderState->BarrierManager, Commands.Buffer);
+
+    VkMemoryBarrier HostBarrier = {};
+    HostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    HostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    HostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(Commands.Buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &HostBarrier, 0, 0, 0, 0);
+
+    Test->CaptureWidth = Width;
+    Test->CaptureHeight = Height;
+    Test->CaptureFormat = ColorFormat;
+    Test->CapturePending = true;
+}
+
+inline void GoldenTestDestroy(golden_test* Test)
+{
+    // IMPORTANT: Only call once the device is idle
+    ReadbackBufferDestroy(&Test->Readback);
+}
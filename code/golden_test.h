@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+
+  NOTE: Golden image regression test. Renders every scenario in BenchmarkScenarios through the tiled deferred renderer from the first
+        keyframe of its camera path, at full resolution and with a fixed SSAO kernel, so every frame of a scenario is the same image.
+        After a few warmup frames we average the GPU timers over the measure frames, then one extra frame copies OutColorEntry and
+        SsaoEntry into a readback buffer. At the start of the next frame that copy gets compared against the golden images in
+        GOLDEN_TEST_DIRECTORY:
+
+    - Color: OutColor holds linear lighting in whatever format the renderer created it with, so the readback gets decoded to linear
+      floats (no sRGB curve) and goes straight to XYZ and CIELAB. A pixel counts as different when the CIE76 delta E is above
+      GOLDEN_TEST_COLOR_TOLERANCE (around 2.3 is a just noticeable difference). Goldens are float RGB PFMs so HDR values survive.
+    - SSAO: a pixel counts as different when its occlusion is more than GOLDEN_TEST_SSAO_TOLERANCE away from the golden one.
+
+        An image fails when more than GOLDEN_TEST_MAX_BAD_PIXEL_RATIO of its pixels differ, or when its size doesn't match. A scenario
+        also fails when one of the passes in GoldenTestPasses got slower than MaxRatio times its baseline plus GOLDEN_TEST_PERF_SLACK_MS
+        (the slack keeps passes that take a few microseconds from failing on noise). Goldens and timing baselines only make sense for
+        one GPU, driver and window size. A scenario without them is MISSING and fails the run, unless GOLDEN_TEST_UPDATE is set, then
+        the current results get written out as its goldens and it is marked NEW. Delete the files and set it to rebaseline.
+
+        Results go to GOLDEN_TEST_FILE_NAME, with a last row that says if the whole run passed. Failing scenarios also write their
+        images next to it so they can be diffed against the goldens.
+
+ */
+
+#define GOLDEN_TEST 0
+#define GOLDEN_TEST_UPDATE 0
+#define GOLDEN_TEST_WARMUP_FRAMES 8
+#define GOLDEN_TEST_MEASURE_FRAMES 64
+#define GOLDEN_TEST_SEED 0x601DE17
+#define GOLDEN_TEST_COLOR_TOLERANCE 2.3f
+#define GOLDEN_TEST_SSAO_TOLERANCE 0.02f
+#define GOLDEN_TEST_MAX_BAD_PIXEL_RATIO 0.001f
+#define GOLDEN_TEST_PERF_SLACK_MS 0.05f
+#define GOLDEN_TEST_ARENA_SIZE MegaBytes(256)
+#define GOLDEN_TEST_DIRECTORY "golden\\"
+#define GOLDEN_TEST_FILE_NAME "golden_test.csv"
+
+struct golden_test_pass
+{
+    gpu_timer_id TimerId;
+    const char* Name;
+    f32 MaxRatio;
+};
+
+global golden_test_pass GoldenTestPasses[] =
+{
+    { GpuTimer_Frame, "Frame", 1.10f },
+    { GpuTimer_GBuffer, "GBuffer", 1.15f },
+    { GpuTimer_LightCull, "LightCull", 1.15f },
+    { GpuTimer_Lighting, "Lighting", 1.15f },
+    { GpuTimer_Transparent, "Transparent", 1.20f },
+};
+
+enum golden_test_status
+{
+    GoldenTestStatus_Pass,
+    GoldenTestStatus_New,
+    GoldenTestStatus_Fail,
+    GoldenTestStatus_Missing,
+};
+
+global const char* GoldenTestStatusNames[] =
+{
+    "PASS",
+    "NEW",
+    "FAIL",
+    "MISSING",
+};
+
+struct golden_test_image_result
+{
+    golden_test_status Status;
+    u32 NumBadPixels;
+    f32 MeanError;
+    f32 MaxError;
+};
+
+struct golden_test_result
+{
+    u32 Width;
+    u32 Height;
+    golden_test_image_result Color;
+    golden_test_image_result Ssao;
+
+    golden_test_status PerfStatus;
+    f32 PassMs[ArrayCount(GoldenTestPasses)];
+    f32 BaselineMs[ArrayCount(GoldenTestPasses)];
+};
+
+struct golden_test
+{
+    b32 Running;
+    b32 Failed;
+    b32 UpdateGoldens;
+    u32 WarmupFrames;
+    u32 MeasureFrames;
+    linear_arena Arena;
+
+    u32 CurrScenario;
+    u32 CurrFrame;
+
+    // NOTE: Set for the frame that records the copy, the readback gets compared once that frame finished
+    b32 CaptureFrame;
+    b32 CapturePending;
+    u32 CaptureWidth;
+    u32 CaptureHeight;
+    VkFormat CaptureFormat;
+    readback_buffer Readback;
+
+    golden_test_result Results[MAX_NUM_SCENARIOS];
+};
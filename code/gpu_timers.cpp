@@ -0,0 +1,63 @@
+
+inline void GpuTimersCreate(gpu_timers* Timers)
+{
+    *Timers = {};
+
+    VkPhysicalDeviceProperties Properties = {};
+    vkGetPhysicalDeviceProperties(RenderState->PhysicalDevice, &Properties);
+    Timers->TimestampPeriodMs = Properties.limits.timestampPeriod / 1000000.0f;
+    
+    VkQueryPoolCreateInfo CreateInfo = {};
+    CreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    CreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    CreateInfo.queryCount = 2*GpuTimer_Count;
+    VkCheckResult(vkCreateQueryPool(RenderState->Device, &CreateInfo, 0, &Timers->QueryPool));
+}
+
+inline void GpuTimersFrameBegin(vk_commands Commands, gpu_timers* Timers)
+{
+    // NOTE: The previous frames fence was waited on, but a query can still read back as not ready (VK_NOT_READY). We ask for the
+    // availability of every query next to its value and skip timers that aren't complete, they keep the last time we read for them
+    // instead of reporting garbage
+    Timers->ValidMask = Timers->WrittenMask;
+    if (Timers->WrittenMask)
+    {
+        u64 Results[2*2*GpuTimer_Count] = {};
+        vkGetQueryPoolResults(RenderState->Device, Timers->QueryPool, 0, 2*GpuTimer_Count, sizeof(Results), Results, 2*sizeof(u64),
+                              VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+        for (u32 TimerId = 0; TimerId < GpuTimer_Count; ++TimerId)
+        {
+            if (Timers->WrittenMask & (1 << TimerId))
+            {
+                u64* Begin = Results + 2*(2*TimerId + 0);
+                u64* End = Results + 2*(2*TimerId + 1);
+                if (Begin[1] != 0 && End[1] != 0)
+                {
+                    u64 Elapsed = End[0] - Begin[0];
+                    Timers->TimesMs[TimerId] = f32(Elapsed) * Timers->TimestampPeriodMs;
+                }
+            }
+        }
+    }
+
+    vkCmdResetQueryPool(Commands.Buffer, Timers->QueryPool, 0, 2*GpuTimer_Count);
+    Timers->WrittenMask = 0;
+}
+
+inline void GpuTimerBegin(vk_commands Commands, gpu_timers* Timers, gpu_timer_id TimerId)
+{
+    vkCmdWriteTimestamp(Commands.Buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, Timers->QueryPool, 2*TimerId + 0);
+}
+
+inline void GpuTimerEnd(vk_commands Commands, gpu_timers* Timers, gpu_timer_id TimerId)
+{
+    vkCmdWriteTimestamp(Commands.Buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, Timers->QueryPool, 2*TimerId + 1);
+    Timers->WrittenMask |= 1 << TimerId;
+}
+
+inline f32 GpuTimerGetMs(gpu_timers* Timers, gpu_timer_id TimerId)
+{
+    f32 Result = (Timers->ValidMask & (1 << TimerId)) ? Timers->TimesMs[TimerId] : 0.0f;
+    return Result;
+}
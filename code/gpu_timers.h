@@ -0,0 +1,31 @@
+#pragma once
+
+/*
+
+  NOTE: GPU timers are pairs of timestamp queries that wrap a pass. We only have one frame in flight, so the results of the previous
+        frame are ready by the time we begin recording the next one and we read them back then.
+  
+ */
+
+enum gpu_timer_id
+{
+    GpuTimer_Frame,
+    GpuTimer_GBuffer,
+    GpuTimer_LightCull,
+    GpuTimer_Lighting,
+    GpuTimer_Transparent,
+    GpuTimer_Upload,
+
+    GpuTimer_Count,
+};
+
+struct gpu_timers
+{
+    VkQueryPool QueryPool;
+    f32 TimestampPeriodMs;
+
+    // NOTE: Timers that were written in the frame we are currently recording/last recorded
+    u32 WrittenMask;
+    u32 ValidMask;
+    f32 TimesMs[GpuTimer_Count];
+};
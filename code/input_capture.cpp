@@ -0,0 +1,158 @@
+
+inline void InputCaptureStop(input_capture* Capture)
+{
+    if (Capture->File)
+    {
+        fclose(Capture->File);
+    }
+    if (Capture->TimingsFile)
+    {
+        fclose(Capture->TimingsFile);
+    }
+
+    *Capture = {};
+}
+
+inline void InputCaptureBegin(input_capture* Capture, input_capture_mode Mode, const char* FileName, random_series* RandomSeries,
+                              u32 RandomSeed)
+{
+    // NOTE: Has to be called before anything draws from the random series
+    *Capture = {};
+    Capture->Mode = Mode;
+    snprintf(Capture->FileName, sizeof(Capture->FileName), "%s", FileName);
+
+    switch (Mode)
+    {
+        case InputCaptureMode_Record:
+        {
+            Capture->File = fopen(FileName, "wb");
+            if (!Capture->File)
+            {
+                Capture->Mode = InputCaptureMode_None;
+                break;
+            }
+
+            Capture->Header.Magic = INPUT_CAPTURE_MAGIC;
+            Capture->Header.Version = INPUT_CAPTURE_VERSION;
+            Capture->Header.RandomSeed = RandomSeed;
+            Capture->Header.CameraSize = sizeof(camera);
+
+            *RandomSeries = RandomSeriesCreate(RandomSeed);
+        } break;
+
+        case InputCaptureMode_Replay:
+        {
+            Capture->File = fopen(FileName, "rb");
+            b32 Valid = (Capture->File &&
+                         fread(&Capture->Header, sizeof(Capture->Header), 1, Capture->File) == 1 &&
+                         Capture->Header.Magic == INPUT_CAPTURE_MAGIC &&
+                         Capture->Header.Version == INPUT_CAPTURE_VERSION &&
+                         Capture->Header.CameraSize == sizeof(camera));
+            if (!Valid)
+            {
+                InputCaptureStop(Capture);
+                break;
+            }
+
+            *RandomSeries = RandomSeriesCreate(Capture->Header.RandomSeed);
+
+            Capture->TimingsFile = fopen(INPUT_CAPTURE_TIMINGS_FILE_NAME, "wb");
+            if (Capture->TimingsFile)
+            {
+                fprintf(Capture->TimingsFile, "Frame, FrameMs, GBufferMs, CullMs, ShadeMs\n");
+            }
+        } break;
+    }
+}
+
+inline void InputCaptureReload(input_capture* Capture)
+{
+    // NOTE: The files were opened by the CRT of the previous code module, which flushed and closed them when it got unloaded. All we can
+    // do is drop the stale handles and reopen the files where we left off
+    Capture->File = 0;
+    Capture->TimingsFile = 0;
+
+    switch (Capture->Mode)
+    {
+        case InputCaptureMode_Record:
+        {
+            Capture->File = fopen(Capture->FileName, "ab");
+        } break;
+
+        case InputCaptureMode_Replay:
+        {
+            Capture->File = fopen(Capture->FileName, "rb");
+            if (Capture->File)
+            {
+                u64 FrameSize = u64(Capture->Header.InputSize) + u64(Capture->Header.CameraSize);
+                fseek(Capture->File, long(sizeof(Capture->Header) + Capture->FrameId * FrameSize), SEEK_SET);
+            }
+            Capture->TimingsFile = fopen(INPUT_CAPTURE_TIMINGS_FILE_NAME, "ab");
+        } break;
+    }
+
+    if (Capture->Mode != InputCaptureMode_None && !Capture->File)
+    {
+        InputCaptureStop(Capture);
+    }
+}
+
+inline b32 InputCaptureFrame(input_capture* Capture, void* Input, u32 InputSize, camera* Camera)
+{
+    // NOTE: Returns true if the camera came from the replay, otherwise the caller has to update it and we record the result after
+    b32 Result = false;
+
+    if (Capture->Mode == InputCaptureMode_Replay && Capture->Header.InputSize != InputSize)
+    {
+        // NOTE: Written by a different build of the platform layer, we can't interpret the input
+        InputCaptureStop(Capture);
+    }
+    
+    if (Capture->Mode == InputCaptureMode_Replay)
+    {
+        camera ReplayCamera = {};
+        if (fread(Input, InputSize, 1, Capture->File) == 1 &&
+            fread(&ReplayCamera, sizeof(ReplayCamera), 1, Capture->File) == 1)
+        {
+            // NOTE: Aspect ratio follows the current window, everything else is what was recorded
+            ReplayCamera.AspectRatio = Camera->AspectRatio;
+            *Camera = ReplayCamera;
+            Capture->FrameId += 1;
+            Result = true;
+        }
+        else
+        {
+            // NOTE: End of the capture, hand control back to the live input
+            InputCaptureStop(Capture);
+        }
+    }
+
+    return Result;
+}
+
+inline void InputCaptureRecord(input_capture* Capture, void* Input, u32 InputSize, camera* Camera)
+{
+    if (Capture->Mode == InputCaptureMode_Record)
+    {
+        // NOTE: Input size is only known once the platform layer hands us input, so the header goes out with the first frame
+        if (Capture->FrameId == 0)
+        {
+            Capture->Header.InputSize = InputSize;
+            fwrite(&Capture->Header, sizeof(Capture->Header), 1, Capture->File);
+        }
+        
+        fwrite(Input, InputSize, 1, Capture->File);
+        fwrite(Camera, sizeof(*Camera), 1, Capture->File);
+        Capture->FrameId += 1;
+    }
+}
+
+inline void InputCaptureTimersLog(input_capture* Capture, gpu_timers* Timers)
+{
+    // NOTE: Called at the start of a frame, timers hold the previous replayed frame
+    if (Capture->Mode == InputCaptureMode_Replay && Capture->TimingsFile && Capture->FrameId > 0)
+    {
+        fprintf(Capture->TimingsFile, "%u, %f, %f, %f, %f\n", Capture->FrameId - 1, GpuTimerGetMs(Timers, GpuTimer_Frame),
+                GpuTimerGetMs(Timers, GpuTimer_GBuffer), GpuTimerGetMs(Timers, GpuTimer_LightCull), GpuTimerGetMs(Timers, GpuTimer_Lighting));
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+/*
+
+  NOTE: Input capture lets two profiling runs see the exact same camera path. Recording writes the seed of the demo random series once,
+        and then the raw input and the camera after CameraUpdate for every frame. Replaying reseeds the random series, feeds the input
+        back and restores the camera directly, so we don't depend on the camera update being stable across builds. Replay also logs the
+        GPU timers per frame so runs can be diffed frame by frame.
+
+        The input is stored as raw bytes of whatever the platform layer hands us, the header keeps its size so we refuse to replay a
+        file written by a different build of the platform layer.
+
+        The files stay open for the whole run and get closed in Destroy. A code reload unloads the CRT that opened them, so the reload
+        reopens them where we left off (InputCaptureReload).
+
+ */
+
+// NOTE: Matches input_capture_mode, 0 is off, 1 records and 2 replays
+#define INPUT_CAPTURE_MODE 0
+#define INPUT_CAPTURE_FILE_NAME "input_capture.bin"
+#define INPUT_CAPTURE_TIMINGS_FILE_NAME "input_replay_timings.csv"
+#define INPUT_CAPTURE_MAX_FILE_NAME 256
+#define INPUT_CAPTURE_MAGIC 0x50414349 // NOTE: "ICAP"
+#define INPUT_CAPTURE_VERSION 1
+
+enum input_capture_mode
+{
+    InputCaptureMode_None,
+    InputCaptureMode_Record,
+    InputCaptureMode_Replay,
+};
+
+struct input_capture_header
+{
+    u32 Magic;
+    u32 Version;
+    u32 RandomSeed;
+    u32 InputSize;
+    u32 CameraSize;
+};
+
+struct input_capture
+{
+    input_capture_mode Mode;
+    char FileName[INPUT_CAPTURE_MAX_FILE_NAME];
+    FILE* File;
+    input_capture_header Header;
+    u32 FrameId;
+
+    // NOTE: Per frame GPU timings of a replay
+    FILE* TimingsFile;
+};
@@ -0,0 +1,208 @@
+
+inline u64 LightGridStatsReadbackSize(u32 NumTilesX, u32 NumTilesY)
+{
+    // NOTE: Layout is both counters, then the opaque grid, then the transparent grid
+    u64 Result = 2*sizeof(u32) + 2*sizeof(u32)*2*NumTilesX*NumTilesY;
+    return Result;
+}
+
+inline void LightGridStatsResize(light_grid_stats* Stats, u32 NumTilesX, u32 NumTilesY)
+{
+    // IMPORTANT: Caller has to make sure the GPU isn't using the readback buffers anymore
+    for (u32 SlotId = 0; SlotId < LIGHT_GRID_STATS_NUM_SLOTS; ++SlotId)
+    {
+        light_grid_stats_slot* Slot = Stats->Slots + SlotId;
+        ReadbackBufferDestroy(&Slot->Readback);
+        if (Stats->Enabled)
+        {
+            Slot->Readback = ReadbackBufferCreate(LightGridStatsReadbackSize(NumTilesX, NumTilesY));
+        }
+        Slot->Pending = false;
+        Slot->NumTilesX = NumTilesX;
+        Slot->NumTilesY = NumTilesY;
+    }
+}
+
+inline void LightGridStatsLogClose(light_grid_stats* Stats)
+{
+    if (Stats->LogFile)
+    {
+        fclose(Stats->LogFile);
+        Stats->LogFile = 0;
+    }
+    Stats->LogFileName[0] = 0;
+}
+
+inline void LightGridStatsReload(light_grid_stats* Stats)
+{
+    // NOTE: The log was opened by the CRT of the previous code module, which flushed and closed it when it got unloaded. Drop the stale
+    // handle and keep appending to the same file
+    Stats->LogFile = 0;
+    if (Stats->LogFileName[0])
+    {
+        Stats->LogFile = fopen(Stats->LogFileName, "ab");
+    }
+}
+
+inline void LightGridStatsEnable(light_grid_stats* Stats, b32 Enabled, const char* LogFileName)
+{
+    Stats->Enabled = Enabled;
+    LightGridStatsResize(Stats, Stats->Slots[0].NumTilesX, Stats->Slots[0].NumTilesY);
+
+    LightGridStatsLogClose(Stats);
+    if (Enabled && LogFileName)
+    {
+        snprintf(Stats->LogFileName, sizeof(Stats->LogFileName), "%s", LogFileName);
+        Stats->LogFile = fopen(LogFileName, "wb");
+        if (Stats->LogFile)
+        {
+            fprintf(Stats->LogFile, "Frame, Grid, LightTestMode, MaxLights, MeanLights, PixelMeanLights, OverflowTiles, IndexCounter, DroppedLights");
+            for (u32 BinId = 0; BinId < LIGHT_GRID_STATS_NUM_BINS; ++BinId)
+            {
+                fprintf(Stats->LogFile, ", Bin%u", BinId);
+            }
+            fprintf(Stats->LogFile, "\n");
+        }
+    }
+}
+
+inline u32 LightGridStatsBinGet(u32 NumLights)
+{
+    u32 Result = 0;
+    while (NumLights != 0 && Result < LIGHT_GRID_STATS_NUM_BINS - 1)
+    {
+        NumLights >>= 1;
+        Result += 1;
+    }
+    return Result;
+}
+
+inline light_grid_histogram LightGridHistogramBuild(u32* Grid, light_grid_stats_slot* Slot, u32 IndexCounter, u32 IndexListCapacity)
+{
+    light_grid_histogram Result = {};
+    Result.IndexCounter = IndexCounter;
+    Result.NumDroppedLights = IndexCounter > IndexListCapacity ? IndexCounter - IndexListCapacity : 0;
+
+    u32 NumTiles = Slot->NumTilesX * Slot->NumTilesY;
+    u64 TotalLights = 0;
+    u64 TotalPixelLights = 0;
+    for (u32 TileY = 0; TileY < Slot->NumTilesY; ++TileY)
+    {
+        for (u32 TileX = 0; TileX < Slot->NumTilesX; ++TileX)
+        {
+            // NOTE: Each texel is the offset + count of the tiles light list
+            u32 TileId = TileY * Slot->NumTilesX + TileX;
+            u32 NumLights = Grid[2*TileId + 1];
+            Result.Bins[LightGridStatsBinGet(NumLights)] += 1;
+            Result.MaxLights = Max(Result.MaxLights, NumLights);
+            Result.NumOverflowTiles += NumLights > MAX_LIGHTS_PER_TILE ? 1 : 0;
+            TotalLights += NumLights;
+
+            // NOTE: Edge tiles only partly cover the screen, and with dynamic resolution some tiles cover none of it
+            u32 MinX = TileX * Slot->TileSize;
+            u32 MinY = TileY * Slot->TileSize;
+            u32 NumPixelsX = MinX < Slot->ScreenWidth ? Min(Slot->TileSize, Slot->ScreenWidth - MinX) : 0;
+            u32 NumPixelsY = MinY < Slot->ScreenHeight ? Min(Slot->TileSize, Slot->ScreenHeight - MinY) : 0;
+            TotalPixelLights += u64(NumLights) * u64(NumPixelsX * NumPixelsY);
+        }
+    }
+
+    u64 NumPixels = u64(Slot->ScreenWidth) * u64(Slot->ScreenHeight);
+    Result.MeanLights = NumTiles > 0 ? f32(f64(TotalLights) / f64(NumTiles)) : 0.0f;
+    Result.PixelMeanLights = NumPixels > 0 ? f32(f64(TotalPixelLights) / f64(NumPixels)) : 0.0f;
+    return Result;
+}
+
+inline void LightGridStatsLog(FILE* File, u32 FrameId, const char* GridName, u32 LightTestMode, light_grid_histogram* Histogram)
+{
+    fprintf(File, "%u, %s, %u, %u, %f, %f, %u, %u, %u", FrameId, GridName, LightTestMode, Histogram->MaxLights, Histogram->MeanLights,
+            Histogram->PixelMeanLights, Histogram->NumOverflowTiles, Histogram->IndexCounter, Histogram->NumDroppedLights);
+    for (u32 BinId = 0; BinId < LIGHT_GRID_STATS_NUM_BINS; ++BinId)
+    {
+        fprintf(File, ", %u", Histogram->Bins[BinId]);
+    }
+    fprintf(File, "\n");
+}
+
+inline void LightGridStatsProcess(light_grid_stats* Stats)
+{
+    // NOTE: Called at the start of a frame, at that point the slot of the previous frame has finished on the GPU
+    if (!Stats->Enabled)
+    {
+        return;
+    }
+
+    u32 PrevFrameId = Stats->FrameId - 1;
+    light_grid_stats_slot* Slot = Stats->Slots + (PrevFrameId % LIGHT_GRID_STATS_NUM_SLOTS);
+    if (Slot->Pending)
+    {
+        u32 NumTiles = Slot->NumTilesX * Slot->NumTilesY;
+        u32 IndexListCapacity = Slot->IndexListCapacity;
+        u32* Counters = (u32*)Slot->Readback.Ptr;
+        u32* GridO = Counters + 2;
+        u32* GridT = GridO + 2*NumTiles;
+        
+        Stats->StatsFrameId = PrevFrameId;
+        Stats->StatsLightTestMode = Slot->LightTestMode;
+        Stats->Opaque = LightGridHistogramBuild(GridO, Slot, Counters[0], IndexListCapacity);
+        Stats->Transparent = LightGridHistogramBuild(GridT, Slot, Counters[1], IndexListCapacity);
+        Slot->Pending = false;
+
+        if (Stats->LogFile)
+        {
+            LightGridStatsLog(Stats->LogFile, PrevFrameId, "Opaque", Slot->LightTestMode, &Stats->Opaque);
+            LightGridStatsLog(Stats->LogFile, PrevFrameId, "Transparent", Slot->LightTestMode, &Stats->Transparent);
+        }
+    }
+}
+
+inline void LightGridStatsCopy(vk_commands Commands, light_grid_stats* Stats, VkBuffer CounterO, VkBuffer CounterT, VkImage GridO,
+                               VkImage GridT, u32 TileSize, u32 ScreenWidth, u32 ScreenHeight, u32 LightTestMode, u32 IndexListCapacity)
+{
+    // IMPORTANT: Expects culling writes to be visible to transfer reads already
+    if (!Stats->Enabled)
+    {
+        return;
+    }
+
+    light_grid_stats_slot* Slot = Stats->Slots + (Stats->FrameId % LIGHT_GRID_STATS_NUM_SLOTS);
+    u32 NumTiles = Slot->NumTilesX * Slot->NumTilesY;
+    Slot->TileSize = TileSize;
+    Slot->ScreenWidth = ScreenWidth;
+    Slot->ScreenHeight = ScreenHeight;
+    Slot->LightTestMode = LightTestMode;
+    Slot->IndexListCapacity = IndexListCapacity;
+
+    VkBufferCopy CounterCopy = {};
+    CounterCopy.size = sizeof(u32);
+    CounterCopy.dstOffset = 0;
+    vkCmdCopyBuffer(Commands.Buffer, CounterO, Slot->Readback.Buffer, 1, &CounterCopy);
+    CounterCopy.dstOffset = sizeof(u32);
+    vkCmdCopyBuffer(Commands.Buffer, CounterT, Slot->Readback.Buffer, 1, &CounterCopy);
+
+    VkBufferImageCopy GridCopy = {};
+    GridCopy.bufferOffset = 2*sizeof(u32);
+    GridCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    GridCopy.imageSubresource.layerCount = 1;
+    GridCopy.imageExtent = { Slot->NumTilesX, Slot->NumTilesY, 1 };
+    vkCmdCopyImageToBuffer(Commands.Buffer, GridO, VK_IMAGE_LAYOUT_GENERAL, Slot->Readback.Buffer, 1, &GridCopy);
+    GridCopy.bufferOffset = 2*sizeof(u32) + 2*sizeof(u32)*NumTiles;
+    vkCmdCopyImageToBuffer(Commands.Buffer, GridT, VK_IMAGE_LAYOUT_GENERAL, Slot->Readback.Buffer, 1, &GridCopy);
+
+    VkMemoryBarrier HostBarrier = {};
+    HostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    HostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    HostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(Commands.Buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &HostBarrier, 0, 0, 0, 0);
+    
+    Slot->Pending = true;
+}
+
+inline void LightGridStatsFrameEnd(light_grid_stats* Stats)
+{
+    Stats->FrameId += 1;
+
+    // NOTE: Frames that skip LightGridStatsProcess (fused lighting) leave the copy before them pending. Drop it before its slot gets
+    // reused, otherwise it would get reported as a later frame
+    Stats->Slots[Stats->FrameId % LIGHT_GRID_STATS_NUM_SLOTS].Pending = false;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+/*
+
+  NOTE: Optional instrumentation for the light grid. After culling we copy both light grids and the index counters into a host visible
+        buffer, and we process them once that frame has finished on the GPU (so we never stall). Bin 0 of the histogram counts empty
+        tiles, bin i counts tiles with [2^(i-1), 2^i) lights and the last bin holds everything above.
+
+        Overflow tiles are tiles that had more lights than fit in shared memory and had to take the slow replay path in culling. Dropped
+        lights are lights that didn't fit in the global index list at all. The tiled light data reads the counters back on its own (stats
+        or not) and grows its index lists when they overflow, so these should only show up for a frame.
+
+        MeanLights is per tile. PixelMeanLights weights every tile by the pixels it covers on screen, which is how many lights the
+        index list lighting pass loops over per pixel, and the number the light vs. tile tests in tiled_deferred.h try to bring down.
+  
+ */
+
+#define LIGHT_GRID_STATS 0
+#define LIGHT_GRID_STATS_NUM_BINS 13
+#define LIGHT_GRID_STATS_NUM_SLOTS 2
+#define LIGHT_GRID_STATS_MAX_FILE_NAME 256
+
+struct light_grid_histogram
+{
+    u32 Bins[LIGHT_GRID_STATS_NUM_BINS];
+    u32 MaxLights;
+    f32 MeanLights;
+    f32 PixelMeanLights;
+    u32 NumOverflowTiles;
+    u32 IndexCounter;
+    u32 NumDroppedLights;
+};
+
+struct light_grid_stats_slot
+{
+    readback_buffer Readback;
+    b32 Pending;
+    u32 NumTilesX;
+    u32 NumTilesY;
+
+    // NOTE: What the copied frame was culled with
+    u32 TileSize;
+    u32 ScreenWidth;
+    u32 ScreenHeight;
+    u32 LightTestMode;
+    u32 IndexListCapacity;
+};
+
+struct light_grid_stats
+{
+    b32 Enabled;
+    u32 FrameId;
+    light_grid_stats_slot Slots[LIGHT_GRID_STATS_NUM_SLOTS];
+
+    // NOTE: Stats of the last frame that finished on the GPU
+    u32 StatsFrameId;
+    u32 StatsLightTestMode;
+    light_grid_histogram Opaque;
+    light_grid_histogram Transparent;
+
+    // NOTE: Kept so a code reload can reopen the log, see LightGridStatsReload
+    char LogFileName[LIGHT_GRID_STATS_MAX_FILE_NAME];
+    FILE* LogFile;
+};
@@ -0,0 +1,290 @@
+
+inline void MemoryStatsNameCopy(char* Dest, const char* Name)
+{
+    // NOTE: Longer names get truncated
+    u32 CharId = 0;
+    for (; CharId < MEMORY_STATS_MAX_NAME_LENGTH - 1 && Name[CharId]; ++CharId)
+    {
+        Dest[CharId] = Name[CharId];
+    }
+    Dest[CharId] = 0;
+}
+
+inline b32 MemoryStatsNameEquals(char* Stored, const char* Name)
+{
+    // NOTE: Compares with the same truncation as MemoryStatsNameCopy
+    u32 CharId = 0;
+    while (CharId < MEMORY_STATS_MAX_NAME_LENGTH - 1 && Stored[CharId] && Stored[CharId] == Name[CharId])
+    {
+        CharId += 1;
+    }
+
+    b32 Result = CharId == MEMORY_STATS_MAX_NAME_LENGTH - 1 || Stored[CharId] == Name[CharId];
+    return Result;
+}
+
+inline u32 MemoryStatsArenaAdd(memory_stats* Stats, const char* Name, b32 Gpu, u64* Used, u64 Size)
+{
+    Assert(Stats->NumArenas < MEMORY_STATS_MAX_ARENAS);
+
+    u32 Result = Stats->NumArenas++;
+    memory_stats_arena* Arena = Stats->Arenas + Result;
+    *Arena = {};
+    MemoryStatsNameCopy(Arena->Name, Name);
+    Arena->Gpu = Gpu;
+    Arena->Used = Used;
+    Arena->Size = Size;
+    Arena->PeakUsed = Used ? *Used : 0;
+
+    return Result;
+}
+
+inline u32 MemoryStatsArenaFind(memory_stats* Stats, u64* Used)
+{
+    u32 Result = 0;
+    for (u32 ArenaId = 0; ArenaId < Stats->NumArenas; ++ArenaId)
+    {
+        if (Stats->Arenas[ArenaId].Used == Used)
+        {
+            Result = ArenaId;
+            break;
+        }
+    }
+
+    // NOTE: Every arena we allocate from has to be registered first
+    Assert(Stats->NumArenas > 0 && Stats->Arenas[Result].Used == Used);
+
+    return Result;
+}
+
+inline memory_stats_tag* MemoryStatsTagGet(memory_stats* Stats, u32 ArenaId, const char* Name)
+{
+    memory_stats_tag* Result = 0;
+    for (u32 TagId = 0; TagId < Stats->NumTags && !Result; ++TagId)
+    {
+        memory_stats_tag* Tag = Stats->Tags + TagId;
+        if (Tag->ArenaId != ArenaId)
+        {
+            continue;
+        }
+
+        if (MemoryStatsNameEquals(Tag->Name, Name))
+        {
+            Result = Tag;
+        }
+    }
+
+    if (!Result)
+    {
+        Assert(Stats->NumTags < MEMORY_STATS_MAX_TAGS);
+        Result = Stats->Tags + Stats->NumTags++;
+        *Result = {};
+        MemoryStatsNameCopy(Result->Name, Name);
+        Result->ArenaId = ArenaId;
+    }
+
+    return Result;
+}
+
+inline u32 MemoryStatsTagIdGet(memory_stats* Stats, u32 ArenaId, const char* Name)
+{
+    u32 Result = u32(MemoryStatsTagGet(Stats, ArenaId, Name) - Stats->Tags);
+    return Result;
+}
+
+inline u64 MemoryStatsArenaCurrent(memory_stats* Stats, u32 ArenaId)
+{
+    memory_stats_arena* Arena = Stats->Arenas + ArenaId;
+
+    u64 Result = 0;
+    if (Arena->Used)
+    {
+        Result = *Arena->Used;
+    }
+    else
+    {
+        for (u32 TagId = 0; TagId < Stats->NumTags; ++TagId)
+        {
+            if (Stats->Tags[TagId].ArenaId == ArenaId)
+            {
+                Result += Stats->Tags[TagId].CurrentBytes;
+            }
+        }
+    }
+
+    return Result;
+}
+
+inline void MemoryStatsRecord(memory_stats* Stats, u32 ArenaId, const char* TagName, u64 Bytes)
+{
+    memory_stats_tag* Tag = MemoryStatsTagGet(Stats, ArenaId, TagName);
+    Tag->NumAllocations += 1;
+    Tag->CurrentBytes += Bytes;
+    Tag->PeakBytes = Max(Tag->PeakBytes, Tag->CurrentBytes);
+
+    memory_stats_arena* Arena = Stats->Arenas + ArenaId;
+    Arena->PeakUsed = Max(Arena->PeakUsed, MemoryStatsArenaCurrent(Stats, ArenaId));
+}
+
+inline void MemoryStatsRelease(memory_stats* Stats, u32 ArenaId, const char* TagName, u64 Bytes)
+{
+    memory_stats_tag* Tag = MemoryStatsTagGet(Stats, ArenaId, TagName);
+    Assert(Tag->CurrentBytes >= Bytes && Tag->NumAllocations > 0);
+    Tag->NumAllocations -= 1;
+    Tag->CurrentBytes -= Bytes;
+}
+
+inline void MemoryStatsArenaClear(memory_stats* Stats, u64* Used)
+{
+    // NOTE: Call together with clearing the arena, peaks are kept
+    u32 ArenaId = MemoryStatsArenaFind(Stats, Used);
+    for (u32 TagId = 0; TagId < Stats->NumTags; ++TagId)
+    {
+        memory_stats_tag* Tag = Stats->Tags + TagId;
+        if (Tag->ArenaId == ArenaId)
+        {
+            Tag->NumAllocations = 0;
+            Tag->CurrentBytes = 0;
+        }
+    }
+}
+
+inline void MemoryStatsUpdate(memory_stats* Stats)
+{
+    // NOTE: Sampled once per frame, so temp allocations that get freed within a frame only count if they are still around here
+    for (u32 ArenaId = 0; ArenaId < Stats->NumArenas; ++ArenaId)
+    {
+        memory_stats_arena* Arena = Stats->Arenas + ArenaId;
+        Arena->PeakUsed = Max(Arena->PeakUsed, MemoryStatsArenaCurrent(Stats, ArenaId));
+    }
+}
+
+inline void MemoryStatsBudgetInit(memory_stats* Stats)
+{
+    u32 NumExtensions = 0;
+    vkEnumerateDeviceExtensionProperties(RenderState->PhysicalDevice, 0, &NumExtensions, 0);
+    VkExtensionProperties* Extensions = PushArray(&DemoState->TempArena, VkExtensionProperties, NumExtensions);
+    vkEnumerateDeviceExtensionProperties(RenderState->PhysicalDevice, 0, &NumExtensions, Extensions);
+
+    const char* BudgetName = VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+    for (u32 ExtensionId = 0; ExtensionId < NumExtensions && !Stats->BudgetSupported; ++ExtensionId)
+    {
+        const char* A = Extensions[ExtensionId].extensionName;
+        const char* B = BudgetName;
+        while (*A && *A == *B)
+        {
+            A++;
+            B++;
+        }
+        Stats->BudgetSupported = *A == *B;
+    }
+}
+
+inline void MemoryStatsDump(memory_stats* Stats, const char* FileName)
+{
+    FILE* File = fopen(FileName, "wb");
+    if (!File)
+    {
+        return;
+    }
+
+    f32 MegaByte = 1024.0f*1024.0f;
+
+    fprintf(File, "Arena, Gpu, SizeMb, UsedMb, PeakMb, UntaggedMb\n");
+    for (u32 ArenaId = 0; ArenaId < Stats->NumArenas; ++ArenaId)
+    {
+        memory_stats_arena* Arena = Stats->Arenas + ArenaId;
+        u64 Current = MemoryStatsArenaCurrent(Stats, ArenaId);
+        u64 Tagged = 0;
+        for (u32 TagId = 0; TagId < Stats->NumTags; ++TagId)
+        {
+            if (Stats->Tags[TagId].ArenaId == ArenaId)
+            {
+                Tagged += Stats->Tags[TagId].CurrentBytes;
+            }
+        }
+        u64 Untagged = Current > Tagged ? Current - Tagged : 0;
+
+        fprintf(File, "%s, %u, %f, %f, %f, %f\n", Arena->Name, Arena->Gpu, f32(Arena->Size) / MegaByte, f32(Current) / MegaByte,
+                f32(Arena->PeakUsed) / MegaByte, f32(Untagged) / MegaByte);
+    }
+
+    fprintf(File, "\nTag, Arena, Allocations, CurrentMb, PeakMb\n");
+    for (u32 TagId = 0; TagId < Stats->NumTags; ++TagId)
+    {
+        memory_stats_tag* Tag = Stats->Tags + TagId;
+        fprintf(File, "%s, %s, %u, %f, %f\n", Tag->Name, Stats->Arenas[Tag->ArenaId].Name, Tag->NumAllocations, f32(Tag->CurrentBytes) / MegaByte,
+                f32(Tag->PeakBytes) / MegaByte);
+    }
+
+    fprintf(File, "\nHeap, DeviceLocal, SizeMb, BudgetMb, UsageMb\n");
+    {
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT Budget = {};
+        Budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+        VkPhysicalDeviceMemoryProperties2 Properties = {};
+        Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        Properties.pNext = Stats->BudgetSupported ? &Budget : 0;
+
+        // NOTE: Core in 1.1 but the framework doesn't load it, so grab it here
+        PFN_vkGetPhysicalDeviceMemoryProperties2 GetMemoryProperties2 =
+            (PFN_vkGetPhysicalDeviceMemoryProperties2)vkGetInstanceProcAddr(RenderState->Instance, "vkGetPhysicalDeviceMemoryProperties2");
+        if (GetMemoryProperties2)
+        {
+            GetMemoryProperties2(RenderState->PhysicalDevice, &Properties);
+        }
+        else
+        {
+            vkGetPhysicalDeviceMemoryProperties(RenderState->PhysicalDevice, &Properties.memoryProperties);
+        }
+
+        // NOTE: Without the extension we can only report the heap sizes
+        b32 HasBudget = Stats->BudgetSupported && GetMemoryProperties2;
+        for (u32 HeapId = 0; HeapId < Properties.memoryProperties.memoryHeapCount; ++HeapId)
+        {
+            VkMemoryHeap* Heap = Properties.memoryProperties.memoryHeaps + HeapId;
+            fprintf(File, "%u, %u, %f, %f, %f\n", HeapId, (Heap->flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? 1 : 0, f32(Heap->size) / MegaByte,
+                    HasBudget ? f32(Budget.heapBudget[HeapId]) / MegaByte : 0.0f, HasBudget ? f32(Budget.heapUsage[HeapId]) / MegaByte : 0.0f);
+        }
+    }
+
+    fclose(File);
+}
+
+//
+// NOTE: Tagged Allocation
+//
+
+inline VkBuffer TaggedBufferCreate(const char* Tag, vk_linear_arena* Arena, VkBufferUsageFlags Usage, u64 Size)
+{
+    u64 StartUsed = Arena->Used;
+    VkBuffer Result = VkBufferCreate(RenderState->Device, Arena, Usage, Size);
+    MemoryStatsRecord(&DemoState->MemoryStats, MemoryStatsArenaFind(&DemoState->MemoryStats, &Arena->Used), Tag, Arena->Used - StartUsed);
+
+    return Result;
+}
+
+inline vk_image TaggedImageCreate(const char* Tag, vk_linear_arena* Arena, u32 Width, u32 Height, VkFormat Format, VkImageUsageFlags Usage,
+                                  VkImageAspectFlags Aspect)
+{
+    u64 StartUsed = Arena->Used;
+    vk_image Result = VkImageCreate(RenderState->Device, Arena, Width, Height, Format, Usage, Aspect);
+    MemoryStatsRecord(&DemoState->MemoryStats, MemoryStatsArenaFind(&DemoState->MemoryStats, &Arena->Used), Tag, Arena->Used - StartUsed);
+
+    return Result;
+}
+
+inline void TaggedRenderTargetEntryReCreate(const char* Tag, vk_linear_arena* Arena, u32 Width, u32 Height, VkFormat Format,
+                                            VkImageUsageFlags Usage, VkImageAspectFlags Aspect, VkImage* Image, render_target_entry* Entry)
+{
+    // IMPORTANT: The old handles get retired instead of destroyed, but the new target usually aliases the old ones memory since callers
+    // clear the arena first. Only call once the GPU is done with the old target (we have a single frame in flight)
+    DeletionQueueImageViewPush(&DemoState->DeletionQueue, Entry->View);
+    DeletionQueueImagePush(&DemoState->DeletionQueue, *Image);
+    Entry->View = VK_NULL_HANDLE;
+    *Image = VK_NULL_HANDLE;
+    
+    u64 StartUsed = Arena->Used;
+    RenderTargetEntryReCreate(Arena, Width, Height, Format, Usage, Aspect, Image, Entry);
+    MemoryStatsRecord(&DemoState->MemoryStats, MemoryStatsArenaFind(&DemoState->MemoryStats, &Arena->Used), Tag, Arena->Used - StartUsed);
+}
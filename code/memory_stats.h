@@ -0,0 +1,54 @@
+#pragma once
+
+/*
+
+  NOTE: Memory stats track how much of every arena we actually use, so we can size them instead of reserving a gigabyte each. Arenas get
+        registered once with their capacity and we sample their used size every frame to get the peak. GPU allocations go through the
+        tagged create functions, which attribute the bytes an allocation took out of its arena (alignment included) to a subsystem tag.
+        Whatever an arena has used that no tag accounts for (framework allocations like the asset meshes) shows up as untagged.
+
+        Arenas without a used size (the staging buffer, dedicated allocations) are tracked through their tags only.
+
+        Arena and tag names get copied into the stats. The stats live in DemoState and survive code reloads, while the string literals
+        callers pass in live in the DLL that gets unloaded.
+
+        If the device supports VK_EXT_memory_budget, the dump also lists the budget and usage the driver reports per memory heap, which
+        includes everything we don't allocate ourselves like the swap chain.
+
+ */
+
+#define MEMORY_STATS_MAX_ARENAS 16
+#define MEMORY_STATS_MAX_TAGS 64
+#define MEMORY_STATS_MAX_NAME_LENGTH 32
+#define MEMORY_STATS_FILE_NAME "memory_stats.csv"
+
+struct memory_stats_arena
+{
+    char Name[MEMORY_STATS_MAX_NAME_LENGTH];
+    b32 Gpu;
+    u64* Used; // NOTE: Can be null, then the arena is only tracked through its tags
+    u64 Size;
+    u64 PeakUsed;
+};
+
+struct memory_stats_tag
+{
+    char Name[MEMORY_STATS_MAX_NAME_LENGTH];
+    u32 ArenaId;
+    u32 NumAllocations;
+    u64 CurrentBytes;
+    u64 PeakBytes;
+};
+
+struct memory_stats
+{
+    u32 NumArenas;
+    memory_stats_arena Arenas[MEMORY_STATS_MAX_ARENAS];
+
+    u32 NumTags;
+    memory_stats_tag Tags[MEMORY_STATS_MAX_TAGS];
+
+    // NOTE: Arena for allocations that get their own VkDeviceMemory
+    u32 DedicatedArenaId;
+    b32 BudgetSupported;
+};
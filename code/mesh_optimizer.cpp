@@ -0,0 +1,572 @@
+
+//
+// NOTE: Measurement
+//
+
+inline f32 MeshAcmr(linear_arena* Arena, u32* Indices, u32 NumIndices, u32 NumVertices, u32 CacheSize)
+{
+    // NOTE: FIFO cache, a vertex is still cached if fewer than CacheSize misses happened since it was inserted
+    u32* InsertTimes = PushArray(Arena, u32, NumVertices);
+    for (u32 VertexId = 0; VertexId < NumVertices; ++VertexId)
+    {
+        InsertTimes[VertexId] = 0;
+    }
+
+    u32 Time = CacheSize + 1;
+    u32 NumMisses = 0;
+    for (u32 IndexId = 0; IndexId < NumIndices; ++IndexId)
+    {
+        u32 VertexId = Indices[IndexId];
+        if (Time - InsertTimes[VertexId] > CacheSize)
+        {
+            InsertTimes[VertexId] = Time++;
+            NumMisses += 1;
+        }
+    }
+
+    f32 Result = NumIndices > 0 ? f32(NumMisses) / f32(NumIndices / 3) : 0.0f;
+    return Result;
+}
+
+//
+// NOTE: Vertex Cache Optimization
+//
+
+inline f32 MeshForsythVertexScore(i32 CachePos, u32 NumActiveTriangles)
+{
+    // NOTE: Vertices without triangles left never get picked again
+    if (NumActiveTriangles == 0)
+    {
+        return -1.0f;
+    }
+
+    f32 Result = 0.0f;
+    if (CachePos >= 0)
+    {
+        if (CachePos < 3)
+        {
+            // NOTE: Used by the last triangle, fixed score so we don't just strip along the same edge
+            Result = 0.75f;
+        }
+        else
+        {
+            f32 Scale = 1.0f / f32(MESH_OPTIMIZER_CACHE_SIZE - 3);
+            Result = powf(1.0f - f32(CachePos - 3) * Scale, 1.5f);
+        }
+    }
+
+    // NOTE: Boost vertices with few triangles left so we finish them off instead of leaving lone triangles behind
+    Result += 2.0f * powf(f32(NumActiveTriangles), -0.5f);
+    return Result;
+}
+
+inline void MeshOptimizeVertexCache(linear_arena* Arena, u32* Indices, u32 NumIndices, u32 NumVertices)
+{
+    u32 NumTriangles = NumIndices / 3;
+
+    // NOTE: Per vertex list of the triangles that use it, the first NumActiveTriangles entries are the ones not emitted yet
+    u32* NumActiveTriangles = PushArray(Arena, u32, NumVertices);
+    u32* TriangleOffsets = PushArray(Arena, u32, NumVertices);
+    u32* VertexTriangles = PushArray(Arena, u32, NumIndices);
+    i32* CachePos = PushArray(Arena, i32, NumVertices);
+    f32* VertexScores = PushArray(Arena, f32, NumVertices);
+    f32* TriangleScores = PushArray(Arena, f32, NumTriangles);
+    b32* TriangleEmitted = PushArray(Arena, b32, NumTriangles);
+    u32* NewIndices = PushArray(Arena, u32, NumIndices);
+
+    for (u32 VertexId = 0; VertexId < NumVertices; ++VertexId)
+    {
+        NumActiveTriangles[VertexId] = 0;
+        CachePos[VertexId] = -1;
+    }
+    for (u32 IndexId = 0; IndexId < NumIndices; ++IndexId)
+    {
+        NumActiveTriangles[Indices[IndexId]] += 1;
+    }
+
+    u32 CurrOffset = 0;
+    for (u32 VertexId = 0; VertexId < NumVertices; ++VertexId)
+    {
+        TriangleOffsets[VertexId] = CurrOffset;
+        CurrOffset += NumActiveTriangles[VertexId];
+        NumActiveTriangles[VertexId] = 0;
+    }
+    for (u32 TriangleId = 0; TriangleId < NumTriangles; ++TriangleId)
+    {
+        for (u32 CornerId = 0; CornerId < 3; ++CornerId)
+        {
+            u32 VertexId = Indices[3*TriangleId + CornerId];
+            VertexTriangles[TriangleOffsets[VertexId] + NumActiveTriangles[VertexId]++] = TriangleId;
+        }
+    }
+
+    for (u32 VertexId = 0; VertexId < NumVertices; ++VertexId)
+    {
+        VertexScores[VertexId] = MeshForsythVertexScore(CachePos[VertexId], NumActiveTriangles[VertexId]);
+    }
+    for (u32 TriangleId = 0; TriangleId < NumTriangles; ++TriangleId)
+    {
+        u32* Triangle = Indices + 3*TriangleId;
+        TriangleScores[TriangleId] = VertexScores[Triangle[0]] + VertexScores[Triangle[1]] + VertexScores[Triangle[2]];
+        TriangleEmitted[TriangleId] = false;
+    }
+
+    u32 Cache[MESH_OPTIMIZER_CACHE_SIZE + 3];
+    u32 NumCached = 0;
+    i32 BestTriangle = -1;
+    u32 ScanStart = 0;
+    for (u32 EmittedId = 0; EmittedId < NumTriangles; ++EmittedId)
+    {
+        if (BestTriangle < 0)
+        {
+            // NOTE: Nothing in the cache has triangles left, find the best remaining triangle. Emitted triangles only ever pile up at
+            // the front in bulk, so we don't restart the scan from 0
+            f32 BestScore = -1.0f;
+            for (u32 TriangleId = ScanStart; TriangleId < NumTriangles; ++TriangleId)
+            {
+                if (!TriangleEmitted[TriangleId] && TriangleScores[TriangleId] > BestScore)
+                {
+                    BestScore = TriangleScores[TriangleId];
+                    BestTriangle = i32(TriangleId);
+                }
+            }
+            while (ScanStart < NumTriangles && TriangleEmitted[ScanStart])
+            {
+                ScanStart += 1;
+            }
+        }
+
+        // NOTE: Emit the triangle and take it out of its vertices lists
+        u32* Triangle = Indices + 3*BestTriangle;
+        TriangleEmitted[BestTriangle] = true;
+        for (u32 CornerId = 0; CornerId < 3; ++CornerId)
+        {
+            u32 VertexId = Triangle[CornerId];
+            NewIndices[3*EmittedId + CornerId] = VertexId;
+
+            u32* VertexTriangleList = VertexTriangles + TriangleOffsets[VertexId];
+            u32 LastId = NumActiveTriangles[VertexId] - 1;
+            for (u32 ListId = 0; ListId <= LastId; ++ListId)
+            {
+                if (VertexTriangleList[ListId] == u32(BestTriangle))
+                {
+                    VertexTriangleList[ListId] = VertexTriangleList[LastId];
+                    VertexTriangleList[LastId] = u32(BestTriangle);
+                    break;
+                }
+            }
+            NumActiveTriangles[VertexId] -= 1;
+        }
+
+        // NOTE: The triangles vertices move to the front of the cache, everything else shifts back. We keep the evicted entries around
+        // for one step so their scores get updated too
+        u32 NewCache[MESH_OPTIMIZER_CACHE_SIZE + 3];
+        u32 NumNewCached = 0;
+        for (u32 CornerId = 0; CornerId < 3; ++CornerId)
+        {
+            NewCache[NumNewCached++] = Triangle[CornerId];
+        }
+        for (u32 CacheId = 0; CacheId < NumCached; ++CacheId)
+        {
+            u32 VertexId = Cache[CacheId];
+            if (VertexId != Triangle[0] && VertexId != Triangle[1] && VertexId != Triangle[2])
+            {
+                NewCache[NumNewCached++] = VertexId;
+            }
+        }
+
+        for (u32 CacheId = 0; CacheId < NumNewCached; ++CacheId)
+        {
+            u32 VertexId = NewCache[CacheId];
+            CachePos[VertexId] = CacheId < MESH_OPTIMIZER_CACHE_SIZE ? i32(CacheId) : -1;
+            VertexScores[VertexId] = MeshForsythVertexScore(CachePos[VertexId], NumActiveTriangles[VertexId]);
+        }
+
+        // NOTE: Only triangles of vertices whose score changed can change, and the best next triangle is very likely one of them
+        BestTriangle = -1;
+        f32 BestScore = -1.0f;
+        for (u32 CacheId = 0; CacheId < NumNewCached; ++CacheId)
+        {
+            u32 VertexId = NewCache[CacheId];
+            u32* VertexTriangleList = VertexTriangles + TriangleOffsets[VertexId];
+            for (u32 ListId = 0; ListId < NumActiveTriangles[VertexId]; ++ListId)
+            {
+                u32 TriangleId = VertexTriangleList[ListId];
+                u32* CurrTriangle = Indices + 3*TriangleId;
+                TriangleScores[TriangleId] = VertexScores[CurrTriangle[0]] + VertexScores[CurrTriangle[1]] + VertexScores[CurrTriangle[2]];
+                if (TriangleScores[TriangleId] > BestScore)
+                {
+                    BestScore = TriangleScores[TriangleId];
+                    BestTriangle = i32(TriangleId);
+                }
+            }
+        }
+
+        NumCached = Min(NumNewCached, u32(MESH_OPTIMIZER_CACHE_SIZE));
+        for (u32 CacheId = 0; CacheId < NumCached; ++CacheId)
+        {
+            Cache[CacheId] = NewCache[CacheId];
+        }
+    }
+
+    Copy(NewIndices, Indices, sizeof(u32)*NumIndices);
+}
+
+//
+// NOTE: Vertex Fetch Optimization
+//
+
+inline void MeshOptimizeVertexFetch(linear_arena* Arena, cpu_mesh* Mesh)
+{
+    // NOTE: Renumber vertices in the order the indices first use them, unreferenced vertices get dropped
+    u32* Remap = PushArray(Arena, u32, Mesh->NumVertices);
+    for (u32 VertexId = 0; VertexId < Mesh->NumVertices; ++VertexId)
+    {
+        Remap[VertexId] = 0xFFFFFFFF;
+    }
+
+    mesh_vertex* NewVertices = PushArray(Arena, mesh_vertex, Mesh->NumVertices);
+    u32 NumNewVertices = 0;
+    for (u32 IndexId = 0; IndexId < Mesh->NumIndices; ++IndexId)
+    {
+        u32 VertexId = Mesh->Indices[IndexId];
+        if (Remap[VertexId] == 0xFFFFFFFF)
+        {
+            Remap[VertexId] = NumNewVertices;
+            NewVertices[NumNewVertices++] = Mesh->Vertices[VertexId];
+        }
+        Mesh->Indices[IndexId] = Remap[VertexId];
+    }
+
+    Mesh->Vertices = NewVertices;
+    Mesh->NumVertices = NumNewVertices;
+}
+
+//
+// NOTE: Quantization
+//
+
+inline u16 MeshF32ToF16(f32 Value)
+{
+    // NOTE: Truncates the mantissa, flushes denormals to zero and clamps to the largest half. Good enough for uvs
+    u32 Bits = 0;
+    Copy(&Value, &Bits, sizeof(Bits));
+
+    u32 Sign = (Bits >> 16) & 0x8000;
+    i32 Exponent = i32((Bits >> 23) & 0xFF) - 127 + 15;
+    u32 Mantissa = Bits & 0x7FFFFF;
+
+    u16 Result = 0;
+    if (Exponent <= 0)
+    {
+        Result = u16(Sign);
+    }
+    else if (Exponent >= 31)
+    {
+        Result = u16(Sign | 0x7BFF);
+    }
+    else
+    {
+        Result = u16(Sign | (u32(Exponent) << 10) | (Mantissa >> 13));
+    }
+
+    return Result;
+}
+
+inline i16 MeshSnorm16(f32 Value)
+{
+    f32 Clamped = Value < -1.0f ? -1.0f : (Value > 1.0f ? 1.0f : Value);
+    i16 Result = i16(roundf(Clamped * 32767.0f));
+    return Result;
+}
+
+inline v2 MeshOctahedralEncode(v3 Normal)
+{
+    f32 AbsX = Normal.x < 0.0f ? -Normal.x : Normal.x;
+    f32 AbsY = Normal.y < 0.0f ? -Normal.y : Normal.y;
+    f32 AbsZ = Normal.z < 0.0f ? -Normal.z : Normal.z;
+    f32 InvSum = 1.0f / Max(AbsX + AbsY + AbsZ, 1e-20f);
+
+    v2 Result = V2(Normal.x * InvSum, Normal.y * InvSum);
+    if (Normal.z < 0.0f)
+    {
+        // NOTE: Fold the lower hemisphere over the diagonals
+        f32 X = (1.0f - AbsY * InvSum) * (Result.x >= 0.0f ? 1.0f : -1.0f);
+        f32 Y = (1.0f - AbsX * InvSum) * (Result.y >= 0.0f ? 1.0f : -1.0f);
+        Result = V2(X, Y);
+    }
+
+    return Result;
+}
+
+inline quantized_vertex* MeshQuantize(linear_arena* Arena, cpu_mesh* Mesh, v3* OutScale, v3* OutBias)
+{
+    v3 MinPos = Mesh->Vertices[0].Pos;
+    v3 MaxPos = Mesh->Vertices[0].Pos;
+    for (u32 VertexId = 1; VertexId < Mesh->NumVertices; ++VertexId)
+    {
+        v3 Pos = Mesh->Vertices[VertexId].Pos;
+        MinPos = V3(Min(MinPos.x, Pos.x), Min(MinPos.y, Pos.y), Min(MinPos.z, Pos.z));
+        MaxPos = V3(Max(MaxPos.x, Pos.x), Max(MaxPos.y, Pos.y), Max(MaxPos.z, Pos.z));
+    }
+
+    // NOTE: Flat axes still need a non zero scale
+    v3 Extent = MaxPos - MinPos;
+    Extent = V3(Max(Extent.x, 1e-6f), Max(Extent.y, 1e-6f), Max(Extent.z, 1e-6f));
+    *OutScale = Extent;
+    *OutBias = MinPos;
+
+    quantized_vertex* Result = PushArray(Arena, quantized_vertex, Mesh->NumVertices);
+    for (u32 VertexId = 0; VertexId < Mesh->NumVertices; ++VertexId)
+    {
+        mesh_vertex* Vertex = Mesh->Vertices + VertexId;
+        quantized_vertex* Quantized = Result + VertexId;
+
+        v3 Normalized = V3((Vertex->Pos.x - MinPos.x) / Extent.x, (Vertex->Pos.y - MinPos.y) / Extent.y, (Vertex->Pos.z - MinPos.z) / Extent.z);
+        Quantized->Pos[0] = u16(roundf(Normalized.x * 65535.0f));
+        Quantized->Pos[1] = u16(roundf(Normalized.y * 65535.0f));
+        Quantized->Pos[2] = u16(roundf(Normalized.z * 65535.0f));
+        Quantized->Pos[3] = 0;
+
+        v2 Octahedral = MeshOctahedralEncode(Vertex->Normal);
+        Quantized->Normal[0] = MeshSnorm16(Octahedral.x);
+        Quantized->Normal[1] = MeshSnorm16(Octahedral.y);
+
+        Quantized->Uv[0] = MeshF32ToF16(Vertex->Uv.x);
+        Quantized->Uv[1] = MeshF32ToF16(Vertex->Uv.y);
+    }
+
+    return Result;
+}
+
+//
+// NOTE: Procedural Meshes
+//
+
+inline cpu_mesh MeshSphereCreate(linear_arena* Arena, u32 NumSlices, u32 NumStacks)
+{
+    // NOTE: Unit radius, counter clockwise seen from the outside
+    cpu_mesh Result = {};
+    Result.NumVertices = (NumSlices + 1) * (NumStacks + 1);
+    Result.Vertices = PushArray(Arena, mesh_vertex, Result.NumVertices);
+    Result.NumIndices = 6 * NumSlices * NumStacks;
+    Result.Indices = PushArray(Arena, u32, Result.NumIndices);
+
+    f32 Pi = 3.14159265359f;
+    for (u32 StackId = 0; StackId <= NumStacks; ++StackId)
+    {
+        f32 V = f32(StackId) / f32(NumStacks);
+        f32 Phi = V * Pi;
+        for (u32 SliceId = 0; SliceId <= NumSlices; ++SliceId)
+        {
+            f32 U = f32(SliceId) / f32(NumSlices);
+            f32 Theta = U * 2.0f * Pi;
+
+            mesh_vertex* Vertex = Result.Vertices + StackId * (NumSlices + 1) + SliceId;
+            Vertex->Pos = V3(sinf(Phi) * cosf(Theta), cosf(Phi), sinf(Phi) * sinf(Theta));
+            Vertex->Normal = Vertex->Pos;
+            Vertex->Uv = V2(U, V);
+        }
+    }
+
+    u32* CurrIndex = Result.Indices;
+    for (u32 StackId = 0; StackId < NumStacks; ++StackId)
+    {
+        for (u32 SliceId = 0; SliceId < NumSlices; ++SliceId)
+        {
+            u32 Index0 = StackId * (NumSlices + 1) + SliceId;
+            u32 Index1 = Index0 + 1;
+            u32 Index2 = Index0 + NumSlices + 1;
+            u32 Index3 = Index2 + 1;
+
+            *CurrIndex++ = Index0;
+            *CurrIndex++ = Index1;
+            *CurrIndex++ = Index2;
+
+            *CurrIndex++ = Index1;
+            *CurrIndex++ = Index3;
+            *CurrIndex++ = Index2;
+        }
+    }
+
+    return Result;
+}
+
+inline cpu_mesh MeshCubeCreate(linear_arena* Arena)
+{
+    // NOTE: Unit cube around the origin like the framework one, 4 vertices per face so normals stay flat
+    cpu_mesh Result = {};
+    Result.NumVertices = 24;
+    Result.Vertices = PushArray(Arena, mesh_vertex, Result.NumVertices);
+    Result.NumIndices = 36;
+    Result.Indices = PushArray(Arena, u32, Result.NumIndices);
+
+    v3 Normals[] = { V3(1, 0, 0), V3(-1, 0, 0), V3(0, 1, 0), V3(0, -1, 0), V3(0, 0, 1), V3(0, 0, -1) };
+    for (u32 FaceId = 0; FaceId < ArrayCount(Normals); ++FaceId)
+    {
+        // NOTE: Any axis in the face works for U, V = Cross(Normal, U) makes Cross(U, V) = Normal so the winding stays counter clockwise
+        v3 Normal = Normals[FaceId];
+        v3 AxisU = Normal.y != 0.0f ? V3(1, 0, 0) : V3(0, 1, 0);
+        v3 AxisV = Cross(Normal, AxisU);
+
+        v2 Corners[] = { V2(0, 0), V2(1, 0), V2(1, 1), V2(0, 1) };
+        for (u32 CornerId = 0; CornerId < ArrayCount(Corners); ++CornerId)
+        {
+            mesh_vertex* Vertex = Result.Vertices + FaceId * 4 + CornerId;
+            v2 Corner = Corners[CornerId];
+            Vertex->Pos = 0.5f * Normal + (Corner.x - 0.5f) * AxisU + (Corner.y - 0.5f) * AxisV;
+            Vertex->Normal = Normal;
+            Vertex->Uv = Corner;
+        }
+
+        u32* Indices = Result.Indices + FaceId * 6;
+        Indices[0] = FaceId * 4 + 0;
+        Indices[1] = FaceId * 4 + 1;
+        Indices[2] = FaceId * 4 + 2;
+        Indices[3] = FaceId * 4 + 0;
+        Indices[4] = FaceId * 4 + 2;
+        Indices[5] = FaceId * 4 + 3;
+    }
+
+    return Result;
+}
+
+//
+// NOTE: Import
+//
+
+inline void SceneMeshCpuCopySet(render_scene* Scene, scene_handle MeshHandle, cpu_mesh Mesh)
+{
+    // NOTE: The software rasterizer reads meshes on the CPU, so we keep a copy that outlives the temp arena
+    cpu_mesh* CpuMesh = PushStruct(&DemoState->Arena, cpu_mesh);
+    CpuMesh->NumVertices = Mesh.NumVertices;
+    CpuMesh->Vertices = PushArray(&DemoState->Arena, mesh_vertex, Mesh.NumVertices);
+    CpuMesh->NumIndices = Mesh.NumIndices;
+    CpuMesh->Indices = PushArray(&DemoState->Arena, u32, Mesh.NumIndices);
+    Copy(Mesh.Vertices, CpuMesh->Vertices, sizeof(mesh_vertex) * Mesh.NumVertices);
+    Copy(Mesh.Indices, CpuMesh->Indices, sizeof(u32) * Mesh.NumIndices);
+    render_mesh* RenderMesh = SceneMeshGet(Scene, MeshHandle);
+    RenderMesh->CpuMesh = CpuMesh;
+
+    // NOTE: We have the vertices here anyway, so this is where meshes get their bounds
+    f32 BoundingRadius = 0.0f;
+    for (u32 VertexId = 0; VertexId < Mesh.NumVertices; ++VertexId)
+    {
+        BoundingRadius = Max(BoundingRadius, Length(Mesh.Vertices[VertexId].Pos));
+    }
+    RenderMesh->BoundingRadius = Max(RenderMesh->BoundingRadius, BoundingRadius);
+}
+
+inline mesh_optimizer_report* MeshOptimizerRun(mesh_optimizer_reports* Reports, const char* Name, cpu_mesh* Mesh)
+{
+    // NOTE: The headless software raster runs this too, so its meshes keep the same triangle order as the GPU ones
+    linear_arena* Arena = &DemoState->TempArena;
+    Assert(Reports->NumReports < MESH_OPTIMIZER_MAX_REPORTS);
+    mesh_optimizer_report* Result = Reports->Reports + Reports->NumReports++;
+    *Result = {};
+    Result->Name = Name;
+    Result->NumTriangles = Mesh->NumIndices / 3;
+    Result->AcmrBefore = MeshAcmr(Arena, Mesh->Indices, Mesh->NumIndices, Mesh->NumVertices, MESH_OPTIMIZER_FIFO_SIZE);
+
+    MeshOptimizeVertexCache(Arena, Mesh->Indices, Mesh->NumIndices, Mesh->NumVertices);
+    MeshOptimizeVertexFetch(Arena, Mesh);
+
+    Result->NumVertices = Mesh->NumVertices;
+    Result->AcmrAfter = MeshAcmr(Arena, Mesh->Indices, Mesh->NumIndices, Mesh->NumVertices, MESH_OPTIMIZER_FIFO_SIZE);
+    Result->VertexBytes = sizeof(mesh_vertex) * Mesh->NumVertices;
+    Result->IndexBytes = sizeof(u32) * Mesh->NumIndices;
+
+    return Result;
+}
+
+inline scene_handle SceneCpuMeshAdd(render_scene* Scene, mesh_optimizer_reports* Reports, const char* Name, vk_image Color, vk_image Normal,
+                                    cpu_mesh Mesh)
+{
+    linear_arena* Arena = &DemoState->TempArena;
+    mesh_optimizer_report* Report = MeshOptimizerRun(Reports, Name, &Mesh);
+
+    // NOTE: Full precision stream, every renderer can draw this one
+    VkBuffer VertexBuffer = TaggedBufferCreate("meshes", &RenderState->GpuArena, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                               Report->VertexBytes);
+    VkBuffer IndexBuffer = TaggedBufferCreate("meshes", &RenderState->GpuArena, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                              Report->IndexBytes);
+    {
+        mesh_vertex* GpuVertices = VkTransferPushWriteArray(&RenderState->TransferManager, VertexBuffer, mesh_vertex, Mesh.NumVertices,
+                                                            BarrierMask(VkAccessFlagBits(0), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT),
+                                                            BarrierMask(VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT));
+        Copy(Mesh.Vertices, GpuVertices, Report->VertexBytes);
+
+        u32* GpuIndices = VkTransferPushWriteArray(&RenderState->TransferManager, IndexBuffer, u32, Mesh.NumIndices,
+                                                   BarrierMask(VkAccessFlagBits(0), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT),
+                                                   BarrierMask(VK_ACCESS_INDEX_READ_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT));
+        Copy(Mesh.Indices, GpuIndices, Report->IndexBytes);
+    }
+
+    scene_handle Result = SceneMeshAdd(Scene, Color, Normal, VertexBuffer, IndexBuffer, Mesh.NumIndices);
+    SceneMeshCpuCopySet(Scene, Result, Mesh);
+    render_mesh* RenderMesh = SceneMeshGet(Scene, Result);
+
+    // NOTE: Quantized stream for the passes that support it
+    {
+        quantized_vertex* QuantizedVertices = MeshQuantize(Arena, &Mesh, &RenderMesh->PosScale, &RenderMesh->PosBias);
+        b32 SmallIndices = Mesh.NumVertices <= 0x10000;
+        Report->QuantizedVertexBytes = sizeof(quantized_vertex) * Mesh.NumVertices;
+        Report->QuantizedIndexBytes = (SmallIndices ? sizeof(u16) : sizeof(u32)) * Mesh.NumIndices;
+
+        RenderMesh->QuantizedVertexBuffer = TaggedBufferCreate("meshes", &RenderState->GpuArena,
+                                                               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                               Report->QuantizedVertexBytes);
+        RenderMesh->QuantizedIndexBuffer = TaggedBufferCreate("meshes", &RenderState->GpuArena,
+                                                              VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                              Report->QuantizedIndexBytes);
+        RenderMesh->QuantizedIndexType = SmallIndices ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+        quantized_vertex* GpuVertices = VkTransferPushWriteArray(&RenderState->TransferManager, RenderMesh->QuantizedVertexBuffer, quantized_vertex,
+                                                                 Mesh.NumVertices, BarrierMask(VkAccessFlagBits(0), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT),
+                                                                 BarrierMask(VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT));
+        Copy(QuantizedVertices, GpuVertices, Report->QuantizedVertexBytes);
+
+        u8* GpuIndices = VkTransferPushWriteArray(&RenderState->TransferManager, RenderMesh->QuantizedIndexBuffer, u8, Report->QuantizedIndexBytes,
+                                                  BarrierMask(VkAccessFlagBits(0), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT),
+                                                  BarrierMask(VK_ACCESS_INDEX_READ_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT));
+        if (SmallIndices)
+        {
+            u16* GpuIndices16 = (u16*)GpuIndices;
+            for (u32 IndexId = 0; IndexId < Mesh.NumIndices; ++IndexId)
+            {
+                GpuIndices16[IndexId] = u16(Mesh.Indices[IndexId]);
+            }
+        }
+        else
+        {
+            Copy(Mesh.Indices, GpuIndices, Report->QuantizedIndexBytes);
+        }
+    }
+
+    return Result;
+}
+
+inline void MeshOptimizerReportsDump(mesh_optimizer_reports* Reports, const char* FileName)
+{
+    FILE* File = fopen(FileName, "wb");
+    if (!File)
+    {
+        return;
+    }
+
+    // NOTE: Fetch bytes are an estimate per draw, every cache miss fetches one vertex
+    fprintf(File, "Mesh, Vertices, Triangles, AcmrBefore, AcmrAfter, VertexBytes, IndexBytes, QuantizedVertexBytes, QuantizedIndexBytes, "
+            "FetchBytesBefore, FetchBytesAfter, FetchBytesQuantized\n");
+    for (u32 ReportId = 0; ReportId < Reports->NumReports; ++ReportId)
+    {
+        mesh_optimizer_report* Report = Reports->Reports + ReportId;
+        f32 FetchBefore = Report->AcmrBefore * f32(Report->NumTriangles) * f32(sizeof(mesh_vertex)) + f32(Report->IndexBytes);
+        f32 FetchAfter = Report->AcmrAfter * f32(Report->NumTriangles) * f32(sizeof(mesh_vertex)) + f32(Report->IndexBytes);
+        f32 FetchQuantized = Report->AcmrAfter * f32(Report->NumTriangles) * f32(sizeof(quantized_vertex)) + f32(Report->QuantizedIndexBytes);
+        fprintf(File, "%s, %u, %u, %f, %f, %llu, %llu, %llu, %llu, %f, %f, %f\n", Report->Name, Report->NumVertices, Report->NumTriangles,
+                Report->AcmrBefore, Report->AcmrAfter, Report->VertexBytes, Report->IndexBytes, Report->QuantizedVertexBytes,
+                Report->QuantizedIndexBytes, FetchBefore, FetchAfter, FetchQuantized);
+    }
+
+    fclose(File);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+/*
+
+  NOTE: Import time mesh optimization. Meshes we generate on the CPU go through three steps before we upload them:
+
+    - Indices get reordered for the post transform cache (Forsyth, "Linear-Speed Vertex Cache Optimisation"). Triangles are emitted
+      greedily by a score that favours vertices that are in the cache and vertices that have few triangles left.
+    - Vertices get reordered into the order the indices first reference them, so vertex fetch walks the buffer mostly linearly.
+    - Optionally a quantized copy of the vertices is built: positions as 16 bit unorm inside the mesh bounds (the shader dequantizes
+      with a per mesh scale and bias), normals octahedral encoded into two 16 bit snorms and uvs as halfs. That takes a vertex from
+      32 to 16 bytes, and meshes with <= 64k vertices also get 16 bit indices.
+
+        ACMR (average cache miss ratio, transformed vertices per triangle) is measured with a FIFO cache of MESH_OPTIMIZER_FIFO_SIZE
+        entries, which is closer to how current GPUs batch vertices than the LRU cache the optimizer models. Results get written to
+        MESH_OPTIMIZER_FILE_NAME.
+
+ */
+
+#define MESH_OPTIMIZER_CACHE_SIZE 32
+#define MESH_OPTIMIZER_FIFO_SIZE 16
+#define MESH_OPTIMIZER_MAX_REPORTS 16
+#define MESH_OPTIMIZER_FILE_NAME "mesh_stats.csv"
+
+// NOTE: Matches the vertex format the framework assets use
+struct mesh_vertex
+{
+    v3 Pos;
+    v3 Normal;
+    v2 Uv;
+};
+
+struct quantized_vertex
+{
+    u16 Pos[4]; // NOTE: w is padding
+    i16 Normal[2];
+    u16 Uv[2];
+};
+
+struct cpu_mesh
+{
+    u32 NumVertices;
+    mesh_vertex* Vertices;
+    u32 NumIndices;
+    u32* Indices;
+};
+
+struct mesh_optimizer_report
+{
+    const char* Name;
+    u32 NumVertices;
+    u32 NumTriangles;
+    f32 AcmrBefore;
+    f32 AcmrAfter;
+    u64 VertexBytes;
+    u64 IndexBytes;
+    u64 QuantizedVertexBytes;
+    u64 QuantizedIndexBytes;
+};
+
+struct mesh_optimizer_reports
+{
+    u32 NumReports;
+    mesh_optimizer_report Reports[MESH_OPTIMIZER_MAX_REPORTS];
+};
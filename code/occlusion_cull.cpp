@@ -0,0 +1,402 @@
+
+inline vk_pipeline OcclusionCullPipelineCreate(const char* FileName, VkDescriptorSetLayout Layout, u32 PushConstantSize)
+{
+    // NOTE: The pipeline manager has no way to pass push constants, so like the light culling permutations these get built by hand
+    // and don't get shader hot reload
+    vk_pipeline Result = {};
+
+    VkShaderModule ShaderModule = VK_NULL_HANDLE;
+    {
+        FILE* File = fopen(FileName, "rb");
+        Assert(File);
+        fseek(File, 0, SEEK_END);
+        u32 CodeSize = u32(ftell(File));
+        fseek(File, 0, SEEK_SET);
+        u32* Code = PushArray(&DemoState->TempArena, u32, CeilU32(f32(CodeSize) / 4.0f));
+        fread(Code, 1, CodeSize, File);
+        fclose(File);
+
+        VkShaderModuleCreateInfo ModuleCreateInfo = {};
+        ModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        ModuleCreateInfo.codeSize = CodeSize;
+        ModuleCreateInfo.pCode = Code;
+        VkCheckResult(vkCreateShaderModule(RenderState->Device, &ModuleCreateInfo, 0, &ShaderModule));
+    }
+
+    VkPushConstantRange PushConstantRange = {};
+    PushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    PushConstantRange.offset = 0;
+    PushConstantRange.size = PushConstantSize;
+
+    VkPipelineLayoutCreateInfo LayoutCreateInfo = {};
+    LayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    LayoutCreateInfo.setLayoutCount = 1;
+    LayoutCreateInfo.pSetLayouts = &Layout;
+    LayoutCreateInfo.pushConstantRangeCount = 1;
+    LayoutCreateInfo.pPushConstantRanges = &PushConstantRange;
+    VkCheckResult(vkCreatePipelineLayout(RenderState->Device, &LayoutCreateInfo, 0, &Result.Layout));
+
+    VkComputePipelineCreateInfo PipelineCreateInfo = {};
+    PipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    PipelineCreateInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    PipelineCreateInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    PipelineCreateInfo.stage.module = ShaderModule;
+    PipelineCreateInfo.stage.pName = "main";
+    PipelineCreateInfo.layout = Result.Layout;
+    VkCheckResult(vkCreateComputePipelines(RenderState->Device, VK_NULL_HANDLE, 1, &PipelineCreateInfo, 0, &Result.Handle));
+
+    vkDestroyShaderModule(RenderState->Device, ShaderModule, 0);
+
+    return Result;
+}
+
+inline void OcclusionCullBuffersWrite(occlusion_cull* Cull)
+{
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Cull->Descriptor, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Cull->Instances.Buffer);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Cull->Descriptor, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Cull->InstanceStates.Buffer);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Cull->Descriptor, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Cull->EarlyDraws.Buffer);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Cull->Descriptor, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Cull->LateDraws.Buffer);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Cull->Descriptor, 7, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Cull->VisibleIds.Buffer);
+}
+
+inline void OcclusionCullDrawDescriptorWrite(occlusion_cull* Cull)
+{
+    // NOTE: The descriptor manager writes whole buffers, dynamic offsets need a range that stays inside the buffer from every region
+    VkDescriptorBufferInfo BufferInfo = {};
+    BufferInfo.buffer = Cull->VisibleIds.Buffer;
+    BufferInfo.offset = 0;
+    BufferInfo.range = Cull->PhaseVisibleIds * sizeof(u32);
+
+    VkWriteDescriptorSet Write = {};
+    Write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    Write.dstSet = Cull->DrawDescriptor;
+    Write.dstBinding = 0;
+    Write.descriptorCount = 1;
+    Write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    Write.pBufferInfo = &BufferInfo;
+    vkUpdateDescriptorSets(RenderState->Device, 1, &Write, 0, 0);
+}
+
+inline void OcclusionCullCreate(renderer_create_info CreateInfo, occlusion_cull* Result)
+{
+    *Result = {};
+    Result->Enabled = OCCLUSION_CULL;
+
+    // NOTE: Batch regions in VisibleIds start at dynamic offsets, see occlusion_cull.h
+    {
+        VkPhysicalDeviceProperties Properties = {};
+        vkGetPhysicalDeviceProperties(RenderState->PhysicalDevice, &Properties);
+        Result->VisibleIdAlignment = Max(u32(Properties.limits.minStorageBufferOffsetAlignment / sizeof(u32)), 1u);
+    }
+
+    Result->Globals = TaggedBufferCreate("occlusion_cull", &RenderState->GpuArena, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                         sizeof(occlusion_cull_globals));
+    GrowableBufferCreate(&Result->Instances, "occlusion_cull", VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                         sizeof(gpu_occlusion_instance), GROWABLE_BUFFER_MIN_CAPACITY);
+    GrowableBufferCreate(&Result->InstanceStates, "occlusion_cull", VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, sizeof(u32), GROWABLE_BUFFER_MIN_CAPACITY);
+    GrowableBufferCreate(&Result->EarlyDraws, "occlusion_cull", VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                         VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, sizeof(VkDrawIndexedIndirectCommand), GROWABLE_BUFFER_MIN_CAPACITY);
+    GrowableBufferCreate(&Result->LateDraws, "occlusion_cull", VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                         VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, sizeof(VkDrawIndexedIndirectCommand), GROWABLE_BUFFER_MIN_CAPACITY);
+    GrowableBufferCreate(&Result->VisibleIds, "occlusion_cull", VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, sizeof(u32), GROWABLE_BUFFER_MIN_CAPACITY);
+    Result->PhaseVisibleIds = Result->VisibleIds.Capacity / 3;
+
+    {
+        vk_descriptor_layout_builder Builder = VkDescriptorLayoutBegin(&Result->DescLayout);
+        VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+        VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+        VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+        VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+        VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+        VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+        VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+        VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+        VkDescriptorLayoutEnd(RenderState->Device, &Builder);
+    }
+
+    {
+        vk_descriptor_layout_builder Builder = VkDescriptorLayoutBegin(&Result->DrawDescLayout);
+        VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_VERTEX_BIT);
+        VkDescriptorLayoutEnd(RenderState->Device, &Builder);
+    }
+
+    // NOTE: The Hi-Z image and the depth buffer get written on swap chain change
+    Result->Descriptor = VkDescriptorSetAllocate(RenderState->Device, RenderState->DescriptorPool, Result->DescLayout);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Result->Descriptor, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, Result->Globals);
+    OcclusionCullBuffersWrite(Result);
+    
+    Result->DrawDescriptor = VkDescriptorSetAllocate(RenderState->Device, RenderState->DescriptorPool, Result->DrawDescLayout);
+    OcclusionCullDrawDescriptorWrite(Result);
+
+    Result->CullPipeline = OcclusionCullPipelineCreate("..\\data\\shader_occlusion_cull.spv", Result->DescLayout, sizeof(u32));
+    Result->HiZDepthPipeline = OcclusionCullPipelineCreate("..\\data\\shader_occlusion_hiz_depth.spv", Result->DescLayout,
+                                                           sizeof(occlusion_hiz_constants));
+    Result->HiZPipeline = OcclusionCullPipelineCreate("..\\data\\shader_occlusion_hiz.spv", Result->DescLayout, sizeof(occlusion_hiz_constants));
+}
+
+inline void OcclusionCullSwapChainChange(occlusion_cull* Cull, vk_linear_arena* Arena, b32 ReCreate, u32 Width, u32 Height,
+                                         VkImageView DepthView)
+{
+    // NOTE: Retire the old pyramid, the frame in flight may still read it
+    if (ReCreate)
+    {
+        DeletionQueueImageViewPush(&DemoState->DeletionQueue, Cull->HiZ.View);
+        DeletionQueueImagePush(&DemoState->DeletionQueue, Cull->HiZ.Image);
+    }
+
+    // NOTE: Level 0 plus the column of smaller levels next to it. Rounding up adds at most a texel per level to the column height
+    u32 Level0Width = (Width + 1) / 2;
+    u32 Level0Height = (Height + 1) / 2;
+    Cull->HiZ = TaggedImageCreate("occlusion_cull", Arena, Level0Width + (Level0Width + 1) / 2, Level0Height + OCCLUSION_CULL_MAX_HIZ_LEVELS,
+                                  VK_FORMAT_R32_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+
+    VkDescriptorImageWrite(&RenderState->DescriptorManager, Cull->Descriptor, 5, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                           Cull->HiZ.View, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL);
+    VkDescriptorImageWrite(&RenderState->DescriptorManager, Cull->Descriptor, 6, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                           DepthView, DemoState->PointSampler, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+
+    // NOTE: Layout gets set up in the next frames command buffer (OcclusionCullFrameBegin)
+    Cull->HiZInitialized = false;
+    Cull->HiZValid = false;
+}
+
+inline void OcclusionCullGlobalsPush(occlusion_cull* Cull, render_scene* Scene, u32 Width, u32 Height)
+{
+    Cull->Active = Cull->Enabled;
+    if (!Cull->Active)
+    {
+        return;
+    }
+
+    Cull->NumInstances = Scene->OpaqueInstances.NumItems;
+    Cull->VPTransform = CameraGetVP(&Scene->Camera);
+    Cull->RenderWidth = Width;
+    Cull->RenderHeight = Height;
+
+    // NOTE: Level rects for this render size, see occlusion_cull.h for the atlas layout
+    {
+        u32 LevelWidth = (Width + 1) / 2;
+        u32 LevelHeight = (Height + 1) / 2;
+        u32 OffsetX = 0;
+        u32 OffsetY = 0;
+        Cull->NumHiZLevels = 0;
+        while (Cull->NumHiZLevels < OCCLUSION_CULL_MAX_HIZ_LEVELS)
+        {
+            u32* Rect = Cull->HiZLevelRects[Cull->NumHiZLevels++];
+            Rect[0] = OffsetX;
+            Rect[1] = OffsetY;
+            Rect[2] = LevelWidth;
+            Rect[3] = LevelHeight;
+            if (LevelWidth == 1 && LevelHeight == 1)
+            {
+                break;
+            }
+
+            OffsetX = Cull->NumHiZLevels == 1 ? LevelWidth : OffsetX;
+            OffsetY = Cull->NumHiZLevels == 1 ? 0 : OffsetY + LevelHeight;
+            LevelWidth = (LevelWidth + 1) / 2;
+            LevelHeight = (LevelHeight + 1) / 2;
+        }
+    }
+
+    // NOTE: One batch per mesh in order of first use, every batch gets an aligned region per phase in VisibleIds
+    linear_arena* FrameArena = FrameArenaGet(&DemoState->FrameArena);
+    u32* InstanceBatchIds = PushArray(FrameArena, u32, Max(Cull->NumInstances, 1u));
+    Cull->Batches = PushArray(FrameArena, occlusion_batch, Max(Scene->RenderMeshes.NumItems, 1u));
+    Cull->NumBatches = 0;
+    {
+        u32* MeshBatchIds = PushArray(FrameArena, u32, Max(Scene->RenderMeshes.NumItems, 1u));
+        for (u32 MeshId = 0; MeshId < Scene->RenderMeshes.NumItems; ++MeshId)
+        {
+            MeshBatchIds[MeshId] = 0xFFFFFFFF;
+        }
+
+        for (u32 InstanceId = 0; InstanceId < Cull->NumInstances; ++InstanceId)
+        {
+            instance_entry* Instance = SceneOpaqueInstanceAt(Scene, InstanceId);
+            scene_pool_slot* MeshSlot = ScenePoolSlotGet(&Scene->RenderMeshes, Instance->Mesh);
+            Assert(MeshSlot);
+            
+            u32* BatchId = MeshBatchIds + MeshSlot->DenseId;
+            if (*BatchId == 0xFFFFFFFF)
+            {
+                *BatchId = Cull->NumBatches++;
+                occlusion_batch* Batch = Cull->Batches + *BatchId;
+                *Batch = {};
+                Batch->Mesh = Instance->Mesh;
+            }
+            
+            Cull->Batches[*BatchId].NumInstances += 1;
+            InstanceBatchIds[InstanceId] = *BatchId;
+        }
+    }
+
+    u32 PhaseVisibleIds = 0;
+    for (u32 BatchId = 0; BatchId < Cull->NumBatches; ++BatchId)
+    {
+        occlusion_batch* Batch = Cull->Batches + BatchId;
+        Batch->VisibleIdOffset = PhaseVisibleIds;
+        PhaseVisibleIds += CeilU32(f32(Batch->NumInstances) / f32(Cull->VisibleIdAlignment)) * Cull->VisibleIdAlignment;
+    }
+    PhaseVisibleIds = Max(PhaseVisibleIds, Cull->VisibleIdAlignment);
+    
+    // NOTE: Instance states only live within a frame, so nothing has to carry over when the buffers grow
+    {
+        b32 Grew = false;
+        Grew |= GrowableBufferReserve(&Cull->Instances, Cull->NumInstances);
+        Grew |= GrowableBufferReserve(&Cull->InstanceStates, Cull->NumInstances);
+        Grew |= GrowableBufferReserve(&Cull->EarlyDraws, Cull->NumBatches);
+        Grew |= GrowableBufferReserve(&Cull->LateDraws, Cull->NumBatches);
+        // NOTE: Early and late regions plus the descriptor range behind the last late region
+        Grew |= GrowableBufferReserve(&Cull->VisibleIds, 3*PhaseVisibleIds);
+        if (Grew)
+        {
+            OcclusionCullBuffersWrite(Cull);
+            VkDescriptorManagerFlush(RenderState->Device, &RenderState->DescriptorManager);
+        }
+
+        if (Grew || PhaseVisibleIds != Cull->PhaseVisibleIds)
+        {
+            Cull->PhaseVisibleIds = PhaseVisibleIds;
+            OcclusionCullDrawDescriptorWrite(Cull);
+        }
+    }
+    
+    if (Cull->NumInstances > 0)
+    {
+        // NOTE: Draws start out empty, the cull shader counts the visible instances of each batch into them
+        VkDrawIndexedIndirectCommand* EarlyDraws = StagingRingPushWriteArray(&DemoState->StagingRing, Cull->EarlyDraws.Buffer,
+                                                                             VkDrawIndexedIndirectCommand, Cull->NumBatches,
+                                                                             VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                                                                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        VkDrawIndexedIndirectCommand* LateDraws = StagingRingPushWriteArray(&DemoState->StagingRing, Cull->LateDraws.Buffer,
+                                                                            VkDrawIndexedIndirectCommand, Cull->NumBatches,
+                                                                            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                                                                            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        for (u32 BatchId = 0; BatchId < Cull->NumBatches; ++BatchId)
+        {
+            VkDrawIndexedIndirectCommand Draw = {};
+            Draw.indexCount = SceneMeshGet(Scene, Cull->Batches[BatchId].Mesh)->NumIndices;
+            EarlyDraws[BatchId] = Draw;
+            LateDraws[BatchId] = Draw;
+        }
+        
+        gpu_occlusion_instance* GpuData = StagingRingPushWriteArray(&DemoState->StagingRing, Cull->Instances.Buffer, gpu_occlusion_instance,
+                                                                    Cull->NumInstances, VK_ACCESS_SHADER_READ_BIT,
+                                                                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        for (u32 InstanceId = 0; InstanceId < Cull->NumInstances; ++InstanceId)
+        {
+            instance_entry* Instance = SceneOpaqueInstanceAt(Scene, InstanceId);
+            render_mesh* Mesh = SceneMeshGet(Scene, Instance->Mesh);
+            gpu_occlusion_instance* Entry = GpuData + InstanceId;
+            u32 BatchId = InstanceBatchIds[InstanceId];
+
+            // NOTE: Box around the transformed bounding sphere, the extent along a world axis is the radius times the length of that
+            // row of the transform. This stays tight for non uniform scales, unlike a sphere around the largest axis
+            v3 AxisX = (Instance->WTransform * V4(1, 0, 0, 0)).xyz;
+            v3 AxisY = (Instance->WTransform * V4(0, 1, 0, 0)).xyz;
+            v3 AxisZ = (Instance->WTransform * V4(0, 0, 1, 0)).xyz;
+            Entry->Center = (Instance->WTransform * V4(0, 0, 0, 1)).xyz;
+            Entry->BatchId = BatchId;
+            Entry->VisibleIdOffset = Cull->Batches[BatchId].VisibleIdOffset;
+            Entry->Extents = Mesh->BoundingRadius * V3(Length(V3(AxisX.x, AxisY.x, AxisZ.x)), Length(V3(AxisX.y, AxisY.y, AxisZ.y)),
+                                                       Length(V3(AxisX.z, AxisY.z, AxisZ.z)));
+            Entry->Flags = Mesh->BoundingRadius > 0.0f ? 0 : u32(OcclusionInstance_NeverCull);
+        }
+    }
+
+    occlusion_cull_globals* Data = StagingRingPushWriteStruct(&DemoState->StagingRing, Cull->Globals, occlusion_cull_globals,
+                                                              VK_ACCESS_UNIFORM_READ_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    *Data = {};
+    Data->VPTransform = Cull->VPTransform;
+    Data->PrevVPTransform = Cull->HiZVPTransform;
+    Data->ScreenSize = V2(f32(Width), f32(Height));
+    Data->NumInstances = Cull->NumInstances;
+    Data->PrevHiZValid = Cull->HiZValid && Cull->HiZRenderWidth == Width && Cull->HiZRenderHeight == Height;
+    Data->NumHiZLevels = Cull->NumHiZLevels;
+    Data->LateVisibleIdOffset = Cull->PhaseVisibleIds;
+    Copy(Cull->HiZLevelRects, Data->HiZLevelRects, sizeof(Cull->HiZLevelRects));
+}
+
+inline void OcclusionCullBarrier(vk_commands Commands, VkPipelineStageFlags SrcStage, VkAccessFlags SrcAccess, VkPipelineStageFlags DstStage,
+                                 VkAccessFlags DstAccess)
+{
+    VkMemoryBarrier Barrier = {};
+    Barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    Barrier.srcAccessMask = SrcAccess;
+    Barrier.dstAccessMask = DstAccess;
+    vkCmdPipelineBarrier(Commands.Buffer, SrcStage, DstStage, 0, 1, &Barrier, 0, 0, 0, 0);
+}
+
+inline void OcclusionCullFrameBegin(vk_commands Commands, occlusion_cull* Cull)
+{
+    if (!Cull->HiZInitialized)
+    {
+        VkBarrierImageAdd(&RenderState->BarrierManager, VK_ACCESS_MEMORY_READ_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                          VK_IMAGE_LAYOUT_UNDEFINED, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                          VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT, Cull->HiZ.Image);
+        VkBarrierManagerFlush(&RenderState->BarrierManager, Commands.Buffer);
+        Cull->HiZInitialized = true;
+    }
+    else
+    {
+        // NOTE: Last frames pyramid
+        OcclusionCullBarrier(Commands, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_ACCESS_SHADER_READ_BIT);
+    }
+}
+
+inline void OcclusionCullDispatch(vk_commands Commands, occlusion_cull* Cull, occlusion_cull_phase Phase)
+{
+    vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, Cull->CullPipeline.Handle);
+    vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, Cull->CullPipeline.Layout, 0, 1, &Cull->Descriptor, 0, 0);
+    u32 PhaseId = Phase;
+    vkCmdPushConstants(Commands.Buffer, Cull->CullPipeline.Layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PhaseId), &PhaseId);
+    vkCmdDispatch(Commands.Buffer, CeilU32(f32(Cull->NumInstances) / f32(OCCLUSION_CULL_GROUP_SIZE)), 1, 1);
+
+    // NOTE: The GBuffer pass that follows reads the draws and visible ids, and may write depth that the Hi-Z build of this phase just read
+    OcclusionCullBarrier(Commands, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                         VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT);
+}
+
+inline void OcclusionCullHiZBuild(vk_commands Commands, occlusion_cull* Cull)
+{
+    // IMPORTANT: Call after the GBuffer pass ended, depth has to be in DEPTH_STENCIL_READ_ONLY_OPTIMAL
+    OcclusionCullBarrier(Commands, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_ACCESS_SHADER_READ_BIT);
+
+    for (u32 LevelId = 0; LevelId < Cull->NumHiZLevels; ++LevelId)
+    {
+        // NOTE: Level 0 reduces the depth buffer, every other level the one before it
+        vk_pipeline* Pipeline = LevelId == 0 ? &Cull->HiZDepthPipeline : &Cull->HiZPipeline;
+        vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, Pipeline->Handle);
+        vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, Pipeline->Layout, 0, 1, &Cull->Descriptor, 0, 0);
+
+        occlusion_hiz_constants Constants = {};
+        if (LevelId == 0)
+        {
+            Constants.SrcRect[2] = Cull->RenderWidth;
+            Constants.SrcRect[3] = Cull->RenderHeight;
+        }
+        else
+        {
+            Copy(Cull->HiZLevelRects[LevelId - 1], Constants.SrcRect, sizeof(Constants.SrcRect));
+        }
+        Copy(Cull->HiZLevelRects[LevelId], Constants.DstRect, sizeof(Constants.DstRect));
+        vkCmdPushConstants(Commands.Buffer, Pipeline->Layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(Constants), &Constants);
+
+        vkCmdDispatch(Commands.Buffer, CeilU32(f32(Constants.DstRect[2]) / f32(OCCLUSION_CULL_HIZ_GROUP_SIZE)),
+                      CeilU32(f32(Constants.DstRect[3]) / f32(OCCLUSION_CULL_HIZ_GROUP_SIZE)), 1);
+
+        OcclusionCullBarrier(Commands, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_ACCESS_SHADER_READ_BIT);
+    }
+
+    Cull->HiZValid = true;
+    Cull->HiZVPTransform = Cull->VPTransform;
+    Cull->HiZRenderWidth = Cull->RenderWidth;
+    Cull->HiZRenderHeight = Cull->RenderHeight;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+/*
+
+  NOTE: Two phase occlusion culling for the tiled deferred GBuffer pass. Every opaque instance gets a world space box around its
+        bounding sphere, and all visibility decisions happen in compute shaders that fill one indexed indirect draw per mesh, so the
+        CPU never reads anything back:
+
+    - Early: frustum test with this frames camera. Instances that pass get projected with the camera the Hi-Z pyramid was built with
+      and tested against it. That pyramid holds last frames depth, so whatever was visible last frame gets drawn right away and
+      rejected instances get marked for a retest.
+    - We build a new Hi-Z pyramid from the depth the early draws wrote.
+    - Late: marked instances get tested against the new pyramid with this frames camera, the ones that pass get drawn on top. These
+      are the instances that got disoccluded this frame, so nothing pops in a frame late.
+    - Once the late draws are done we build the pyramid again so the next frame has the full depth to test against.
+
+        A stale pyramid (camera cut, scene change, renderer switch) can only reject too much in the early phase, and the late phase
+        picks all of that back up, so it costs draws but never correctness. The pyramid is only reused when the render size didn't
+        change, dynamic resolution steps skip the early occlusion test for one frame.
+
+        The framework images only have one mip, so the pyramid lives in one R32F storage image as an atlas: level 0 (half the render
+        size, every texel the farthest depth of its 2x2 footprint, which is the smallest with reversed z) sits in the top left and
+        every following level is stacked below the previous one to the right of level 0.
+
+        Instances get batched by mesh on the CPU and every batch owns a region of VisibleIds. The cull shader appends the ids of
+        visible instances to their batch region and bumps the instance count of the batch draw, so a phase records one draw per mesh
+        instead of one per instance. Indirect draws always start at instance 0, a non zero firstInstance would need
+        drawIndirectFirstInstance which the framework never enables. Instead the culled GBuffer permutations bind VisibleIds as a
+        dynamic storage buffer, offset to the start of the batch region, and look up the instance id with gl_InstanceIndex. Dynamic
+        offsets have to be multiples of minStorageBufferOffsetAlignment, so regions start aligned and the pass buffer holds both
+        phases plus a tail for the descriptor range behind the last region.
+
+ */
+
+#define OCCLUSION_CULL 0
+#define OCCLUSION_CULL_MAX_HIZ_LEVELS 16
+#define OCCLUSION_CULL_GROUP_SIZE 64
+#define OCCLUSION_CULL_HIZ_GROUP_SIZE 8
+
+enum occlusion_cull_phase
+{
+    OcclusionCullPhase_Early,
+    OcclusionCullPhase_Late,
+};
+
+enum occlusion_instance_flags
+{
+    OcclusionInstance_NeverCull = 1 << 0, // NOTE: Meshes without bounds
+};
+
+struct gpu_occlusion_instance
+{
+    v3 Center;
+    u32 BatchId;
+    v3 Extents;
+    u32 Flags;
+    u32 VisibleIdOffset; // NOTE: Start of the batch region within a phase
+    u32 Pad[3];
+};
+
+struct occlusion_batch
+{
+    scene_handle Mesh;
+    u32 NumInstances;
+    u32 VisibleIdOffset;
+};
+
+struct occlusion_cull_globals
+{
+    m4 VPTransform;
+    m4 PrevVPTransform; // NOTE: Camera the pyramid was built with
+    v2 ScreenSize;
+    u32 NumInstances;
+    u32 PrevHiZValid;
+    u32 NumHiZLevels;
+    u32 LateVisibleIdOffset;
+    u32 Pad[2];
+    u32 HiZLevelRects[OCCLUSION_CULL_MAX_HIZ_LEVELS][4]; // NOTE: Offset and size in texels
+};
+
+struct occlusion_hiz_constants
+{
+    u32 SrcRect[4];
+    u32 DstRect[4];
+};
+
+struct occlusion_cull
+{
+    b32 Enabled;
+
+    // NOTE: Set when this frames globals got pushed, the GBuffer pass only culls on those frames
+    b32 Active;
+    u32 NumInstances;
+    u32 NumBatches;
+    occlusion_batch* Batches; // NOTE: Lives in the frame arena
+    u32 VisibleIdAlignment; // NOTE: In ids
+    u32 PhaseVisibleIds; // NOTE: Size of one phase in VisibleIds, also the range of DrawDescriptor
+    m4 VPTransform;
+    u32 RenderWidth;
+    u32 RenderHeight;
+    u32 NumHiZLevels;
+    u32 HiZLevelRects[OCCLUSION_CULL_MAX_HIZ_LEVELS][4];
+
+    // NOTE: What the pyramid in HiZ currently holds
+    b32 HiZInitialized;
+    b32 HiZValid;
+    m4 HiZVPTransform;
+    u32 HiZRenderWidth;
+    u32 HiZRenderHeight;
+
+    VkBuffer Globals;
+    growable_buffer Instances;
+    growable_buffer InstanceStates;
+    growable_buffer EarlyDraws;
+    growable_buffer LateDraws;
+    growable_buffer VisibleIds;
+    vk_image HiZ;
+
+    VkDescriptorSetLayout DescLayout;
+    VkDescriptorSet Descriptor;
+
+    // NOTE: VisibleIds for the culled GBuffer permutations
+    VkDescriptorSetLayout DrawDescLayout;
+    VkDescriptorSet DrawDescriptor;
+    vk_pipeline CullPipeline;
+    vk_pipeline HiZDepthPipeline;
+    vk_pipeline HiZPipeline;
+};
@@ -0,0 +1,275 @@
+#version 450
+
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_GOOGLE_include_directive : enable
+
+//
+// NOTE: Descriptor Sets
+//
+
+// NOTE: Has to match occlusion_cull.h
+#define OCCLUSION_CULL_MAX_HIZ_LEVELS 16
+#define OCCLUSION_CULL_GROUP_SIZE 64
+#define OCCLUSION_CULL_HIZ_GROUP_SIZE 8
+#define OCCLUSION_PHASE_EARLY 0
+#define OCCLUSION_PHASE_LATE 1
+#define OCCLUSION_INSTANCE_NEVER_CULL 1
+
+#define INSTANCE_STATE_DONE 0
+#define INSTANCE_STATE_RETEST 1
+
+struct occlusion_instance
+{
+    vec3 Center;
+    uint BatchId;
+    vec3 Extents;
+    uint Flags;
+    uint VisibleIdOffset;
+    uint Pad0;
+    uint Pad1;
+    uint Pad2;
+};
+
+// NOTE: Same layout as VkDrawIndexedIndirectCommand
+struct draw_indexed_command
+{
+    uint IndexCount;
+    uint InstanceCount;
+    uint FirstIndex;
+    int VertexOffset;
+    uint FirstInstance;
+};
+
+layout(set = 0, binding = 0) uniform occlusion_cull_globals
+{
+    mat4 VPTransform;
+    mat4 PrevVPTransform;
+    vec2 ScreenSize;
+    uint NumInstances;
+    uint PrevHiZValid;
+    uint NumHiZLevels;
+    uint LateVisibleIdOffset;
+    uvec4 HiZLevelRects[OCCLUSION_CULL_MAX_HIZ_LEVELS];
+};
+
+layout(set = 0, binding = 1) buffer occlusion_instances
+{
+    occlusion_instance OcclusionInstances[];
+};
+
+layout(set = 0, binding = 2) buffer instance_states
+{
+    uint InstanceStates[];
+};
+
+layout(set = 0, binding = 3) buffer early_draws
+{
+    draw_indexed_command EarlyDraws[];
+};
+
+layout(set = 0, binding = 4) buffer late_draws
+{
+    draw_indexed_command LateDraws[];
+};
+
+layout(set = 0, binding = 5, r32f) uniform image2D HiZ;
+layout(set = 0, binding = 6) uniform sampler2D DepthTexture;
+
+layout(set = 0, binding = 7) buffer visible_ids
+{
+    uint VisibleIds[];
+};
+
+//
+// NOTE: Hi-Z Build
+//
+
+#if HIZ_BUILD
+
+layout(push_constant) uniform hiz_constants
+{
+    uvec4 SrcRect;
+    uvec4 DstRect;
+};
+
+layout(local_size_x = OCCLUSION_CULL_HIZ_GROUP_SIZE, local_size_y = OCCLUSION_CULL_HIZ_GROUP_SIZE, local_size_z = 1) in;
+
+float SrcDepthLoad(uvec2 Pos)
+{
+#if FROM_DEPTH
+    float Result = texelFetch(DepthTexture, ivec2(Pos), 0).x;
+#else
+    float Result = imageLoad(HiZ, ivec2(SrcRect.xy + Pos)).x;
+#endif
+    return Result;
+}
+
+void main()
+{
+    uvec2 DstPos = uvec2(gl_GlobalInvocationID.xy);
+    if (DstPos.x < DstRect.z && DstPos.y < DstRect.w)
+    {
+        // NOTE: Odd sizes round up and clamp, so every source texel still lands in exactly one destination texel
+        uvec2 SrcMax = SrcRect.zw - uvec2(1);
+        uvec2 Src0 = min(2*DstPos, SrcMax);
+        uvec2 Src1 = min(2*DstPos + uvec2(1), SrcMax);
+
+        // NOTE: Reversed z, the farthest depth is the smallest
+        float Depth = min(min(SrcDepthLoad(Src0), SrcDepthLoad(uvec2(Src1.x, Src0.y))),
+                          min(SrcDepthLoad(uvec2(Src0.x, Src1.y)), SrcDepthLoad(Src1)));
+        imageStore(HiZ, ivec2(DstRect.xy + DstPos), vec4(Depth));
+    }
+}
+
+#endif
+
+//
+// NOTE: Occlusion Cull
+//
+
+#if OCCLUSION_CULL
+
+layout(push_constant) uniform cull_constants
+{
+    uint Phase;
+};
+
+layout(local_size_x = OCCLUSION_CULL_GROUP_SIZE, local_size_y = 1, local_size_z = 1) in;
+
+// NOTE: Returns false when the box is outside the frustum. Boxes that cross the near plane get the whole screen and the nearest depth,
+// so they never count as occluded
+bool BoxProject(mat4 Transform, occlusion_instance Instance, out vec4 UvRect, out float MaxDepth)
+{
+    uint OutsideLeft = 0;
+    uint OutsideRight = 0;
+    uint OutsideTop = 0;
+    uint OutsideBottom = 0;
+    uint OutsideFar = 0;
+    uint OutsideNear = 0;
+    bool CrossesNear = false;
+    vec2 NdcMin = vec2(1);
+    vec2 NdcMax = vec2(-1);
+    MaxDepth = 0;
+    for (uint CornerId = 0; CornerId < 8; ++CornerId)
+    {
+        vec3 Corner = vec3((CornerId & 1) != 0 ? 1 : -1, (CornerId & 2) != 0 ? 1 : -1, (CornerId & 4) != 0 ? 1 : -1);
+        vec4 ClipPos = Transform * vec4(Instance.Center + Corner * Instance.Extents, 1);
+
+        // NOTE: Reversed z, the far plane is at 0 and the near plane at w
+        OutsideLeft += ClipPos.x < -ClipPos.w ? 1 : 0;
+        OutsideRight += ClipPos.x > ClipPos.w ? 1 : 0;
+        OutsideTop += ClipPos.y < -ClipPos.w ? 1 : 0;
+        OutsideBottom += ClipPos.y > ClipPos.w ? 1 : 0;
+        OutsideFar += ClipPos.z < 0 ? 1 : 0;
+        OutsideNear += ClipPos.z > ClipPos.w ? 1 : 0;
+
+        if (ClipPos.w <= 0 || ClipPos.z > ClipPos.w)
+        {
+            CrossesNear = true;
+        }
+        else
+        {
+            vec3 NdcPos = ClipPos.xyz / ClipPos.w;
+            NdcMin = min(NdcMin, NdcPos.xy);
+            NdcMax = max(NdcMax, NdcPos.xy);
+            MaxDepth = max(MaxDepth, NdcPos.z);
+        }
+    }
+
+    bool Result = (OutsideLeft < 8 && OutsideRight < 8 && OutsideTop < 8 && OutsideBottom < 8 && OutsideFar < 8 && OutsideNear < 8);
+    if (CrossesNear)
+    {
+        UvRect = vec4(0, 0, 1, 1);
+        MaxDepth = 1;
+    }
+    else
+    {
+        UvRect = clamp(0.5 * vec4(NdcMin, NdcMax) + vec4(0.5), vec4(0), vec4(1));
+    }
+
+    return Result;
+}
+
+bool HiZOccluded(vec4 UvRect, float MaxDepth)
+{
+    // NOTE: Level L texels cover 2^(L+1) pixels, pick the first level where the rect touches at most 2x2 texels
+    vec2 PixelMin = UvRect.xy * ScreenSize;
+    vec2 PixelMax = UvRect.zw * ScreenSize;
+    float MaxPixelSize = max(max(PixelMax.x - PixelMin.x, PixelMax.y - PixelMin.y), 1);
+    uint LevelId = min(uint(max(ceil(log2(0.5 * MaxPixelSize)), 0)), NumHiZLevels - 1);
+
+    uvec4 Rect = HiZLevelRects[LevelId];
+    float TexelSize = float(2u << LevelId);
+    uvec2 TexelMin = min(uvec2(PixelMin / TexelSize), Rect.zw - uvec2(1));
+    uvec2 TexelMax = min(uvec2(PixelMax / TexelSize), Rect.zw - uvec2(1));
+
+    float MinDepth = min(min(imageLoad(HiZ, ivec2(Rect.xy + TexelMin)).x, imageLoad(HiZ, ivec2(Rect.xy + uvec2(TexelMax.x, TexelMin.y))).x),
+                         min(imageLoad(HiZ, ivec2(Rect.xy + uvec2(TexelMin.x, TexelMax.y))).x, imageLoad(HiZ, ivec2(Rect.xy + TexelMax)).x));
+
+    // NOTE: Reversed z, occluded when the nearest point of the box is farther than everything drawn over it
+    bool Result = MaxDepth < MinDepth;
+    return Result;
+}
+
+void main()
+{
+    uint InstanceId = uint(gl_GlobalInvocationID.x);
+    if (InstanceId >= NumInstances)
+    {
+        return;
+    }
+
+    occlusion_instance Instance = OcclusionInstances[InstanceId];
+    bool NeverCull = (Instance.Flags & OCCLUSION_INSTANCE_NEVER_CULL) != 0;
+
+    if (Phase == OCCLUSION_PHASE_EARLY)
+    {
+        bool Visible = true;
+        bool Retest = false;
+        if (!NeverCull)
+        {
+            vec4 UvRect;
+            float MaxDepth;
+            Visible = BoxProject(VPTransform, Instance, UvRect, MaxDepth);
+
+            // NOTE: The pyramid holds last frames depth, so we test where the box would have been on last frames screen. Boxes that
+            // were outside last frames frustum have nothing to test against
+            vec4 PrevUvRect;
+            float PrevMaxDepth;
+            if (Visible && PrevHiZValid != 0 && BoxProject(PrevVPTransform, Instance, PrevUvRect, PrevMaxDepth) &&
+                HiZOccluded(PrevUvRect, PrevMaxDepth))
+            {
+                Visible = false;
+                Retest = true;
+            }
+        }
+
+        InstanceStates[InstanceId] = Retest ? INSTANCE_STATE_RETEST : INSTANCE_STATE_DONE;
+        if (Visible)
+        {
+            // NOTE: Draws always start at instance 0, the vertex shader finds our id in the batch region
+            uint Slot = atomicAdd(EarlyDraws[Instance.BatchId].InstanceCount, 1);
+            VisibleIds[Instance.VisibleIdOffset + Slot] = InstanceId;
+        }
+    }
+    else
+    {
+        // NOTE: Only instances the early phase rejected get another chance, against the pyramid of what got drawn so far
+        bool Visible = false;
+        if (InstanceStates[InstanceId] == INSTANCE_STATE_RETEST)
+        {
+            vec4 UvRect;
+            float MaxDepth;
+            BoxProject(VPTransform, Instance, UvRect, MaxDepth);
+            Visible = !HiZOccluded(UvRect, MaxDepth);
+        }
+
+        if (Visible)
+        {
+            uint Slot = atomicAdd(LateDraws[Instance.BatchId].InstanceCount, 1);
+            VisibleIds[LateVisibleIdOffset + Instance.VisibleIdOffset + Slot] = InstanceId;
+        }
+    }
+}
+
+#endif
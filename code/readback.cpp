@@ -0,0 +1,68 @@
+
+inline u32 VkHostMemoryTypeFind(u32 TypeBits, VkMemoryPropertyFlags Preferred, VkMemoryPropertyFlags Required)
+{
+    VkPhysicalDeviceMemoryProperties MemoryProperties = {};
+    vkGetPhysicalDeviceMemoryProperties(RenderState->PhysicalDevice, &MemoryProperties);
+
+    u32 Result = 0xFFFFFFFF;
+    for (u32 TypeId = 0; TypeId < MemoryProperties.memoryTypeCount; ++TypeId)
+    {
+        VkMemoryPropertyFlags Flags = MemoryProperties.memoryTypes[TypeId].propertyFlags;
+        if ((TypeBits & (1 << TypeId)) && (Flags & Required) == Required)
+        {
+            if ((Flags & Preferred) == Preferred)
+            {
+                Result = TypeId;
+                break;
+            }
+            else if (Result == 0xFFFFFFFF)
+            {
+                Result = TypeId;
+            }
+        }
+    }
+
+    Assert(Result != 0xFFFFFFFF);
+    return Result;
+}
+
+inline readback_buffer ReadbackBufferCreate(u64 Size)
+{
+    readback_buffer Result = {};
+    Result.Size = Size;
+    
+    VkBufferCreateInfo BufferCreateInfo = {};
+    BufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    BufferCreateInfo.size = Size;
+    BufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    BufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VkCheckResult(vkCreateBuffer(RenderState->Device, &BufferCreateInfo, 0, &Result.Buffer));
+
+    VkMemoryRequirements MemoryRequirements;
+    vkGetBufferMemoryRequirements(RenderState->Device, Result.Buffer, &MemoryRequirements);
+
+    VkMemoryAllocateInfo AllocateInfo = {};
+    AllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    AllocateInfo.allocationSize = MemoryRequirements.size;
+    AllocateInfo.memoryTypeIndex = VkHostMemoryTypeFind(MemoryRequirements.memoryTypeBits,
+                                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+                                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    VkCheckResult(vkAllocateMemory(RenderState->Device, &AllocateInfo, 0, &Result.Memory));
+    MemoryStatsRecord(&DemoState->MemoryStats, DemoState->MemoryStats.DedicatedArenaId, "readback", Result.Size);
+    VkCheckResult(vkBindBufferMemory(RenderState->Device, Result.Buffer, Result.Memory, 0));
+    VkCheckResult(vkMapMemory(RenderState->Device, Result.Memory, 0, VK_WHOLE_SIZE, 0, (void**)&Result.Ptr));
+
+    return Result;
+}
+
+inline void ReadbackBufferDestroy(readback_buffer* Buffer)
+{
+    if (Buffer->Buffer != VK_NULL_HANDLE)
+    {
+        vkUnmapMemory(RenderState->Device, Buffer->Memory);
+        vkDestroyBuffer(RenderState->Device, Buffer->Buffer, 0);
+        vkFreeMemory(RenderState->Device, Buffer->Memory, 0);
+        MemoryStatsRelease(&DemoState->MemoryStats, DemoState->MemoryStats.DedicatedArenaId, "readback", Buffer->Size);
+    }
+    *Buffer = {};
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+/*
+
+  NOTE: Host visible buffers we copy GPU results into. These are persistently mapped and host cached where possible since the CPU
+        reads from them.
+  
+ */
+
+struct readback_buffer
+{
+    VkBuffer Buffer;
+    VkDeviceMemory Memory;
+    u64 Size;
+    u8* Ptr;
+};
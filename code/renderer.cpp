@@ -0,0 +1,248 @@
+
+inline render_target_entry* RendererOutColorGet(renderer* Renderer)
+{
+    render_target_entry* Result = 0;
+    switch (Renderer->Type)
+    {
+        case RendererType_Forward: Result = &Renderer->Forward.OutColorEntry; break;
+        case RendererType_Deferred: Result = &Renderer->Deferred.OutColorEntry; break;
+        case RendererType_TiledForward: Result = &Renderer->TiledForward.OutColorEntry; break;
+        case RendererType_TiledDeferred: Result = &Renderer->TiledDeferred.OutColorEntry; break;
+        default: InvalidCodePath;
+    }
+
+    return Result;
+}
+
+inline void RendererOutputWrite(renderer* Renderer)
+{
+    VkDescriptorImageWrite(&RenderState->DescriptorManager, Renderer->OutputRtSet, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                           RendererOutColorGet(Renderer)->View, DemoState->LinearSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    VkDescriptorManagerFlush(RenderState->Device, &RenderState->DescriptorManager);
+}
+
+inline void RendererBackendSwapChainChange(renderer* Renderer, renderer_type Type)
+{
+    renderer_create_info* CreateInfo = &Renderer->CreateInfo;
+    switch (Type)
+    {
+        case RendererType_Forward:
+        {
+            ForwardSwapChainChange(&Renderer->Forward, CreateInfo->Width, CreateInfo->Height, CreateInfo->ColorFormat, CreateInfo->Scene);
+        } break;
+
+        case RendererType_Deferred:
+        {
+            DeferredSwapChainChange(&Renderer->Deferred, CreateInfo->Width, CreateInfo->Height, CreateInfo->ColorFormat, CreateInfo->Scene);
+        } break;
+
+        case RendererType_TiledForward:
+        {
+            TiledLightDataTileSizeSet(&Renderer->TiledForward.Tiled, Renderer->TileSize);
+            TiledForwardSwapChainChange(&Renderer->TiledForward, CreateInfo->Width, CreateInfo->Height, CreateInfo->ColorFormat, CreateInfo->Scene);
+        } break;
+
+        case RendererType_TiledDeferred:
+        {
+            TiledLightDataTileSizeSet(&Renderer->TiledDeferred.Tiled, Renderer->TileSize);
+            TiledDeferredSwapChainChange(&Renderer->TiledDeferred, CreateInfo->Width, CreateInfo->Height, CreateInfo->ColorFormat, CreateInfo->Scene);
+        } break;
+
+        default: InvalidCodePath;
+    }
+
+    Renderer->Stale[Type] = false;
+}
+
+inline void RendererBackendCreate(renderer* Renderer, renderer_type Type)
+{
+    // IMPORTANT: Records light grid inits into the current frame like a swap chain change does, call after the previous frames fence wait
+    renderer_create_info CreateInfo = Renderer->CreateInfo;
+    b32 TileSizeChanged = false;
+    switch (Type)
+    {
+        case RendererType_Forward:
+        {
+            ForwardCreate(CreateInfo, &Renderer->Forward);
+        } break;
+
+        case RendererType_Deferred:
+        {
+            DeferredCreate(CreateInfo, &Renderer->Deferred);
+            if (Renderer->QuadMesh)
+            {
+                DeferredAddMeshes(&Renderer->Deferred, Renderer->QuadMesh, Renderer->SphereMesh);
+            }
+        } break;
+
+        case RendererType_TiledForward:
+        {
+            TiledForwardCreate(CreateInfo, &Renderer->TiledForward);
+            TileSizeChanged = Renderer->TiledForward.Tiled.TileSize != Renderer->TileSize;
+        } break;
+
+        case RendererType_TiledDeferred:
+        {
+            TiledDeferredCreate(CreateInfo, &Renderer->TiledDeferred);
+            if (Renderer->QuadMesh)
+            {
+                TiledDeferredAddMeshes(&Renderer->TiledDeferred, Renderer->QuadMesh);
+            }
+            TileSizeChanged = Renderer->TiledDeferred.Tiled.TileSize != Renderer->TileSize;
+        } break;
+
+        default: InvalidCodePath;
+    }
+
+    Renderer->Created[Type] = true;
+    Renderer->Stale[Type] = false;
+
+    // NOTE: Backends get created with the default tile size, the tuner may have moved on since
+    if (TileSizeChanged)
+    {
+        RendererBackendSwapChainChange(Renderer, Type);
+    }
+}
+
+inline void RendererSetType(renderer* Renderer, renderer_type Type)
+{
+    // IMPORTANT: The output set gets rewritten here so this has to be called when no frame that reads it is in flight
+    Assert(Type < RendererType_Count);
+    if (!Renderer->Created[Type])
+    {
+        RendererBackendCreate(Renderer, Type);
+    }
+    else if (Renderer->Stale[Type])
+    {
+        RendererBackendSwapChainChange(Renderer, Type);
+    }
+
+    Renderer->Type = Type;
+    RendererOutputWrite(Renderer);
+}
+
+inline void RendererCreate(renderer_create_info CreateInfo, VkDescriptorSet OutputRtSet, renderer_type Type, renderer* Result)
+{
+    *Result = {};
+    Result->OutputRtSet = OutputRtSet;
+    Result->CreateInfo = CreateInfo;
+    Result->TileSize = TILE_SIZE_IN_PIXELS;
+
+    RendererBackendCreate(Result, RendererType_TiledDeferred);
+    RendererSetType(Result, Type);
+}
+
+inline void RendererSwapChainChange(renderer* Renderer, u32 Width, u32 Height, VkFormat ColorFormat, render_scene* Scene)
+{
+    Renderer->CreateInfo.Width = Width;
+    Renderer->CreateInfo.Height = Height;
+    Renderer->CreateInfo.ColorFormat = ColorFormat;
+    Renderer->CreateInfo.Scene = Scene;
+
+    for (u32 TypeId = 0; TypeId < RendererType_Count; ++TypeId)
+    {
+        if (!Renderer->Created[TypeId])
+        {
+            continue;
+        }
+        
+        if (TypeId == u32(Renderer->Type))
+        {
+            RendererBackendSwapChainChange(Renderer, renderer_type(TypeId));
+        }
+        else
+        {
+            Renderer->Stale[TypeId] = true;
+        }
+    }
+
+    RendererOutputWrite(Renderer);
+}
+
+inline void RendererTileSizeSet(renderer* Renderer, u32 TileSize, u32 Width, u32 Height, VkFormat ColorFormat, render_scene* Scene)
+{
+    // IMPORTANT: Recreates all tile sized resources of the active renderer, call after the previous frames fence wait. Old resources
+    // go through the deletion queue and the light grid init gets recorded into the next frame. The tile size field of every created
+    // tiled backend changes right away so callers comparing against it see the new size
+    Renderer->TileSize = TileSize;
+    if (Renderer->Created[RendererType_TiledForward])
+    {
+        TiledLightDataTileSizeSet(&Renderer->TiledForward.Tiled, TileSize);
+    }
+    if (Renderer->Created[RendererType_TiledDeferred])
+    {
+        TiledLightDataTileSizeSet(&Renderer->TiledDeferred.Tiled, TileSize);
+    }
+    RendererSwapChainChange(Renderer, Width, Height, ColorFormat, Scene);
+}
+
+inline void RendererAddMeshes(renderer* Renderer, render_mesh* QuadMesh, render_mesh* SphereMesh)
+{
+    // NOTE: Backends created later pick the meshes up in RendererBackendCreate
+    Renderer->QuadMesh = QuadMesh;
+    Renderer->SphereMesh = SphereMesh;
+    if (Renderer->Created[RendererType_Deferred])
+    {
+        DeferredAddMeshes(&Renderer->Deferred, QuadMesh, SphereMesh);
+    }
+    if (Renderer->Created[RendererType_TiledDeferred])
+    {
+        TiledDeferredAddMeshes(&Renderer->TiledDeferred, QuadMesh);
+    }
+}
+
+inline b32 RendererLightsDepthSorted(renderer* Renderer, u32 NumPointLights)
+{
+    // NOTE: Bit mask light lists index their z-bins by light id, so the lights have to be uploaded in view depth order
+    b32 Result = false;
+    switch (Renderer->Type)
+    {
+        case RendererType_TiledForward: Result = TiledLightDataBitMaskActive(&Renderer->TiledForward.Tiled, NumPointLights); break;
+        case RendererType_TiledDeferred: Result = TiledLightDataBitMaskActive(&Renderer->TiledDeferred.Tiled, NumPointLights); break;
+    }
+
+    return Result;
+}
+
+inline void RendererGlobalsPush(renderer* Renderer, render_scene* Scene, u32 Width, u32 Height)
+{
+    switch (Renderer->Type)
+    {
+        case RendererType_Deferred:
+        {
+            DeferredLightVolumesPush(&Renderer->Deferred, Scene);
+        } break;
+        
+        case RendererType_TiledForward:
+        {
+            TiledLightDataGlobalsPush(&Renderer->TiledForward.Tiled, Scene, Width, Height);
+        } break;
+
+        case RendererType_TiledDeferred:
+        {
+            Renderer->TiledDeferred.RenderWidth = Width;
+            Renderer->TiledDeferred.RenderHeight = Height;
+            TiledLightDataGlobalsPush(&Renderer->TiledDeferred.Tiled, Scene, Width, Height);
+            OcclusionCullGlobalsPush(&Renderer->TiledDeferred.OcclusionCull, Scene, Width, Height);
+        } break;
+    }
+}
+
+inline b32 RendererDynamicResolutionSupported(renderer* Renderer)
+{
+    // NOTE: Only tiled deferred can render into a sub rectangle of its targets, see dynamic_resolution.h
+    b32 Result = Renderer->Type == RendererType_TiledDeferred;
+    return Result;
+}
+
+inline void RendererRender(vk_commands Commands, renderer* Renderer, render_scene* Scene)
+{
+    switch (Renderer->Type)
+    {
+        case RendererType_Forward: ForwardRender(Commands, &Renderer->Forward, Scene); break;
+        case RendererType_Deferred: DeferredRender(Commands, &Renderer->Deferred, Scene); break;
+        case RendererType_TiledForward: TiledForwardRender(Commands, &Renderer->TiledForward, Scene); break;
+        case RendererType_TiledDeferred: TiledDeferredRender(Commands, &Renderer->TiledDeferred, Scene); break;
+        default: InvalidCodePath;
+    }
+}
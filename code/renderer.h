@@ -0,0 +1,50 @@
+#pragma once
+
+/*
+
+  NOTE: Every rendering technique sits behind the same create/swapchain change/render interface, which lets a single run compare
+        techniques on the exact same scene.
+
+        Every backend owns a dedicated render target arena (512MB for most of them), so backends only get created the first time they
+        are selected, and only the active one follows swap chain and tile size changes. The others are marked stale and catch up when
+        they get selected again, which makes that first frame after a switch slower. Tiled deferred always exists since the demo pushes
+        its SSAO inputs every frame.
+  
+ */
+
+enum renderer_type
+{
+    RendererType_Forward,
+    RendererType_Deferred,
+    RendererType_TiledForward,
+    RendererType_TiledDeferred,
+
+    RendererType_Count,
+};
+
+global const char* RendererTypeNames[] =
+{
+    "forward",
+    "deferred",
+    "tiled_forward",
+    "tiled_deferred",
+};
+
+struct renderer
+{
+    renderer_type Type;
+    VkDescriptorSet OutputRtSet;
+
+    // NOTE: What lazily created and stale backends get built with, kept up to date by swap chain and tile size changes
+    renderer_create_info CreateInfo;
+    u32 TileSize;
+    render_mesh* QuadMesh;
+    render_mesh* SphereMesh;
+    b32 Created[RendererType_Count];
+    b32 Stale[RendererType_Count];
+    
+    forward_state Forward;
+    deferred_state Deferred;
+    tiled_forward_state TiledForward;
+    tiled_deferred_state TiledDeferred;
+};
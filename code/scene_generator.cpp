@@ -0,0 +1,217 @@
+
+//
+// NOTE: Random Series
+//
+
+inline random_series RandomSeriesCreate(u32 Seed)
+{
+    random_series Result = {};
+    // NOTE: Xorshift gets stuck at 0
+    Result.State = Seed != 0 ? Seed : 0x9E3779B9;
+    return Result;
+}
+
+inline u32 RandomNextU32(random_series* Series)
+{
+    // NOTE: Xorshift32
+    u32 Result = Series->State;
+    Result ^= Result << 13;
+    Result ^= Result >> 17;
+    Result ^= Result << 5;
+    Series->State = Result;
+    return Result;
+}
+
+inline f32 RandomNextUnilateral(random_series* Series)
+{
+    // NOTE: Top 24 bits map exactly onto a float mantissa
+    f32 Result = f32(RandomNextU32(Series) >> 8) * (1.0f / 16777216.0f);
+    return Result;
+}
+
+inline f32 RandomNextBilateral(random_series* Series)
+{
+    f32 Result = 2.0f*RandomNextUnilateral(Series) - 1.0f;
+    return Result;
+}
+
+inline f32 RandomNextRange(random_series* Series, f32 Min, f32 Max)
+{
+    f32 Result = Min + (Max - Min)*RandomNextUnilateral(Series);
+    return Result;
+}
+
+inline v3 RandomNextV3Range(random_series* Series, v3 Min, v3 Max)
+{
+    v3 Result = V3(RandomNextRange(Series, Min.x, Max.x), RandomNextRange(Series, Min.y, Max.y), RandomNextRange(Series, Min.z, Max.z));
+    return Result;
+}
+
+//
+// NOTE: Scene Generators
+//
+
+inline void SceneGenRoom(render_scene* Scene, scene_handle Sphere, scene_handle Cube)
+{
+    SceneOpaqueInstanceAdd(Scene, Sphere, M4Pos(V3(0)));
+    SceneOpaqueInstanceAdd(Scene, Cube, M4Pos(V3(0, 0, 5)) * M4Scale(V3(10, 10, 1)));
+    SceneOpaqueInstanceAdd(Scene, Cube, M4Pos(V3(0, -5, 0)) * M4Scale(V3(10, 1, 10)));
+    SceneOpaqueInstanceAdd(Scene, Cube, M4Pos(V3(0, 5, 0)) * M4Scale(V3(10, 1, 10)));
+    SceneOpaqueInstanceAdd(Scene, Cube, M4Pos(V3(-5, 0, 0)) * M4Scale(V3(1, 10, 10)));
+    SceneOpaqueInstanceAdd(Scene, Cube, M4Pos(V3(5, 0, 0)) * M4Scale(V3(1, 10, 10)));
+}
+
+inline void SceneGenInstanceGrid(render_scene* Scene, random_series* Series, scene_handle Mesh, v3 Center, u32 NumX, u32 NumZ, f32 Spacing,
+                                 f32 MinScale, f32 MaxScale)
+{
+    v3 Start = Center - 0.5f*Spacing*V3(f32(NumX - 1), 0, f32(NumZ - 1));
+    for (u32 Z = 0; Z < NumZ; ++Z)
+    {
+        for (u32 X = 0; X < NumX; ++X)
+        {
+            v3 Pos = Start + Spacing*V3(f32(X), 0, f32(Z));
+            f32 Scale = RandomNextRange(Series, MinScale, MaxScale);
+            SceneOpaqueInstanceAdd(Scene, Mesh, M4Pos(Pos) * M4Scale(V3(Scale)));
+        }
+    }
+}
+
+inline void SceneGenLightCloud(render_scene* Scene, random_series* Series, v3 MinPos, v3 MaxPos, u32 NumLights, f32 MinRadius,
+                               f32 MaxRadius)
+{
+    for (u32 LightId = 0; LightId < NumLights; ++LightId)
+    {
+        v3 Pos = RandomNextV3Range(Series, MinPos, MaxPos);
+        v3 Color = RandomNextV3Range(Series, V3(0), V3(1));
+        ScenePointLightAdd(Scene, Pos, Color, RandomNextRange(Series, MinRadius, MaxRadius));
+    }
+}
+
+inline void SceneGenLightClusters(render_scene* Scene, random_series* Series, v3 MinPos, v3 MaxPos, u32 NumClusters,
+                                  u32 NumLightsPerCluster, f32 ClusterRadius, f32 LightRadius)
+{
+    // NOTE: Many lights stacked in a small volume, this is the worst case for per tile light lists
+    for (u32 ClusterId = 0; ClusterId < NumClusters; ++ClusterId)
+    {
+        v3 ClusterCenter = RandomNextV3Range(Series, MinPos, MaxPos);
+        v3 ClusterColor = RandomNextV3Range(Series, V3(0.2f), V3(1));
+        for (u32 LightId = 0; LightId < NumLightsPerCluster; ++LightId)
+        {
+            v3 Offset = ClusterRadius*V3(RandomNextBilateral(Series), RandomNextBilateral(Series), RandomNextBilateral(Series));
+            ScenePointLightAdd(Scene, ClusterCenter + Offset, ClusterColor, LightRadius);
+        }
+    }
+}
+
+inline void SceneGenDepthLayers(render_scene* Scene, random_series* Series, scene_handle Mesh, v3 Center, u32 NumLayers, f32 LayerSpacing,
+                                u32 NumPerLayer)
+{
+    // NOTE: Rows of boxes stacked along +z so that a camera looking down +z sees a lot of overdraw
+    for (u32 LayerId = 0; LayerId < NumLayers; ++LayerId)
+    {
+        for (u32 BoxId = 0; BoxId < NumPerLayer; ++BoxId)
+        {
+            v3 Pos = Center + V3(RandomNextRange(Series, -4.0f, 4.0f), RandomNextRange(Series, -4.0f, 4.0f), f32(LayerId)*LayerSpacing);
+            v3 Scale = V3(RandomNextRange(Series, 0.5f, 3.0f), RandomNextRange(Series, 0.5f, 3.0f), 0.1f);
+            SceneOpaqueInstanceAdd(Scene, Mesh, M4Pos(Pos) * M4Scale(Scale));
+        }
+    }
+}
+
+inline void SceneGenGlassPanes(render_scene* Scene, random_series* Series, scene_handle Mesh, v3 MinPos, v3 MaxPos, u32 NumPanes)
+{
+    // NOTE: Thin tinted boxes scattered at random depths so that they overlap in no particular order
+    for (u32 PaneId = 0; PaneId < NumPanes; ++PaneId)
+    {
+        v3 Pos = RandomNextV3Range(Series, MinPos, MaxPos);
+        v3 Scale = V3(RandomNextRange(Series, 0.5f, 2.5f), RandomNextRange(Series, 0.5f, 2.5f), 0.05f);
+        v3 Tint = RandomNextV3Range(Series, V3(0.2f), V3(1));
+        f32 Alpha = RandomNextRange(Series, 0.2f, 0.6f);
+        SceneTransparentInstanceAdd(Scene, Mesh, M4Pos(Pos) * M4Scale(Scale), V4(Tint, Alpha));
+    }
+}
+
+//
+// NOTE: Scenarios
+//
+
+SCENARIO_POPULATE(ScenarioRoomPopulate)
+{
+    SceneGenRoom(Scene, DemoState->Sphere, DemoState->Cube);
+}
+
+SCENARIO_POPULATE(ScenarioInstanceGridPopulate)
+{
+    SceneGenInstanceGrid(Scene, Series, DemoState->Cube, V3(0, -1, 20), 24, 24, 2.0f, 0.25f, 1.0f);
+    SceneGenInstanceGrid(Scene, Series, DemoState->Sphere, V3(0, 1, 20), 16, 16, 3.0f, 0.25f, 1.0f);
+    SceneGenLightCloud(Scene, Series, V3(-24, -2, -4), V3(24, 4, 44), 1000, 1.0f, 3.0f);
+}
+
+SCENARIO_POPULATE(ScenarioLightCloudPopulate)
+{
+    SceneGenRoom(Scene, DemoState->Sphere, DemoState->Cube);
+    SceneGenLightCloud(Scene, Series, V3(-4.5f), V3(4.5f), 10000, 0.1f, 0.5f);
+}
+
+SCENARIO_POPULATE(ScenarioLightClustersPopulate)
+{
+    SceneGenRoom(Scene, DemoState->Sphere, DemoState->Cube);
+    SceneGenLightClusters(Scene, Series, V3(-4.0f), V3(4.0f), 32, 512, 0.3f, 1.0f);
+}
+
+SCENARIO_POPULATE(ScenarioDepthComplexityPopulate)
+{
+    SceneGenDepthLayers(Scene, Series, DemoState->Cube, V3(0, 0, 2), 32, 0.75f, 24);
+    SceneGenLightCloud(Scene, Series, V3(-5, -5, 0), V3(5, 5, 26), 4000, 0.25f, 1.0f);
+}
+
+SCENARIO_POPULATE(ScenarioLargeLightsPopulate)
+{
+    // NOTE: Few lights that each cover a big part of the screen, the case light volumes are meant for
+    SceneGenRoom(Scene, DemoState->Sphere, DemoState->Cube);
+    SceneGenLightCloud(Scene, Series, V3(-4.0f), V3(4.0f), 32, 3.0f, 6.0f);
+}
+
+SCENARIO_POPULATE(ScenarioTransparentPopulate)
+{
+    SceneGenRoom(Scene, DemoState->Sphere, DemoState->Cube);
+    SceneGenGlassPanes(Scene, Series, DemoState->Cube, V3(-3.5f), V3(3.5f), 64);
+    SceneGenLightCloud(Scene, Series, V3(-4.5f), V3(4.5f), 2000, 0.25f, 1.0f);
+}
+
+global benchmark_scenario BenchmarkScenarios[] =
+{
+    { "room", 1, ScenarioRoomPopulate, 240, 2, { { V3(0, 0, -4.5f), V3(0, 0, 0) }, { V3(3, 2, -3), V3(0, 0, 0) } } },
+    { "instance_grid", 2, ScenarioInstanceGridPopulate, 480, 3, { { V3(0, 6, -8), V3(0, 0, 20) }, { V3(-20, 4, 20), V3(0, 0, 20) },
+                                                                  { V3(0, 12, 48), V3(0, 0, 20) } } },
+    { "light_cloud", 3, ScenarioLightCloudPopulate, 240, 2, { { V3(0, 0, -4.5f), V3(0, 0, 0) }, { V3(-3, -2, -3), V3(0, 0, 0) } } },
+    { "light_clusters", 4, ScenarioLightClustersPopulate, 240, 2, { { V3(0, 0, -4.5f), V3(0, 0, 0) }, { V3(3, -3, -3), V3(0, 0, 0) } } },
+    { "depth_complexity", 5, ScenarioDepthComplexityPopulate, 240, 2, { { V3(0, 0, -2), V3(0, 0, 10) }, { V3(1, 1, -2), V3(0, 0, 10) } } },
+    { "large_lights", 6, ScenarioLargeLightsPopulate, 240, 2, { { V3(0, 0, -4.5f), V3(0, 0, 0) }, { V3(2, 3, -3), V3(0, 0, 0) } } },
+    { "transparent", 7, ScenarioTransparentPopulate, 240, 2, { { V3(0, 0, -4.5f), V3(0, 0, 0) }, { V3(-3, 2, -3), V3(0, 0, 0) } } },
+};
+
+inline void ScenarioPopulate(benchmark_scenario* Scenario, render_scene* Scene)
+{
+    // NOTE: Reseed every frame so that the scene is identical each frame and each run
+    random_series Series = RandomSeriesCreate(Scenario->Seed);
+    Scenario->Populate(Scene, &Series);
+}
+
+inline camera_keyframe ScenarioCameraGet(benchmark_scenario* Scenario, u32 FrameId)
+{
+    camera_keyframe Result = Scenario->KeyFrames[0];
+    if (Scenario->NumKeyFrames > 1)
+    {
+        f32 PathT = f32(FrameId % Scenario->NumFrames) / f32(Scenario->NumFrames) * f32(Scenario->NumKeyFrames);
+        u32 KeyFrameId = u32(PathT);
+        f32 T = PathT - f32(KeyFrameId);
+
+        camera_keyframe* Prev = Scenario->KeyFrames + KeyFrameId;
+        camera_keyframe* Next = Scenario->KeyFrames + ((KeyFrameId + 1) % Scenario->NumKeyFrames);
+        Result.Pos = Prev->Pos + T*(Next->Pos - Prev->Pos);
+        Result.Target = Prev->Target + T*(Next->Target - Prev->Target);
+    }
+    
+    return Result;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+/*
+
+  NOTE: Deterministic scene generation. Everything random in here goes through a random_series seeded by the caller, so the same seed
+        always generates the same scene no matter the platform or what else consumed random numbers before.
+  
+ */
+
+struct random_series
+{
+    u32 State;
+};
+
+//
+// NOTE: Scenarios
+//
+
+struct render_scene;
+
+#define SCENARIO_POPULATE(name) void name(render_scene* Scene, random_series* Series)
+typedef SCENARIO_POPULATE(scenario_populate);
+
+struct camera_keyframe
+{
+    v3 Pos;
+    v3 Target;
+};
+
+struct benchmark_scenario
+{
+    const char* Name;
+    u32 Seed;
+    scenario_populate* Populate;
+
+    // NOTE: Camera path is walked linearly over NumFrames, looping back to the first keyframe at the end
+    u32 NumFrames;
+    u32 NumKeyFrames;
+    camera_keyframe KeyFrames[4];
+};
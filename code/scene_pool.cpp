@@ -0,0 +1,245 @@
+//
+// NOTE: Chunked Array
+//
+
+inline void ChunkedArrayCreate(chunked_array* Array, u32 Stride)
+{
+    *Array = {};
+    Array->Stride = Stride;
+}
+
+inline u32 ChunkedArrayCapacity(chunked_array* Array)
+{
+    u32 Result = Array->NumChunks << SCENE_POOL_CHUNK_SHIFT;
+    return Result;
+}
+
+inline void ChunkedArrayReserve(chunked_array* Array, linear_arena* Arena, u32 Count)
+{
+    // NOTE: New chunks come zeroed, so users can tell entries that were never written apart
+    while (ChunkedArrayCapacity(Array) < Count)
+    {
+        Assert(Array->NumChunks < SCENE_POOL_MAX_CHUNKS);
+        u64 ChunkSize = u64(Array->Stride) * SCENE_POOL_CHUNK_SIZE;
+        u8* Chunk = PushArray(Arena, u8, ChunkSize);
+        for (u64 ByteId = 0; ByteId < ChunkSize; ++ByteId)
+        {
+            Chunk[ByteId] = 0;
+        }
+        Array->Chunks[Array->NumChunks++] = Chunk;
+    }
+}
+
+inline void* ChunkedArrayGet(chunked_array* Array, u32 Id)
+{
+    Assert((Id >> SCENE_POOL_CHUNK_SHIFT) < Array->NumChunks);
+    void* Result = Array->Chunks[Id >> SCENE_POOL_CHUNK_SHIFT] + u64(Id & (SCENE_POOL_CHUNK_SIZE - 1)) * Array->Stride;
+    return Result;
+}
+
+#define ChunkedArrayAt(Array, Type, Id) ((Type*)ChunkedArrayGet(Array, Id))
+
+//
+// NOTE: Scene Pool
+//
+
+#define SCENE_POOL_NULL_SLOT 0xFFFFFFFF
+
+inline void ScenePoolCreate(scene_pool* Pool, linear_arena* Arena, u32 ItemSize)
+{
+    *Pool = {};
+    Pool->Arena = Arena;
+    Pool->FirstFreeSlot = SCENE_POOL_NULL_SLOT;
+    ChunkedArrayCreate(&Pool->Items, ItemSize);
+    ChunkedArrayCreate(&Pool->DenseSlotIds, sizeof(u32));
+    ChunkedArrayCreate(&Pool->Slots, sizeof(scene_pool_slot));
+}
+
+inline scene_pool_slot* ScenePoolSlotGet(scene_pool* Pool, scene_handle Handle)
+{
+    scene_pool_slot* Result = 0;
+    if (Handle.SlotId < Pool->NumSlots)
+    {
+        scene_pool_slot* Slot = ChunkedArrayAt(&Pool->Slots, scene_pool_slot, Handle.SlotId);
+        if (Slot->Generation == Handle.Generation)
+        {
+            Result = Slot;
+        }
+    }
+
+    return Result;
+}
+
+inline void ScenePoolSlotFree(scene_pool* Pool, u32 SlotId)
+{
+    // NOTE: Bumping the generation here already invalidates every handle to the slot while it sits in the free list
+    scene_pool_slot* Slot = ChunkedArrayAt(&Pool->Slots, scene_pool_slot, SlotId);
+    Slot->Generation = Slot->Generation == 0xFFFFFFFF ? 1 : Slot->Generation + 1;
+    Slot->DenseId = Pool->FirstFreeSlot;
+    Pool->FirstFreeSlot = SlotId;
+}
+
+inline void* ScenePoolAdd_(scene_pool* Pool, scene_handle* Handle)
+{
+    u32 SlotId = Pool->FirstFreeSlot;
+    scene_pool_slot* Slot = 0;
+    if (SlotId != SCENE_POOL_NULL_SLOT)
+    {
+        Slot = ChunkedArrayAt(&Pool->Slots, scene_pool_slot, SlotId);
+        Pool->FirstFreeSlot = Slot->DenseId;
+    }
+    else
+    {
+        SlotId = Pool->NumSlots++;
+        ChunkedArrayReserve(&Pool->Slots, Pool->Arena, Pool->NumSlots);
+        Slot = ChunkedArrayAt(&Pool->Slots, scene_pool_slot, SlotId);
+        Slot->Generation = 1;
+    }
+
+    u32 DenseId = Pool->NumItems++;
+    ChunkedArrayReserve(&Pool->Items, Pool->Arena, Pool->NumItems);
+    ChunkedArrayReserve(&Pool->DenseSlotIds, Pool->Arena, Pool->NumItems);
+    *ChunkedArrayAt(&Pool->DenseSlotIds, u32, DenseId) = SlotId;
+    Slot->DenseId = DenseId;
+
+    if (Handle)
+    {
+        Handle->SlotId = SlotId;
+        Handle->Generation = Slot->Generation;
+    }
+
+    void* Result = ChunkedArrayGet(&Pool->Items, DenseId);
+    return Result;
+}
+
+inline void ScenePoolRemove(scene_pool* Pool, scene_handle Handle)
+{
+    scene_pool_slot* Slot = ScenePoolSlotGet(Pool, Handle);
+    Assert(Slot);
+
+    // NOTE: The last item moves into the hole so the items stay dense
+    u32 LastDenseId = --Pool->NumItems;
+    if (Slot->DenseId != LastDenseId)
+    {
+        Copy(ChunkedArrayGet(&Pool->Items, LastDenseId), ChunkedArrayGet(&Pool->Items, Slot->DenseId), Pool->Items.Stride);
+        u32 LastSlotId = *ChunkedArrayAt(&Pool->DenseSlotIds, u32, LastDenseId);
+        *ChunkedArrayAt(&Pool->DenseSlotIds, u32, Slot->DenseId) = LastSlotId;
+        ChunkedArrayAt(&Pool->Slots, scene_pool_slot, LastSlotId)->DenseId = Slot->DenseId;
+    }
+
+    ScenePoolSlotFree(Pool, Handle.SlotId);
+}
+
+inline void ScenePoolClear(scene_pool* Pool)
+{
+    for (u32 DenseId = 0; DenseId < Pool->NumItems; ++DenseId)
+    {
+        ScenePoolSlotFree(Pool, *ChunkedArrayAt(&Pool->DenseSlotIds, u32, DenseId));
+    }
+    Pool->NumItems = 0;
+}
+
+inline void* ScenePoolGet_(scene_pool* Pool, scene_handle Handle)
+{
+    // NOTE: Stale handles resolve to null
+    void* Result = 0;
+    scene_pool_slot* Slot = ScenePoolSlotGet(Pool, Handle);
+    if (Slot)
+    {
+        Result = ChunkedArrayGet(&Pool->Items, Slot->DenseId);
+    }
+
+    return Result;
+}
+
+inline void* ScenePoolAt_(scene_pool* Pool, u32 DenseId)
+{
+    Assert(DenseId < Pool->NumItems);
+    void* Result = ChunkedArrayGet(&Pool->Items, DenseId);
+    return Result;
+}
+
+inline scene_handle ScenePoolHandleGet(scene_pool* Pool, u32 DenseId)
+{
+    Assert(DenseId < Pool->NumItems);
+    scene_handle Result = {};
+    Result.SlotId = *ChunkedArrayAt(&Pool->DenseSlotIds, u32, DenseId);
+    Result.Generation = ChunkedArrayAt(&Pool->Slots, scene_pool_slot, Result.SlotId)->Generation;
+    return Result;
+}
+
+inline b32 SceneHandleEqual(scene_handle A, scene_handle B)
+{
+    b32 Result = A.SlotId == B.SlotId && A.Generation == B.Generation;
+    return Result;
+}
+
+#define ScenePoolAdd(Pool, Type, Handle) ((Type*)ScenePoolAdd_(Pool, Handle))
+#define ScenePoolGet(Pool, Type, Handle) ((Type*)ScenePoolGet_(Pool, Handle))
+#define ScenePoolAt(Pool, Type, DenseId) ((Type*)ScenePoolAt_(Pool, DenseId))
+
+//
+// NOTE: Scene Accessors
+//
+
+inline render_mesh* SceneMeshGet(render_scene* Scene, scene_handle MeshHandle)
+{
+    render_mesh* Result = ScenePoolGet(&Scene->RenderMeshes, render_mesh, MeshHandle);
+    Assert(Result);
+    return Result;
+}
+
+inline instance_entry* SceneOpaqueInstanceAt(render_scene* Scene, u32 InstanceId)
+{
+    instance_entry* Result = ScenePoolAt(&Scene->OpaqueInstances, instance_entry, InstanceId);
+    return Result;
+}
+
+inline transparent_instance_entry* SceneTransparentInstanceAt(render_scene* Scene, u32 InstanceId)
+{
+    transparent_instance_entry* Result = ScenePoolAt(&Scene->TransparentInstances, transparent_instance_entry, InstanceId);
+    return Result;
+}
+
+inline point_light* ScenePointLightAt(render_scene* Scene, u32 LightId)
+{
+    point_light* Result = ScenePoolAt(&Scene->PointLights, point_light, LightId);
+    return Result;
+}
+
+//
+// NOTE: Growable Buffer
+//
+
+inline void GrowableBufferCreate(growable_buffer* Result, const char* Tag, VkBufferUsageFlags Usage, u64 Stride, u32 Capacity)
+{
+    *Result = {};
+    Result->Usage = Usage;
+    Result->Stride = Stride;
+    Result->Capacity = Max(Capacity, u32(GROWABLE_BUFFER_MIN_CAPACITY));
+    Result->Buffer = TaggedBufferCreate(Tag, &RenderState->GpuArena, Usage, Stride * Result->Capacity);
+    Result->TagId = MemoryStatsTagIdGet(&DemoState->MemoryStats, MemoryStatsArenaFind(&DemoState->MemoryStats, &RenderState->GpuArena.Used),
+                                        Tag);
+}
+
+inline b32 GrowableBufferReserve(growable_buffer* Buffer, u32 Count)
+{
+    // IMPORTANT: Call after the previous frames fence wait and before this frame references the buffer. Returns true when the buffer
+    // got replaced, its descriptors have to be written again then
+    b32 Result = Count > Buffer->Capacity;
+    if (Result)
+    {
+        u32 Capacity = Buffer->Capacity;
+        while (Capacity < Count)
+        {
+            Capacity *= 2;
+        }
+
+        DeletionQueueBufferPush(&DemoState->DeletionQueue, Buffer->Buffer);
+        Buffer->Capacity = Capacity;
+        Buffer->Buffer = TaggedBufferCreate(DemoState->MemoryStats.Tags[Buffer->TagId].Name, &RenderState->GpuArena, Buffer->Usage,
+                                            Buffer->Stride * Capacity);
+    }
+
+    return Result;
+}
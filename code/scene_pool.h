@@ -0,0 +1,68 @@
+#pragma once
+
+/*
+
+  NOTE: Scene pools. Meshes, instances and lights live in pools instead of fixed size arrays, so a scene can hold as many as it needs
+        without reserving the worst case up front:
+
+    - Items are packed densely, so uploads and draws iterate them in order without skipping holes. Removing an item moves the last
+      one into its place, which makes dense ids (and pointers to the last item) only valid until the next remove.
+    - Everything that has to keep referring to an item holds a handle instead. A handle is a slot id plus the generation of that slot,
+      the slot knows where its item currently sits. Removing an item bumps the slot generation before the slot gets reused, so stale
+      handles resolve to nothing instead of to whatever took the slot. Generation 0 is never used, so a zeroed handle is null.
+    - Storage grows a chunk of SCENE_POOL_CHUNK_SIZE items at a time out of the arena the pool was created with. Chunks never move
+      and never get freed, the pool keeps its high water mark. Add, remove and lookups are O(1).
+
+        Scenes that get rebuilt every frame clear their pools, which invalidates every handle into them.
+
+        The GPU copies of the pools are growable buffers. Once a frame needs more than a buffer holds, the buffer gets recreated at
+        twice the size and the old one goes through the deletion queue. GPU arenas are linear, so the old memory stays allocated,
+        doubling keeps that below the size of the current buffer. Whoever binds the buffer has to write its descriptors again when
+        GrowableBufferReserve returns true.
+
+ */
+
+#define SCENE_POOL_CHUNK_SHIFT 12
+#define SCENE_POOL_CHUNK_SIZE (1 << SCENE_POOL_CHUNK_SHIFT)
+#define SCENE_POOL_MAX_CHUNKS 4096
+#define GROWABLE_BUFFER_MIN_CAPACITY 1024
+
+struct scene_handle
+{
+    u32 SlotId;
+    u32 Generation;
+};
+
+struct chunked_array
+{
+    u32 Stride;
+    u32 NumChunks;
+    u8* Chunks[SCENE_POOL_MAX_CHUNKS];
+};
+
+struct scene_pool_slot
+{
+    u32 DenseId; // NOTE: Next free slot while the slot is free
+    u32 Generation;
+};
+
+struct scene_pool
+{
+    linear_arena* Arena;
+    u32 NumItems;
+    chunked_array Items;
+    chunked_array DenseSlotIds;
+
+    u32 NumSlots;
+    u32 FirstFreeSlot;
+    chunked_array Slots;
+};
+
+struct growable_buffer
+{
+    u32 TagId; // NOTE: Index into the memory stats tags, the name passed at create lives in the DLL and doesn't survive a code reload
+    VkBufferUsageFlags Usage;
+    u64 Stride;
+    u32 Capacity;
+    VkBuffer Buffer;
+};
@@ -7,8 +7,14 @@ layout(location = 0) in vec2 InUv;
 layout(location = 0) out vec4 OutColor;
 
 layout(set = 0, binding = 0) uniform sampler2D ColorTexture;
+layout(set = 0, binding = 1) uniform copy_to_swap_globals
+{
+    vec2 UvScale;
+    vec2 UvMax;
+};
 
 void main()
 {
-    OutColor = texture(ColorTexture, InUv);
+    // NOTE: The renderer may have only filled part of its output (dynamic resolution), bilinear filtering upscales it
+    OutColor = texture(ColorTexture, min(InUv * UvScale, UvMax));
 }
@@ -7,16 +7,36 @@
     layout(set = set_number, binding = 0) uniform sampler2D ColorTexture; \
     layout(set = set_number, binding = 1) uniform sampler2D NormalTexture; \
 
+// NOTE: Has to match the host define
+#define MAX_BINDLESS_MATERIALS 64
+
+#define BINDLESS_MATERIAL_DESCRIPTOR_LAYOUT(set_number)                 \
+    layout(set = set_number, binding = 0) uniform sampler2D ColorTextures[MAX_BINDLESS_MATERIALS]; \
+    layout(set = set_number, binding = 1) uniform sampler2D NormalTextures[MAX_BINDLESS_MATERIALS]; \
+
 //
 // NOTE: Scene
 //
 
 #include "shader_light_types.cpp"
 
+#define LIGHT_GROUP_SIZE 64
+
 struct instance_entry
 {
     mat4 WTransform;
     mat4 WVPTransform;
+    vec3 PosScale; // NOTE: Dequantization for quantized vertex streams
+    uint MaterialId;
+    vec3 PosBias;
+    uint Pad;
+};
+
+struct transparent_instance_entry
+{
+    mat4 WTransform;
+    mat4 WVPTransform;
+    vec4 Color;
 };
 
 #define SCENE_DESCRIPTOR_LAYOUT(set_number)                             \
@@ -24,6 +44,7 @@ struct instance_entry
     {                                                                   \
         vec3 CameraPos;                                                 \
         uint NumPointLights;                                            \
+        mat4 VTransform;                                                \
     } SceneBuffer;                                                      \
                                                                         \
     layout(set = set_number, binding = 1) buffer instance_buffer        \
@@ -45,13 +66,38 @@ struct instance_entry
     {                                                                   \
         mat4 PointLightTransforms[];                                    \
     };                                                                  \
+                                                                        \
+    layout(set = set_number, binding = 5) buffer point_light_group_bounds \
+    {                                                                   \
+        vec4 PointLightGroupBounds[];                                   \
+    };                                                                  \
+                                                                        \
+    layout(set = set_number, binding = 6) buffer transparent_instance_buffer \
+    {                                                                   \
+        transparent_instance_entry TransparentInstanceBuffer[];         \
+    };                                                                  \
 
 
 //
 // NOTE: Tiled Deferred Globals
 //
 
-#define TILE_DIM_IN_PIXELS 8
+#define DEBUG_VIEW_LIT 0
+#define DEBUG_VIEW_AO 1
+#define DEBUG_VIEW_LIGHT_HEAT_MAP_OPAQUE 2
+#define DEBUG_VIEW_LIGHT_HEAT_MAP_TRANSPARENT 3
+
+// NOTE: Has to match tiled_deferred.h
+#define LIGHT_LIST_MODE_INDEX_LIST 0
+#define LIGHT_LIST_MODE_BIT_MASK 1
+#define TILED_BIT_MASK_MAX_LIGHTS 4096
+#define TILED_BIT_MASK_WORDS_PER_TILE (TILED_BIT_MASK_MAX_LIGHTS / 32)
+#define ZBIN_COUNT 1024
+#define LIGHT_TEST_MODE_FRUSTUM 0
+#define LIGHT_TEST_MODE_AABB 1
+#define LIGHT_TEST_MODE_AABB_CONE 2
+#define TILED_COARSE_TILE_SIZE 32
+#define TILED_COARSE_MAX_LIGHTS_PER_TILE 4096
 
 struct plane
 {
@@ -103,6 +149,24 @@ bool SphereInsideFrustum(vec3 SphereCenter, float SphereRadius, frustum Frustum,
     return Result;
 }
 
+bool SphereInsideAabb(vec3 SphereCenter, float SphereRadius, vec3 AabbMin, vec3 AabbMax)
+{
+    // NOTE: Distance from the center to the closest point of the box
+    vec3 Delta = SphereCenter - clamp(SphereCenter, AabbMin, AabbMax);
+    bool Result = dot(Delta, Delta) <= SphereRadius * SphereRadius;
+    return Result;
+}
+
+bool SphereInsideCone(vec3 SphereCenter, float SphereRadius, vec3 ConeAxis, float ConeCos, float ConeSin)
+{
+    // NOTE: The apex is at the camera. This is the distance to the line on the cones surface closest to the center, for centers behind
+    // the apex it is less than the real distance so we never cull too much
+    float AxisDist = dot(SphereCenter, ConeAxis);
+    float PerpDist = sqrt(max(dot(SphereCenter, SphereCenter) - AxisDist * AxisDist, 0.0f));
+    bool Result = ConeCos * PerpDist - ConeSin * AxisDist <= SphereRadius;
+    return Result;
+}
+
 vec4 ClipToView(mat4 InverseProjection, vec4 ClipPos)
 {
     vec4 Result = InverseProjection * ClipPos;
@@ -110,6 +174,23 @@ vec4 ClipToView(mat4 InverseProjection, vec4 ClipPos)
     return Result;
 }
 
+uvec2 ZBinUnpack(uint ZBin)
+{
+    // NOTE: Returns the min and max light id in the bin, empty bins have min > max
+    uvec2 Result = uvec2(ZBin & 0xFFFFu, ZBin >> 16);
+    return Result;
+}
+
+uint ZBinWordMask(uvec2 ZBinRange, uint WordId)
+{
+    // NOTE: Bits of the given mask word whose lights fall inside the z-bin range
+    uint FirstLightId = WordId * 32;
+    uint FirstBit = max(ZBinRange.x, FirstLightId) - FirstLightId;
+    uint LastBit = min(ZBinRange.y, FirstLightId + 31) - FirstLightId;
+    uint Result = (0xFFFFFFFFu << FirstBit) & (0xFFFFFFFFu >> (31 - LastBit));
+    return Result;
+}
+
 vec4 ScreenToView(mat4 InverseProjection, vec2 ScreenSize, vec4 ScreenPos)
 {
     vec2 Ndc = 2.0f * (ScreenPos.xy / ScreenSize) - vec2(1.0f);
@@ -123,6 +204,15 @@ vec4 ScreenToView(mat4 InverseProjection, vec2 ScreenSize, vec4 ScreenPos)
         mat4 InverseProjection;                                         \
         vec2 ScreenSize;                                                \
         uvec2 GridSize;                                                 \
+        uint LightIndexListCapacity;                                    \
+        uint DebugViewMode;                                             \
+        uint TileSize;                                                  \
+        uint MaxLightsPerTile;                                          \
+        uint LightListMode;                                             \
+        float ZBinScale;                                                \
+        uint LightTestMode;                                             \
+        uint CoarseCulling;                                             \
+        uint CoarseGridSizeX;                                           \
     };                                                                  \
                                                                         \
     layout(set = set_number, binding = 1) buffer grid_frustums          \
@@ -155,5 +245,29 @@ vec4 ScreenToView(mat4 InverseProjection, vec2 ScreenSize, vec4 ScreenPos)
     layout(set = set_number, binding = 10) uniform sampler2D GBufferColorTexture; \
     layout(set = set_number, binding = 11) uniform sampler2D GBufferDepthTexture; \
     layout(set = set_number, binding = 12) uniform sampler2D SsaoTexture; \
+                                                                        \
+    layout(set = set_number, binding = 13) buffer light_bit_mask_opaque \
+    {                                                                   \
+        uint LightBitMask_O[];                                          \
+    };                                                                  \
+    layout(set = set_number, binding = 14) buffer light_bit_mask_transparent \
+    {                                                                   \
+        uint LightBitMask_T[];                                          \
+    };                                                                  \
+    layout(set = set_number, binding = 15) buffer z_bins                \
+    {                                                                   \
+        uint ZBins[ZBIN_COUNT];                                         \
+    };                                                                  \
+                                                                        \
+    layout(set = set_number, binding = 16, rgba16f) uniform writeonly image2D FusedOutColor; \
+                                                                        \
+    layout(set = set_number, binding = 17) buffer coarse_light_counts   \
+    {                                                                   \
+        uint CoarseLightCounts[];                                       \
+    };                                                                  \
+    layout(set = set_number, binding = 18) buffer coarse_light_index_list \
+    {                                                                   \
+        uint CoarseLightIndexList[];                                    \
+    };                                                                  \
 
 
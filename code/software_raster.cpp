@@ -0,0 +1,846 @@
+
+//
+// NOTE: Threading
+//
+
+struct software_raster_job
+{
+    software_raster* Raster;
+    u32 ThreadId;
+};
+
+inline void SoftwareRasterWork(software_raster* Raster, u32 ThreadId);
+
+DWORD WINAPI SoftwareRasterThreadProc(LPVOID Param)
+{
+    software_raster_job* Job = (software_raster_job*)Param;
+    SoftwareRasterWork(Job->Raster, Job->ThreadId);
+    return 0;
+}
+
+inline void SoftwareRasterPhaseRun(software_raster* Raster, software_raster_phase Phase)
+{
+    // NOTE: Threads only live for one phase. Creating them is a few us per phase, which is noise next to the work they do
+    Raster->Phase = Phase;
+    Raster->NextTileId = 0;
+
+    software_raster_job Jobs[SOFTWARE_RASTER_MAX_THREADS] = {};
+    HANDLE Handles[SOFTWARE_RASTER_MAX_THREADS] = {};
+    for (u32 ThreadId = 1; ThreadId < Raster->NumThreads; ++ThreadId)
+    {
+        Jobs[ThreadId].Raster = Raster;
+        Jobs[ThreadId].ThreadId = ThreadId;
+        Handles[ThreadId] = CreateThread(0, 0, SoftwareRasterThreadProc, Jobs + ThreadId, 0, 0);
+        Assert(Handles[ThreadId]);
+    }
+
+    SoftwareRasterWork(Raster, 0);
+
+    if (Raster->NumThreads > 1)
+    {
+        WaitForMultipleObjects(Raster->NumThreads - 1, Handles + 1, TRUE, INFINITE);
+        for (u32 ThreadId = 1; ThreadId < Raster->NumThreads; ++ThreadId)
+        {
+            CloseHandle(Handles[ThreadId]);
+        }
+    }
+}
+
+inline b32 SoftwareRasterTileGet(software_raster* Raster, u32* TileId)
+{
+    *TileId = u32(InterlockedIncrement(&Raster->NextTileId) - 1);
+    b32 Result = *TileId < Raster->NumTiles;
+    return Result;
+}
+
+//
+// NOTE: Setup
+//
+
+struct software_raster_clip_vertex
+{
+    v4 Pos;
+    v2 SourceBary;
+};
+
+inline software_raster_clip_vertex SoftwareRasterClipLerp(software_raster_clip_vertex A, software_raster_clip_vertex B, f32 T)
+{
+    software_raster_clip_vertex Result = {};
+    Result.Pos = A.Pos + T * (B.Pos - A.Pos);
+    Result.SourceBary = A.SourceBary + T * (B.SourceBary - A.SourceBary);
+    return Result;
+}
+
+inline void SoftwareRasterTriangleAdd(software_raster* Raster, software_raster_thread* Thread, u32 InstanceId, u32 IndexId,
+                                      software_raster_clip_vertex V0, software_raster_clip_vertex V1, software_raster_clip_vertex V2)
+{
+    software_raster_clip_vertex Vertices[3] = { V0, V1, V2 };
+    software_raster_triangle Triangle = {};
+    Triangle.InstanceId = InstanceId;
+    Triangle.IndexId = IndexId;
+
+    v2 MinPos = {};
+    v2 MaxPos = {};
+    for (u32 VertexId = 0; VertexId < 3; ++VertexId)
+    {
+        v4 Pos = Vertices[VertexId].Pos;
+        f32 InvW = 1.0f / Pos.w;
+        Triangle.ScreenPos[VertexId] = V2((0.5f * Pos.x * InvW + 0.5f) * f32(Raster->Width), (0.5f * Pos.y * InvW + 0.5f) * f32(Raster->Height));
+        Triangle.Depth[VertexId] = Pos.z * InvW;
+        Triangle.InvW[VertexId] = InvW;
+        Triangle.SourceBary[VertexId] = Vertices[VertexId].SourceBary;
+
+        v2 ScreenPos = Triangle.ScreenPos[VertexId];
+        MinPos = VertexId == 0 ? ScreenPos : V2(Min(MinPos.x, ScreenPos.x), Min(MinPos.y, ScreenPos.y));
+        MaxPos = VertexId == 0 ? ScreenPos : V2(Max(MaxPos.x, ScreenPos.x), Max(MaxPos.y, ScreenPos.y));
+    }
+
+    // NOTE: Keep one winding so the edge functions are positive inside, we don't cull either side
+    v2 Edge0 = Triangle.ScreenPos[1] - Triangle.ScreenPos[0];
+    v2 Edge1 = Triangle.ScreenPos[2] - Triangle.ScreenPos[0];
+    f32 Area = Edge0.x * Edge1.y - Edge0.y * Edge1.x;
+    if (Area == 0.0f)
+    {
+        return;
+    }
+    else if (Area < 0.0f)
+    {
+        SoftwareRasterTriangleAdd(Raster, Thread, InstanceId, IndexId, V0, V2, V1);
+        return;
+    }
+
+    // NOTE: Pixels whose center is inside the bounds, anything that covers no center can't produce a fragment
+    f32 MinPixelX = Max(ceilf(MinPos.x - 0.5f), 0.0f);
+    f32 MinPixelY = Max(ceilf(MinPos.y - 0.5f), 0.0f);
+    f32 MaxPixelX = Min(floorf(MaxPos.x - 0.5f), f32(Raster->Width - 1));
+    f32 MaxPixelY = Min(floorf(MaxPos.y - 0.5f), f32(Raster->Height - 1));
+    if (MinPixelX > MaxPixelX || MinPixelY > MaxPixelY)
+    {
+        return;
+    }
+    Triangle.MinX = u32(MinPixelX);
+    Triangle.MinY = u32(MinPixelY);
+    Triangle.MaxX = u32(MaxPixelX);
+    Triangle.MaxY = u32(MaxPixelY);
+
+    Assert(Thread->NumTriangles < Thread->MaxNumTriangles);
+    Thread->Triangles[Thread->NumTriangles++] = Triangle;
+
+    for (u32 TileY = Triangle.MinY / SOFTWARE_RASTER_TILE_SIZE; TileY <= Triangle.MaxY / SOFTWARE_RASTER_TILE_SIZE; ++TileY)
+    {
+        for (u32 TileX = Triangle.MinX / SOFTWARE_RASTER_TILE_SIZE; TileX <= Triangle.MaxX / SOFTWARE_RASTER_TILE_SIZE; ++TileX)
+        {
+            Thread->TileCounts[TileY * Raster->NumTilesX + TileX] += 1;
+        }
+    }
+}
+
+inline void SoftwareRasterSetup(software_raster* Raster, u32 ThreadId)
+{
+    software_raster_thread* Thread = Raster->Threads + ThreadId;
+    render_scene* Scene = Raster->Scene;
+    for (u32 TileId = 0; TileId < Raster->NumTiles; ++TileId)
+    {
+        Thread->TileCounts[TileId] = 0;
+    }
+
+    u32 FirstInstanceId = Scene->OpaqueInstances.NumItems * ThreadId / Raster->NumThreads;
+    u32 LastInstanceId = Scene->OpaqueInstances.NumItems * (ThreadId + 1) / Raster->NumThreads;
+    for (u32 InstanceId = FirstInstanceId; InstanceId < LastInstanceId; ++InstanceId)
+    {
+        instance_entry* Instance = SceneOpaqueInstanceAt(Scene, InstanceId);
+        cpu_mesh* Mesh = SceneMeshGet(Scene, Instance->Mesh)->CpuMesh;
+        if (!Mesh)
+        {
+            Thread->NumSkippedInstances += 1;
+            continue;
+        }
+
+        for (u32 IndexId = 0; IndexId < Mesh->NumIndices; IndexId += 3)
+        {
+            software_raster_clip_vertex Vertices[3] = {};
+            Vertices[1].SourceBary = V2(1, 0);
+            Vertices[2].SourceBary = V2(0, 1);
+            u32 OutsideMask = 0x1F;
+            for (u32 VertexId = 0; VertexId < 3; ++VertexId)
+            {
+                v4 Pos = Instance->WVPTransform * V4(Mesh->Vertices[Mesh->Indices[IndexId + VertexId]].Pos, 1.0f);
+                Vertices[VertexId].Pos = Pos;
+
+                u32 VertexMask = ((Pos.x > Pos.w ? 1 : 0) | (Pos.x < -Pos.w ? 2 : 0) | (Pos.y > Pos.w ? 4 : 0) | (Pos.y < -Pos.w ? 8 : 0) |
+                                  (Pos.w < SOFTWARE_RASTER_MIN_W ? 16 : 0));
+                OutsideMask &= VertexMask;
+            }
+
+            // NOTE: All vertices outside of the same plane
+            if (OutsideMask != 0)
+            {
+                continue;
+            }
+
+            // NOTE: Clip against the near plane, one triangle can become a quad
+            software_raster_clip_vertex Clipped[4] = {};
+            u32 NumClipped = 0;
+            for (u32 VertexId = 0; VertexId < 3; ++VertexId)
+            {
+                software_raster_clip_vertex Curr = Vertices[VertexId];
+                software_raster_clip_vertex Next = Vertices[(VertexId + 1) % 3];
+                b32 CurrInside = Curr.Pos.w >= SOFTWARE_RASTER_MIN_W;
+                b32 NextInside = Next.Pos.w >= SOFTWARE_RASTER_MIN_W;
+                if (CurrInside)
+                {
+                    Clipped[NumClipped++] = Curr;
+                }
+                if (CurrInside != NextInside)
+                {
+                    f32 T = (SOFTWARE_RASTER_MIN_W - Curr.Pos.w) / (Next.Pos.w - Curr.Pos.w);
+                    Clipped[NumClipped++] = SoftwareRasterClipLerp(Curr, Next, T);
+                }
+            }
+
+            for (u32 ClippedId = 2; ClippedId < NumClipped; ++ClippedId)
+            {
+                SoftwareRasterTriangleAdd(Raster, Thread, InstanceId, IndexId, Clipped[0], Clipped[ClippedId - 1], Clipped[ClippedId]);
+            }
+        }
+    }
+}
+
+//
+// NOTE: Binning
+//
+
+inline void SoftwareRasterBin(software_raster* Raster, u32 ThreadId)
+{
+    // NOTE: Tile counts become write cursors here and end up as counts again
+    software_raster_thread* Thread = Raster->Threads + ThreadId;
+    for (u32 TileId = 0; TileId < Raster->NumTiles; ++TileId)
+    {
+        Thread->TileCounts[TileId] = 0;
+    }
+
+    for (u32 TriangleId = 0; TriangleId < Thread->NumTriangles; ++TriangleId)
+    {
+        software_raster_triangle* Triangle = Thread->Triangles + TriangleId;
+        for (u32 TileY = Triangle->MinY / SOFTWARE_RASTER_TILE_SIZE; TileY <= Triangle->MaxY / SOFTWARE_RASTER_TILE_SIZE; ++TileY)
+        {
+            for (u32 TileX = Triangle->MinX / SOFTWARE_RASTER_TILE_SIZE; TileX <= Triangle->MaxX / SOFTWARE_RASTER_TILE_SIZE; ++TileX)
+            {
+                u32 TileId = TileY * Raster->NumTilesX + TileX;
+                Thread->Bins[Thread->TileOffsets[TileId] + Thread->TileCounts[TileId]++] = TriangleId;
+            }
+        }
+    }
+}
+
+//
+// NOTE: Raster
+//
+
+inline f32 SoftwareRasterEdge(v2 A, v2 B, v2 P)
+{
+    f32 Result = (B.x - A.x) * (P.y - A.y) - (B.y - A.y) * (P.x - A.x);
+    return Result;
+}
+
+inline b32 SoftwareRasterEdgeTopLeft(v2 A, v2 B)
+{
+    // NOTE: With y pointing down and our winding, top edges go right and left edges go up
+    v2 Delta = B - A;
+    b32 Result = (Delta.y == 0.0f && Delta.x > 0.0f) || Delta.y < 0.0f;
+    return Result;
+}
+
+inline b32 SoftwareRasterInside(f32 Edge, b32 TopLeft)
+{
+    b32 Result = Edge > 0.0f || (Edge == 0.0f && TopLeft);
+    return Result;
+}
+
+inline v3 SoftwareRasterBarycentrics(software_raster_triangle* Triangle, v2 PixelPos)
+{
+    // NOTE: Screen space weights, the caller decides if it needs them perspective correct
+    v2* Pos = Triangle->ScreenPos;
+    f32 InvArea = 1.0f / SoftwareRasterEdge(Pos[0], Pos[1], Pos[2]);
+    v3 Result = V3(SoftwareRasterEdge(Pos[1], Pos[2], PixelPos) * InvArea, SoftwareRasterEdge(Pos[2], Pos[0], PixelPos) * InvArea,
+                   SoftwareRasterEdge(Pos[0], Pos[1], PixelPos) * InvArea);
+    return Result;
+}
+
+inline v4 SoftwareTextureSample(software_texture* Texture, v2 Uv)
+{
+    i32 X = Min(Max(i32(floorf(Uv.x * f32(Texture->Width))), 0), i32(Texture->Width) - 1);
+    i32 Y = Min(Max(i32(floorf(Uv.y * f32(Texture->Height))), 0), i32(Texture->Height) - 1);
+    u32 Texel = Texture->Texels[Y * Texture->Width + X];
+
+    v4 Result = V4(f32((Texel >> 0) & 0xFF), f32((Texel >> 8) & 0xFF), f32((Texel >> 16) & 0xFF), f32((Texel >> 24) & 0xFF)) / 255.0f;
+    return Result;
+}
+
+inline void SoftwareRasterTileRect(software_raster* Raster, u32 TileId, u32* MinX, u32* MinY, u32* EndX, u32* EndY)
+{
+    *MinX = (TileId % Raster->NumTilesX) * SOFTWARE_RASTER_TILE_SIZE;
+    *MinY = (TileId / Raster->NumTilesX) * SOFTWARE_RASTER_TILE_SIZE;
+    *EndX = Min(*MinX + SOFTWARE_RASTER_TILE_SIZE, Raster->Width);
+    *EndY = Min(*MinY + SOFTWARE_RASTER_TILE_SIZE, Raster->Height);
+}
+
+inline void SoftwareRasterTileRaster(software_raster* Raster, software_raster_thread* Thread, u32 TileId)
+{
+    u32 TileMinX, TileMinY, TileEndX, TileEndY;
+    SoftwareRasterTileRect(Raster, TileId, &TileMinX, &TileMinY, &TileEndX, &TileEndY);
+
+    for (u32 Y = TileMinY; Y < TileEndY; ++Y)
+    {
+        for (u32 X = TileMinX; X < TileEndX; ++X)
+        {
+            Raster->Depth[Y * Raster->Width + X] = 0.0f;
+            Raster->Visibility[Y * Raster->Width + X] = 0xFFFFFFFF;
+        }
+    }
+
+    // NOTE: Depth pass into the visibility buffer, threads in order keeps the submission order
+    for (u32 BinThreadId = 0; BinThreadId < Raster->NumThreads; ++BinThreadId)
+    {
+        software_raster_thread* BinThread = Raster->Threads + BinThreadId;
+        u32* Bin = BinThread->Bins + BinThread->TileOffsets[TileId];
+        for (u32 EntryId = 0; EntryId < BinThread->TileCounts[TileId]; ++EntryId)
+        {
+            software_raster_triangle* Triangle = BinThread->Triangles + Bin[EntryId];
+            v2* Pos = Triangle->ScreenPos;
+            f32 InvArea = 1.0f / SoftwareRasterEdge(Pos[0], Pos[1], Pos[2]);
+            b32 TopLeft0 = SoftwareRasterEdgeTopLeft(Pos[1], Pos[2]);
+            b32 TopLeft1 = SoftwareRasterEdgeTopLeft(Pos[2], Pos[0]);
+            b32 TopLeft2 = SoftwareRasterEdgeTopLeft(Pos[0], Pos[1]);
+            u32 VisibilityId = BinThread->TriangleOffset + Bin[EntryId];
+
+            u32 MinX = Max(Triangle->MinX, TileMinX);
+            u32 MinY = Max(Triangle->MinY, TileMinY);
+            u32 EndX = Min(Triangle->MaxX + 1, TileEndX);
+            u32 EndY = Min(Triangle->MaxY + 1, TileEndY);
+            for (u32 Y = MinY; Y < EndY; ++Y)
+            {
+                for (u32 X = MinX; X < EndX; ++X)
+                {
+                    v2 PixelPos = V2(f32(X) + 0.5f, f32(Y) + 0.5f);
+                    f32 Edge0 = SoftwareRasterEdge(Pos[1], Pos[2], PixelPos);
+                    f32 Edge1 = SoftwareRasterEdge(Pos[2], Pos[0], PixelPos);
+                    f32 Edge2 = SoftwareRasterEdge(Pos[0], Pos[1], PixelPos);
+                    if (!SoftwareRasterInside(Edge0, TopLeft0) || !SoftwareRasterInside(Edge1, TopLeft1) ||
+                        !SoftwareRasterInside(Edge2, TopLeft2))
+                    {
+                        continue;
+                    }
+
+                    // NOTE: z/w is linear in screen space. Reversed z, and anything past the far plane gets clipped
+                    f32 Depth = (Edge0 * Triangle->Depth[0] + Edge1 * Triangle->Depth[1] + Edge2 * Triangle->Depth[2]) * InvArea;
+                    u32 PixelId = Y * Raster->Width + X;
+                    if (Depth > Raster->Depth[PixelId] && Depth <= 1.0f)
+                    {
+                        Raster->Depth[PixelId] = Depth;
+                        Raster->Visibility[PixelId] = VisibilityId;
+                    }
+                }
+            }
+        }
+    }
+
+    // NOTE: Resolve the GBuffer, this is GBUFFER_VERT + GBUFFER_FRAG for the pixels that survived
+    render_scene* Scene = Raster->Scene;
+    for (u32 Y = TileMinY; Y < TileEndY; ++Y)
+    {
+        for (u32 X = TileMinX; X < TileEndX; ++X)
+        {
+            u32 PixelId = Y * Raster->Width + X;
+            if (Raster->Visibility[PixelId] == 0xFFFFFFFF)
+            {
+                Raster->Position[PixelId] = V4(0, 0, 0, 0);
+                Raster->Normal[PixelId] = V4(0, 0, 0, 0);
+                Raster->Color[PixelId] = V4(0, 0, 0, 0);
+                continue;
+            }
+
+            software_raster_triangle* Triangle = Raster->Triangles + Raster->Visibility[PixelId];
+            v3 Bary = SoftwareRasterBarycentrics(Triangle, V2(f32(X) + 0.5f, f32(Y) + 0.5f));
+            Bary = V3(Bary.x * Triangle->InvW[0], Bary.y * Triangle->InvW[1], Bary.z * Triangle->InvW[2]);
+            Bary = Bary / (Bary.x + Bary.y + Bary.z);
+            v2 SourceBary = Bary.x * Triangle->SourceBary[0] + Bary.y * Triangle->SourceBary[1] + Bary.z * Triangle->SourceBary[2];
+            f32 Weights[3] = { 1.0f - SourceBary.x - SourceBary.y, SourceBary.x, SourceBary.y };
+
+            instance_entry* Instance = SceneOpaqueInstanceAt(Scene, Triangle->InstanceId);
+            render_mesh* RenderMesh = SceneMeshGet(Scene, Instance->Mesh);
+            cpu_mesh* Mesh = RenderMesh->CpuMesh;
+            v3 Pos = V3(0);
+            v3 Normal = V3(0);
+            v2 Uv = V2(0, 0);
+            for (u32 VertexId = 0; VertexId < 3; ++VertexId)
+            {
+                mesh_vertex* Vertex = Mesh->Vertices + Mesh->Indices[Triangle->IndexId + VertexId];
+                Pos += Weights[VertexId] * Vertex->Pos;
+                Normal += Weights[VertexId] * Vertex->Normal;
+                Uv += Weights[VertexId] * Vertex->Uv;
+            }
+
+            Raster->Position[PixelId] = V4((Instance->WTransform * V4(Pos, 1.0f)).xyz, 0.0f);
+            Raster->Normal[PixelId] = V4(Normalize((Instance->WTransform * V4(Normal, 0.0f)).xyz), 0.0f);
+            Raster->Color[PixelId] = RenderMesh->CpuColor ? SoftwareTextureSample(RenderMesh->CpuColor, Uv) : V4(1, 1, 1, 1);
+            Thread->NumCoveredPixels += 1;
+        }
+    }
+}
+
+//
+// NOTE: Shading
+//
+
+inline f32 SoftwareRasterSsao(software_raster* Raster, m4 VPTransform, u32 X, u32 Y)
+{
+    // NOTE: Same as STANDARD_SSAO in ssao_shader.cpp
+    f32 Radius = 0.25f;
+    f32 Bias = 0.0000001f;
+
+    u32 PixelId = Y * Raster->Width + X;
+    v3 SurfacePos = Raster->Position[PixelId].xyz;
+    v3 SurfaceNormal = Raster->Normal[PixelId].xyz;
+    v3 RandomRotation = V3(Raster->RandomRotations[(Y % 4) * 4 + (X % 4)].xy, 0.0f);
+    v3 SurfaceTangent = Normalize(RandomRotation - SurfaceNormal * Dot(RandomRotation, SurfaceNormal));
+    v3 SurfaceBiTangent = Cross(SurfaceNormal, SurfaceTangent);
+
+    v2 ScreenSize = V2(f32(Raster->Width), f32(Raster->Height));
+    f32 Result = 0.0f;
+    for (u32 SampleId = 0; SampleId < ArrayCount(Raster->HemisphereSamples); ++SampleId)
+    {
+        v3 Hemisphere = Raster->HemisphereSamples[SampleId].xyz;
+        v3 Sample = Radius * (Hemisphere.x * SurfaceTangent + Hemisphere.y * SurfaceBiTangent + Hemisphere.z * SurfaceNormal) + SurfacePos;
+        v4 ProjectedSample = VPTransform * V4(Sample, 1.0f);
+        ProjectedSample.xyz = ProjectedSample.xyz / ProjectedSample.w;
+
+        f32 SampleX = Min((0.5f * ProjectedSample.x + 0.5f) * ScreenSize.x, ScreenSize.x - 0.5f);
+        f32 SampleY = Min((0.5f * ProjectedSample.y + 0.5f) * ScreenSize.y, ScreenSize.y - 0.5f);
+        u32 SamplePixelX = u32(Max(floorf(SampleX), 0.0f));
+        u32 SamplePixelY = u32(Max(floorf(SampleY), 0.0f));
+        f32 StoredDepth = Raster->Depth[SamplePixelY * Raster->Width + SamplePixelX];
+        Result += ProjectedSample.z >= (StoredDepth - Bias) ? 1.0f : 0.0f;
+    }
+
+    Result /= f32(ArrayCount(Raster->HemisphereSamples));
+    return Result;
+}
+
+inline v3 SoftwareRasterBlinnPhong(v3 View, v3 SurfaceColor, v3 SurfaceNormal, f32 SpecularPower, v3 LightDir, v3 LightColor)
+{
+    // NOTE: Same as BlinnPhongLighting in shader_blinn_phong_lighting.cpp, LightDir points from the light to the surface
+    f32 LightIntensity = Max(Dot(-LightDir, SurfaceNormal), 0.0f);
+    v3 HalfwayDir = Normalize(-LightDir + View);
+    LightIntensity += powf(Max(Dot(SurfaceNormal, HalfwayDir), 0.0f), SpecularPower);
+
+    v3 Result = LightIntensity * V3(SurfaceColor.x * LightColor.x, SurfaceColor.y * LightColor.y, SurfaceColor.z * LightColor.z);
+    return Result;
+}
+
+inline void SoftwareRasterTileShade(software_raster* Raster, software_raster_thread* Thread, u32 TileId)
+{
+    render_scene* Scene = Raster->Scene;
+    m4 VPTransform = CameraGetVP(&Scene->Camera);
+    u32 TileMinX, TileMinY, TileEndX, TileEndY;
+    SoftwareRasterTileRect(Raster, TileId, &TileMinX, &TileMinY, &TileEndX, &TileEndY);
+
+    // NOTE: Occlusion and the world space bounds of what the tile sees
+    v3 MinPos = V3(0);
+    v3 MaxPos = V3(0);
+    b32 Covered = false;
+    for (u32 Y = TileMinY; Y < TileEndY; ++Y)
+    {
+        for (u32 X = TileMinX; X < TileEndX; ++X)
+        {
+            u32 PixelId = Y * Raster->Width + X;
+            Raster->Occlusion[PixelId] = 0.0f;
+            if (Raster->Visibility[PixelId] != 0xFFFFFFFF)
+            {
+                v3 Pos = Raster->Position[PixelId].xyz;
+                MinPos = Covered ? V3(Min(MinPos.x, Pos.x), Min(MinPos.y, Pos.y), Min(MinPos.z, Pos.z)) : Pos;
+                MaxPos = Covered ? V3(Max(MaxPos.x, Pos.x), Max(MaxPos.y, Pos.y), Max(MaxPos.z, Pos.z)) : Pos;
+                Raster->Occlusion[PixelId] = SoftwareRasterSsao(Raster, VPTransform, X, Y);
+                Covered = true;
+            }
+        }
+    }
+
+    // NOTE: Light culling, a light touches the tile if its sphere overlaps the bounds
+    u32 NumTileLights = 0;
+    if (Covered)
+    {
+        for (u32 LightId = 0; LightId < Scene->PointLights.NumItems; ++LightId)
+        {
+            point_light* Light = ScenePointLightAt(Scene, LightId);
+            v3 Closest = V3(Min(Max(Light->Pos.x, MinPos.x), MaxPos.x), Min(Max(Light->Pos.y, MinPos.y), MaxPos.y),
+                            Min(Max(Light->Pos.z, MinPos.z), MaxPos.z));
+            v3 Delta = Closest - Light->Pos;
+            if (Dot(Delta, Delta) <= Light->MaxDistance * Light->MaxDistance)
+            {
+                Thread->LightIds[NumTileLights++] = LightId;
+            }
+        }
+    }
+
+    // NOTE: Same as TILED_DEFERRED_LIGHTING_FRAG, in world space
+    directional_light* DirectionalLight = &Scene->DirectionalLight;
+    for (u32 Y = TileMinY; Y < TileEndY; ++Y)
+    {
+        for (u32 X = TileMinX; X < TileEndX; ++X)
+        {
+            u32 PixelId = Y * Raster->Width + X;
+            v3 SurfacePos = Raster->Position[PixelId].xyz;
+            v3 SurfaceNormal = Raster->Normal[PixelId].xyz;
+            v3 SurfaceColor = Raster->Color[PixelId].xyz;
+            v3 Color = V3(0);
+            if (Raster->Visibility[PixelId] != 0xFFFFFFFF)
+            {
+                v3 View = Normalize(Scene->Camera.Pos - SurfacePos);
+                for (u32 TileLightId = 0; TileLightId < NumTileLights; ++TileLightId)
+                {
+                    point_light* Light = ScenePointLightAt(Scene, Thread->LightIds[TileLightId]);
+                    f32 Distance = Length(Light->Pos - SurfacePos);
+                    f32 PercentDist = Min(Max((Light->MaxDistance - Distance) / Light->MaxDistance, 0.0f), 1.0f);
+                    v3 LightDir = Normalize(SurfacePos - Light->Pos);
+                    Color += SoftwareRasterBlinnPhong(View, SurfaceColor, SurfaceNormal, 32.0f, LightDir, PercentDist * Light->Color);
+                }
+
+                Color += SoftwareRasterBlinnPhong(View, SurfaceColor, SurfaceNormal, 32.0f, DirectionalLight->Dir, DirectionalLight->Color);
+                v3 Ambient = Raster->Occlusion[PixelId] * DirectionalLight->AmbientColor;
+                Color += V3(Ambient.x * SurfaceColor.x, Ambient.y * SurfaceColor.y, Ambient.z * SurfaceColor.z);
+            }
+
+            Raster->Lit[PixelId] = Color;
+        }
+    }
+}
+
+inline void SoftwareRasterWork(software_raster* Raster, u32 ThreadId)
+{
+    software_raster_thread* Thread = Raster->Threads + ThreadId;
+    switch (Raster->Phase)
+    {
+        case SoftwareRasterPhase_Setup:
+        {
+            SoftwareRasterSetup(Raster, ThreadId);
+        } break;
+
+        case SoftwareRasterPhase_Bin:
+        {
+            SoftwareRasterBin(Raster, ThreadId);
+        } break;
+
+        case SoftwareRasterPhase_Raster:
+        {
+            u32 TileId;
+            while (SoftwareRasterTileGet(Raster, &TileId))
+            {
+                SoftwareRasterTileRaster(Raster, Thread, TileId);
+            }
+        } break;
+
+        case SoftwareRasterPhase_Shade:
+        {
+            u32 TileId;
+            while (SoftwareRasterTileGet(Raster, &TileId))
+            {
+                SoftwareRasterTileShade(Raster, Thread, TileId);
+            }
+        } break;
+
+        default:
+        {
+            InvalidCodePath;
+        } break;
+    }
+}
+
+//
+// NOTE: Output
+//
+
+inline u8 SoftwareRasterUnorm8(f32 Value)
+{
+    u8 Result = u8(Min(Max(Value, 0.0f), 1.0f) * 255.0f + 0.5f);
+    return Result;
+}
+
+inline u32 SoftwareRasterImageHash(software_raster* Raster)
+{
+    // NOTE: FNV-1a over the 8 bit lit image, that is what we compare between runs and machines
+    u32 Result = 2166136261;
+    for (u32 PixelId = 0; PixelId < Raster->Width * Raster->Height; ++PixelId)
+    {
+        u8 Bytes[3] = { SoftwareRasterUnorm8(Raster->Lit[PixelId].x), SoftwareRasterUnorm8(Raster->Lit[PixelId].y),
+                        SoftwareRasterUnorm8(Raster->Lit[PixelId].z) };
+        for (u32 ByteId = 0; ByteId < ArrayCount(Bytes); ++ByteId)
+        {
+            Result = (Result ^ Bytes[ByteId]) * 16777619;
+        }
+    }
+
+    return Result;
+}
+
+inline void SoftwareRasterImageWrite(software_raster* Raster, const char* FileName, v3* Pixels, u32 Stride, f32 Scale, f32 Bias)
+{
+    // NOTE: Binary PPM, rows top to bottom like the render targets
+    FILE* File = fopen(FileName, "wb");
+    if (!File)
+    {
+        return;
+    }
+
+    fprintf(File, "P6\n%u %u\n255\n", Raster->Width, Raster->Height);
+    u8* Row = PushArray(&Raster->Arena, u8, 3 * Raster->Width);
+    for (u32 Y = 0; Y < Raster->Height; ++Y)
+    {
+        for (u32 X = 0; X < Raster->Width; ++X)
+        {
+            v3 Pixel = *(v3*)((u8*)Pixels + (Y * Raster->Width + X) * Stride);
+            Row[3 * X + 0] = SoftwareRasterUnorm8(Scale * Pixel.x + Bias);
+            Row[3 * X + 1] = SoftwareRasterUnorm8(Scale * Pixel.y + Bias);
+            Row[3 * X + 2] = SoftwareRasterUnorm8(Scale * Pixel.z + Bias);
+        }
+        fwrite(Row, 3 * Raster->Width, 1, File);
+    }
+    fclose(File);
+}
+
+inline void SoftwareRasterImagesWrite(software_raster* Raster)
+{
+    SoftwareRasterImageWrite(Raster, SOFTWARE_RASTER_IMAGE_PREFIX "_lit.ppm", Raster->Lit, sizeof(v3), 1.0f, 0.0f);
+    SoftwareRasterImageWrite(Raster, SOFTWARE_RASTER_IMAGE_PREFIX "_color.ppm", (v3*)Raster->Color, sizeof(v4), 1.0f, 0.0f);
+    SoftwareRasterImageWrite(Raster, SOFTWARE_RASTER_IMAGE_PREFIX "_normal.ppm", (v3*)Raster->Normal, sizeof(v4), 0.5f, 0.5f);
+
+    // NOTE: Single channel buffers get expanded to gray, reversed z depth is tiny far away so it gets stretched to the closest pixel
+    u32 NumPixels = Raster->Width * Raster->Height;
+    v3* Gray = PushArray(&Raster->Arena, v3, NumPixels);
+    for (u32 PixelId = 0; PixelId < NumPixels; ++PixelId)
+    {
+        Gray[PixelId] = V3(Raster->Occlusion[PixelId]);
+    }
+    SoftwareRasterImageWrite(Raster, SOFTWARE_RASTER_IMAGE_PREFIX "_ao.ppm", Gray, sizeof(v3), 1.0f, 0.0f);
+
+    f32 MaxDepth = 0.0f;
+    for (u32 PixelId = 0; PixelId < NumPixels; ++PixelId)
+    {
+        MaxDepth = Max(MaxDepth, Raster->Depth[PixelId]);
+    }
+    for (u32 PixelId = 0; PixelId < NumPixels; ++PixelId)
+    {
+        Gray[PixelId] = V3(Raster->Depth[PixelId]);
+    }
+    SoftwareRasterImageWrite(Raster, SOFTWARE_RASTER_IMAGE_PREFIX "_depth.ppm", Gray, sizeof(v3), MaxDepth > 0.0f ? 1.0f / MaxDepth : 1.0f, 0.0f);
+}
+
+inline void SoftwareRasterStatsDump(software_raster* Raster, const char* FileName)
+{
+    if (Raster->NumRuns == 0)
+    {
+        return;
+    }
+
+    FILE* File = fopen(FileName, "wb");
+    if (File)
+    {
+        // NOTE: Throughput counts setup, binning and raster, shading depends on the light count and not the triangles
+        fprintf(File, "Run, Threads, Width, Height, Triangles, SetupTriangles, BinEntries, CoveredPixels, SetupMs, BinMs, RasterMs, ShadeMs, TotalMs, MTrianglesPerSec, ImageHash\n");
+        for (u32 RunId = 0; RunId < Raster->NumRuns; ++RunId)
+        {
+            software_raster_stats* Stats = Raster->Stats + RunId;
+            f32 GeometryMs = Stats->SetupMs + Stats->BinMs + Stats->RasterMs;
+            f32 MTrianglesPerSec = GeometryMs > 0.0f ? f32(Stats->NumTriangles) / (GeometryMs * 1000.0f) : 0.0f;
+            fprintf(File, "%u, %u, %u, %u, %llu, %llu, %llu, %llu, %f, %f, %f, %f, %f, %f, %08X\n", RunId, Raster->NumThreads, Raster->Width,
+                    Raster->Height, Stats->NumTriangles, Stats->NumSetupTriangles, Stats->NumBinEntries, Stats->NumCoveredPixels,
+                    Stats->SetupMs, Stats->BinMs, Stats->RasterMs, Stats->ShadeMs, Stats->TotalMs, MTrianglesPerSec, Stats->ImageHash);
+        }
+        fclose(File);
+    }
+}
+
+//
+// NOTE: Frame
+//
+
+inline u64 SoftwareRasterTicksGet()
+{
+    LARGE_INTEGER Ticks;
+    QueryPerformanceCounter(&Ticks);
+    return u64(Ticks.QuadPart);
+}
+
+inline void SoftwareRasterCreate(software_raster* Raster, b32 Enabled)
+{
+    *Raster = {};
+    Raster->Enabled = Enabled;
+    if (!Enabled)
+    {
+        return;
+    }
+
+    SYSTEM_INFO SystemInfo = {};
+    GetSystemInfo(&SystemInfo);
+    Raster->NumThreads = Min(Max(u32(SystemInfo.dwNumberOfProcessors), 1u), u32(SOFTWARE_RASTER_MAX_THREADS));
+
+    LARGE_INTEGER Frequency;
+    QueryPerformanceFrequency(&Frequency);
+    Raster->TicksPerSecond = u64(Frequency.QuadPart);
+
+    // NOTE: Fixed kernel, built the same way as the per frame GPU one
+    random_series Series = RandomSeriesCreate(SOFTWARE_RASTER_SEED);
+    for (u32 SampleId = 0; SampleId < ArrayCount(Raster->HemisphereSamples); ++SampleId)
+    {
+        v3 Sample = V3(RandomNextBilateral(&Series), RandomNextBilateral(&Series), RandomNextUnilateral(&Series));
+        Raster->HemisphereSamples[SampleId] = V4(RandomNextUnilateral(&Series) * Normalize(Sample), 0.0f);
+    }
+    for (u32 RotationId = 0; RotationId < ArrayCount(Raster->RandomRotations); ++RotationId)
+    {
+        Raster->RandomRotations[RotationId] = V4(RandomNextBilateral(&Series), RandomNextBilateral(&Series), 0.0f, 0.0f);
+    }
+}
+
+inline void SoftwareRasterArenaReserve(linear_arena* Arena, void** Memory, u64 Size)
+{
+    // NOTE: Nothing survives between runs, so growing just swaps the memory out
+    Size += SOFTWARE_RASTER_ARENA_SLACK;
+    if (Arena->Size < Size)
+    {
+        if (*Memory)
+        {
+            VirtualFree(*Memory, 0, MEM_RELEASE);
+        }
+        *Memory = VirtualAlloc(0, Size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        Assert(*Memory);
+        *Arena = LinearArenaCreate(*Memory, Size);
+    }
+
+    Arena->Used = 0;
+}
+
+inline void SoftwareRasterRun(software_raster* Raster, render_scene* Scene, u32 Width, u32 Height)
+{
+    CPU_TIMED_BLOCK("SoftwareRaster");
+    Assert(Raster->NumRuns < SOFTWARE_RASTER_NUM_RUNS);
+    software_raster_stats* Stats = Raster->Stats + Raster->NumRuns++;
+    *Stats = {};
+
+    Raster->Scene = Scene;
+    Raster->Width = Width;
+    Raster->Height = Height;
+    Raster->NumTilesX = CeilU32(f32(Width) / f32(SOFTWARE_RASTER_TILE_SIZE));
+    Raster->NumTilesY = CeilU32(f32(Height) / f32(SOFTWARE_RASTER_TILE_SIZE));
+    Raster->NumTiles = Raster->NumTilesX * Raster->NumTilesY;
+
+    // NOTE: Near plane clipping turns a triangle into at most two, so every thread gets room for twice its source triangles
+    u32 TriangleOffset = 0;
+    for (u32 ThreadId = 0; ThreadId < Raster->NumThreads; ++ThreadId)
+    {
+        software_raster_thread* Thread = Raster->Threads + ThreadId;
+        *Thread = {};
+        Thread->TriangleOffset = TriangleOffset;
+
+        u32 FirstInstanceId = Scene->OpaqueInstances.NumItems * ThreadId / Raster->NumThreads;
+        u32 LastInstanceId = Scene->OpaqueInstances.NumItems * (ThreadId + 1) / Raster->NumThreads;
+        for (u32 InstanceId = FirstInstanceId; InstanceId < LastInstanceId; ++InstanceId)
+        {
+            cpu_mesh* Mesh = SceneMeshGet(Scene, SceneOpaqueInstanceAt(Scene, InstanceId)->Mesh)->CpuMesh;
+            u32 NumMeshTriangles = Mesh ? Mesh->NumIndices / 3 : 0;
+            Thread->MaxNumTriangles += 2 * NumMeshTriangles;
+            Stats->NumTriangles += NumMeshTriangles;
+        }
+        TriangleOffset += Thread->MaxNumTriangles;
+    }
+
+    // NOTE: Pixel buffers, the image rows and gray buffer SoftwareRasterImagesWrite pushes, per thread tile and light lists and triangles
+    u32 NumPixels = Width * Height;
+    u32 NumLights = Max(Scene->PointLights.NumItems, 1u);
+    u64 ArenaSize = (u64(NumPixels) * (sizeof(u32) + 3 * sizeof(v4) + 2 * sizeof(f32) + 2 * sizeof(v3)) + 5 * 3 * u64(Width) +
+                     u64(Raster->NumThreads) * (2 * Raster->NumTiles + NumLights) * sizeof(u32) +
+                     u64(Max(TriangleOffset, 1u)) * sizeof(software_raster_triangle));
+    SoftwareRasterArenaReserve(&Raster->Arena, &Raster->ArenaMemory, ArenaSize);
+
+    Raster->Visibility = PushArray(&Raster->Arena, u32, NumPixels);
+    Raster->Position = PushArray(&Raster->Arena, v4, NumPixels);
+    Raster->Normal = PushArray(&Raster->Arena, v4, NumPixels);
+    Raster->Color = PushArray(&Raster->Arena, v4, NumPixels);
+    Raster->Depth = PushArray(&Raster->Arena, f32, NumPixels);
+    Raster->Occlusion = PushArray(&Raster->Arena, f32, NumPixels);
+    Raster->Lit = PushArray(&Raster->Arena, v3, NumPixels);
+    for (u32 ThreadId = 0; ThreadId < Raster->NumThreads; ++ThreadId)
+    {
+        software_raster_thread* Thread = Raster->Threads + ThreadId;
+        Thread->TileCounts = PushArray(&Raster->Arena, u32, Raster->NumTiles);
+        Thread->TileOffsets = PushArray(&Raster->Arena, u32, Raster->NumTiles);
+        Thread->LightIds = PushArray(&Raster->Arena, u32, NumLights);
+    }
+    Raster->Triangles = PushArray(&Raster->Arena, software_raster_triangle, Max(TriangleOffset, 1u));
+    for (u32 ThreadId = 0; ThreadId < Raster->NumThreads; ++ThreadId)
+    {
+        Raster->Threads[ThreadId].Triangles = Raster->Triangles + Raster->Threads[ThreadId].TriangleOffset;
+    }
+
+    u64 StartTicks = SoftwareRasterTicksGet();
+    SoftwareRasterPhaseRun(Raster, SoftwareRasterPhase_Setup);
+    u64 SetupTicks = SoftwareRasterTicksGet();
+
+    u32 ThreadNumEntries[SOFTWARE_RASTER_MAX_THREADS] = {};
+    for (u32 ThreadId = 0; ThreadId < Raster->NumThreads; ++ThreadId)
+    {
+        software_raster_thread* Thread = Raster->Threads + ThreadId;
+        u32 NumEntries = 0;
+        for (u32 TileId = 0; TileId < Raster->NumTiles; ++TileId)
+        {
+            Thread->TileOffsets[TileId] = NumEntries;
+            NumEntries += Thread->TileCounts[TileId];
+        }
+        ThreadNumEntries[ThreadId] = Max(NumEntries, 1u);
+        Stats->NumSetupTriangles += Thread->NumTriangles;
+        Stats->NumBinEntries += NumEntries;
+    }
+
+    // NOTE: Bin sizes are only known now that setup counted them
+    SoftwareRasterArenaReserve(&Raster->BinArena, &Raster->BinArenaMemory, (Stats->NumBinEntries + Raster->NumThreads) * sizeof(u32));
+    for (u32 ThreadId = 0; ThreadId < Raster->NumThreads; ++ThreadId)
+    {
+        Raster->Threads[ThreadId].Bins = PushArray(&Raster->BinArena, u32, ThreadNumEntries[ThreadId]);
+    }
+    SoftwareRasterPhaseRun(Raster, SoftwareRasterPhase_Bin);
+    u64 BinTicks = SoftwareRasterTicksGet();
+
+    SoftwareRasterPhaseRun(Raster, SoftwareRasterPhase_Raster);
+    u64 RasterTicks = SoftwareRasterTicksGet();
+
+    SoftwareRasterPhaseRun(Raster, SoftwareRasterPhase_Shade);
+    u64 ShadeTicks = SoftwareRasterTicksGet();
+
+    f32 TicksToMs = 1000.0f / f32(Raster->TicksPerSecond);
+    Stats->SetupMs = f32(SetupTicks - StartTicks) * TicksToMs;
+    Stats->BinMs = f32(BinTicks - SetupTicks) * TicksToMs;
+    Stats->RasterMs = f32(RasterTicks - BinTicks) * TicksToMs;
+    Stats->ShadeMs = f32(ShadeTicks - RasterTicks) * TicksToMs;
+    Stats->TotalMs = f32(ShadeTicks - StartTicks) * TicksToMs;
+    for (u32 ThreadId = 0; ThreadId < Raster->NumThreads; ++ThreadId)
+    {
+        Stats->NumCoveredPixels += Raster->Threads[ThreadId].NumCoveredPixels;
+    }
+    Stats->ImageHash = SoftwareRasterImageHash(Raster);
+}
+
+inline void SoftwareRasterFrame(software_raster* Raster, render_scene* Scene, u32 Width, u32 Height)
+{
+    // NOTE: Runs back to back on the first populated frame, the last run leaves its buffers behind for the images
+    if (!Raster->Enabled || Raster->Done)
+    {
+        return;
+    }
+
+    for (u32 RunId = 0; RunId < SOFTWARE_RASTER_NUM_RUNS; ++RunId)
+    {
+        SoftwareRasterRun(Raster, Scene, Width, Height);
+    }
+    SoftwareRasterImagesWrite(Raster);
+    SoftwareRasterStatsDump(Raster, SOFTWARE_RASTER_FILE_NAME);
+    Raster->Done = true;
+}
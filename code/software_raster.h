@@ -0,0 +1,145 @@
+#pragma once
+
+/*
+
+  NOTE: Software GBuffer rasterizer. Renders the opaque instances of a render_scene on the CPU into the same position, normal, color and
+        depth buffers the tiled deferred GBUFFER_VERT/FRAG shaders write, then runs CPU versions of standard SSAO and the tiled deferred
+        lighting on them. It only reads CPU side scene data (instances, camera, lights and the CPU copies of the meshes and textures),
+        so it gives us a reference image and a triangle throughput baseline on machines without a GPU.
+
+        The frame goes through these phases, each one split across SOFTWARE_RASTER_MAX_THREADS threads:
+
+    - Setup: every thread takes a contiguous range of instances, transforms the vertices with WVPTransform, clips against the near
+      plane, culls triangles outside the screen and counts how many triangles touch every screen tile.
+    - Bin: every thread writes its triangle ids into its own per tile lists, so binning needs no atomics.
+    - Raster: threads grab tiles. A tile walks the lists of thread 0, 1, ... in order, which is instance order no matter how many
+      threads we have, so depth ties resolve the same way on every run. Winners go into a visibility buffer and only those pixels
+      get their attributes interpolated and written to the GBuffer.
+    - Shade: threads grab tiles again, compute SSAO and light every pixel with the point lights whose sphere touches the world space
+      bounds of the tile.
+
+        Rasterization follows Vulkan: pixel centers at +0.5, top left fill rule, no culling, reversed z (cleared to 0, GREATER test).
+        Attributes are interpolated perspective correct and positions/normals get transformed to world space per pixel, like the vertex
+        shader does per vertex (both are linear so the result is the same). SSAO uses its own fixed seed kernel since the GPU one gets
+        rerandomized every frame, and lighting happens in world space instead of view space, which is the same math.
+
+        Every run writes a row with the phase timings and a hash of the lit image to SOFTWARE_RASTER_FILE_NAME, the last run also writes
+        the buffers out as images with SOFTWARE_RASTER_IMAGE_PREFIX.
+
+        Memory comes from two arenas that get sized on every run, one from the resolution and the triangle count of the scene before
+        setup and one from the bin entry count after it. They only get reallocated when a run needs more than they hold, so nothing is
+        reserved up front and a small window never pays for a big one. software_raster_main.cpp builds the same scenes without a GPU.
+
+ */
+
+#define SOFTWARE_RASTER 0
+#define SOFTWARE_RASTER_NUM_RUNS 4
+#define SOFTWARE_RASTER_MAX_THREADS 16
+#define SOFTWARE_RASTER_TILE_SIZE 64
+#define SOFTWARE_RASTER_ARENA_SLACK MegaBytes(1) // NOTE: Room for the alignment of the arrays we push
+#define SOFTWARE_RASTER_SEED 0x50F7A5E5
+#define SOFTWARE_RASTER_MIN_W 0.001f // NOTE: Clip plane in clip w, matches the cameras near plane
+#define SOFTWARE_RASTER_FILE_NAME "software_raster.csv"
+#define SOFTWARE_RASTER_IMAGE_PREFIX "software_raster"
+
+// NOTE: R8G8B8A8 texels, sampled with nearest filtering and clamp to edge like the point sampler
+struct software_texture
+{
+    u32 Width;
+    u32 Height;
+    u32* Texels;
+};
+
+struct software_raster_triangle
+{
+    u32 InstanceId;
+    u32 IndexId; // NOTE: First index of the source triangle in the mesh
+
+    // NOTE: Screen space x, y, z/w and 1/w per vertex
+    v2 ScreenPos[3];
+    f32 Depth[3];
+    f32 InvW[3];
+
+    // NOTE: Clipped vertices are blends of the source triangles vertices, these are the weights of vertex 1 and 2
+    v2 SourceBary[3];
+
+    // NOTE: Inclusive pixel bounds
+    u32 MinX;
+    u32 MinY;
+    u32 MaxX;
+    u32 MaxY;
+};
+
+enum software_raster_phase
+{
+    SoftwareRasterPhase_Setup,
+    SoftwareRasterPhase_Bin,
+    SoftwareRasterPhase_Raster,
+    SoftwareRasterPhase_Shade,
+};
+
+struct software_raster_thread
+{
+    u32 NumTriangles;
+    u32 MaxNumTriangles;
+    software_raster_triangle* Triangles; // NOTE: Points into the shared triangle array
+    u32 TriangleOffset;
+    u32* TileCounts;
+    u32* TileOffsets;
+    u32* Bins;
+    u32* LightIds;
+    u64 NumSkippedInstances;
+    u64 NumCoveredPixels;
+};
+
+struct software_raster_stats
+{
+    u64 NumTriangles;
+    u64 NumSetupTriangles;
+    u64 NumBinEntries;
+    u64 NumCoveredPixels;
+    f32 SetupMs;
+    f32 BinMs;
+    f32 RasterMs;
+    f32 ShadeMs;
+    f32 TotalMs;
+    u32 ImageHash;
+};
+
+struct software_raster
+{
+    b32 Enabled;
+    b32 Done;
+    u32 NumThreads;
+    void* ArenaMemory;
+    linear_arena Arena;
+    void* BinArenaMemory;
+    linear_arena BinArena;
+    u64 TicksPerSecond;
+
+    // NOTE: Per run state, everything below points into the arenas
+    render_scene* Scene;
+    u32 Width;
+    u32 Height;
+    u32 NumTilesX;
+    u32 NumTilesY;
+    u32 NumTiles;
+    software_raster_phase Phase;
+    volatile LONG NextTileId;
+    software_raster_triangle* Triangles;
+    software_raster_thread Threads[SOFTWARE_RASTER_MAX_THREADS];
+
+    u32* Visibility;
+    v4* Position;
+    v4* Normal;
+    v4* Color;
+    f32* Depth;
+    f32* Occlusion;
+    v3* Lit;
+
+    v4 HemisphereSamples[64];
+    v4 RandomRotations[16];
+
+    u32 NumRuns;
+    software_raster_stats Stats[SOFTWARE_RASTER_NUM_RUNS];
+};
@@ -0,0 +1,119 @@
+
+/*
+
+  NOTE: Headless software raster. Builds a benchmark scenario out of CPU only meshes and runs the software rasterizer on it, so the
+        image hash and the PPMs can be produced on machines without a GPU or a window. It compiles the same unity build as the demo to
+        share the scene, scenario and mesh code, but never calls into Vulkan or the framework's window and device setup.
+
+        Usage: software_raster.exe [ScenarioId] [Width] [Height]
+
+        The camera sits on the first keyframe of the scenario, the same frame the golden test renders.
+
+ */
+
+#include <stdlib.h>
+#include "ssao_demo.cpp"
+
+#define SOFTWARE_RASTER_MAIN_MEMORY_SIZE MegaBytes(256)
+#define SOFTWARE_RASTER_MAIN_WIDTH 1920
+#define SOFTWARE_RASTER_MAIN_HEIGHT 1080
+
+inline scene_handle SoftwareRasterMeshAdd(render_scene* Scene, software_texture* Color, cpu_mesh Mesh)
+{
+    // NOTE: Only what lod selection and the software rasterizer read, there are no GPU buffers or descriptors behind these
+    scene_handle Result = {};
+    render_mesh* RenderMesh = ScenePoolAdd(&Scene->RenderMeshes, render_mesh, &Result);
+    *RenderMesh = {};
+    RenderMesh->NumIndices = Mesh.NumIndices;
+    RenderMesh->PosScale = V3(1.0f);
+    RenderMesh->NumLods = 1;
+    RenderMesh->LodMeshes[0] = Result;
+    RenderMesh->MaterialId = Scene->NumMaterials++;
+    RenderMesh->CpuColor = Color;
+    SceneMeshCpuCopySet(Scene, Result, Mesh);
+
+    return Result;
+}
+
+int main(int ArgCount, char** Args)
+{
+    u32 ScenarioId = ArgCount > 1 ? u32(atoi(Args[1])) : 0;
+    u32 Width = ArgCount > 2 ? u32(atoi(Args[2])) : SOFTWARE_RASTER_MAIN_WIDTH;
+    u32 Height = ArgCount > 3 ? u32(atoi(Args[3])) : SOFTWARE_RASTER_MAIN_HEIGHT;
+    if (ScenarioId >= ArrayCount(BenchmarkScenarios) || Width == 0 || Height == 0)
+    {
+        fprintf(stderr, "Usage: %s [ScenarioId 0-%u] [Width] [Height]\n", Args[0], u32(ArrayCount(BenchmarkScenarios) - 1));
+        return 1;
+    }
+
+    // NOTE: Init Memory, same layout as Init. RenderState stays zeroed since nothing here touches the GPU
+    {
+        void* ProgramMemory = VirtualAlloc(0, SOFTWARE_RASTER_MAIN_MEMORY_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (!ProgramMemory)
+        {
+            fprintf(stderr, "Failed to allocate program memory\n");
+            return 1;
+        }
+
+        linear_arena Arena = LinearArenaCreate(ProgramMemory, SOFTWARE_RASTER_MAIN_MEMORY_SIZE);
+        DemoAllocGlobals(&Arena);
+        *DemoState = {};
+        *RenderState = {};
+        DemoState->Arena = Arena;
+        DemoState->TempArena = LinearSubArena(&DemoState->Arena, MegaBytes(10));
+        FrameArenaCreate(&DemoState->FrameArena, &DemoState->Arena);
+        DemoState->RandomSeries = RandomSeriesCreate(DEMO_RANDOM_SEED);
+#if CPU_PROFILER
+        CpuProfilerInit(&DemoState->CpuProfiler, &DemoState->Arena);
+#endif
+    }
+
+    // NOTE: Init scene system, only the pools
+    render_scene* Scene = &DemoState->Scene;
+    {
+        Scene->Camera = CameraFpsCreate(V3(0, 0, -5), V3(0, 0, 1), f32(Width) / f32(Height), 0.001f, 1000.0f, SCENE_CAMERA_FOV, 1.0f, 0.005f);
+        ScenePoolCreate(&Scene->PointLights, &DemoState->Arena, sizeof(point_light));
+        ScenePoolCreate(&Scene->RenderMeshes, &DemoState->Arena, sizeof(render_mesh));
+        ScenePoolCreate(&Scene->OpaqueInstances, &DemoState->Arena, sizeof(instance_entry));
+        Scene->LodsEnabled = SCENE_LODS;
+        ChunkedArrayCreate(&Scene->PrevLods, sizeof(scene_lod_state));
+        ScenePoolCreate(&Scene->TransparentInstances, &DemoState->Arena, sizeof(transparent_instance_entry));
+    }
+
+    // NOTE: Meshes go through the same optimizer as in Init so triangles come in the same order and depth ties resolve the same way
+    {
+        software_texture* WhiteCpuTexture = PushStruct(&DemoState->Arena, software_texture);
+        WhiteCpuTexture->Width = WHITE_TEXTURE_DIM;
+        WhiteCpuTexture->Height = WHITE_TEXTURE_DIM;
+        WhiteCpuTexture->Texels = WhiteTexels;
+
+        DemoState->Cube = SoftwareRasterMeshAdd(Scene, WhiteCpuTexture, MeshCubeCreate(&DemoState->TempArena));
+
+        cpu_mesh SphereMesh = MeshSphereCreate(&DemoState->TempArena, 64, 64);
+        MeshOptimizerRun(&DemoState->MeshReports, "sphere", &SphereMesh);
+        DemoState->Sphere = SoftwareRasterMeshAdd(Scene, WhiteCpuTexture, SphereMesh);
+        SceneMeshGet(Scene, DemoState->Sphere)->BoundingRadius = 1.0f;
+        for (u32 LodId = 0; LodId < ArrayCount(SphereLodTessellations); ++LodId)
+        {
+            u32 Tessellation = SphereLodTessellations[LodId];
+            cpu_mesh LodMesh = MeshSphereCreate(&DemoState->TempArena, Tessellation, Tessellation);
+            MeshOptimizerRun(&DemoState->MeshReports, SphereLodNames[LodId], &LodMesh);
+            SceneMeshLodAdd(Scene, DemoState->Sphere, SoftwareRasterMeshAdd(Scene, WhiteCpuTexture, LodMesh), SphereLodMinScreenSizes[LodId]);
+        }
+    }
+
+    // NOTE: Populate scene, same as MainLoop
+    benchmark_scenario* Scenario = BenchmarkScenarios + ScenarioId;
+    ScenarioCameraApply(Scenario, 0, &Scene->Camera);
+    ScenarioPopulate(Scenario, Scene);
+    SceneDirectionalLightSet(Scene, Normalize(V3(1.0f, 0.4f, 0.0f)), 0.3f*V3(1.0f, 1.0f, 1.0f), V3(0.4f, 0.4f, 0.4f));
+
+    SoftwareRasterCreate(&DemoState->SoftwareRaster, true);
+    SoftwareRasterFrame(&DemoState->SoftwareRaster, Scene, Width, Height);
+
+    software_raster_stats* Stats = DemoState->SoftwareRaster.Stats + DemoState->SoftwareRaster.NumRuns - 1;
+    printf("%s %ux%u: %llu triangles, %f ms, hash %08X\n", Scenario->Name, Width, Height, Stats->NumTriangles, Stats->TotalMs,
+           Stats->ImageHash);
+
+    return 0;
+}
@@ -1,64 +1,341 @@
 
 #include "ssao_demo.h"
+#include "gpu_timers.cpp"
+#include "deletion_queue.cpp"
+#include "memory_stats.cpp"
+#include "cpu_profiler.cpp"
+#include "readback.cpp"
+#include "staging_ring.cpp"
+#include "frame_arena.cpp"
+#include "scene_pool.cpp"
+#include "dynamic_resolution.cpp"
+#include "light_grid_stats.cpp"
+#include "occlusion_cull.cpp"
+#include "input_capture.cpp"
+#include "forward.cpp"
+#include "deferred.cpp"
 #include "tiled_deferred.cpp"
-
-// TODO: Add Random Floats
-
-inline f32 RandomFloat()
-{
-    f32 Result = static_cast<f32>(rand()) / static_cast<f32>(RAND_MAX);
-    return Result;
-}
+#include "tiled_forward.cpp"
+#include "renderer.cpp"
 
 //
 // NOTE: Asset Storage System
 //
 
-inline u32 SceneMeshAdd(render_scene* Scene, vk_image Color, vk_image Normal, VkBuffer VertexBuffer, VkBuffer IndexBuffer, u32 NumIndices)
+inline void SceneBindlessMaterialWrite(render_scene* Scene, u32 MaterialId, vk_image Color, vk_image Normal)
 {
-    Assert(Scene->NumRenderMeshes < Scene->MaxNumRenderMeshes);
-    
-    u32 MeshId = Scene->NumRenderMeshes++;
-    render_mesh* Mesh = Scene->RenderMeshes + MeshId;
+    // NOTE: The descriptor manager only writes the first array element, so we write our slots directly. This happens outside of a
+    // frame so the set isn't in use
+    VkDescriptorImageInfo ImageInfos[2] = {};
+    ImageInfos[0].sampler = DemoState->PointSampler;
+    ImageInfos[0].imageView = Color.View;
+    ImageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    ImageInfos[1].sampler = DemoState->PointSampler;
+    ImageInfos[1].imageView = Normal.View;
+    ImageInfos[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkWriteDescriptorSet Writes[2] = {};
+    for (u32 WriteId = 0; WriteId < ArrayCount(Writes); ++WriteId)
+    {
+        Writes[WriteId].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        Writes[WriteId].dstSet = Scene->BindlessMaterialDescriptor;
+        Writes[WriteId].dstBinding = WriteId;
+        Writes[WriteId].dstArrayElement = MaterialId;
+        Writes[WriteId].descriptorCount = 1;
+        Writes[WriteId].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        Writes[WriteId].pImageInfo = ImageInfos + WriteId;
+    }
+    vkUpdateDescriptorSets(RenderState->Device, ArrayCount(Writes), Writes, 0, 0);
+}
+
+inline scene_handle SceneMeshAdd(render_scene* Scene, vk_image Color, vk_image Normal, VkBuffer VertexBuffer, VkBuffer IndexBuffer, u32 NumIndices)
+{
+    scene_handle Result = {};
+    render_mesh* Mesh = ScenePoolAdd(&Scene->RenderMeshes, render_mesh, &Result);
     Mesh->Color = Color;
     Mesh->Normal = Normal;
     Mesh->VertexBuffer = VertexBuffer;
     Mesh->IndexBuffer = IndexBuffer;
     Mesh->NumIndices = NumIndices;
+    Mesh->QuantizedVertexBuffer = VK_NULL_HANDLE;
+    Mesh->QuantizedIndexBuffer = VK_NULL_HANDLE;
+    Mesh->QuantizedIndexType = VK_INDEX_TYPE_UINT32;
+    Mesh->PosScale = V3(1.0f);
+    Mesh->PosBias = V3(0.0f);
+    Mesh->BoundingRadius = 0.0f;
+    Mesh->NumLods = 1;
+    Mesh->LodMeshes[0] = Result;
+    Mesh->LodMinScreenSizes[0] = 0.0f;
+    Mesh->CpuMesh = 0;
+    Mesh->CpuColor = 0;
     Mesh->MaterialDescriptor = VkDescriptorSetAllocate(RenderState->Device, RenderState->DescriptorPool, Scene->MaterialDescLayout);
     VkDescriptorImageWrite(&RenderState->DescriptorManager, Mesh->MaterialDescriptor, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
                            Color.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
     VkDescriptorImageWrite(&RenderState->DescriptorManager, Mesh->MaterialDescriptor, 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
                            Normal.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
-    return MeshId;
+    // NOTE: Meshes past the bindless array size have nowhere to put their textures, so bindless gets turned off
+    Mesh->MaterialId = Scene->NumMaterials++;
+    if (Mesh->MaterialId < MAX_BINDLESS_MATERIALS)
+    {
+        SceneBindlessMaterialWrite(Scene, Mesh->MaterialId, Color, Normal);
+    }
+    else
+    {
+        Scene->BindlessMaterialsSupported = false;
+    }
+
+    return Result;
 }
 
-inline u32 SceneMeshAdd(render_scene* Scene, vk_image Color, vk_image Normal, procedural_mesh Mesh)
+inline scene_handle SceneMeshAdd(render_scene* Scene, vk_image Color, vk_image Normal, procedural_mesh Mesh)
 {
-    u32 Result = SceneMeshAdd(Scene, Color, Normal, Mesh.Vertices, Mesh.Indices, Mesh.NumIndices);
+    scene_handle Result = SceneMeshAdd(Scene, Color, Normal, Mesh.Vertices, Mesh.Indices, Mesh.NumIndices);
     return Result;
 }
 
-inline void SceneOpaqueInstanceAdd(render_scene* Scene, u32 MeshId, m4 WTransform)
+inline void SceneMeshLodAdd(render_scene* Scene, scene_handle MeshHandle, scene_handle LodMeshHandle, f32 MinScreenSize)
 {
-    Assert(Scene->NumOpaqueInstances < Scene->MaxNumOpaqueInstances);
+    // NOTE: Lods have to be added from finest to coarsest, the mesh itself is used above the first lods screen size
+    render_mesh* Mesh = SceneMeshGet(Scene, MeshHandle);
+    Assert(Mesh->NumLods < SCENE_MAX_LODS);
+    Assert(Mesh->NumLods == 1 || MinScreenSize < Mesh->LodMinScreenSizes[Mesh->NumLods - 2]);
+
+    u32 LodId = Mesh->NumLods++;
+    Mesh->LodMeshes[LodId] = LodMeshHandle;
+    Mesh->LodMinScreenSizes[LodId - 1] = MinScreenSize;
+    Mesh->LodMinScreenSizes[LodId] = 0.0f;
+
+    // NOTE: Lods share the base meshes material so bindless draws keep indexing the same textures
+    SceneMeshGet(Scene, LodMeshHandle)->MaterialId = Mesh->MaterialId;
+}
 
-    instance_entry* Instance = Scene->OpaqueInstances + Scene->NumOpaqueInstances++;
-    Instance->MeshId = MeshId;
+inline u32 SceneLodSelect(render_mesh* Mesh, f32 ScreenSize, f32 ThresholdScale)
+{
+    u32 Result = Mesh->NumLods - 1;
+    for (u32 LodId = 0; LodId < Mesh->NumLods - 1; ++LodId)
+    {
+        if (ScreenSize >= ThresholdScale * Mesh->LodMinScreenSizes[LodId])
+        {
+            Result = LodId;
+            break;
+        }
+    }
+
+    return Result;
+}
+
+inline scene_handle SceneOpaqueInstanceAdd(render_scene* Scene, scene_handle MeshHandle, m4 WTransform)
+{
+    scene_handle Result = {};
+    u32 InstanceId = Scene->OpaqueInstances.NumItems;
+    instance_entry* Instance = ScenePoolAdd(&Scene->OpaqueInstances, instance_entry, &Result);
+    Instance->Mesh = MeshHandle;
     Instance->WTransform = WTransform;
     Instance->WVPTransform = CameraGetVP(&Scene->Camera)*Instance->WTransform;
+
+    render_mesh* Mesh = SceneMeshGet(Scene, MeshHandle);
+    Scene->NumOpaqueFullTriangles += Mesh->NumIndices / 3;
+    if (Scene->LodsEnabled && Mesh->NumLods > 1)
+    {
+        // NOTE: Largest axis scale bounds the scaled sphere, clip w is the view depth of the model origin
+        f32 Scale = Max(Length((WTransform * V4(1, 0, 0, 0)).xyz), Max(Length((WTransform * V4(0, 1, 0, 0)).xyz),
+                                                                         Length((WTransform * V4(0, 0, 1, 0)).xyz)));
+        f32 Radius = Scale * Mesh->BoundingRadius;
+        f32 ViewDepth = (Instance->WVPTransform * V4(0, 0, 0, 1)).w;
+
+        ChunkedArrayReserve(&Scene->PrevLods, &DemoState->Arena, InstanceId + 1);
+        scene_lod_state* PrevLod = ChunkedArrayAt(&Scene->PrevLods, scene_lod_state, InstanceId);
+
+        u32 LodId = 0;
+        if (ViewDepth > Radius)
+        {
+            f32 CotHalfFov = 1.0f / tanf(0.5f * SCENE_CAMERA_FOV * (3.14159265359f / 180.0f));
+            f32 ScreenSize = Radius * CotHalfFov / ViewDepth;
+
+            // NOTE: Staying put is fine while we are inside the hysteresis band around the thresholds
+            u32 FinestLodId = SceneLodSelect(Mesh, ScreenSize, 1.0f - SCENE_LOD_HYSTERESIS);
+            u32 CoarsestLodId = SceneLodSelect(Mesh, ScreenSize, 1.0f + SCENE_LOD_HYSTERESIS);
+            LodId = SceneLodSelect(Mesh, ScreenSize, 1.0f);
+            if (SceneHandleEqual(PrevLod->Mesh, MeshHandle))
+            {
+                LodId = Min(Max(PrevLod->LodId, FinestLodId), CoarsestLodId);
+            }
+        }
+
+        PrevLod->Mesh = MeshHandle;
+        PrevLod->LodId = LodId;
+        Instance->Mesh = Mesh->LodMeshes[LodId];
+    }
+    Scene->NumOpaqueTriangles += SceneMeshGet(Scene, Instance->Mesh)->NumIndices / 3;
+
+    return Result;
 }
 
-inline void ScenePointLightAdd(render_scene* Scene, v3 Pos, v3 Color, f32 MaxDistance)
+inline scene_handle SceneTransparentInstanceAdd(render_scene* Scene, scene_handle MeshHandle, m4 WTransform, v4 Color)
 {
-    Assert(Scene->NumPointLights < Scene->MaxNumPointLights);
+    scene_handle Result = {};
+    transparent_instance_entry* Instance = ScenePoolAdd(&Scene->TransparentInstances, transparent_instance_entry, &Result);
+    Instance->Mesh = MeshHandle;
+    Instance->WTransform = WTransform;
+    Instance->WVPTransform = CameraGetVP(&Scene->Camera)*Instance->WTransform;
+    Instance->Color = Color;
 
+    return Result;
+}
+
+inline scene_handle ScenePointLightAdd(render_scene* Scene, v3 Pos, v3 Color, f32 MaxDistance)
+{
     // TODO: Specify strength or a sphere so that we can visualize nicely too?
-    point_light* PointLight = Scene->PointLights + Scene->NumPointLights++;
+    scene_handle Result = {};
+    point_light* PointLight = ScenePoolAdd(&Scene->PointLights, point_light, &Result);
     PointLight->Pos = Pos;
     PointLight->Color = Color;
     PointLight->MaxDistance = MaxDistance;
+
+    return Result;
+}
+
+inline void SceneGrowableBuffersWrite(render_scene* Scene)
+{
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Scene->SceneDescriptor, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Scene->OpaqueInstanceBuffer.Buffer);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Scene->SceneDescriptor, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Scene->PointLightBuffer.Buffer);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Scene->SceneDescriptor, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Scene->PointLightTransforms.Buffer);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Scene->SceneDescriptor, 5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Scene->PointLightGroupBounds.Buffer);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Scene->SceneDescriptor, 6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Scene->TransparentInstanceBuffer.Buffer);
+}
+
+inline void SceneGpuBuffersReserve(render_scene* Scene)
+{
+    // IMPORTANT: Call once the scene is populated for the frame and before anything gets pushed to or recorded against its buffers
+    u32 NumPointLights = Scene->PointLights.NumItems;
+    b32 Grew = false;
+    Grew |= GrowableBufferReserve(&Scene->OpaqueInstanceBuffer, Scene->OpaqueInstances.NumItems);
+    Grew |= GrowableBufferReserve(&Scene->TransparentInstanceBuffer, Scene->TransparentInstances.NumItems);
+    Grew |= GrowableBufferReserve(&Scene->PointLightBuffer, NumPointLights);
+    Grew |= GrowableBufferReserve(&Scene->PointLightTransforms, NumPointLights);
+    Grew |= GrowableBufferReserve(&Scene->PointLightGroupBounds, CeilU32(f32(NumPointLights) / f32(LIGHT_GROUP_SIZE)));
+    
+    if (Grew)
+    {
+        SceneGrowableBuffersWrite(Scene);
+        VkDescriptorManagerFlush(RenderState->Device, &RenderState->DescriptorManager);
+    }
+}
+
+inline u32 MortonSpread10(u32 Value)
+{
+    // NOTE: Spreads the bottom 10 bits so that there are 2 zero bits between each bit
+    u32 Result = Value & 0x3FF;
+    Result = (Result | (Result << 16)) & 0x030000FF;
+    Result = (Result | (Result << 8)) & 0x0300F00F;
+    Result = (Result | (Result << 4)) & 0x030C30C3;
+    Result = (Result | (Result << 2)) & 0x09249249;
+    return Result;
+}
+
+inline u32 FloatSortKey(f32 Value)
+{
+    // NOTE: Flips the bits so that the keys of negative floats sort below positive ones as unsigned ints
+    u32 Bits = *(u32*)&Value;
+    u32 Result = (Bits & 0x80000000) ? ~Bits : (Bits | 0x80000000);
+    return Result;
+}
+
+inline void ScenePointLightsSort(render_scene* Scene, b32 ViewDepthOrder)
+{
+    // NOTE: Sort lights along a morton curve so that neighbouring lights in the array are close in space. This keeps the bounds of each
+    // light group tight, which is what lets light culling skip whole groups. Bit mask light lists need them sorted by view depth
+    // instead so that each z-bin is a contiguous range of lights
+    u32 NumLights = Scene->PointLights.NumItems;
+    if (NumLights == 0)
+    {
+        return;
+    }
+
+    // NOTE: Doubling, the arrays we outgrow stay behind in the arena
+    if (NumLights > Scene->MaxNumSortedLights)
+    {
+        Scene->MaxNumSortedLights = Max(2*Scene->MaxNumSortedLights, NumLights);
+        Scene->PointLightSortKeys = PushArray(&DemoState->Arena, u32, 2*Scene->MaxNumSortedLights);
+        Scene->PointLightSortIds = PushArray(&DemoState->Arena, u32, 2*Scene->MaxNumSortedLights);
+    }
+
+    u32* Keys = Scene->PointLightSortKeys;
+    u32* Ids = Scene->PointLightSortIds;
+    if (ViewDepthOrder)
+    {
+        m4 VTransform = CameraGetV(&Scene->Camera);
+        for (u32 LightId = 0; LightId < NumLights; ++LightId)
+        {
+            Keys[LightId] = FloatSortKey((VTransform * V4(ScenePointLightAt(Scene, LightId)->Pos, 1.0f)).z);
+            Ids[LightId] = LightId;
+        }
+    }
+    else
+    {
+
+        v3 MinPos = ScenePointLightAt(Scene, 0)->Pos;
+        v3 MaxPos = ScenePointLightAt(Scene, 0)->Pos;
+        for (u32 LightId = 1; LightId < NumLights; ++LightId)
+        {
+            v3 Pos = ScenePointLightAt(Scene, LightId)->Pos;
+            MinPos = V3(Min(MinPos.x, Pos.x), Min(MinPos.y, Pos.y), Min(MinPos.z, Pos.z));
+            MaxPos = V3(Max(MaxPos.x, Pos.x), Max(MaxPos.y, Pos.y), Max(MaxPos.z, Pos.z));
+        }
+
+        v3 Extent = MaxPos - MinPos;
+        v3 InvExtent = V3(Extent.x > 0.0f ? 1023.0f / Extent.x : 0.0f,
+                          Extent.y > 0.0f ? 1023.0f / Extent.y : 0.0f,
+                          Extent.z > 0.0f ? 1023.0f / Extent.z : 0.0f);
+    
+        for (u32 LightId = 0; LightId < NumLights; ++LightId)
+        {
+            v3 Pos = ScenePointLightAt(Scene, LightId)->Pos - MinPos;
+            u32 X = u32(Pos.x * InvExtent.x);
+            u32 Y = u32(Pos.y * InvExtent.y);
+            u32 Z = u32(Pos.z * InvExtent.z);
+            Keys[LightId] = MortonSpread10(X) | (MortonSpread10(Y) << 1) | (MortonSpread10(Z) << 2);
+            Ids[LightId] = LightId;
+        }
+    }
+
+    // NOTE: LSD radix sort, 8 bits at a time. The second halves of the arrays are used as the ping pong buffers
+    u32* TempKeys = Keys + Scene->MaxNumSortedLights;
+    u32* TempIds = Ids + Scene->MaxNumSortedLights;
+    for (u32 Shift = 0; Shift < 32; Shift += 8)
+    {
+        u32 Offsets[256] = {};
+        for (u32 LightId = 0; LightId < NumLights; ++LightId)
+        {
+            Offsets[(Keys[LightId] >> Shift) & 0xFF] += 1;
+        }
+
+        u32 Total = 0;
+        for (u32 BucketId = 0; BucketId < 256; ++BucketId)
+        {
+            u32 Count = Offsets[BucketId];
+            Offsets[BucketId] = Total;
+            Total += Count;
+        }
+
+        for (u32 LightId = 0; LightId < NumLights; ++LightId)
+        {
+            u32 WriteId = Offsets[(Keys[LightId] >> Shift) & 0xFF]++;
+            TempKeys[WriteId] = Keys[LightId];
+            TempIds[WriteId] = Ids[LightId];
+        }
+
+        u32* SwapKeys = Keys;
+        Keys = TempKeys;
+        TempKeys = SwapKeys;
+        u32* SwapIds = Ids;
+        Ids = TempIds;
+        TempIds = SwapIds;
+    }
+
+    // NOTE: Even number of passes so the sorted ids end up back in the front half
+    Assert(Ids == Scene->PointLightSortIds);
 }
 
 inline void SceneDirectionalLightSet(render_scene* Scene, v3 LightDir, v3 Color, v3 AmbientColor)
@@ -68,10 +345,41 @@ inline void SceneDirectionalLightSet(render_scene* Scene, v3 LightDir, v3 Color,
     Scene->DirectionalLight.AmbientColor = AmbientColor;
 }
 
+#include "mesh_optimizer.cpp"
+#include "scene_generator.cpp"
+#include "benchmark.cpp"
+#include "software_raster.cpp"
+#include "golden_test.cpp"
+
+inline f32 RandomFloat()
+{
+    f32 Result = RandomNextUnilateral(&DemoState->RandomSeries);
+    return Result;
+}
+
 //
 // NOTE: Demo Code
 //
 
+// NOTE: Shared by Init and the headless software raster, so both sample the same texture
+#define WHITE_TEXTURE_DIM 8
+global u32 WhiteTexels[WHITE_TEXTURE_DIM * WHITE_TEXTURE_DIM] =
+{
+    0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 
+    0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF,
+    0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 
+    0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF,
+    0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 
+    0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF,
+    0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 
+    0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF,
+};
+
+// NOTE: Procedural lods are just lower tessellations, every step has a quarter of the triangles
+global const char* SphereLodNames[] = { "sphere_lod1", "sphere_lod2", "sphere_lod3" };
+global u32 SphereLodTessellations[] = { 32, 16, 8 };
+global f32 SphereLodMinScreenSizes[] = { 0.25f, 0.1f, 0.04f };
+
 inline void DemoAllocGlobals(linear_arena* Arena)
 {
     // IMPORTANT: These are always the top of the program memory
@@ -81,6 +389,8 @@ inline void DemoAllocGlobals(linear_arena* Arena)
 
 DEMO_INIT(Init)
 {
+    CPU_TIMED_BLOCK("Init");
+    
     // NOTE: Init Memory
     {
         linear_arena Arena = LinearArenaCreate(ProgramMemory, ProgramMemorySize);
@@ -89,11 +399,18 @@ DEMO_INIT(Init)
         *RenderState = {};
         DemoState->Arena = Arena;
         DemoState->TempArena = LinearSubArena(&DemoState->Arena, MegaBytes(10));
+        FrameArenaCreate(&DemoState->FrameArena, &DemoState->Arena);
+        DemoState->RandomSeries = RandomSeriesCreate(DEMO_RANDOM_SEED);
+#if CPU_PROFILER
+        CpuProfilerInit(&DemoState->CpuProfiler, &DemoState->Arena);
+#endif
     }
 
     // NOTE: Init Vulkan
     {
         {
+            CPU_TIMED_BLOCK("VkInit");
+            
             const char* DeviceExtensions[] =
             {
                 "VK_EXT_shader_viewport_index_layer",
@@ -103,15 +420,29 @@ DEMO_INIT(Init)
             InitParams.ValidationEnabled = true;
             InitParams.WindowWidth = WindowWidth;
             InitParams.WindowHeight = WindowHeight;
-            InitParams.StagingBufferSize = MegaBytes(400);
+            InitParams.StagingBufferSize = MegaBytes(64);
             InitParams.DeviceExtensionCount = ArrayCount(DeviceExtensions);
             InitParams.DeviceExtensions = DeviceExtensions;
             VkInit(VulkanLib, hInstance, WindowHandle, &DemoState->Arena, &DemoState->TempArena, InitParams);
+
+            // NOTE: Every arena we allocate from gets registered before anything allocates from it
+            memory_stats* Stats = &DemoState->MemoryStats;
+            MemoryStatsArenaAdd(Stats, "program", false, &DemoState->Arena.Used, DemoState->Arena.Size);
+            MemoryStatsArenaAdd(Stats, "temp", false, &DemoState->TempArena.Used, DemoState->TempArena.Size);
+            MemoryStatsArenaAdd(Stats, "render_cpu", false, &RenderState->CpuArena.Used, RenderState->CpuArena.Size);
+            MemoryStatsArenaAdd(Stats, "gpu", true, &RenderState->GpuArena.Used, RenderState->GpuArena.Size);
+            u32 StagingArenaId = MemoryStatsArenaAdd(Stats, "staging", true, 0, InitParams.StagingBufferSize);
+            MemoryStatsRecord(Stats, StagingArenaId, "transfer_manager", InitParams.StagingBufferSize);
+            Stats->DedicatedArenaId = MemoryStatsArenaAdd(Stats, "dedicated", true, 0, 0);
+            MemoryStatsBudgetInit(Stats);
         }
+
+        // NOTE: Per frame uploads go through the staging ring, the framework staging buffer only has to fit the init uploads
+        StagingRingCreate(&DemoState->StagingRing, STAGING_RING_SIZE);
         
         // NOTE: Init descriptor pool
         {
-            VkDescriptorPoolSize Pools[5] = {};
+            VkDescriptorPoolSize Pools[7] = {};
             Pools[0].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
             Pools[0].descriptorCount = 1000;
             Pools[1].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
@@ -122,6 +453,10 @@ DEMO_INIT(Init)
             Pools[3].descriptorCount = 1000;
             Pools[4].type = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
             Pools[4].descriptorCount = 1000;
+            Pools[5].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            Pools[5].descriptorCount = 1000;
+            Pools[6].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+            Pools[6].descriptorCount = 16;
             
             VkDescriptorPoolCreateInfo CreateInfo = {};
             CreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
@@ -147,9 +482,16 @@ DEMO_INIT(Init)
         {
             vk_descriptor_layout_builder Builder = VkDescriptorLayoutBegin(&DemoState->CopyToSwapDescLayout);
             VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
+            VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
             VkDescriptorLayoutEnd(RenderState->Device, &Builder);
         }
 
+        DemoState->CopyToSwapGlobals = TaggedBufferCreate("copy_to_swap", &RenderState->GpuArena,
+                                                          VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                          sizeof(copy_to_swap_globals));
+        DynamicResolutionCreate(&DemoState->DynamicResolution, DYNAMIC_RESOLUTION, DYNAMIC_RESOLUTION_TARGET_MS, RenderState->WindowWidth,
+                                RenderState->WindowHeight);
+
         render_target_builder Builder = RenderTargetBuilderBegin(&DemoState->Arena, &DemoState->TempArena, RenderState->WindowWidth,
                                                                  RenderState->WindowHeight);
         RenderTargetAddTarget(&Builder, &DemoState->SwapChainEntry, VkClearColorCreate(0, 0, 0, 1));
@@ -172,33 +514,36 @@ DEMO_INIT(Init)
         render_scene* Scene = &DemoState->Scene;
 
         Scene->Camera = CameraFpsCreate(V3(0, 0, -5), V3(0, 0, 1), f32(RenderState->WindowWidth / RenderState->WindowHeight),
-                                        0.001f, 1000.0f, 90.0f, 1.0f, 0.005f);
+                                        0.001f, 1000.0f, SCENE_CAMERA_FOV, 1.0f, 0.005f);
 
-        Scene->SceneBuffer = VkBufferCreate(RenderState->Device, &RenderState->GpuArena,
-                                            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                            sizeof(scene_globals));
+        Scene->SceneBuffer = TaggedBufferCreate("scene", &RenderState->GpuArena,
+                                                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                sizeof(scene_globals));
         
-        Scene->MaxNumPointLights = 1000;
-        Scene->PointLights = PushArray(&DemoState->Arena, point_light, Scene->MaxNumPointLights);
-        Scene->PointLightBuffer = VkBufferCreate(RenderState->Device, &RenderState->GpuArena,
-                                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                 sizeof(point_light)*Scene->MaxNumPointLights);
-        Scene->PointLightTransforms = VkBufferCreate(RenderState->Device, &RenderState->GpuArena,
-                                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                     sizeof(m4)*Scene->MaxNumPointLights);
-
-        Scene->DirectionalLightBuffer = VkBufferCreate(RenderState->Device, &RenderState->GpuArena,
-                                                       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                       sizeof(directional_light));
+        // NOTE: Pools and GPU buffers start small and grow with the scenes we populate
+        ScenePoolCreate(&Scene->PointLights, &DemoState->Arena, sizeof(point_light));
+        GrowableBufferCreate(&Scene->PointLightBuffer, "scene", VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                             sizeof(point_light), GROWABLE_BUFFER_MIN_CAPACITY);
+        GrowableBufferCreate(&Scene->PointLightTransforms, "scene", VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                             sizeof(m4), GROWABLE_BUFFER_MIN_CAPACITY);
+        GrowableBufferCreate(&Scene->PointLightGroupBounds, "scene", VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                             sizeof(v4), GROWABLE_BUFFER_MIN_CAPACITY);
+
+        Scene->DirectionalLightBuffer = TaggedBufferCreate("scene", &RenderState->GpuArena,
+                                                           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                           sizeof(directional_light));
         
-        Scene->MaxNumRenderMeshes = 1000;
-        Scene->RenderMeshes = PushArray(&DemoState->Arena, render_mesh, Scene->MaxNumRenderMeshes);
+        ScenePoolCreate(&Scene->RenderMeshes, &DemoState->Arena, sizeof(render_mesh));
+
+        ScenePoolCreate(&Scene->OpaqueInstances, &DemoState->Arena, sizeof(instance_entry));
+        Scene->LodsEnabled = SCENE_LODS;
+        ChunkedArrayCreate(&Scene->PrevLods, sizeof(scene_lod_state));
+        GrowableBufferCreate(&Scene->OpaqueInstanceBuffer, "scene", VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                             sizeof(gpu_instance_entry), GROWABLE_BUFFER_MIN_CAPACITY);
 
-        Scene->MaxNumOpaqueInstances = 1000;
-        Scene->OpaqueInstances = PushArray(&DemoState->Arena, instance_entry, Scene->MaxNumOpaqueInstances);
-        Scene->OpaqueInstanceBuffer = VkBufferCreate(RenderState->Device, &RenderState->GpuArena,
-                                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                     sizeof(gpu_instance_entry)*Scene->MaxNumOpaqueInstances);
+        ScenePoolCreate(&Scene->TransparentInstances, &DemoState->Arena, sizeof(transparent_instance_entry));
+        GrowableBufferCreate(&Scene->TransparentInstanceBuffer, "scene", VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                             sizeof(gpu_transparent_instance_entry), GROWABLE_BUFFER_MIN_CAPACITY);
 
         // NOTE: Create general descriptor set layouts
         {
@@ -209,6 +554,24 @@ DEMO_INIT(Init)
                 VkDescriptorLayoutEnd(RenderState->Device, &Builder);
             }
 
+            // NOTE: Bindless material arrays get indexed with a dynamically uniform material id. Without the dynamic indexing feature
+            // enabled at device creation shaders may only use constant indices, so bindless stays off unless the device was created with
+            // it (DEVICE_SAMPLED_IMAGE_DYNAMIC_INDEXING) and the per stage limits fit both arrays
+            {
+                VkPhysicalDeviceFeatures Features = {};
+                vkGetPhysicalDeviceFeatures(RenderState->PhysicalDevice, &Features);
+                VkPhysicalDeviceProperties Properties = {};
+                vkGetPhysicalDeviceProperties(RenderState->PhysicalDevice, &Properties);
+                Scene->BindlessMaterialsSupported = (DEVICE_SAMPLED_IMAGE_DYNAMIC_INDEXING && Features.shaderSampledImageArrayDynamicIndexing &&
+                                                     Properties.limits.maxPerStageDescriptorSamplers >= 2*MAX_BINDLESS_MATERIALS &&
+                                                     Properties.limits.maxPerStageDescriptorSampledImages >= 2*MAX_BINDLESS_MATERIALS);
+                
+                vk_descriptor_layout_builder Builder = VkDescriptorLayoutBegin(&Scene->BindlessMaterialDescLayout);
+                VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_BINDLESS_MATERIALS, VK_SHADER_STAGE_FRAGMENT_BIT);
+                VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_BINDLESS_MATERIALS, VK_SHADER_STAGE_FRAGMENT_BIT);
+                VkDescriptorLayoutEnd(RenderState->Device, &Builder);
+            }
+
             {
                 vk_descriptor_layout_builder Builder = VkDescriptorLayoutBegin(&Scene->SceneDescLayout);
                 VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
@@ -216,33 +579,70 @@ DEMO_INIT(Init)
                 VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
                 VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
                 VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
+                VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
+                VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
                 VkDescriptorLayoutEnd(RenderState->Device, &Builder);
             }
         }
 
         // NOTE: Populate descriptors
+        Scene->BindlessMaterialDescriptor = VkDescriptorSetAllocate(RenderState->Device, RenderState->DescriptorPool, Scene->BindlessMaterialDescLayout);
         Scene->SceneDescriptor = VkDescriptorSetAllocate(RenderState->Device, RenderState->DescriptorPool, Scene->SceneDescLayout);
         VkDescriptorBufferWrite(&RenderState->DescriptorManager, Scene->SceneDescriptor, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, Scene->SceneBuffer);
-        VkDescriptorBufferWrite(&RenderState->DescriptorManager, Scene->SceneDescriptor, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Scene->OpaqueInstanceBuffer);
-        VkDescriptorBufferWrite(&RenderState->DescriptorManager, Scene->SceneDescriptor, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Scene->PointLightBuffer);
         VkDescriptorBufferWrite(&RenderState->DescriptorManager, Scene->SceneDescriptor, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Scene->DirectionalLightBuffer);
-        VkDescriptorBufferWrite(&RenderState->DescriptorManager, Scene->SceneDescriptor, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Scene->PointLightTransforms);
+        SceneGrowableBuffersWrite(Scene);
     }
 
     // NOTE: Create render data
     DemoState->SwapChainFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
     DemoState->CopyToSwapDesc = VkDescriptorSetAllocate(RenderState->Device, RenderState->DescriptorPool, DemoState->CopyToSwapDescLayout);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, DemoState->CopyToSwapDesc, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                            DemoState->CopyToSwapGlobals);
     {
         renderer_create_info CreateInfo = {};
         CreateInfo.Width = RenderState->WindowWidth;
         CreateInfo.Height = RenderState->WindowHeight;
         CreateInfo.ColorFormat = DemoState->SwapChainFormat;
         CreateInfo.MaterialDescLayout = DemoState->Scene.MaterialDescLayout;
+        CreateInfo.BindlessMaterialDescLayout = DemoState->Scene.BindlessMaterialDescLayout;
         CreateInfo.SceneDescLayout = DemoState->Scene.SceneDescLayout;
         CreateInfo.Scene = &DemoState->Scene;
-        TiledDeferredCreate(CreateInfo, &DemoState->CopyToSwapDesc, &DemoState->TiledDeferredState);
+        DemoState->ActiveRenderer = RendererType_TiledDeferred;
+        CPU_TIMED_BLOCK("RendererCreate");
+        RendererCreate(CreateInfo, DemoState->CopyToSwapDesc, DemoState->ActiveRenderer, &DemoState->Renderer);
     }
 
+    // NOTE: Profiling
+    GpuTimersCreate(&DemoState->GpuTimers);
+#if LIGHT_BENCHMARK
+    LightBenchmarkBegin(&DemoState->LightBenchmark, &DemoState->ScenarioRunner, 8, 64);
+#endif
+#if SCENARIO_BENCHMARK
+    ScenarioRunnerBegin(&DemoState->ScenarioRunner, &DemoState->LightBenchmark, 8);
+#endif
+    DemoState->TileSizeTuner.TileSize = TILE_SIZE_IN_PIXELS;
+    SoftwareRasterCreate(&DemoState->SoftwareRaster, SOFTWARE_RASTER);
+#if GOLDEN_TEST
+    GoldenTestBegin(&DemoState->GoldenTest, GOLDEN_TEST_WARMUP_FRAMES, GOLDEN_TEST_MEASURE_FRAMES, GOLDEN_TEST_UPDATE);
+    MemoryStatsArenaAdd(&DemoState->MemoryStats, "golden_test", false, &DemoState->GoldenTest.Arena.Used, DemoState->GoldenTest.Arena.Size);
+#endif
+#if TILE_SIZE_AUTO_TUNE
+    TileSizeTunerBegin(&DemoState->TileSizeTuner, 8, 64);
+#endif
+#if INPUT_CAPTURE_MODE
+    InputCaptureBegin(&DemoState->InputCapture, input_capture_mode(INPUT_CAPTURE_MODE), INPUT_CAPTURE_FILE_NAME, &DemoState->RandomSeries, DEMO_RANDOM_SEED);
+#endif
+#if LIGHT_GRID_STATS
+    LightGridStatsEnable(&DemoState->Renderer.TiledDeferred.Tiled.LightGridStats, true, "light_grid_stats.csv");
+#endif
+#if LIGHT_TEST_COMPARE
+    LightTestCompareBegin(&DemoState->LightTestCompare, 8, 64);
+    if (!DemoState->Renderer.TiledDeferred.Tiled.LightGridStats.Enabled)
+    {
+        LightGridStatsEnable(&DemoState->Renderer.TiledDeferred.Tiled.LightGridStats, true, 0);
+    }
+#endif
+    
     // NOTE: Copy To Swap FullScreen Pass
     DemoState->CopyToSwapPass = FullScreenPassCreate("shader_copy_to_swap_frag.spv", "main", &DemoState->CopyToSwapTarget, 0, 1,
                                                      &DemoState->CopyToSwapDescLayout, 1, &DemoState->CopyToSwapDesc);
@@ -251,27 +651,18 @@ DEMO_INIT(Init)
     vk_commands Commands = RenderState->Commands;
     VkCommandsBegin(RenderState->Device, Commands);
     {
+        CPU_TIMED_BLOCK("AssetUpload");
         render_scene* Scene = &DemoState->Scene;
         
         // NOTE: Push textures
         vk_image WhiteTexture = {};
+        software_texture* WhiteCpuTexture = PushStruct(&DemoState->Arena, software_texture);
         {
-            u32 Texels[] =
-            {
-                0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 
-                0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF,
-                0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 
-                0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF,
-                0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 
-                0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF,
-                0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 
-                0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF, 0xFF000000, 0xFFFFFFFF,
-            };
-
-            u32 Dim = 8;
+            u32* Texels = WhiteTexels;
+            u32 Dim = WHITE_TEXTURE_DIM;
             u32 ImageSize = Dim*Dim*sizeof(u32);
-            WhiteTexture = VkImageCreate(RenderState->Device, &RenderState->GpuArena, Dim, Dim, VK_FORMAT_R8G8B8A8_UNORM,
-                                         VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+            WhiteTexture = TaggedImageCreate("textures", &RenderState->GpuArena, Dim, Dim, VK_FORMAT_R8G8B8A8_UNORM,
+                                             VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
 
             // TODO: Better barrier here pls
             u8* GpuMemory = VkTransferPushWriteImage(&RenderState->TransferManager, WhiteTexture.Image, Dim, Dim, ImageSize,
@@ -280,38 +671,114 @@ DEMO_INIT(Init)
                                                      BarrierMask(VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT));
 
             Copy(Texels, GpuMemory, ImageSize);
+
+            WhiteCpuTexture->Width = Dim;
+            WhiteCpuTexture->Height = Dim;
+            WhiteCpuTexture->Texels = PushArray(&DemoState->Arena, u32, Dim*Dim);
+            Copy(Texels, WhiteCpuTexture->Texels, ImageSize);
+        }
+
+        // NOTE: Every bindless slot has to hold a valid texture, unused ones point to white
+        for (u32 MaterialId = 0; MaterialId < MAX_BINDLESS_MATERIALS; ++MaterialId)
+        {
+            SceneBindlessMaterialWrite(Scene, MaterialId, WhiteTexture, WhiteTexture);
         }
                         
         // NOTE: Push meshes
         DemoState->Quad = SceneMeshAdd(Scene, WhiteTexture, WhiteTexture, AssetsPushQuad());
         DemoState->Cube = SceneMeshAdd(Scene, WhiteTexture, WhiteTexture, AssetsPushCube());
-        DemoState->Sphere = SceneMeshAdd(Scene, WhiteTexture, WhiteTexture, AssetsPushSphere(64, 64));
+        SceneMeshCpuCopySet(Scene, DemoState->Cube, MeshCubeCreate(&DemoState->TempArena));
+        DemoState->Sphere = SceneCpuMeshAdd(Scene, &DemoState->MeshReports, "sphere", WhiteTexture, WhiteTexture,
+                                            MeshSphereCreate(&DemoState->TempArena, 64, 64));
+        {
+            SceneMeshGet(Scene, DemoState->Sphere)->BoundingRadius = 1.0f;
+            for (u32 LodId = 0; LodId < ArrayCount(SphereLodTessellations); ++LodId)
+            {
+                u32 Tessellation = SphereLodTessellations[LodId];
+                scene_handle LodMesh = SceneCpuMeshAdd(Scene, &DemoState->MeshReports, SphereLodNames[LodId], WhiteTexture, WhiteTexture,
+                                                       MeshSphereCreate(&DemoState->TempArena, Tessellation, Tessellation));
+                SceneMeshLodAdd(Scene, DemoState->Sphere, LodMesh, SphereLodMinScreenSizes[LodId]);
+            }
+        }
+        MeshOptimizerReportsDump(&DemoState->MeshReports, MESH_OPTIMIZER_FILE_NAME);
 
-        TiledDeferredAddMeshes(&DemoState->TiledDeferredState, Scene->RenderMeshes + DemoState->Quad);
+        // NOTE: Light volumes keep the framework sphere, the deferred inside/outside split culls by its winding
+        DemoState->LightVolumeSphere = SceneMeshAdd(Scene, WhiteTexture, WhiteTexture, AssetsPushSphere(64, 64));
 
-        VkDescriptorManagerFlush(RenderState->Device, &RenderState->DescriptorManager);
+        RendererAddMeshes(&DemoState->Renderer, SceneMeshGet(Scene, DemoState->Quad), SceneMeshGet(Scene, DemoState->LightVolumeSphere));
+
+        // NOTE: Every mesh samples the white texture
+        for (u32 MeshId = 0; MeshId < Scene->RenderMeshes.NumItems; ++MeshId)
+        {
+            ScenePoolAt(&Scene->RenderMeshes, render_mesh, MeshId)->CpuColor = WhiteCpuTexture;
+        }
+
+        {
+            CPU_TIMED_BLOCK("DescriptorFlush");
+            VkDescriptorManagerFlush(RenderState->Device, &RenderState->DescriptorManager);
+        }
         VkTransferManagerFlush(&RenderState->TransferManager, RenderState->Device, RenderState->Commands.Buffer, &RenderState->BarrierManager);
     }
     
     VkCommandsSubmit(RenderState->GraphicsQueue, Commands);
+
+    MemoryStatsDump(&DemoState->MemoryStats, MEMORY_STATS_FILE_NAME);
 }
 
 DEMO_DESTROY(Destroy)
 {
+#if CPU_PROFILER
+    CpuProfilerExport(&DemoState->CpuProfiler, CPU_PROFILER_FILE_NAME);
+#endif
+    
+    // NOTE: Last dump has the peaks of the whole run
+    MemoryStatsUpdate(&DemoState->MemoryStats);
+    MemoryStatsDump(&DemoState->MemoryStats, MEMORY_STATS_FILE_NAME);
+    StagingRingStatsDump(&DemoState->StagingRing, STAGING_RING_FILE_NAME);
+    FrameArenaStatsDump(&DemoState->FrameArena, FRAME_ARENA_FILE_NAME);
+    DynamicResolutionStatsDump(&DemoState->DynamicResolution, DYNAMIC_RESOLUTION_FILE_NAME);
+    InputCaptureStop(&DemoState->InputCapture);
+    LightGridStatsLogClose(&DemoState->Renderer.TiledDeferred.Tiled.LightGridStats);
+    LightGridStatsLogClose(&DemoState->Renderer.TiledForward.Tiled.LightGridStats);
+
+    // NOTE: Shutting down, the only place left where we wait for the device to go idle
+    VkCheckResult(vkDeviceWaitIdle(RenderState->Device));
+    DeletionQueueFlush(&DemoState->DeletionQueue);
+    GoldenTestDestroy(&DemoState->GoldenTest);
 }
 
-DEMO_SWAPCHAIN_CHANGE(SwapChainChange)
+inline void DemoSwapChainResize()
 {
-    VkCheckResult(vkDeviceWaitIdle(RenderState->Device));
-    VkSwapChainReCreate(&DemoState->TempArena, WindowWidth, WindowHeight, RenderState->PresentMode);
+    // IMPORTANT: Only call after VkCommandsBegin waited on the previous frame. The new targets come out of the same render target arenas
+    // right after they get cleared, so they alias the memory of the ones they replace. That is only safe because we have a single frame
+    // in flight and that wait means the GPU is done with the old ones. The deletion queue only defers destroying the old handles, more
+    // frames in flight would need a second arena per generation
+    CPU_TIMED_BLOCK("SwapChainResize");
+
+    u32 Width = DemoState->ResizeWidth;
+    u32 Height = DemoState->ResizeHeight;
+    DemoState->ResizePending = false;
+    
+    VkSwapChainReCreate(FrameArenaGet(&DemoState->FrameArena), Width, Height, RenderState->PresentMode);
 
     DemoState->SwapChainEntry.Width = RenderState->WindowWidth;
     DemoState->SwapChainEntry.Height = RenderState->WindowHeight;
 
     DemoState->Scene.Camera.AspectRatio = f32(RenderState->WindowWidth / RenderState->WindowHeight);
+    DynamicResolutionResize(&DemoState->DynamicResolution, RenderState->WindowWidth, RenderState->WindowHeight);
     
-    TiledDeferredSwapChainChange(&DemoState->TiledDeferredState, RenderState->WindowWidth, RenderState->WindowHeight,
-                                 DemoState->SwapChainFormat, &DemoState->Scene, &DemoState->CopyToSwapDesc);
+    RendererSwapChainChange(&DemoState->Renderer, RenderState->WindowWidth, RenderState->WindowHeight, DemoState->SwapChainFormat,
+                            &DemoState->Scene);
+
+    MemoryStatsDump(&DemoState->MemoryStats, MEMORY_STATS_FILE_NAME);
+}
+
+DEMO_SWAPCHAIN_CHANGE(SwapChainChange)
+{
+    // NOTE: Don't stall here, the resize gets applied at the start of the next frame once its fence wait is done
+    DemoState->ResizePending = true;
+    DemoState->ResizeWidth = WindowWidth;
+    DemoState->ResizeHeight = WindowHeight;
 }
 
 DEMO_CODE_RELOAD(CodeReload)
@@ -324,103 +791,323 @@ DEMO_CODE_RELOAD(CodeReload)
     VkGetGlobalFunctionPointers(VulkanLib);
     VkGetInstanceFunctionPointers();
     VkGetDeviceFunctionPointers();
+
+#if CPU_PROFILER
+    CpuProfilerReset(&DemoState->CpuProfiler);
+#endif
+
+    // NOTE: Open files belong to the CRT of the unloaded module (we link it statically)
+    InputCaptureReload(&DemoState->InputCapture);
+    LightGridStatsReload(&DemoState->Renderer.TiledDeferred.Tiled.LightGridStats);
+    LightGridStatsReload(&DemoState->Renderer.TiledForward.Tiled.LightGridStats);
 }
 
 DEMO_MAIN_LOOP(MainLoop)
 {
+    CPU_TIMED_BLOCK("MainLoop");
+
+    // NOTE: Minimized, we can't create a zero sized swap chain so skip frames until we get a real size again
+    if (DemoState->ResizePending && (DemoState->ResizeWidth == 0 || DemoState->ResizeHeight == 0))
+    {
+        return;
+    }
+    
+    vk_commands Commands = RenderState->Commands;
+    {
+        // NOTE: Waits on the previous frames fence
+        CPU_TIMED_BLOCK("CommandsBegin");
+        VkCommandsBegin(RenderState->Device, Commands);
+    }
+    StagingRingFrameBegin(&DemoState->StagingRing, Commands.Fence);
+    DeletionQueueFrameBegin(&DemoState->DeletionQueue, Commands.Fence);
+    FrameArenaFrameBegin(&DemoState->FrameArena, Commands.Fence);
+
+    // NOTE: Resizes and tile size changes recreate targets and light grids. The previous frame is done at this point, and the work
+    // they need on the GPU gets recorded into this frames command buffer, so neither of them has to wait for the device to go idle
+    if (DemoState->ResizePending)
+    {
+        DemoSwapChainResize();
+    }
+    
+    if (DemoState->Renderer.TiledDeferred.Tiled.TileSize != DemoState->TileSizeTuner.TileSize)
+    {
+        RendererTileSizeSet(&DemoState->Renderer, DemoState->TileSizeTuner.TileSize, RenderState->WindowWidth, RenderState->WindowHeight,
+                            DemoState->SwapChainFormat, &DemoState->Scene);
+    }
+    
     u32 ImageIndex;
-    VkCheckResult(vkAcquireNextImageKHR(RenderState->Device, RenderState->SwapChain, UINT64_MAX, RenderState->ImageAvailableSemaphore,
-                                        VK_NULL_HANDLE, &ImageIndex));
+    {
+        CPU_TIMED_BLOCK("AcquireImage");
+        VkResult AcquireResult = vkAcquireNextImageKHR(RenderState->Device, RenderState->SwapChain, UINT64_MAX,
+                                                       RenderState->ImageAvailableSemaphore, VK_NULL_HANDLE, &ImageIndex);
+        if (AcquireResult == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            // NOTE: Window changed before we got notified. Skip the frame and recreate at the start of the next one, by then the platform
+            // has usually sent us the real size. Recreating and acquiring right away just hits out of date again during a drag resize.
+            // The semaphore wasn't signaled so we submit what got recorded so far without waiting on it, which keeps the fence
+            // signaled for the next VkCommandsBegin
+            if (!DemoState->ResizePending)
+            {
+                DemoState->ResizePending = true;
+                DemoState->ResizeWidth = RenderState->WindowWidth;
+                DemoState->ResizeHeight = RenderState->WindowHeight;
+            }
+
+            VkCheckResult(vkEndCommandBuffer(Commands.Buffer));
+            VkSubmitInfo SubmitInfo = {};
+            SubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            SubmitInfo.commandBufferCount = 1;
+            SubmitInfo.pCommandBuffers = &Commands.Buffer;
+            VkCheckResult(vkQueueSubmit(RenderState->GraphicsQueue, 1, &SubmitInfo, Commands.Fence));
+            DeletionQueueFrameEnd(&DemoState->DeletionQueue, Commands.Fence);
+            FrameArenaFrameEnd(&DemoState->FrameArena, Commands.Fence);
+            
+            return;
+        }
+        else if (AcquireResult == VK_SUBOPTIMAL_KHR)
+        {
+            // NOTE: Still presentable, recreate next frame
+            DemoState->ResizePending = true;
+            DemoState->ResizeWidth = RenderState->WindowWidth;
+            DemoState->ResizeHeight = RenderState->WindowHeight;
+        }
+        else
+        {
+            VkCheckResult(AcquireResult);
+        }
+    }
     DemoState->SwapChainEntry.View = RenderState->SwapChainViews[ImageIndex];
 
-    vk_commands Commands = RenderState->Commands;
-    VkCommandsBegin(RenderState->Device, Commands);
+    GpuTimersFrameBegin(Commands, &DemoState->GpuTimers);
+    StagingRingTimerUpdate(&DemoState->StagingRing, &DemoState->GpuTimers);
+    LightBenchmarkUpdate(&DemoState->LightBenchmark, &DemoState->GpuTimers);
+    ScenarioRunnerUpdate(&DemoState->ScenarioRunner, &DemoState->GpuTimers, &DemoState->Scene);
+    TileSizeTunerUpdate(&DemoState->TileSizeTuner, &DemoState->GpuTimers);
+    LightTestCompareUpdate(&DemoState->LightTestCompare, &DemoState->GpuTimers, &DemoState->Renderer.TiledDeferred.Tiled.LightGridStats);
+    GoldenTestUpdate(&DemoState->GoldenTest, &DemoState->GpuTimers);
+    DynamicResolutionUpdate(&DemoState->DynamicResolution, &DemoState->GpuTimers);
+    InputCaptureTimersLog(&DemoState->InputCapture, &DemoState->GpuTimers);
+    MemoryStatsUpdate(&DemoState->MemoryStats);
 
+    // NOTE: Switch renderers once the previous frame has finished with the output descriptor
+    {
+        renderer_type RendererType = DemoState->ScenarioRunner.Running ? DemoState->ScenarioRunner.CurrRenderer : DemoState->ActiveRenderer;
+        RendererType = DemoState->GoldenTest.Running || DemoState->LightTestCompare.Running ? RendererType_TiledDeferred : RendererType;
+        if (DemoState->Renderer.Type != RendererType)
+        {
+            RendererSetType(&DemoState->Renderer, RendererType);
+        }
+    }
+
+    LightTestCompareSettingsApply(&DemoState->LightTestCompare, &DemoState->Renderer.TiledDeferred);
+    
+    GpuTimerBegin(Commands, &DemoState->GpuTimers, GpuTimer_Frame);
+    
     // NOTE: Update pipelines
-    VkPipelineUpdateShaders(RenderState->Device, &RenderState->CpuArena, &RenderState->PipelineManager);
+    {
+        CPU_TIMED_BLOCK("PipelineUpdate");
+        VkPipelineUpdateShaders(RenderState->Device, &RenderState->CpuArena, &RenderState->PipelineManager);
+    }
 
-    RenderTargetUpdateEntries(&DemoState->TempArena, &DemoState->CopyToSwapTarget);
+    RenderTargetUpdateEntries(FrameArenaGet(&DemoState->FrameArena), &DemoState->CopyToSwapTarget);
     
     // NOTE: Upload scene data
     {
         render_scene* Scene = &DemoState->Scene;
-        Scene->NumOpaqueInstances = 0;
-        Scene->NumPointLights = 0;
-        CameraUpdate(&Scene->Camera, CurrInput, PrevInput);
+        ScenePoolClear(&Scene->OpaqueInstances);
+        Scene->NumOpaqueTriangles = 0;
+        Scene->NumOpaqueFullTriangles = 0;
+        ScenePoolClear(&Scene->TransparentInstances);
+        ScenePoolClear(&Scene->PointLights);
+        benchmark_scenario* Scenario = BenchmarkScenarios + DemoState->ActiveScenario;
+        if (DemoState->ScenarioRunner.Running)
+        {
+            Scenario = BenchmarkScenarios + DemoState->ScenarioRunner.CurrScenario;
+            ScenarioCameraApply(Scenario, ScenarioRunnerFrameId(&DemoState->ScenarioRunner), &Scene->Camera);
+        }
+        else if (DemoState->GoldenTest.Running)
+        {
+            // NOTE: Every frame of a scenario renders the same image
+            Scenario = BenchmarkScenarios + DemoState->GoldenTest.CurrScenario;
+            ScenarioCameraApply(Scenario, 0, &Scene->Camera);
+        }
+        else
+        {
+            if (!InputCaptureFrame(&DemoState->InputCapture, CurrInput, sizeof(*CurrInput), &Scene->Camera))
+            {
+                CameraUpdate(&Scene->Camera, CurrInput, PrevInput);
+                InputCaptureRecord(&DemoState->InputCapture, CurrInput, sizeof(*CurrInput), &Scene->Camera);
+            }
+        }
         
         // NOTE: Populate scene
         {
-            // NOTE: Add Instances
+            CPU_TIMED_BLOCK("ScenePopulate");
+            ScenarioPopulate(Scenario, Scene);
+            SceneDirectionalLightSet(Scene, Normalize(V3(1.0f, 0.4f, 0.0f)), 0.3f*V3(1.0f, 1.0f, 1.0f), V3(0.4f, 0.4f, 0.4f));
+            LightBenchmarkPopulate(&DemoState->LightBenchmark, Scene);
+
+            // NOTE: Everything is added now, so the GPU buffers can grow before anything gets pushed to them
+            SceneGpuBuffersReserve(Scene);
+        }
+
+        // NOTE: Push Instances
+        {
+            CPU_TIMED_BLOCK("InstanceUpload");
+            u32 NumOpaqueInstances = Scene->OpaqueInstances.NumItems;
+            if (NumOpaqueInstances > 0)
             {
-                SceneOpaqueInstanceAdd(Scene, DemoState->Sphere, M4Pos(V3(0)));
-                SceneOpaqueInstanceAdd(Scene, DemoState->Cube, M4Pos(V3(0, 0, 5)) * M4Scale(V3(10, 10, 1)));
-                SceneOpaqueInstanceAdd(Scene, DemoState->Cube, M4Pos(V3(0, -5, 0)) * M4Scale(V3(10, 1, 10)));
-                SceneOpaqueInstanceAdd(Scene, DemoState->Cube, M4Pos(V3(0, 5, 0)) * M4Scale(V3(10, 1, 10)));
-                SceneOpaqueInstanceAdd(Scene, DemoState->Cube, M4Pos(V3(-5, 0, 0)) * M4Scale(V3(1, 10, 10)));
-                SceneOpaqueInstanceAdd(Scene, DemoState->Cube, M4Pos(V3(5, 0, 0)) * M4Scale(V3(1, 10, 10)));
-                
-                gpu_instance_entry* GpuData = VkTransferPushWriteArray(&RenderState->TransferManager, Scene->OpaqueInstanceBuffer, gpu_instance_entry, Scene->NumOpaqueInstances,
-                                                                       BarrierMask(VkAccessFlagBits(0), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT),
-                                                                       BarrierMask(VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT));
+                gpu_instance_entry* GpuData = StagingRingPushWriteArray(&DemoState->StagingRing, Scene->OpaqueInstanceBuffer.Buffer, gpu_instance_entry,
+                                                                        NumOpaqueInstances, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);
 
-                for (u32 InstanceId = 0; InstanceId < Scene->NumOpaqueInstances; ++InstanceId)
+                for (u32 InstanceId = 0; InstanceId < NumOpaqueInstances; ++InstanceId)
                 {
-                    GpuData[InstanceId].WTransform = Scene->OpaqueInstances[InstanceId].WTransform;
-                    GpuData[InstanceId].WVPTransform = Scene->OpaqueInstances[InstanceId].WVPTransform;
+                    instance_entry* Instance = SceneOpaqueInstanceAt(Scene, InstanceId);
+                    GpuData[InstanceId].WTransform = Instance->WTransform;
+                    GpuData[InstanceId].WVPTransform = Instance->WVPTransform;
+                    render_mesh* Mesh = SceneMeshGet(Scene, Instance->Mesh);
+                    GpuData[InstanceId].PosScale = Mesh->PosScale;
+                    GpuData[InstanceId].MaterialId = Mesh->MaterialId;
+                    GpuData[InstanceId].PosBias = Mesh->PosBias;
                 }
             }
-            
-            SceneDirectionalLightSet(Scene, Normalize(V3(1.0f, 0.4f, 0.0f)), 0.3f*V3(1.0f, 1.0f, 1.0f), V3(0.4f, 0.4f, 0.4f));
-        }        
+
+            u32 NumTransparentInstances = Scene->TransparentInstances.NumItems;
+            if (NumTransparentInstances > 0)
+            {
+                gpu_transparent_instance_entry* TransparentData = StagingRingPushWriteArray(&DemoState->StagingRing, Scene->TransparentInstanceBuffer.Buffer,
+                                                                                            gpu_transparent_instance_entry, NumTransparentInstances,
+                                                                                            VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);
+
+                for (u32 InstanceId = 0; InstanceId < NumTransparentInstances; ++InstanceId)
+                {
+                    transparent_instance_entry* Instance = SceneTransparentInstanceAt(Scene, InstanceId);
+                    TransparentData[InstanceId].WTransform = Instance->WTransform;
+                    TransparentData[InstanceId].WVPTransform = Instance->WVPTransform;
+                    TransparentData[InstanceId].Color = Instance->Color;
+                }
+            }
+        }
+
+        // NOTE: CPU reference of this frame, only reads the scene we just populated
+        if (DemoState->SoftwareRaster.Enabled && !DemoState->SoftwareRaster.Done)
+        {
+            software_raster* SoftwareRaster = &DemoState->SoftwareRaster;
+            SoftwareRasterFrame(SoftwareRaster, Scene, RenderState->WindowWidth, RenderState->WindowHeight);
+
+            // NOTE: The runs size the arenas, so they only get tracked once they exist
+            MemoryStatsArenaAdd(&DemoState->MemoryStats, "software_raster", false, &SoftwareRaster->Arena.Used, SoftwareRaster->Arena.Size);
+            MemoryStatsArenaAdd(&DemoState->MemoryStats, "software_raster_bins", false, &SoftwareRaster->BinArena.Used,
+                                SoftwareRaster->BinArena.Size);
+        }
         
         // NOTE: Push Point Lights
-        if (Scene->NumPointLights > 0)
+        if (Scene->PointLights.NumItems > 0)
         {
-            point_light* PointLights = VkTransferPushWriteArray(&RenderState->TransferManager, Scene->PointLightBuffer, point_light, Scene->NumPointLights,
-                                                                BarrierMask(VkAccessFlagBits(0), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT),
-                                                                BarrierMask(VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT));
-            m4* Transforms = VkTransferPushWriteArray(&RenderState->TransferManager, Scene->PointLightTransforms, m4, Scene->NumPointLights,
-                                                      BarrierMask(VkAccessFlagBits(0), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT),
-                                                      BarrierMask(VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT));
+            CPU_TIMED_BLOCK("PointLightUpload");
+            ScenePointLightsSort(Scene, RendererLightsDepthSorted(&DemoState->Renderer, Scene->PointLights.NumItems));
+            
+            u32 NumGroups = CeilU32(f32(Scene->PointLights.NumItems) / f32(LIGHT_GROUP_SIZE));
+            point_light* PointLights = StagingRingPushWriteArray(&DemoState->StagingRing, Scene->PointLightBuffer.Buffer, point_light, Scene->PointLights.NumItems,
+                                                                 VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);
+            m4* Transforms = StagingRingPushWriteArray(&DemoState->StagingRing, Scene->PointLightTransforms.Buffer, m4, Scene->PointLights.NumItems,
+                                                       VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);
+            v4* GroupBounds = StagingRingPushWriteArray(&DemoState->StagingRing, Scene->PointLightGroupBounds.Buffer, v4, NumGroups,
+                                                        VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
 
-            for (u32 LightId = 0; LightId < Scene->NumPointLights; ++LightId)
+            // NOTE: Staging memory is write combined, so the group bounds work off our own copy of the view space positions instead of
+            // reading back what we just wrote
+            v3* ViewPositions = PushArray(FrameArenaGet(&DemoState->FrameArena), v3, Scene->PointLights.NumItems);
+            m4 VTransform = CameraGetV(&Scene->Camera);
+            m4 VPTransform = CameraGetVP(&Scene->Camera);
+            for (u32 LightId = 0; LightId < Scene->PointLights.NumItems; ++LightId)
             {
-                point_light* CurrLight = Scene->PointLights + LightId;
-                PointLights[LightId] = *CurrLight;
+                point_light* CurrLight = ScenePointLightAt(Scene, Scene->PointLightSortIds[LightId]);
                 // NOTE: Convert to view space
-                v4 Test = CameraGetV(&Scene->Camera) * V4(CurrLight->Pos, 1.0f);
-                PointLights[LightId].Pos = (CameraGetV(&Scene->Camera) * V4(CurrLight->Pos, 1.0f)).xyz;
-                Transforms[LightId] = CameraGetVP(&Scene->Camera) * M4Pos(CurrLight->Pos) * M4Scale(V3(CurrLight->MaxDistance));
+                ViewPositions[LightId] = (VTransform * V4(CurrLight->Pos, 1.0f)).xyz;
+                PointLights[LightId] = *CurrLight;
+                PointLights[LightId].Pos = ViewPositions[LightId];
+                Transforms[LightId] = VPTransform * M4Pos(CurrLight->Pos) * M4Scale(V3(CurrLight->MaxDistance));
+            }
+
+            // NOTE: Build a bounding sphere per light group in view space
+            for (u32 GroupId = 0; GroupId < NumGroups; ++GroupId)
+            {
+                u32 StartLightId = GroupId*LIGHT_GROUP_SIZE;
+                u32 EndLightId = Min(StartLightId + LIGHT_GROUP_SIZE, Scene->PointLights.NumItems);
+
+                v3 Center = V3(0);
+                for (u32 LightId = StartLightId; LightId < EndLightId; ++LightId)
+                {
+                    Center += ViewPositions[LightId];
+                }
+                Center = Center / f32(EndLightId - StartLightId);
+
+                f32 Radius = 0.0f;
+                for (u32 LightId = StartLightId; LightId < EndLightId; ++LightId)
+                {
+                    f32 MaxDistance = ScenePointLightAt(Scene, Scene->PointLightSortIds[LightId])->MaxDistance;
+                    Radius = Max(Radius, Length(ViewPositions[LightId] - Center) + MaxDistance);
+                }
+
+                GroupBounds[GroupId] = V4(Center, Radius);
             }
         }
 
         // NOTE: Push Directional Lights
         {
-            directional_light* GpuData = VkTransferPushWriteStruct(&RenderState->TransferManager, Scene->DirectionalLightBuffer, directional_light,
-                                                                   BarrierMask(VkAccessFlagBits(0), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT),
-                                                                   BarrierMask(VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT));
+            directional_light* GpuData = StagingRingPushWriteStruct(&DemoState->StagingRing, Scene->DirectionalLightBuffer, directional_light,
+                                                                    VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);
             Copy(&Scene->DirectionalLight, GpuData, sizeof(directional_light));
         }
 
         // NOTE: Push Scene Globals
         {
-            scene_globals* Data = VkTransferPushWriteStruct(&RenderState->TransferManager, Scene->SceneBuffer, scene_globals,
-                                                            BarrierMask(VkAccessFlagBits(0), VK_PIPELINE_STAGE_ALL_COMMANDS_BIT),
-                                                            BarrierMask(VK_ACCESS_UNIFORM_READ_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT));
+            scene_globals* Data = StagingRingPushWriteStruct(&DemoState->StagingRing, Scene->SceneBuffer, scene_globals,
+                                                             VK_ACCESS_UNIFORM_READ_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
             *Data = {};
             Data->CameraPos = Scene->Camera.Pos;
-            Data->NumPointLights = Scene->NumPointLights;
+            Data->NumPointLights = Scene->PointLights.NumItems;
+            Data->VTransform = CameraGetV(&Scene->Camera);
+        }
+
+        // NOTE: Render size for this frame, the copy to swap pass upscales from it
+        u32 RenderWidth = RenderState->WindowWidth;
+        u32 RenderHeight = RenderState->WindowHeight;
+        if (DemoState->DynamicResolution.Enabled && RendererDynamicResolutionSupported(&DemoState->Renderer) && !DemoState->GoldenTest.Running)
+        {
+            RenderWidth = DemoState->DynamicResolution.Width;
+            RenderHeight = DemoState->DynamicResolution.Height;
+        }
+        
+        {
+            CPU_TIMED_BLOCK("RendererGlobalsPush");
+            RendererGlobalsPush(&DemoState->Renderer, Scene, RenderWidth, RenderHeight);
+        }
+
+        // NOTE: Push Copy To Swap Globals
+        {
+            copy_to_swap_globals* Data = StagingRingPushWriteStruct(&DemoState->StagingRing, DemoState->CopyToSwapGlobals, copy_to_swap_globals,
+                                                                    VK_ACCESS_UNIFORM_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+            v2 TargetSize = V2(f32(RenderState->WindowWidth), f32(RenderState->WindowHeight));
+            Data->UvScale = V2(f32(RenderWidth) / TargetSize.x, f32(RenderHeight) / TargetSize.y);
+            Data->UvMax = V2((f32(RenderWidth) - 0.5f) / TargetSize.x, (f32(RenderHeight) - 0.5f) / TargetSize.y);
         }
 
         // NOTE: Push Scene Globals
         {
-            gpu_ssao_inputs* Data = VkTransferPushWriteStruct(&RenderState->TransferManager, DemoState->TiledDeferredState.SsaoInputBuffer, gpu_ssao_inputs,
-                                                            BarrierMask(VkAccessFlagBits(0), VK_PIPELINE_STAGE_ALL_COMMANDS_BIT),
-                                                            BarrierMask(VK_ACCESS_UNIFORM_READ_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT));
+            gpu_ssao_inputs* Data = StagingRingPushWriteStruct(&DemoState->StagingRing, DemoState->Renderer.TiledDeferred.SsaoInputBuffer, gpu_ssao_inputs,
+                                                             VK_ACCESS_UNIFORM_READ_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
             *Data = {};
 
             Data->VPTransform = CameraGetVP(&DemoState->Scene.Camera);
 
+            // NOTE: Goldens need the same kernel every frame
+            if (DemoState->GoldenTest.Running)
+            {
+                DemoState->RandomSeries = RandomSeriesCreate(GOLDEN_TEST_SEED);
+            }
+
             for (u32 SampleId = 0; SampleId < ArrayCount(Data->HemisphereSamples); ++SampleId)
             {
                 Data->HemisphereSamples[SampleId] = V4(RandomFloat() * 2.0f - 1.0f, RandomFloat() * 2.0f - 1.0f, RandomFloat(), 0.0f);
@@ -436,17 +1123,31 @@ DEMO_MAIN_LOOP(MainLoop)
             }
         }
 
-        VkTransferManagerFlush(&RenderState->TransferManager, RenderState->Device, RenderState->Commands.Buffer, &RenderState->BarrierManager);
+        {
+            CPU_TIMED_BLOCK("TransferFlush");
+            GpuTimerBegin(Commands, &DemoState->GpuTimers, GpuTimer_Upload);
+            StagingRingFlush(&DemoState->StagingRing, Commands);
+            GpuTimerEnd(Commands, &DemoState->GpuTimers, GpuTimer_Upload);
+
+            // NOTE: Only has work when the staging ring overflowed
+            VkTransferManagerFlush(&RenderState->TransferManager, RenderState->Device, RenderState->Commands.Buffer, &RenderState->BarrierManager);
+        }
     }
 
     // NOTE: Render Scene
-    TiledDeferredRender(Commands, &DemoState->TiledDeferredState, &DemoState->Scene);
+    {
+        CPU_TIMED_BLOCK("CommandRecording");
+        RendererRender(Commands, &DemoState->Renderer, &DemoState->Scene);
+        GoldenTestCapture(Commands, &DemoState->GoldenTest, &DemoState->Renderer.TiledDeferred);
+
+        RenderTargetPassBegin(&DemoState->CopyToSwapTarget, Commands, RenderTargetRenderPass_SetViewPort | RenderTargetRenderPass_SetScissor);
+        FullScreenPassRender(Commands, &DemoState->CopyToSwapPass);
+        RenderTargetPassEnd(Commands);
 
-    RenderTargetPassBegin(&DemoState->CopyToSwapTarget, Commands, RenderTargetRenderPass_SetViewPort | RenderTargetRenderPass_SetScissor);
-    FullScreenPassRender(Commands, &DemoState->CopyToSwapPass);
-    RenderTargetPassEnd(Commands);
+        GpuTimerEnd(Commands, &DemoState->GpuTimers, GpuTimer_Frame);
     
-    VkCheckResult(vkEndCommandBuffer(Commands.Buffer));
+        VkCheckResult(vkEndCommandBuffer(Commands.Buffer));
+    }
                     
     // NOTE: Render to our window surface
     // NOTE: Tell queue where we render to surface to wait
@@ -460,7 +1161,12 @@ DEMO_MAIN_LOOP(MainLoop)
     SubmitInfo.pCommandBuffers = &Commands.Buffer;
     SubmitInfo.signalSemaphoreCount = 1;
     SubmitInfo.pSignalSemaphores = &RenderState->FinishedRenderingSemaphore;
-    VkCheckResult(vkQueueSubmit(RenderState->GraphicsQueue, 1, &SubmitInfo, Commands.Fence));
+    {
+        CPU_TIMED_BLOCK("QueueSubmit");
+        VkCheckResult(vkQueueSubmit(RenderState->GraphicsQueue, 1, &SubmitInfo, Commands.Fence));
+    }
+    DeletionQueueFrameEnd(&DemoState->DeletionQueue, Commands.Fence);
+    FrameArenaFrameEnd(&DemoState->FrameArena, Commands.Fence);
     
     VkPresentInfoKHR PresentInfo = {};
     PresentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -469,7 +1175,11 @@ DEMO_MAIN_LOOP(MainLoop)
     PresentInfo.swapchainCount = 1;
     PresentInfo.pSwapchains = &RenderState->SwapChain;
     PresentInfo.pImageIndices = &ImageIndex;
-    VkResult Result = vkQueuePresentKHR(RenderState->PresentQueue, &PresentInfo);
+    VkResult Result = VK_SUCCESS;
+    {
+        CPU_TIMED_BLOCK("Present");
+        Result = vkQueuePresentKHR(RenderState->PresentQueue, &PresentInfo);
+    }
 
     switch (Result)
     {
@@ -480,8 +1190,13 @@ DEMO_MAIN_LOOP(MainLoop)
         case VK_ERROR_OUT_OF_DATE_KHR:
         case VK_SUBOPTIMAL_KHR:
         {
-            // NOTE: Window size changed
-            InvalidCodePath;
+            // NOTE: Window size changed, keep a size we already got notified about, otherwise recreate at the current one
+            if (!DemoState->ResizePending)
+            {
+                DemoState->ResizePending = true;
+                DemoState->ResizeWidth = RenderState->WindowWidth;
+                DemoState->ResizeHeight = RenderState->WindowHeight;
+            }
         } break;
 
         default:
@@ -3,6 +3,7 @@
 #define VALIDATION 1
 
 #include "framework_vulkan\framework_vulkan.h"
+#include "scene_pool.h"
 
 /*
 
@@ -44,34 +45,109 @@ struct point_light
     f32 MaxDistance;
 };
 
+// NOTE: Lights are sorted spatially and split into groups of this size so culling can reject a whole group with one bounds test
+#define LIGHT_GROUP_SIZE 64
+
+/*
+
+  NOTE: Discrete LODs. A mesh can point to a chain of coarser meshes (they are regular scene meshes) together with the smallest
+        screen size each one is still used at. Screen size is the projected bounding sphere radius over half the screen height, so
+        it doesn't depend on the resolution. Instances get their LOD when they are added to the scene, which happens every frame.
+
+        To avoid popping back and forth at a threshold, an instance only moves to a different LOD once its screen size is
+        SCENE_LOD_HYSTERESIS past the threshold. The previous LOD is remembered per instance slot, scenarios add their instances in
+        the same order every frame so a slot stays the same instance.
+
+ */
+
+#define SCENE_LODS 1
+#define SCENE_MAX_LODS 4
+#define SCENE_LOD_HYSTERESIS 0.15f
+#define SCENE_CAMERA_FOV 90.0f
+
+// NOTE: Size of the bindless material texture arrays, every mesh takes one slot. Has to match the shader define
+#define MAX_BINDLESS_MATERIALS 64
+
+// NOTE: Bindless shaders index the material arrays with a per draw material id, which needs shaderSampledImageArrayDynamicIndexing
+// enabled on the device. render_init_params has no way to request device features, so VkInit never enables it. Set this once VkInit
+// creates the device with the feature
+#define DEVICE_SAMPLED_IMAGE_DYNAMIC_INDEXING 0
+
 struct scene_globals
 {
     v3 CameraPos;
     u32 NumPointLights;
+    m4 VTransform;
 };
 
 struct instance_entry
 {
-    u32 MeshId;
+    scene_handle Mesh;
     m4 WTransform;
     m4 WVPTransform;
 };
 
+// NOTE: LOD an instance slot used last frame together with the base mesh it was picked for, zeroed entries match no mesh
+struct scene_lod_state
+{
+    scene_handle Mesh;
+    u32 LodId;
+};
+
 struct gpu_instance_entry
 {
     m4 WTransform;
     m4 WVPTransform;
+    v3 PosScale;
+    u32 MaterialId;
+    v3 PosBias;
+    u32 Pad;
+};
+
+struct transparent_instance_entry
+{
+    scene_handle Mesh;
+    m4 WTransform;
+    m4 WVPTransform;
+    v4 Color;
 };
 
+struct gpu_transparent_instance_entry
+{
+    m4 WTransform;
+    m4 WVPTransform;
+    v4 Color; // NOTE: Tint, alpha is the coverage
+};
+
+struct cpu_mesh;
+struct software_texture;
 struct render_mesh
 {
     vk_image Color;
     vk_image Normal;
     VkDescriptorSet MaterialDescriptor;
+    u32 MaterialId; // NOTE: Slot of our textures in the bindless material arrays, LODs share it with their base mesh
     
     VkBuffer VertexBuffer;
     VkBuffer IndexBuffer;
     u32 NumIndices;
+
+    // NOTE: Optional quantized stream (see mesh_optimizer.h), positions dequantize as Pos * PosScale + PosBias
+    VkBuffer QuantizedVertexBuffer;
+    VkBuffer QuantizedIndexBuffer;
+    VkIndexType QuantizedIndexType;
+    v3 PosScale;
+    v3 PosBias;
+
+    // NOTE: LOD chain, entry 0 is always this mesh. Bounds are a sphere around the model origin
+    f32 BoundingRadius;
+    u32 NumLods;
+    scene_handle LodMeshes[SCENE_MAX_LODS];
+    f32 LodMinScreenSizes[SCENE_MAX_LODS];
+
+    // NOTE: Optional CPU copies for the software rasterizer, meshes without them get skipped there
+    cpu_mesh* CpuMesh;
+    software_texture* CpuColor;
 };
 
 struct render_scene;
@@ -82,11 +158,32 @@ struct renderer_create_info
     VkFormat ColorFormat;
 
     VkDescriptorSetLayout MaterialDescLayout;
+    VkDescriptorSetLayout BindlessMaterialDescLayout;
     VkDescriptorSetLayout SceneDescLayout;
     render_scene* Scene;
 };
 
+#include "gpu_timers.h"
+#include "memory_stats.h"
+#include "cpu_profiler.h"
+#include "readback.h"
+#include "deletion_queue.h"
+#include "staging_ring.h"
+#include "frame_arena.h"
+#include "mesh_optimizer.h"
+#include "dynamic_resolution.h"
+#include "software_raster.h"
+#include "scene_generator.h"
+#include "light_grid_stats.h"
+#include "occlusion_cull.h"
+#include "input_capture.h"
+#include "forward.h"
+#include "deferred.h"
 #include "tiled_deferred.h"
+#include "tiled_forward.h"
+#include "renderer.h"
+#include "benchmark.h"
+#include "golden_test.h"
 
 struct render_scene
 {
@@ -97,32 +194,51 @@ struct render_scene
     VkBuffer SceneBuffer;
     VkDescriptorSet SceneDescriptor;
 
-    // NOTE: Scene Lights
-    u32 MaxNumPointLights;
-    u32 NumPointLights;
-    point_light* PointLights;
-    VkBuffer PointLightBuffer;
-    VkBuffer PointLightTransforms;
+    // NOTE: Scene Lights, the sort arrays hold two halves of MaxNumSortedLights each
+    scene_pool PointLights;
+    growable_buffer PointLightBuffer;
+    growable_buffer PointLightTransforms;
+    growable_buffer PointLightGroupBounds;
+    u32 MaxNumSortedLights;
+    u32* PointLightSortKeys;
+    u32* PointLightSortIds;
     
     directional_light DirectionalLight;
     VkBuffer DirectionalLightBuffer;
 
+    // NOTE: Bindless Materials, every meshes textures also live in one big array so a pass can bind all materials once
+    b32 BindlessMaterialsSupported;
+    VkDescriptorSetLayout BindlessMaterialDescLayout;
+    VkDescriptorSet BindlessMaterialDescriptor;
+
     // NOTE: Scene Meshes
-    u32 MaxNumRenderMeshes;
-    u32 NumRenderMeshes;
-    render_mesh* RenderMeshes;
+    scene_pool RenderMeshes;
+    u32 NumMaterials;
     
     // NOTE: Opaque Instances
-    u32 MaxNumOpaqueInstances;
-    u32 NumOpaqueInstances;
-    instance_entry* OpaqueInstances;
-    VkBuffer OpaqueInstanceBuffer;
+    scene_pool OpaqueInstances;
+    growable_buffer OpaqueInstanceBuffer;
+
+    // NOTE: LOD selection, previous frames choice per dense instance id (scene_lod_state) and the triangles we draw with and without LODs
+    b32 LodsEnabled;
+    chunked_array PrevLods;
+    u64 NumOpaqueTriangles;
+    u64 NumOpaqueFullTriangles;
+
+    // NOTE: Transparent Instances (blended order independently, so they don't need sorting)
+    scene_pool TransparentInstances;
+    growable_buffer TransparentInstanceBuffer;
 };
 
+// NOTE: Seed for RandomFloat, fixed so that runs are reproducible
+#define DEMO_RANDOM_SEED 0x5EED1234
+
 struct demo_state
 {
     linear_arena Arena;
-    linear_arena TempArena;
+    linear_arena TempArena; // NOTE: Init and load time only, it never gets reset
+    frame_arena FrameArena;
+    random_series RandomSeries;
 
     // NOTE: Samplers
     VkSampler PointSampler;
@@ -135,16 +251,45 @@ struct demo_state
     render_target CopyToSwapTarget;
     VkDescriptorSetLayout CopyToSwapDescLayout;
     VkDescriptorSet CopyToSwapDesc;
+    VkBuffer CopyToSwapGlobals;
     render_fullscreen_pass CopyToSwapPass;
+    dynamic_resolution DynamicResolution;
 
     render_scene Scene;
 
-    // NOTE: Saved model ids
-    u32 Quad;
-    u32 Cube;
-    u32 Sphere;
+    // NOTE: Saved model handles
+    scene_handle Quad;
+    scene_handle Cube;
+    scene_handle Sphere;
+    scene_handle LightVolumeSphere;
+    mesh_optimizer_reports MeshReports;
+
+    renderer_type ActiveRenderer;
+    renderer Renderer;
+
+    // NOTE: Per frame uploads
+    staging_ring StagingRing;
+    deletion_queue DeletionQueue;
+
+    // NOTE: Swap chain changes get applied at the start of the next frame, once the frame in flight is done with our resources
+    b32 ResizePending;
+    u32 ResizeWidth;
+    u32 ResizeHeight;
 
-    tiled_deferred_state TiledDeferredState;
+    // NOTE: Profiling
+    gpu_timers GpuTimers;
+    memory_stats MemoryStats;
+#if CPU_PROFILER
+    cpu_profiler CpuProfiler;
+#endif
+    light_benchmark LightBenchmark;
+    u32 ActiveScenario;
+    scenario_runner ScenarioRunner;
+    tile_size_tuner TileSizeTuner;
+    light_test_compare LightTestCompare;
+    input_capture InputCapture;
+    software_raster SoftwareRaster;
+    golden_test GoldenTest;
 };
 
 global demo_state* DemoState;
@@ -72,8 +72,10 @@ void main()
         vec4 ProjectedSample = SsaoInputBuffer.VPTransform * vec4(Sample, 1);
         ProjectedSample.xyz /= ProjectedSample.w;
         
-        // NOTE: Convert to 0-1 range
+        // NOTE: Convert to 0-1 range, then into the part of the depth target we render to (dynamic resolution)
         ProjectedSample.xy = 0.5 * ProjectedSample.xy + vec2(0.5);
+        vec2 DepthSize = vec2(textureSize(GBufferDepthTexture, 0));
+        ProjectedSample.xy = min(ProjectedSample.xy * ScreenSize, ScreenSize - vec2(0.5)) / DepthSize;
 
         // NOTE: Compare to depth value
         float StoredDepth = texture(GBufferDepthTexture, ProjectedSample.xy).x;
@@ -0,0 +1,270 @@
+
+inline void StagingRingCreate(staging_ring* Ring, u64 Size)
+{
+    *Ring = {};
+    Ring->Size = Size;
+    Ring->MaxCopies = STAGING_RING_MIN_COPIES;
+    Ring->Copies = PushArray(&DemoState->Arena, staging_ring_copy, Ring->MaxCopies);
+    Ring->Regions = PushArray(&DemoState->Arena, VkBufferCopy, Ring->MaxCopies);
+
+    VkBufferCreateInfo BufferCreateInfo = {};
+    BufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    BufferCreateInfo.size = Size;
+    BufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    BufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VkCheckResult(vkCreateBuffer(RenderState->Device, &BufferCreateInfo, 0, &Ring->Buffer));
+
+    VkMemoryRequirements MemoryRequirements;
+    vkGetBufferMemoryRequirements(RenderState->Device, Ring->Buffer, &MemoryRequirements);
+
+    // NOTE: The CPU only writes to this memory, so we don't want it host cached
+    VkMemoryAllocateInfo AllocateInfo = {};
+    AllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    AllocateInfo.allocationSize = MemoryRequirements.size;
+    AllocateInfo.memoryTypeIndex = VkHostMemoryTypeFind(MemoryRequirements.memoryTypeBits,
+                                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    VkCheckResult(vkAllocateMemory(RenderState->Device, &AllocateInfo, 0, &Ring->Memory));
+    MemoryStatsRecord(&DemoState->MemoryStats, DemoState->MemoryStats.DedicatedArenaId, "staging_ring", Ring->Size);
+    VkCheckResult(vkBindBufferMemory(RenderState->Device, Ring->Buffer, Ring->Memory, 0));
+    VkCheckResult(vkMapMemory(RenderState->Device, Ring->Memory, 0, VK_WHOLE_SIZE, 0, (void**)&Ring->Ptr));
+}
+
+inline void StagingRingFrameRetire(staging_ring* Ring)
+{
+    staging_ring_frame* Frame = Ring->Frames + Ring->FirstFrame;
+    Ring->Tail = Frame->End;
+    Ring->FirstFrame = (Ring->FirstFrame + 1) % STAGING_RING_MAX_FRAMES;
+    Ring->NumFrames -= 1;
+}
+
+inline void StagingRingFrameBegin(staging_ring* Ring, VkFence CompletedFence)
+{
+    // NOTE: Call right after waiting on a fence. Fences get reset once they are waited on, so every frame they guard has to be retired
+    // here or we would wait on them again later. Frames complete in order, so everything older than the newest match is done too
+    u32 NumRetired = 0;
+    for (u32 FrameId = 0; FrameId < Ring->NumFrames; ++FrameId)
+    {
+        if (Ring->Frames[(Ring->FirstFrame + FrameId) % STAGING_RING_MAX_FRAMES].Fence == CompletedFence)
+        {
+            NumRetired = FrameId + 1;
+        }
+    }
+
+    for (u32 FrameId = 0; FrameId < NumRetired; ++FrameId)
+    {
+        StagingRingFrameRetire(Ring);
+    }
+}
+
+inline void StagingRingCopiesRecord(staging_ring* Ring, VkCommandBuffer CmdBuffer)
+{
+    if (Ring->NumCopies == 0)
+    {
+        return;
+    }
+
+    // NOTE: Group the copies by destination buffer (insertion sort, keeps the push order within a buffer) so every buffer gets one copy
+    // command with all its regions
+    for (u32 CopyId = 1; CopyId < Ring->NumCopies; ++CopyId)
+    {
+        staging_ring_copy Copy = Ring->Copies[CopyId];
+        u32 InsertId = CopyId;
+        while (InsertId > 0 && Ring->Copies[InsertId - 1].Buffer > Copy.Buffer)
+        {
+            Ring->Copies[InsertId] = Ring->Copies[InsertId - 1];
+            InsertId -= 1;
+        }
+        Ring->Copies[InsertId] = Copy;
+    }
+
+    // NOTE: Anything recorded before the flush can still read or write our destinations, the copies have to wait for it
+    {
+        VkMemoryBarrier Barrier = {};
+        Barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        Barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        Barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(CmdBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &Barrier, 0, 0, 0, 0);
+    }
+
+    VkBufferCopy* Regions = Ring->Regions;
+    for (u32 CopyId = 0; CopyId < Ring->NumCopies;)
+    {
+        VkBuffer Buffer = Ring->Copies[CopyId].Buffer;
+        u32 NumRegions = 0;
+        for (; CopyId < Ring->NumCopies && Ring->Copies[CopyId].Buffer == Buffer; ++CopyId)
+        {
+            staging_ring_copy* Copy = Ring->Copies + CopyId;
+            VkBufferCopy* Region = Regions + NumRegions++;
+            Region->srcOffset = Copy->SrcOffset;
+            Region->dstOffset = Copy->DstOffset;
+            Region->size = Copy->Size;
+        }
+
+        vkCmdCopyBuffer(CmdBuffer, Ring->Buffer, Buffer, NumRegions, Regions);
+        Ring->Stats.NumCopyCommands += 1;
+    }
+
+    // NOTE: One barrier covers every destination
+    VkMemoryBarrier Barrier = {};
+    Barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    Barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    Barrier.dstAccessMask = Ring->DstAccessMask;
+    vkCmdPipelineBarrier(CmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, Ring->DstStageMask, 0, 1, &Barrier, 0, 0, 0, 0);
+
+    Ring->Stats.NumRegions += Ring->NumCopies;
+    Ring->NumCopies = 0;
+    Ring->DstAccessMask = 0;
+    Ring->DstStageMask = 0;
+}
+
+inline void StagingRingCopiesGrow(staging_ring* Ring)
+{
+    // NOTE: Old arrays stay behind in the arena, doubling keeps them below the size of the final one
+    u32 MaxCopies = 2 * Ring->MaxCopies;
+    staging_ring_copy* Copies = PushArray(&DemoState->Arena, staging_ring_copy, MaxCopies);
+    Copy(Ring->Copies, Copies, sizeof(staging_ring_copy) * Ring->NumCopies);
+    Ring->Copies = Copies;
+    Ring->Regions = PushArray(&DemoState->Arena, VkBufferCopy, MaxCopies);
+    Ring->MaxCopies = MaxCopies;
+}
+
+inline u8* StagingRingPushWrite(staging_ring* Ring, VkBuffer Buffer, u64 DstOffset, u64 Size, VkAccessFlags DstAccessMask,
+                                VkPipelineStageFlags DstStageMask)
+{
+    u8* Result = 0;
+    if (Size == 0)
+    {
+        return Result;
+    }
+
+    u64 AlignedSize = (Size + STAGING_RING_ALIGNMENT - 1) & ~u64(STAGING_RING_ALIGNMENT - 1);
+    u64 Start = (Ring->Head + STAGING_RING_ALIGNMENT - 1) & ~u64(STAGING_RING_ALIGNMENT - 1);
+
+    // NOTE: Allocations never straddle the end of the buffer, we skip to the start instead
+    u64 Offset = Start % Ring->Size;
+    if (Offset + AlignedSize > Ring->Size)
+    {
+        Start += Ring->Size - Offset;
+        Offset = 0;
+    }
+
+    // NOTE: Backpressure, wait for the oldest frames in flight until we fit
+    while (Start + AlignedSize - Ring->Tail > Ring->Size && Ring->NumFrames > 0)
+    {
+        staging_ring_frame* Frame = Ring->Frames + Ring->FirstFrame;
+        VkCheckResult(vkWaitForFences(RenderState->Device, 1, &Frame->Fence, VK_TRUE, UINT64_MAX));
+        StagingRingFrameRetire(Ring);
+        Ring->Stats.NumWaits += 1;
+    }
+
+    if (Start + AlignedSize - Ring->Tail > Ring->Size)
+    {
+        // NOTE: Only the current frame is left in the ring, so it alone doesn't fit. The framework transfer manager only writes whole
+        // buffers, which is all our pushes do
+        Assert(DstOffset == 0);
+        Result = VkTransferPushWriteArray(&RenderState->TransferManager, Buffer, u8, Size,
+                                          BarrierMask(VkAccessFlagBits(0), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT),
+                                          BarrierMask(VkAccessFlagBits(DstAccessMask), VkPipelineStageFlagBits(DstStageMask)));
+        Ring->Stats.OverflowBytes += Size;
+        return Result;
+    }
+
+    Ring->Head = Start + AlignedSize;
+    Result = Ring->Ptr + Offset;
+    Ring->DstAccessMask |= DstAccessMask;
+    Ring->DstStageMask |= DstStageMask;
+    Ring->Stats.NumPushes += 1;
+
+    // NOTE: Merge with the previous copy if we continue it in both buffers
+    staging_ring_copy* PrevCopy = Ring->NumCopies > 0 ? Ring->Copies + Ring->NumCopies - 1 : 0;
+    if (PrevCopy && PrevCopy->Buffer == Buffer && PrevCopy->SrcOffset + PrevCopy->Size == Offset &&
+        PrevCopy->DstOffset + PrevCopy->Size == DstOffset)
+    {
+        PrevCopy->Size += Size;
+    }
+    else
+    {
+        if (Ring->NumCopies == Ring->MaxCopies)
+        {
+            // NOTE: Passes may already be recorded, so the copies can't go in early, they have to wait for the flush
+            StagingRingCopiesGrow(Ring);
+        }
+
+        staging_ring_copy* Copy = Ring->Copies + Ring->NumCopies++;
+        Copy->Buffer = Buffer;
+        Copy->SrcOffset = Offset;
+        Copy->DstOffset = DstOffset;
+        Copy->Size = Size;
+    }
+
+    return Result;
+}
+
+#define StagingRingPushWriteArray(Ring, Buffer, Type, Count, DstAccessMask, DstStageMask) \
+    (Type*)StagingRingPushWrite(Ring, Buffer, 0, sizeof(Type)*(Count), DstAccessMask, DstStageMask)
+#define StagingRingPushWriteStruct(Ring, Buffer, Type, DstAccessMask, DstStageMask) \
+    (Type*)StagingRingPushWrite(Ring, Buffer, 0, sizeof(Type), DstAccessMask, DstStageMask)
+
+inline void StagingRingFlush(staging_ring* Ring, vk_commands Commands)
+{
+    StagingRingCopiesRecord(Ring, Commands.Buffer);
+
+    // NOTE: The frame owns everything up to the head, it gets reclaimed once the commands fence signals
+    u64 FrameBytes = Ring->Head - Ring->FrameStart;
+    if (FrameBytes > 0)
+    {
+        if (Ring->NumFrames == STAGING_RING_MAX_FRAMES)
+        {
+            VkCheckResult(vkWaitForFences(RenderState->Device, 1, &Ring->Frames[Ring->FirstFrame].Fence, VK_TRUE, UINT64_MAX));
+            StagingRingFrameRetire(Ring);
+            Ring->Stats.NumWaits += 1;
+        }
+
+        staging_ring_frame* Frame = Ring->Frames + ((Ring->FirstFrame + Ring->NumFrames) % STAGING_RING_MAX_FRAMES);
+        Frame->End = Ring->Head;
+        Frame->Fence = Commands.Fence;
+        Ring->NumFrames += 1;
+    }
+    Ring->FrameStart = Ring->Head;
+
+    Ring->Stats.NumFrames += 1;
+    Ring->Stats.TotalBytes += FrameBytes;
+    Ring->Stats.PeakFrameBytes = Max(Ring->Stats.PeakFrameBytes, FrameBytes);
+    Ring->Stats.PrevFrameBytes = FrameBytes;
+}
+
+inline void StagingRingTimerUpdate(staging_ring* Ring, gpu_timers* Timers)
+{
+    // NOTE: Call after the timers frame begin, the upload timer then holds the copies of the previous frame
+    f32 UploadMs = GpuTimerGetMs(Timers, GpuTimer_Upload);
+    if (UploadMs > 0.0f)
+    {
+        Ring->Stats.NumTimedFrames += 1;
+        Ring->Stats.TimedBytes += Ring->Stats.PrevFrameBytes;
+        Ring->Stats.TimedGpuMs += UploadMs;
+    }
+}
+
+inline void StagingRingStatsDump(staging_ring* Ring, const char* FileName)
+{
+    FILE* File = fopen(FileName, "wb");
+    if (!File)
+    {
+        return;
+    }
+
+    staging_ring_stats* Stats = &Ring->Stats;
+    f32 MegaByte = 1024.0f*1024.0f;
+    f32 NumFrames = f32(Max(Stats->NumFrames, u64(1)));
+    f32 NumTimedFrames = f32(Max(Stats->NumTimedFrames, u64(1)));
+    f32 TimedMb = f32(Stats->TimedBytes) / MegaByte;
+
+    fprintf(File, "RingMb, Frames, AvgMbPerFrame, PeakMbPerFrame, Pushes, Regions, CopyCommands, Waits, OverflowMb, GpuUploadMs, GpuMbPerSec\n");
+    fprintf(File, "%f, %llu, %f, %f, %llu, %llu, %llu, %llu, %f, %f, %f\n", f32(Ring->Size) / MegaByte, Stats->NumFrames,
+            f32(Stats->TotalBytes) / MegaByte / NumFrames, f32(Stats->PeakFrameBytes) / MegaByte, Stats->NumPushes, Stats->NumRegions,
+            Stats->NumCopyCommands, Stats->NumWaits, f32(Stats->OverflowBytes) / MegaByte, Stats->TimedGpuMs / NumTimedFrames,
+            Stats->TimedGpuMs > 0.0f ? 1000.0f * TimedMb / Stats->TimedGpuMs : 0.0f);
+
+    fclose(File);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+/*
+
+  NOTE: Staging ring for the uploads we do every frame. The framework transfer manager reserves one big staging buffer and only gets
+        reused once everything is flushed, so it has to be sized for the worst case. The ring instead sub allocates every push from a
+        persistently mapped buffer, and every frame that flushes remembers how far the head got and which fence guards it. Once that
+        fence is known to be signaled, the space up to that frames end goes back to the ring.
+
+        When a push doesn't fit we wait on the oldest frame still in flight and reclaim its space (backpressure) instead of asserting.
+        Only a single frame that is larger than the whole ring can't be handled that way, those pushes go through the framework transfer
+        manager and are reported as overflow.
+
+        Pushes are recorded as pending copies. A push that continues the previous one (same destination buffer, contiguous in both the
+        ring and the destination) is merged into it. On flush all regions for a buffer go into one vkCmdCopyBuffer and all destination
+        barriers are combined into a single vkCmdPipelineBarrier. The flush is not the first thing in the command buffer (timer resets,
+        resizes and tile size changes get recorded before it), and a fence wait on the CPU doesn't make earlier GPU work visible to the
+        copies either, so the copies also get a barrier in front that orders them after every earlier command and its writes.
+
+        The copy list grows when a frame has more copies than it holds. Recording the copies early instead would only be correct if
+        every push came before the first pass of the frame.
+
+        Init uploads (textures, meshes) still go through the framework transfer manager.
+
+ */
+
+#define STAGING_RING_SIZE MegaBytes(64)
+#define STAGING_RING_MAX_FRAMES 8
+#define STAGING_RING_MIN_COPIES 256
+#define STAGING_RING_ALIGNMENT 16
+#define STAGING_RING_FILE_NAME "upload_stats.csv"
+
+struct staging_ring_copy
+{
+    VkBuffer Buffer;
+    u64 SrcOffset;
+    u64 DstOffset;
+    u64 Size;
+};
+
+struct staging_ring_frame
+{
+    u64 End;
+    VkFence Fence;
+};
+
+struct staging_ring_stats
+{
+    u64 NumFrames;
+    u64 TotalBytes;
+    u64 PeakFrameBytes;
+    u64 NumPushes;
+    u64 NumRegions;
+    u64 NumCopyCommands;
+    u64 NumWaits;
+    u64 OverflowBytes;
+
+    // NOTE: Upload timer results show up a frame late, so we keep the bytes of the frame they belong to
+    u64 PrevFrameBytes;
+    u64 NumTimedFrames;
+    u64 TimedBytes;
+    f32 TimedGpuMs;
+};
+
+struct staging_ring
+{
+    VkBuffer Buffer;
+    VkDeviceMemory Memory;
+    u64 Size;
+    u8* Ptr;
+
+    // NOTE: Head and tail only ever grow, the offset in the buffer is them modulo the size
+    u64 Head;
+    u64 Tail;
+
+    u32 FirstFrame;
+    u32 NumFrames;
+    staging_ring_frame Frames[STAGING_RING_MAX_FRAMES];
+
+    // NOTE: Pending copies and barriers for the current frame
+    u64 FrameStart;
+    u32 NumCopies;
+    u32 MaxCopies;
+    staging_ring_copy* Copies;
+    VkBufferCopy* Regions;
+    VkAccessFlags DstAccessMask;
+    VkPipelineStageFlags DstStageMask;
+
+    staging_ring_stats Stats;
+};
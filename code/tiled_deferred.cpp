@@ -8,149 +8,380 @@
   
 */
 
-inline void TiledDeferredSwapChainChange(tiled_deferred_state* State, u32 Width, u32 Height, VkFormat ColorFormat,
-                                         render_scene* Scene, VkDescriptorSet* OutputRtSet)
+//
+// NOTE: Tiled Light Data
+//
+
+inline b32 TiledLightDataBitMaskActive(tiled_light_data* Tiled, u32 NumPointLights)
 {
-    b32 ReCreate = State->RenderTargetArena.Used != 0;
-    VkArenaClear(&State->RenderTargetArena);
-    
-    // NOTE: Render Target Data
+    b32 Result = Tiled->LightListMode == TiledLightListMode_BitMask && NumPointLights <= TILED_BIT_MASK_MAX_LIGHTS;
+    return Result;
+}
+
+inline void TiledLightDataIndexListsCreate(tiled_light_data* Tiled, vk_linear_arena* Arena)
+{
+    Tiled->LightIndexList_O = TaggedBufferCreate("tiled_light_data", Arena, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                 sizeof(u32) * Tiled->LightIndexListCapacity);
+    Tiled->LightIndexList_T = TaggedBufferCreate("tiled_light_data", Arena, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                 sizeof(u32) * Tiled->LightIndexListCapacity);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Tiled->TiledDeferredDescriptor, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Tiled->LightIndexList_O);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Tiled->TiledDeferredDescriptor, 6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Tiled->LightIndexList_T);
+}
+
+inline void TiledLightDataGlobalsPush(tiled_light_data* Tiled, render_scene* Scene, u32 Width, u32 Height)
+{
+    // NOTE: Culling clamps to the index list capacity, so lights past it get dropped. Both counters get read back on every index list
+    // frame, once the previous frame asked for more than fits we grow both lists like a growable buffer and this frames globals already
+    // get the new capacity. Grown lists come out of the same arena as the swap chain ones, so the next swap chain change reclaims them
     {
-        RenderTargetEntryReCreate(&State->RenderTargetArena, Width, Height, VK_FORMAT_R32G32B32A32_SFLOAT,
-                                  VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
-                                  VK_IMAGE_ASPECT_COLOR_BIT, &State->GBufferPositionImage, &State->GBufferPositionEntry);
-        RenderTargetEntryReCreate(&State->RenderTargetArena, Width, Height, VK_FORMAT_R32G32B32A32_SFLOAT,
-                                  VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
-                                  VK_IMAGE_ASPECT_COLOR_BIT, &State->GBufferNormalImage, &State->GBufferNormalEntry);
-        RenderTargetEntryReCreate(&State->RenderTargetArena, Width, Height, VK_FORMAT_R32G32B32A32_SFLOAT,
-                                  VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-                                  VK_IMAGE_ASPECT_COLOR_BIT, &State->GBufferColorImage, &State->GBufferColorEntry);
-        RenderTargetEntryReCreate(&State->RenderTargetArena, Width, Height, VK_FORMAT_D32_SFLOAT,
-                                  VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
-                                  VK_IMAGE_ASPECT_DEPTH_BIT, &State->DepthImage, &State->DepthEntry);
-        RenderTargetEntryReCreate(&State->RenderTargetArena, Width, Height, VK_FORMAT_R32_SFLOAT,
-                                  VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-                                  VK_IMAGE_ASPECT_COLOR_BIT, &State->SsaoImage, &State->SsaoEntry);
-        RenderTargetEntryReCreate(&State->RenderTargetArena, Width, Height, ColorFormat,
-                                  VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-                                  VK_IMAGE_ASPECT_COLOR_BIT, &State->OutColorImage, &State->OutColorEntry);
+        u32 PrevFrameId = Tiled->IndexCounterFrameId - 1;
+        u32 SlotId = PrevFrameId % TILED_INDEX_COUNTER_NUM_SLOTS;
+        if (Tiled->IndexCounterPending[SlotId])
+        {
+            u32* Counters = (u32*)Tiled->IndexCounterReadbacks[SlotId].Ptr;
+            u32 NumIndices = Max(Counters[0], Counters[1]);
+            Tiled->IndexCounterPending[SlotId] = false;
+            
+            if (NumIndices > Tiled->LightIndexListCapacity)
+            {
+                while (Tiled->LightIndexListCapacity < NumIndices)
+                {
+                    Tiled->LightIndexListCapacity *= 2;
+                }
 
-        if (ReCreate)
+                DeletionQueueBufferPush(&DemoState->DeletionQueue, Tiled->LightIndexList_O);
+                DeletionQueueBufferPush(&DemoState->DeletionQueue, Tiled->LightIndexList_T);
+                TiledLightDataIndexListsCreate(Tiled, Tiled->IndexListArena);
+                VkDescriptorManagerFlush(RenderState->Device, &RenderState->DescriptorManager);
+            }
+        }
+    }
+    
+    Tiled->ActiveLightListMode = (TiledLightDataBitMaskActive(Tiled, Scene->PointLights.NumItems) ? TiledLightListMode_BitMask :
+                                  TiledLightListMode_IndexList);
+    Tiled->CoarseActive = (Tiled->CoarseCulling && Tiled->ActiveLightListMode == TiledLightListMode_IndexList &&
+                           Tiled->TileSize < TILED_COARSE_TILE_SIZE);
+
+    // NOTE: Build the z-bins, lights are sorted by view depth in bit mask mode so every bin is a contiguous range of light ids
+    f32 ZBinScale = 0.0f;
+    if (Tiled->ActiveLightListMode == TiledLightListMode_BitMask)
+    {
+        m4 VTransform = CameraGetV(&Scene->Camera);
+        
+        f32 MaxLightDepth = 1.0f;
+        for (u32 LightId = 0; LightId < Scene->PointLights.NumItems; ++LightId)
         {
-            RenderTargetUpdateEntries(&DemoState->TempArena, &State->GBufferPass);
-            RenderTargetUpdateEntries(&DemoState->TempArena, &State->LightingPass);
+            point_light* Light = ScenePointLightAt(Scene, Scene->PointLightSortIds[LightId]);
+            f32 ViewZ = (VTransform * V4(Light->Pos, 1.0f)).z;
+            MaxLightDepth = Max(MaxLightDepth, ViewZ + Light->MaxDistance);
         }
+        ZBinScale = f32(ZBIN_COUNT) / MaxLightDepth;
         
-        VkDescriptorImageWrite(&RenderState->DescriptorManager, *OutputRtSet, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                               State->OutColorEntry.View, DemoState->LinearSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        // NOTE: Staging memory is write combined, so the bins get built in our own memory and copied over once
+        u32* ZBins = PushArray(FrameArenaGet(&DemoState->FrameArena), u32, ZBIN_COUNT);
+
+        // NOTE: Packed as min id in the low 16 bits and max id in the high 16 bits, empty bins have min > max
+        for (u32 BinId = 0; BinId < ZBIN_COUNT; ++BinId)
+        {
+            ZBins[BinId] = 0xFFFF;
+        }
         
-        // NOTE: GBuffer
-        VkDescriptorImageWrite(&RenderState->DescriptorManager, State->TiledDeferredDescriptor, 8, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                               State->GBufferPositionEntry.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-        VkDescriptorImageWrite(&RenderState->DescriptorManager, State->TiledDeferredDescriptor, 9, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                               State->GBufferNormalEntry.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-        VkDescriptorImageWrite(&RenderState->DescriptorManager, State->TiledDeferredDescriptor, 10, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                               State->GBufferColorEntry.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-        VkDescriptorImageWrite(&RenderState->DescriptorManager, State->TiledDeferredDescriptor, 11, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                               State->DepthEntry.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
-        VkDescriptorImageWrite(&RenderState->DescriptorManager, State->TiledDeferredDescriptor, 12, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                               State->SsaoEntry.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        for (u32 LightId = 0; LightId < Scene->PointLights.NumItems; ++LightId)
+        {
+            point_light* Light = ScenePointLightAt(Scene, Scene->PointLightSortIds[LightId]);
+            f32 ViewZ = (VTransform * V4(Light->Pos, 1.0f)).z;
+            if (ViewZ + Light->MaxDistance < 0.0f)
+            {
+                continue;
+            }
+            
+            u32 StartBin = u32(Max(0.0f, ViewZ - Light->MaxDistance) * ZBinScale);
+            u32 EndBin = Min(u32((ViewZ + Light->MaxDistance) * ZBinScale), u32(ZBIN_COUNT - 1));
+            for (u32 BinId = StartBin; BinId <= EndBin; ++BinId)
+            {
+                u32 MinId = Min(ZBins[BinId] & 0xFFFF, LightId);
+                u32 MaxId = Max(ZBins[BinId] >> 16, LightId);
+                ZBins[BinId] = MinId | (MaxId << 16);
+            }
+        }
+
+        u32* StagingZBins = StagingRingPushWriteArray(&DemoState->StagingRing, Tiled->ZBins, u32, ZBIN_COUNT,
+                                                      VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        Copy(ZBins, StagingZBins, sizeof(u32) * ZBIN_COUNT);
     }
     
-    // NOTE: Tiled Data
+    // NOTE: Width and height are the size we render at, which can be smaller than the grid we allocated
+    tiled_deferred_globals* Data = StagingRingPushWriteStruct(&DemoState->StagingRing, Tiled->TiledDeferredGlobals, tiled_deferred_globals,
+                                                              VK_ACCESS_UNIFORM_READ_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+    *Data = {};
+    Data->InverseProjection = Inverse(CameraGetP(&Scene->Camera));
+    Data->ScreenSize = V2(Width, Height);
+    Data->GridSizeX = CeilU32(f32(Width) / f32(Tiled->TileSize));
+    Data->GridSizeY = CeilU32(f32(Height) / f32(Tiled->TileSize));
+    Tiled->NumTilesX = Data->GridSizeX;
+    Tiled->NumTilesY = Data->GridSizeY;
+    Tiled->ScreenWidth = Width;
+    Tiled->ScreenHeight = Height;
+    Tiled->NumCoarseTilesX = CeilU32(f32(Width) / f32(TILED_COARSE_TILE_SIZE));
+    Tiled->NumCoarseTilesY = CeilU32(f32(Height) / f32(TILED_COARSE_TILE_SIZE));
+    Data->LightIndexListCapacity = Tiled->LightIndexListCapacity;
+    Data->DebugViewMode = Tiled->DebugViewMode;
+    Data->TileSize = Tiled->TileSize;
+    Data->MaxLightsPerTile = Tiled->MaxLightsPerTile;
+    Data->LightListMode = Tiled->ActiveLightListMode;
+    Data->ZBinScale = ZBinScale;
+    Data->LightTestMode = Tiled->LightTestMode;
+    Data->CoarseCulling = Tiled->CoarseActive;
+    Data->CoarseGridSizeX = Tiled->NumCoarseTilesX;
+}
+
+inline b32 TileSizeSupported(u32 TileSize)
+{
+    VkPhysicalDeviceProperties Properties = {};
+    vkGetPhysicalDeviceProperties(RenderState->PhysicalDevice, &Properties);
+    VkPhysicalDeviceLimits* Limits = &Properties.limits;
+
+    // NOTE: Matches the shared declarations of the index list culling, which is the biggest of the permutations
+    u32 NumThreads = TileSize * TileSize;
+    u32 SharedSize = sizeof(u32) * (NumThreads + 2*MAX_LIGHTS_PER_TILE) + TILED_LIGHT_CULL_SHARED_OVERHEAD;
+    b32 Result = (NumThreads <= Limits->maxComputeWorkGroupInvocations &&
+                  TileSize <= Limits->maxComputeWorkGroupSize[0] &&
+                  TileSize <= Limits->maxComputeWorkGroupSize[1] &&
+                  SharedSize <= Limits->maxComputeSharedMemorySize);
+    return Result;
+}
+
+inline vk_pipeline TiledLightCullPipelineCreate(const char* FileName, VkDescriptorSetLayout* Layouts, u32 NumLayouts, u32 TileSize,
+                                                u32 MaxLightsPerTile)
+{
+    // NOTE: The pipeline manager has no way to pass specialization constants so we build these permutations by hand. They don't get
+    // shader hot reload.
+    vk_pipeline Result = {};
+
+    VkShaderModule ShaderModule = VK_NULL_HANDLE;
     {
-        u32 NumTilesX = CeilU32(f32(Width) / f32(TILE_SIZE_IN_PIXELS));
-        u32 NumTilesY = CeilU32(f32(Height) / f32(TILE_SIZE_IN_PIXELS));
+        FILE* File = fopen(FileName, "rb");
+        Assert(File);
+        fseek(File, 0, SEEK_END);
+        u32 CodeSize = u32(ftell(File));
+        fseek(File, 0, SEEK_SET);
+        u32* Code = PushArray(&DemoState->TempArena, u32, CeilU32(f32(CodeSize) / 4.0f));
+        fread(Code, 1, CodeSize, File);
+        fclose(File);
 
-        // NOTE: Destroy old data
-        if (ReCreate)
+        VkShaderModuleCreateInfo ModuleCreateInfo = {};
+        ModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        ModuleCreateInfo.codeSize = CodeSize;
+        ModuleCreateInfo.pCode = Code;
+        VkCheckResult(vkCreateShaderModule(RenderState->Device, &ModuleCreateInfo, 0, &ShaderModule));
+    }
+
+    u32 SpecData[] =
+    {
+        TileSize,
+        MaxLightsPerTile,
+    };
+    VkSpecializationMapEntry SpecEntries[ArrayCount(SpecData)] = {};
+    for (u32 EntryId = 0; EntryId < ArrayCount(SpecData); ++EntryId)
+    {
+        SpecEntries[EntryId].constantID = EntryId;
+        SpecEntries[EntryId].offset = EntryId*sizeof(u32);
+        SpecEntries[EntryId].size = sizeof(u32);
+    }
+    
+    VkSpecializationInfo SpecInfo = {};
+    SpecInfo.mapEntryCount = ArrayCount(SpecEntries);
+    SpecInfo.pMapEntries = SpecEntries;
+    SpecInfo.dataSize = sizeof(SpecData);
+    SpecInfo.pData = SpecData;
+
+    VkPipelineLayoutCreateInfo LayoutCreateInfo = {};
+    LayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    LayoutCreateInfo.setLayoutCount = NumLayouts;
+    LayoutCreateInfo.pSetLayouts = Layouts;
+    VkCheckResult(vkCreatePipelineLayout(RenderState->Device, &LayoutCreateInfo, 0, &Result.Layout));
+    
+    VkComputePipelineCreateInfo PipelineCreateInfo = {};
+    PipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    PipelineCreateInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    PipelineCreateInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    PipelineCreateInfo.stage.module = ShaderModule;
+    PipelineCreateInfo.stage.pName = "main";
+    PipelineCreateInfo.stage.pSpecializationInfo = &SpecInfo;
+    PipelineCreateInfo.layout = Result.Layout;
+    VkCheckResult(vkCreateComputePipelines(RenderState->Device, VK_NULL_HANDLE, 1, &PipelineCreateInfo, 0, &Result.Handle));
+
+    vkDestroyShaderModule(RenderState->Device, ShaderModule, 0);
+    
+    return Result;
+}
+
+inline void TiledLightDataTileSizeSet(tiled_light_data* Tiled, u32 TileSize)
+{
+    // NOTE: Only takes effect on the next swap chain change since all tile sized resources get recreated there
+    Tiled->TileSize = TileSize;
+    Tiled->TileSizeId = ArrayCount(TileSizeCandidates);
+    for (u32 CandidateId = 0; CandidateId < ArrayCount(TileSizeCandidates); ++CandidateId)
+    {
+        if (TileSizeCandidates[CandidateId] == TileSize)
         {
-            vkDestroyBuffer(RenderState->Device, State->GridFrustums, 0);
-            vkDestroyBuffer(RenderState->Device, State->LightIndexList_O, 0);
-            vkDestroyBuffer(RenderState->Device, State->LightIndexList_T, 0);
-            vkDestroyImageView(RenderState->Device, State->LightGrid_O.View, 0);
-            vkDestroyImage(RenderState->Device, State->LightGrid_O.Image, 0);
-            vkDestroyImageView(RenderState->Device, State->LightGrid_T.View, 0);
-            vkDestroyImage(RenderState->Device, State->LightGrid_T.Image, 0);
+            Tiled->TileSizeId = CandidateId;
         }
+    }
+    Assert(Tiled->TileSizeId < ArrayCount(TileSizeCandidates));
+    Assert(TileSizeSupported(TileSize));
+}
+
+inline void TiledLightDataGridFrustumsBuild(vk_commands Commands, tiled_light_data* Tiled, u32 Width, u32 Height)
+{
+    // IMPORTANT: Reads the screen size from the globals, so they have to be flushed for the same size before this runs
+    vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, Tiled->GridFrustumPipeline->Handle);
+    VkDescriptorSet DescriptorSets[] =
+        {
+            Tiled->TiledDeferredDescriptor,
+        };
+    vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, Tiled->GridFrustumPipeline->Layout, 0,
+                            ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
+    u32 DispatchX = CeilU32(f32(CeilU32(f32(Width) / f32(Tiled->TileSize))) / 8.0f);
+    u32 DispatchY = CeilU32(f32(CeilU32(f32(Height) / f32(Tiled->TileSize))) / 8.0f);
+    vkCmdDispatch(Commands.Buffer, DispatchX, DispatchY, 1);
+
+    Tiled->FrustumWidth = Width;
+    Tiled->FrustumHeight = Height;
+}
+
+inline void TiledLightDataSwapChainChange(tiled_light_data* Tiled, vk_linear_arena* Arena, b32 ReCreate, u32 Width, u32 Height,
+                                          render_scene* Scene)
+{
+    u32 NumTilesX = CeilU32(f32(Width) / f32(Tiled->TileSize));
+    u32 NumTilesY = CeilU32(f32(Height) / f32(Tiled->TileSize));
+    Tiled->NumTilesX = NumTilesX;
+    Tiled->NumTilesY = NumTilesY;
+    
+    // NOTE: Retire old data, the frame in flight may still read it
+    if (ReCreate)
+    {
+        deletion_queue* Queue = &DemoState->DeletionQueue;
+        DeletionQueueBufferPush(Queue, Tiled->GridFrustums);
+        DeletionQueueBufferPush(Queue, Tiled->LightIndexList_O);
+        DeletionQueueBufferPush(Queue, Tiled->LightIndexList_T);
+        DeletionQueueBufferPush(Queue, Tiled->LightBitMask_O);
+        DeletionQueueBufferPush(Queue, Tiled->LightBitMask_T);
+        DeletionQueueBufferPush(Queue, Tiled->CoarseLightCounts);
+        DeletionQueueBufferPush(Queue, Tiled->CoarseLightIndexList);
+        DeletionQueueImageViewPush(Queue, Tiled->LightGrid_O.View);
+        DeletionQueueImagePush(Queue, Tiled->LightGrid_O.Image);
+        DeletionQueueImageViewPush(Queue, Tiled->LightGrid_T.View);
+        DeletionQueueImagePush(Queue, Tiled->LightGrid_T.Image);
+    }
         
-        State->GridFrustums = VkBufferCreate(RenderState->Device, &State->RenderTargetArena, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+    Tiled->GridFrustums = TaggedBufferCreate("tiled_light_data", Arena, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
                                              sizeof(frustum) * NumTilesX * NumTilesY);
-        State->LightGrid_O = VkImageCreate(RenderState->Device, &State->RenderTargetArena, NumTilesX, NumTilesY, VK_FORMAT_R32G32_UINT,
-                                           VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
-        State->LightIndexList_O = VkBufferCreate(RenderState->Device, &State->RenderTargetArena, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                                                 sizeof(u32) * MAX_LIGHTS_PER_TILE * NumTilesX * NumTilesY);
-        State->LightGrid_T = VkImageCreate(RenderState->Device, &State->RenderTargetArena, NumTilesX, NumTilesY, VK_FORMAT_R32G32_UINT,
-                                           VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
-        State->LightIndexList_T = VkBufferCreate(RenderState->Device, &State->RenderTargetArena, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                                                 sizeof(u32) * MAX_LIGHTS_PER_TILE * NumTilesX * NumTilesY);
-
-        VkDescriptorBufferWrite(&RenderState->DescriptorManager, State->TiledDeferredDescriptor, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, State->GridFrustums);
-        VkDescriptorImageWrite(&RenderState->DescriptorManager, State->TiledDeferredDescriptor, 2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-                               State->LightGrid_O.View, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL);
-        VkDescriptorBufferWrite(&RenderState->DescriptorManager, State->TiledDeferredDescriptor, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, State->LightIndexList_O);
-        VkDescriptorImageWrite(&RenderState->DescriptorManager, State->TiledDeferredDescriptor, 5, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-                               State->LightGrid_T.View, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL);
-        VkDescriptorBufferWrite(&RenderState->DescriptorManager, State->TiledDeferredDescriptor, 6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, State->LightIndexList_T);
-    }
-
-    VkDescriptorManagerFlush(RenderState->Device, &RenderState->DescriptorManager);
+    Tiled->LightGrid_O = TaggedImageCreate("tiled_light_data", Arena, NumTilesX, NumTilesY, VK_FORMAT_R32G32_UINT,
+                                           VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                           VK_IMAGE_ASPECT_COLOR_BIT);
+    Tiled->LightGrid_T = TaggedImageCreate("tiled_light_data", Arena, NumTilesX, NumTilesY, VK_FORMAT_R32G32_UINT,
+                                           VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                           VK_IMAGE_ASPECT_COLOR_BIT);
+    // NOTE: Grown index lists keep their size across resizes
+    Tiled->LightIndexListCapacity = Max(Tiled->LightIndexListCapacity, Tiled->MaxLightsPerTile * NumTilesX * NumTilesY);
+    Tiled->IndexListArena = Arena;
+    TiledLightDataIndexListsCreate(Tiled, Arena);
+    Tiled->LightBitMask_O = TaggedBufferCreate("tiled_light_data", Arena, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                               sizeof(u32) * TILED_BIT_MASK_WORDS_PER_TILE * NumTilesX * NumTilesY);
+    Tiled->LightBitMask_T = TaggedBufferCreate("tiled_light_data", Arena, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                               sizeof(u32) * TILED_BIT_MASK_WORDS_PER_TILE * NumTilesX * NumTilesY);
+
+    // NOTE: Super tile lists take 16KB per super tile (~32MB at 1080p). Without coarse culling nothing reads them, so the descriptors
+    // only get one element placeholders to stay valid
+    u32 NumCoarseTiles = 1;
+    u32 CoarseMaxLightsPerTile = 1;
+    if (Tiled->CoarseCulling)
+    {
+        NumCoarseTiles = CeilU32(f32(Width) / f32(TILED_COARSE_TILE_SIZE)) * CeilU32(f32(Height) / f32(TILED_COARSE_TILE_SIZE));
+        CoarseMaxLightsPerTile = TILED_COARSE_MAX_LIGHTS_PER_TILE;
+    }
+    Tiled->CoarseLightCounts = TaggedBufferCreate("tiled_light_data", Arena, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, sizeof(u32) * NumCoarseTiles);
+    Tiled->CoarseLightIndexList = TaggedBufferCreate("tiled_light_data", Arena, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                     sizeof(u32) * CoarseMaxLightsPerTile * NumCoarseTiles);
+
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Tiled->TiledDeferredDescriptor, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Tiled->GridFrustums);
+    VkDescriptorImageWrite(&RenderState->DescriptorManager, Tiled->TiledDeferredDescriptor, 2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                           Tiled->LightGrid_O.View, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL);
+    VkDescriptorImageWrite(&RenderState->DescriptorManager, Tiled->TiledDeferredDescriptor, 5, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                           Tiled->LightGrid_T.View, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Tiled->TiledDeferredDescriptor, 13, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Tiled->LightBitMask_O);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Tiled->TiledDeferredDescriptor, 14, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Tiled->LightBitMask_T);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Tiled->TiledDeferredDescriptor, 17, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Tiled->CoarseLightCounts);
+    VkDescriptorBufferWrite(&RenderState->DescriptorManager, Tiled->TiledDeferredDescriptor, 18, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Tiled->CoarseLightIndexList);
+
+    LightGridStatsResize(&Tiled->LightGridStats, NumTilesX, NumTilesY);
+
+    {
+        CPU_TIMED_BLOCK("DescriptorFlush");
+        VkDescriptorManagerFlush(RenderState->Device, &RenderState->DescriptorManager);
+    }
     
-    // NOTE: Init Grid Frustums
-    vk_commands Commands = RenderState->Commands;
-    VkCommandsBegin(RenderState->Device, Commands);
+    // NOTE: Image layouts and grid frustums get set up in the next frames command buffer (TiledLightDataFrameBegin)
+    Tiled->ImagesInitialized = false;
+    Tiled->FrustumWidth = 0;
+    Tiled->FrustumHeight = 0;
+}
+
+inline void TiledLightDataFrameBegin(vk_commands Commands, tiled_light_data* Tiled)
+{
+    // IMPORTANT: Has to run after the globals for this frame were flushed and before anything touches the light grids
+    if (!Tiled->ImagesInitialized)
     {
-        // NOTE: Init our images
         VkBarrierImageAdd(&RenderState->BarrierManager, VK_ACCESS_MEMORY_READ_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
                           VK_IMAGE_LAYOUT_UNDEFINED, VK_ACCESS_MEMORY_READ_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_IMAGE_LAYOUT_GENERAL,
-                          VK_IMAGE_ASPECT_COLOR_BIT, State->LightGrid_O.Image);
+                          VK_IMAGE_ASPECT_COLOR_BIT, Tiled->LightGrid_O.Image);
         VkBarrierImageAdd(&RenderState->BarrierManager, VK_ACCESS_MEMORY_READ_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
                           VK_IMAGE_LAYOUT_UNDEFINED, VK_ACCESS_MEMORY_READ_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_IMAGE_LAYOUT_GENERAL,
-                          VK_IMAGE_ASPECT_COLOR_BIT, State->LightGrid_T.Image);
+                          VK_IMAGE_ASPECT_COLOR_BIT, Tiled->LightGrid_T.Image);
         VkBarrierManagerFlush(&RenderState->BarrierManager, Commands.Buffer);
+        Tiled->ImagesInitialized = true;
+    }
 
-        // NOTE: Update our tiled deferred globals
-        {
-            tiled_deferred_globals* Data = VkTransferPushWriteStruct(&RenderState->TransferManager, State->TiledDeferredGlobals, tiled_deferred_globals,
-                                                                     BarrierMask(VkAccessFlagBits(0), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT),
-                                                                     BarrierMask(VK_ACCESS_UNIFORM_READ_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT));
-            *Data = {};
-            Data->InverseProjection = Inverse(CameraGetP(&Scene->Camera));
-            Data->ScreenSize = V2(RenderState->WindowWidth, RenderState->WindowHeight);
-            Data->GridSizeX = CeilU32(f32(RenderState->WindowWidth) / f32(TILE_SIZE_IN_PIXELS));
-            Data->GridSizeY = CeilU32(f32(RenderState->WindowHeight) / f32(TILE_SIZE_IN_PIXELS));
-        }
-        VkTransferManagerFlush(&RenderState->TransferManager, RenderState->Device, RenderState->Commands.Buffer, &RenderState->BarrierManager);
+    // NOTE: Resizes and dynamic resolution both change the screen size the frustums were built for
+    if (Tiled->FrustumWidth != Tiled->ScreenWidth || Tiled->FrustumHeight != Tiled->ScreenHeight)
+    {
+        TiledLightDataGridFrustumsBuild(Commands, Tiled, Tiled->ScreenWidth, Tiled->ScreenHeight);
 
-        vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, State->GridFrustumPipeline->Handle);
-        VkDescriptorSet DescriptorSets[] =
-            {
-                State->TiledDeferredDescriptor,
-            };
-        vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, State->GridFrustumPipeline->Layout, 0,
-                                ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
-        u32 DispatchX = CeilU32(f32(RenderState->WindowWidth) / f32(8 * TILE_SIZE_IN_PIXELS));
-        u32 DispatchY = CeilU32(f32(RenderState->WindowHeight) / f32(8 * TILE_SIZE_IN_PIXELS));
-        vkCmdDispatch(Commands.Buffer, DispatchX, DispatchY, 1);
+        VkMemoryBarrier FrustumBarrier = {};
+        FrustumBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        FrustumBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        FrustumBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(Commands.Buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &FrustumBarrier,
+                             0, 0, 0, 0);
     }
-    VkCommandsSubmit(RenderState->GraphicsQueue, Commands);
 }
 
-inline void TiledDeferredCreate(renderer_create_info CreateInfo, VkDescriptorSet* OutputRtSet, tiled_deferred_state* Result)
+inline void TiledLightDataCreate(renderer_create_info CreateInfo, tiled_light_data* Result)
 {
     *Result = {};
-
-    u64 HeapSize = GigaBytes(1);
-    Result->RenderTargetArena = VkLinearArenaCreate(VkMemoryAllocate(RenderState->Device, RenderState->LocalMemoryId, HeapSize), HeapSize);
+    Result->DebugViewMode = TiledDeferredDebugView_Ao;
+    Result->MaxLightsPerTile = MAX_LIGHTS_PER_TILE;
+    Result->LightListMode = TILED_LIGHT_LIST_BIT_MASK ? TiledLightListMode_BitMask : TiledLightListMode_IndexList;
+    Result->LightTestMode = tiled_light_test_mode(TILED_LIGHT_TEST_MODE);
+    Result->CoarseCulling = TILED_COARSE_LIGHT_CULLING;
     
     // NOTE: Create globals
     {        
-        Result->TiledDeferredGlobals = VkBufferCreate(RenderState->Device, &RenderState->GpuArena, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                                                      sizeof(tiled_deferred_globals));
-        Result->LightIndexCounter_O = VkBufferCreate(RenderState->Device, &RenderState->GpuArena, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                                                     sizeof(u32));
-        Result->LightIndexCounter_T = VkBufferCreate(RenderState->Device, &RenderState->GpuArena, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                                                     sizeof(u32));
+        Result->TiledDeferredGlobals = TaggedBufferCreate("tiled_light_data", &RenderState->GpuArena, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                                          sizeof(tiled_deferred_globals));
+        Result->LightIndexCounter_O = TaggedBufferCreate("tiled_light_data", &RenderState->GpuArena,
+                                                         VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                         sizeof(u32));
+        Result->LightIndexCounter_T = TaggedBufferCreate("tiled_light_data", &RenderState->GpuArena,
+                                                         VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                         sizeof(u32));
+        Result->ZBins = TaggedBufferCreate("tiled_light_data", &RenderState->GpuArena, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                           sizeof(u32) * ZBIN_COUNT);
+        for (u32 SlotId = 0; SlotId < TILED_INDEX_COUNTER_NUM_SLOTS; ++SlotId)
+        {
+            Result->IndexCounterReadbacks[SlotId] = ReadbackBufferCreate(2*sizeof(u32));
+        }
         
         {
             vk_descriptor_layout_builder Builder = VkDescriptorLayoutBegin(&Result->TiledDeferredDescLayout);
@@ -165,12 +396,24 @@ inline void TiledDeferredCreate(renderer_create_info CreateInfo, VkDescriptorSet
             VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
             VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
 
-            // NOTE: GBuffer Descriptors
+            // NOTE: GBuffer Descriptors (tiled forward only writes the depth binding)
             VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
             VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
             VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
             VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
             VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
+
+            // NOTE: Bit Mask Descriptors
+            VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
+            VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
+            VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT);
+
+            // NOTE: Fused lighting output (tiled deferred only)
+            VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+
+            // NOTE: Coarse culling super tile lists
+            VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+            VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
             
             VkDescriptorLayoutEnd(RenderState->Device, &Builder);
         }
@@ -181,6 +424,7 @@ inline void TiledDeferredCreate(renderer_create_info CreateInfo, VkDescriptorSet
         VkDescriptorBufferWrite(&RenderState->DescriptorManager, Result->TiledDeferredDescriptor, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, Result->TiledDeferredGlobals);
         VkDescriptorBufferWrite(&RenderState->DescriptorManager, Result->TiledDeferredDescriptor, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Result->LightIndexCounter_O);
         VkDescriptorBufferWrite(&RenderState->DescriptorManager, Result->TiledDeferredDescriptor, 7, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Result->LightIndexCounter_T);
+        VkDescriptorBufferWrite(&RenderState->DescriptorManager, Result->TiledDeferredDescriptor, 15, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, Result->ZBins);
     }
 
     // NOTE: Grid Frustum
@@ -193,7 +437,330 @@ inline void TiledDeferredCreate(renderer_create_info CreateInfo, VkDescriptorSet
         Result->GridFrustumPipeline = VkPipelineComputeCreate(RenderState->Device, &RenderState->PipelineManager, &DemoState->TempArena,
                                                               "shader_tiled_deferred_grid_frustum.spv", "main", Layouts, ArrayCount(Layouts));
     }
+        
+    // NOTE: Light Cull
+    {
+        VkDescriptorSetLayout Layouts[] =
+            {
+                Result->TiledDeferredDescLayout,
+                CreateInfo.SceneDescLayout,
+            };
+
+
+        // NOTE: Unsupported tile sizes keep empty pipelines, TiledLightDataTileSizeSet never picks them
+        for (u32 CandidateId = 0; CandidateId < ArrayCount(TileSizeCandidates); ++CandidateId)
+        {
+            if (!TileSizeSupported(TileSizeCandidates[CandidateId]))
+            {
+                continue;
+            }
+            
+            Result->LightCullPipelines[CandidateId] = TiledLightCullPipelineCreate("..\\data\\shader_tiled_deferred_light_culling.spv", Layouts,
+                                                                                   ArrayCount(Layouts), TileSizeCandidates[CandidateId],
+                                                                                   Result->MaxLightsPerTile);
+            Result->LightCullBitMaskPipelines[CandidateId] = TiledLightCullPipelineCreate("..\\data\\shader_tiled_deferred_light_culling_bit_mask.spv",
+                                                                                          Layouts, ArrayCount(Layouts), TileSizeCandidates[CandidateId],
+                                                                                          Result->MaxLightsPerTile);
+        }
+
+        // NOTE: Super tiles have a fixed size so this one goes through the pipeline manager
+        Result->CoarseLightCullPipeline = VkPipelineComputeCreate(RenderState->Device, &RenderState->PipelineManager, &DemoState->TempArena,
+                                                                  "shader_tiled_deferred_light_culling_coarse.spv", "main", Layouts,
+                                                                  ArrayCount(Layouts));
+    }
+
+    TiledLightDataTileSizeSet(Result, TILE_SIZE_IN_PIXELS);
+}
+
+inline void TiledLightDataClear(vk_commands Commands, tiled_light_data* Tiled)
+{
+    VkClearValue ClearColor = VkClearColorCreate(0, 0, 0, 0);
+    VkImageSubresourceRange Range = {};
+    Range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    Range.baseMipLevel = 0;
+    Range.levelCount = 1;
+    Range.baseArrayLayer = 0;
+    Range.layerCount = 1;
+        
+    vkCmdClearColorImage(Commands.Buffer, Tiled->LightGrid_O.Image, VK_IMAGE_LAYOUT_GENERAL, &ClearColor.color, 1, &Range);
+    vkCmdClearColorImage(Commands.Buffer, Tiled->LightGrid_T.Image, VK_IMAGE_LAYOUT_GENERAL, &ClearColor.color, 1, &Range);
+    vkCmdFillBuffer(Commands.Buffer, Tiled->LightIndexCounter_O, 0, sizeof(u32), 0);
+    vkCmdFillBuffer(Commands.Buffer, Tiled->LightIndexCounter_T, 0, sizeof(u32), 0);
+}
+
+inline void TiledLightDataCoarseCull(vk_commands Commands, tiled_light_data* Tiled, render_scene* Scene)
+{
+    // NOTE: Fills the super tile lists the fine culling reads when the globals have coarse culling on
+    if (!Tiled->CoarseActive)
+    {
+        return;
+    }
+
+    vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, Tiled->CoarseLightCullPipeline->Handle);
+    VkDescriptorSet DescriptorSets[] =
+        {
+            Tiled->TiledDeferredDescriptor,
+            Scene->SceneDescriptor,
+        };
+    vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, Tiled->CoarseLightCullPipeline->Layout, 0,
+                            ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
+    vkCmdDispatch(Commands.Buffer, Tiled->NumCoarseTilesX, Tiled->NumCoarseTilesY, 1);
+
+    VkMemoryBarrier CoarseBarrier = {};
+    CoarseBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    CoarseBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    CoarseBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(Commands.Buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &CoarseBarrier,
+                         0, 0, 0, 0);
+}
+
+inline void TiledLightDataCull(vk_commands Commands, tiled_light_data* Tiled, render_scene* Scene)
+{
+    b32 BitMask = Tiled->ActiveLightListMode == TiledLightListMode_BitMask;
+    vk_pipeline* Pipeline = (BitMask ? Tiled->LightCullBitMaskPipelines : Tiled->LightCullPipelines) + Tiled->TileSizeId;
+    
+    GpuTimerBegin(Commands, &DemoState->GpuTimers, GpuTimer_LightCull);
+    TiledLightDataCoarseCull(Commands, Tiled, Scene);
+    {
+        vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, Pipeline->Handle);
+        VkDescriptorSet DescriptorSets[] =
+            {
+                Tiled->TiledDeferredDescriptor,
+                Scene->SceneDescriptor,
+            };
+        vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, Pipeline->Layout, 0,
+                                ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
+        vkCmdDispatch(Commands.Buffer, Tiled->NumTilesX, Tiled->NumTilesY, 1);
+    }
+    GpuTimerEnd(Commands, &DemoState->GpuTimers, GpuTimer_LightCull);
+
+    // NOTE: The counters and the stats only mean something for the index list
+    if (!BitMask)
+    {
+        VkMemoryBarrier CullBarrier = {};
+        CullBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        CullBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        CullBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(Commands.Buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &CullBarrier, 0, 0, 0, 0);
+
+        // NOTE: Counters for growing the index lists, see TiledLightDataGlobalsPush
+        {
+            u32 SlotId = Tiled->IndexCounterFrameId % TILED_INDEX_COUNTER_NUM_SLOTS;
+            VkBuffer Readback = Tiled->IndexCounterReadbacks[SlotId].Buffer;
+            
+            VkBufferCopy CounterCopy = {};
+            CounterCopy.size = sizeof(u32);
+            CounterCopy.dstOffset = 0;
+            vkCmdCopyBuffer(Commands.Buffer, Tiled->LightIndexCounter_O, Readback, 1, &CounterCopy);
+            CounterCopy.dstOffset = sizeof(u32);
+            vkCmdCopyBuffer(Commands.Buffer, Tiled->LightIndexCounter_T, Readback, 1, &CounterCopy);
+
+            VkMemoryBarrier HostBarrier = {};
+            HostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            HostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            HostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+            vkCmdPipelineBarrier(Commands.Buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &HostBarrier, 0, 0, 0, 0);
+
+            Tiled->IndexCounterPending[SlotId] = true;
+            Tiled->IndexCounterFrameId += 1;
+        }
+        
+        LightGridStatsCopy(Commands, &Tiled->LightGridStats, Tiled->LightIndexCounter_O, Tiled->LightIndexCounter_T, Tiled->LightGrid_O.Image,
+                           Tiled->LightGrid_T.Image, Tiled->TileSize, Tiled->ScreenWidth, Tiled->ScreenHeight, Tiled->LightTestMode,
+                           Tiled->LightIndexListCapacity);
+    }
+}
+
+//
+// NOTE: Tiled Deferred
+//
+
+inline void TiledDeferredSwapChainChange(tiled_deferred_state* State, u32 Width, u32 Height, VkFormat ColorFormat,
+                                         render_scene* Scene)
+{
+    b32 ReCreate = State->RenderTargetArena.Used != 0;
+    VkArenaClear(&State->RenderTargetArena);
+    MemoryStatsArenaClear(&DemoState->MemoryStats, &State->RenderTargetArena.Used);
+    
+    // NOTE: Render Target Data
+    {
+        TaggedRenderTargetEntryReCreate("tiled_deferred", &State->RenderTargetArena, Width, Height, VK_FORMAT_R32G32B32A32_SFLOAT,
+                                        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
+                                        VK_IMAGE_ASPECT_COLOR_BIT, &State->GBufferPositionImage, &State->GBufferPositionEntry);
+        TaggedRenderTargetEntryReCreate("tiled_deferred", &State->RenderTargetArena, Width, Height, VK_FORMAT_R32G32B32A32_SFLOAT,
+                                        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
+                                        VK_IMAGE_ASPECT_COLOR_BIT, &State->GBufferNormalImage, &State->GBufferNormalEntry);
+        TaggedRenderTargetEntryReCreate("tiled_deferred", &State->RenderTargetArena, Width, Height, VK_FORMAT_R32G32B32A32_SFLOAT,
+                                        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                        VK_IMAGE_ASPECT_COLOR_BIT, &State->GBufferColorImage, &State->GBufferColorEntry);
+        TaggedRenderTargetEntryReCreate("tiled_deferred", &State->RenderTargetArena, Width, Height, VK_FORMAT_D32_SFLOAT,
+                                        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
+                                        VK_IMAGE_ASPECT_DEPTH_BIT, &State->DepthImage, &State->DepthEntry);
+        TaggedRenderTargetEntryReCreate("tiled_deferred", &State->RenderTargetArena, Width, Height, VK_FORMAT_R32_SFLOAT,
+                                        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                        VK_IMAGE_ASPECT_COLOR_BIT, &State->SsaoImage, &State->SsaoEntry);
+        // NOTE: Fused lighting writes this as a storage image, FusedOutColor is declared rgba16f to match the swap chain format (storage
+        // support for it is mandatory). The golden test copies it and SSAO out
+        Assert(ColorFormat == VK_FORMAT_R16G16B16A16_SFLOAT);
+        TaggedRenderTargetEntryReCreate("tiled_deferred", &State->RenderTargetArena, Width, Height, ColorFormat,
+                                        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT |
+                                        VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                        VK_IMAGE_ASPECT_COLOR_BIT, &State->OutColorImage, &State->OutColorEntry);
+        TaggedRenderTargetEntryReCreate("tiled_deferred", &State->RenderTargetArena, Width, Height, VK_FORMAT_R16G16B16A16_SFLOAT,
+                                        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
+                                        VK_IMAGE_ASPECT_COLOR_BIT, &State->TransparentAccumImage, &State->TransparentAccumEntry);
+        TaggedRenderTargetEntryReCreate("tiled_deferred", &State->RenderTargetArena, Width, Height, VK_FORMAT_R16_SFLOAT,
+                                        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
+                                        VK_IMAGE_ASPECT_COLOR_BIT, &State->TransparentRevealImage, &State->TransparentRevealEntry);
+
+        if (ReCreate)
+        {
+            RenderTargetUpdateEntries(FrameArenaGet(&DemoState->FrameArena), &State->GBufferPass);
+            RenderTargetUpdateEntries(FrameArenaGet(&DemoState->FrameArena), &State->GBufferEarlyPass);
+            RenderTargetUpdateEntries(FrameArenaGet(&DemoState->FrameArena), &State->GBufferLatePass);
+            RenderTargetUpdateEntries(FrameArenaGet(&DemoState->FrameArena), &State->LightingPass);
+            RenderTargetUpdateEntries(FrameArenaGet(&DemoState->FrameArena), &State->TransparentPass);
+        }
+        
+        // NOTE: GBuffer
+        VkDescriptorImageWrite(&RenderState->DescriptorManager, State->Tiled.TiledDeferredDescriptor, 8, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                               State->GBufferPositionEntry.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        VkDescriptorImageWrite(&RenderState->DescriptorManager, State->Tiled.TiledDeferredDescriptor, 9, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                               State->GBufferNormalEntry.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        VkDescriptorImageWrite(&RenderState->DescriptorManager, State->Tiled.TiledDeferredDescriptor, 10, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                               State->GBufferColorEntry.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        VkDescriptorImageWrite(&RenderState->DescriptorManager, State->Tiled.TiledDeferredDescriptor, 11, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                               State->DepthEntry.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+        VkDescriptorImageWrite(&RenderState->DescriptorManager, State->Tiled.TiledDeferredDescriptor, 12, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                               State->SsaoEntry.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        VkDescriptorImageWrite(&RenderState->DescriptorManager, State->Tiled.TiledDeferredDescriptor, 16, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                               State->OutColorEntry.View, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL);
+
+        // NOTE: Transparent
+        VkDescriptorImageWrite(&RenderState->DescriptorManager, State->TransparentDescriptor, 0, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,
+                               State->TransparentAccumEntry.View, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        VkDescriptorImageWrite(&RenderState->DescriptorManager, State->TransparentDescriptor, 1, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,
+                               State->TransparentRevealEntry.View, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+    
+    OcclusionCullSwapChainChange(&State->OcclusionCull, &State->RenderTargetArena, ReCreate, Width, Height, State->DepthEntry.View);
+    TiledLightDataSwapChainChange(&State->Tiled, &State->RenderTargetArena, ReCreate, Width, Height, Scene);
+    State->RenderWidth = Width;
+    State->RenderHeight = Height;
+}
+
+inline void TiledDeferredViewportSet(vk_commands Commands, u32 Width, u32 Height)
+{
+    // NOTE: Passes render into the top left of the targets, gl_FragCoord and texel fetches stay the same as at full size
+    VkViewport ViewPort = {};
+    ViewPort.x = 0;
+    ViewPort.y = 0;
+    ViewPort.width = f32(Width);
+    ViewPort.height = f32(Height);
+    ViewPort.minDepth = 0.0f;
+    ViewPort.maxDepth = 1.0f;
+    vkCmdSetViewport(Commands.Buffer, 0, 1, &ViewPort);
+    
+    VkRect2D Scissor = {};
+    Scissor.offset = {};
+    Scissor.extent = { Width, Height };
+    vkCmdSetScissor(Commands.Buffer, 0, 1, &Scissor);
+}
+
+inline render_target TiledDeferredGBufferPassCreate(tiled_deferred_state* State, u32 Width, u32 Height, tiled_deferred_gbuffer_pass_type Type)
+{
+    // NOTE: The late pass keeps what the early pass drew, only the full and late passes produce SSAO
+    b32 LoadGBuffer = Type == TiledDeferredGBufferPass_Late;
+    VkAttachmentLoadOp GBufferLoadOp = LoadGBuffer ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+    VkImageLayout GBufferInitialLayout = LoadGBuffer ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+    VkImageLayout DepthInitialLayout = LoadGBuffer ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+    b32 SkipSsao = Type == TiledDeferredGBufferPass_Early;
+    
+    render_target_builder Builder = RenderTargetBuilderBegin(&DemoState->Arena, &DemoState->TempArena, Width, Height);
+    RenderTargetAddTarget(&Builder, &State->GBufferPositionEntry, VkClearColorCreate(0, 0, 0, 1));
+    RenderTargetAddTarget(&Builder, &State->GBufferNormalEntry, VkClearColorCreate(0, 0, 0, 1));
+    RenderTargetAddTarget(&Builder, &State->GBufferColorEntry, VkClearColorCreate(0, 0, 0, 1));
+    RenderTargetAddTarget(&Builder, &State->DepthEntry, VkClearDepthStencilCreate(0, 0));
+    RenderTargetAddTarget(&Builder, &State->SsaoEntry, VkClearColorCreate(0, 0, 0, 0));
+                            
+    vk_render_pass_builder RpBuilder = VkRenderPassBuilderBegin(&DemoState->TempArena);
+
+    u32 GBufferPositionId = VkRenderPassAttachmentAdd(&RpBuilder, State->GBufferPositionEntry.Format, GBufferLoadOp,
+                                                      VK_ATTACHMENT_STORE_OP_STORE, GBufferInitialLayout,
+                                                      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    u32 GBufferNormalId = VkRenderPassAttachmentAdd(&RpBuilder, State->GBufferNormalEntry.Format, GBufferLoadOp,
+                                                    VK_ATTACHMENT_STORE_OP_STORE, GBufferInitialLayout,
+                                                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    u32 GBufferColorId = VkRenderPassAttachmentAdd(&RpBuilder, State->GBufferColorEntry.Format, GBufferLoadOp,
+                                                   VK_ATTACHMENT_STORE_OP_STORE, GBufferInitialLayout,
+                                                   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    u32 DepthId = VkRenderPassAttachmentAdd(&RpBuilder, State->DepthEntry.Format, GBufferLoadOp,
+                                            VK_ATTACHMENT_STORE_OP_STORE, DepthInitialLayout,
+                                            VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+    u32 SsaoId = VkRenderPassAttachmentAdd(&RpBuilder, State->SsaoEntry.Format,
+                                           SkipSsao ? VK_ATTACHMENT_LOAD_OP_DONT_CARE : VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                           SkipSsao ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_UNDEFINED,
+                                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    VkRenderPassSubPassBegin(&RpBuilder, VK_PIPELINE_BIND_POINT_GRAPHICS);
+    VkRenderPassColorRefAdd(&RpBuilder, GBufferPositionId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    VkRenderPassColorRefAdd(&RpBuilder, GBufferNormalId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    VkRenderPassColorRefAdd(&RpBuilder, GBufferColorId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    VkRenderPassDepthRefAdd(&RpBuilder, DepthId, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+    VkRenderPassSubPassEnd(&RpBuilder);
+
+    VkRenderPassDependency(&RpBuilder, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                           VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                           VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                           VK_ACCESS_SHADER_READ_BIT, VK_DEPENDENCY_BY_REGION_BIT);
+
+    // NOTE: The early pass keeps the SSAO subpass empty so its subpasses match the other two
+    VkRenderPassSubPassBegin(&RpBuilder, VK_PIPELINE_BIND_POINT_GRAPHICS);
+    VkRenderPassInputRefAdd(&RpBuilder, GBufferPositionId, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    VkRenderPassInputRefAdd(&RpBuilder, GBufferNormalId, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    VkRenderPassInputRefAdd(&RpBuilder, DepthId, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+    VkRenderPassColorRefAdd(&RpBuilder, SsaoId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    VkRenderPassSubPassEnd(&RpBuilder);
+
+    render_target Result = RenderTargetBuilderEnd(&Builder, VkRenderPassBuilderEnd(&RpBuilder, RenderState->Device));
+    return Result;
+}
+
+inline void TiledDeferredCreate(renderer_create_info CreateInfo, tiled_deferred_state* Result)
+{
+    *Result = {};
 
+    u64 HeapSize = GigaBytes(1);
+    Result->RenderTargetArena = VkLinearArenaCreate(VkMemoryAllocate(RenderState->Device, RenderState->LocalMemoryId, HeapSize), HeapSize);
+    MemoryStatsArenaAdd(&DemoState->MemoryStats, "tiled_deferred_targets", true, &Result->RenderTargetArena.Used, HeapSize);
+    
+    TiledLightDataCreate(CreateInfo, &Result->Tiled);
+    OcclusionCullCreate(CreateInfo, &Result->OcclusionCull);
+    Result->FusedLighting = TILED_DEFERRED_FUSED_LIGHTING;
+    Result->BindlessMaterials = TILED_DEFERRED_BINDLESS_MATERIALS;
+    Result->QuantizedVertices = TILED_DEFERRED_QUANTIZED_VERTICES;
+
+    // NOTE: Fused Lighting
+    {
+        VkDescriptorSetLayout Layouts[] =
+            {
+                Result->Tiled.TiledDeferredDescLayout,
+                CreateInfo.SceneDescLayout,
+            };
+
+        for (u32 CandidateId = 0; CandidateId < ArrayCount(TileSizeCandidates); ++CandidateId)
+        {
+            if (!TileSizeSupported(TileSizeCandidates[CandidateId]))
+            {
+                continue;
+            }
+            
+            Result->FusedLightingPipelines[CandidateId] = TiledLightCullPipelineCreate("..\\data\\shader_tiled_deferred_lighting_fused.spv", Layouts,
+                                                                                       ArrayCount(Layouts), TileSizeCandidates[CandidateId],
+                                                                                       Result->Tiled.MaxLightsPerTile);
+        }
+    }
+    
     // NOTE: Ssao Data
     {
         vk_descriptor_layout_builder Builder = VkDescriptorLayoutBegin(&Result->SsaoDescLayout);
@@ -201,12 +768,22 @@ inline void TiledDeferredCreate(renderer_create_info CreateInfo, VkDescriptorSet
         VkDescriptorLayoutEnd(RenderState->Device, &Builder);
 
         Result->SsaoDescriptor = VkDescriptorSetAllocate(RenderState->Device, RenderState->DescriptorPool, Result->SsaoDescLayout);
-        Result->SsaoInputBuffer = VkBufferCreate(RenderState->Device, &RenderState->GpuArena, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                                                 sizeof(gpu_ssao_inputs));
+        Result->SsaoInputBuffer = TaggedBufferCreate("tiled_deferred", &RenderState->GpuArena, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                                     sizeof(gpu_ssao_inputs));
         VkDescriptorBufferWrite(&RenderState->DescriptorManager, Result->SsaoDescriptor, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, Result->SsaoInputBuffer);
     }
 
-    TiledDeferredSwapChainChange(Result, CreateInfo.Width, CreateInfo.Height, CreateInfo.ColorFormat, CreateInfo.Scene, OutputRtSet);
+    // NOTE: Transparent Composite Data
+    {
+        vk_descriptor_layout_builder Builder = VkDescriptorLayoutBegin(&Result->TransparentDescLayout);
+        VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
+        VkDescriptorLayoutAdd(&Builder, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
+        VkDescriptorLayoutEnd(RenderState->Device, &Builder);
+
+        Result->TransparentDescriptor = VkDescriptorSetAllocate(RenderState->Device, RenderState->DescriptorPool, Result->TransparentDescLayout);
+    }
+
+    TiledDeferredSwapChainChange(Result, CreateInfo.Width, CreateInfo.Height, CreateInfo.ColorFormat, CreateInfo.Scene);
 
     // NOTE: Create PSOs
     // IMPORTANT: We don't do this in a single render pass since we cannot do compute between graphics
@@ -214,66 +791,54 @@ inline void TiledDeferredCreate(renderer_create_info CreateInfo, VkDescriptorSet
         // NOTE: GBuffer Pass
         {
             // NOTE: RT
-            {
-                render_target_builder Builder = RenderTargetBuilderBegin(&DemoState->Arena, &DemoState->TempArena, CreateInfo.Width, CreateInfo.Height);
-                RenderTargetAddTarget(&Builder, &Result->GBufferPositionEntry, VkClearColorCreate(0, 0, 0, 1));
-                RenderTargetAddTarget(&Builder, &Result->GBufferNormalEntry, VkClearColorCreate(0, 0, 0, 1));
-                RenderTargetAddTarget(&Builder, &Result->GBufferColorEntry, VkClearColorCreate(0, 0, 0, 1));
-                RenderTargetAddTarget(&Builder, &Result->DepthEntry, VkClearDepthStencilCreate(0, 0));
-                RenderTargetAddTarget(&Builder, &Result->SsaoEntry, VkClearColorCreate(0, 0, 0, 0));
-                            
-                vk_render_pass_builder RpBuilder = VkRenderPassBuilderBegin(&DemoState->TempArena);
-
-                u32 GBufferPositionId = VkRenderPassAttachmentAdd(&RpBuilder, Result->GBufferPositionEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
-                                                                  VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_UNDEFINED,
-                                                                  VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-                u32 GBufferNormalId = VkRenderPassAttachmentAdd(&RpBuilder, Result->GBufferNormalEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
-                                                                VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_UNDEFINED,
-                                                                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-                u32 GBufferColorId = VkRenderPassAttachmentAdd(&RpBuilder, Result->GBufferColorEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
-                                                               VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_UNDEFINED,
-                                                               VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-                u32 DepthId = VkRenderPassAttachmentAdd(&RpBuilder, Result->DepthEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
-                                                        VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_UNDEFINED,
-                                                        VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
-                u32 SsaoId = VkRenderPassAttachmentAdd(&RpBuilder, Result->SsaoEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
-                                                       VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_UNDEFINED,
-                                                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-                VkRenderPassSubPassBegin(&RpBuilder, VK_PIPELINE_BIND_POINT_GRAPHICS);
-                VkRenderPassColorRefAdd(&RpBuilder, GBufferPositionId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-                VkRenderPassColorRefAdd(&RpBuilder, GBufferNormalId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-                VkRenderPassColorRefAdd(&RpBuilder, GBufferColorId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-                VkRenderPassDepthRefAdd(&RpBuilder, DepthId, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
-                VkRenderPassSubPassEnd(&RpBuilder);
-
-                VkRenderPassDependency(&RpBuilder, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-                                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-                                       VK_ACCESS_SHADER_READ_BIT, VK_DEPENDENCY_BY_REGION_BIT);
-
-                VkRenderPassSubPassBegin(&RpBuilder, VK_PIPELINE_BIND_POINT_GRAPHICS);
-                VkRenderPassInputRefAdd(&RpBuilder, GBufferPositionId, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-                VkRenderPassInputRefAdd(&RpBuilder, GBufferNormalId, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-                VkRenderPassInputRefAdd(&RpBuilder, DepthId, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
-                VkRenderPassColorRefAdd(&RpBuilder, SsaoId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-                VkRenderPassSubPassEnd(&RpBuilder);
-
-                Result->GBufferPass = RenderTargetBuilderEnd(&Builder, VkRenderPassBuilderEnd(&RpBuilder, RenderState->Device));
-            }
+            Result->GBufferPass = TiledDeferredGBufferPassCreate(Result, CreateInfo.Width, CreateInfo.Height, TiledDeferredGBufferPass_Full);
+            Result->GBufferEarlyPass = TiledDeferredGBufferPassCreate(Result, CreateInfo.Width, CreateInfo.Height, TiledDeferredGBufferPass_Early);
+            Result->GBufferLatePass = TiledDeferredGBufferPassCreate(Result, CreateInfo.Width, CreateInfo.Height, TiledDeferredGBufferPass_Late);
 
+            // NOTE: One pipeline per material binding model, vertex format and instance id source
+            const char* VertShaders[] =
+                {
+                    "shader_tiled_deferred_gbuffer_vert.spv",
+                    "shader_tiled_deferred_gbuffer_bindless_vert.spv",
+                    "shader_tiled_deferred_gbuffer_quantized_vert.spv",
+                    "shader_tiled_deferred_gbuffer_bindless_quantized_vert.spv",
+                    "shader_tiled_deferred_gbuffer_culled_vert.spv",
+                    "shader_tiled_deferred_gbuffer_bindless_culled_vert.spv",
+                    "shader_tiled_deferred_gbuffer_quantized_culled_vert.spv",
+                    "shader_tiled_deferred_gbuffer_bindless_quantized_culled_vert.spv",
+                };
+            for (u32 PipelineId = 0; PipelineId < ArrayCount(Result->GBufferPipelines); ++PipelineId)
             {
+                b32 Bindless = (PipelineId & TiledDeferredGBuffer_Bindless) != 0;
+                b32 Quantized = (PipelineId & TiledDeferredGBuffer_Quantized) != 0;
+                b32 Culled = (PipelineId & TiledDeferredGBuffer_Culled) != 0;
                 vk_pipeline_builder Builder = VkPipelineBuilderBegin(&DemoState->TempArena);
 
                 // NOTE: Shaders
-                VkPipelineShaderAdd(&Builder, "shader_tiled_deferred_gbuffer_vert.spv", "main", VK_SHADER_STAGE_VERTEX_BIT);
-                VkPipelineShaderAdd(&Builder, "shader_tiled_deferred_gbuffer_frag.spv", "main", VK_SHADER_STAGE_FRAGMENT_BIT);
+                VkPipelineShaderAdd(&Builder, VertShaders[PipelineId], "main", VK_SHADER_STAGE_VERTEX_BIT);
+                if (Bindless)
+                {
+                    VkPipelineShaderAdd(&Builder, "shader_tiled_deferred_gbuffer_bindless_frag.spv", "main", VK_SHADER_STAGE_FRAGMENT_BIT);
+                }
+                else
+                {
+                    VkPipelineShaderAdd(&Builder, "shader_tiled_deferred_gbuffer_frag.spv", "main", VK_SHADER_STAGE_FRAGMENT_BIT);
+                }
                 
                 // NOTE: Specify input vertex data format
                 VkPipelineVertexBindingBegin(&Builder);
-                VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, sizeof(v3));
-                VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, sizeof(v3));
-                VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32_SFLOAT, sizeof(v2));
+                if (Quantized)
+                {
+                    VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R16G16B16A16_UNORM, 4*sizeof(u16));
+                    VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R16G16_SNORM, 2*sizeof(i16));
+                    VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R16G16_SFLOAT, 2*sizeof(u16));
+                }
+                else
+                {
+                    VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, sizeof(v3));
+                    VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, sizeof(v3));
+                    VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32_SFLOAT, sizeof(v2));
+                }
                 VkPipelineVertexBindingEnd(&Builder);
 
                 VkPipelineInputAssemblyAdd(&Builder, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
@@ -288,26 +853,28 @@ inline void TiledDeferredCreate(renderer_create_info CreateInfo, VkDescriptorSet
 
                 VkDescriptorSetLayout DescriptorLayouts[] =
                     {
-                        Result->TiledDeferredDescLayout,
+                        Result->Tiled.TiledDeferredDescLayout,
                         CreateInfo.SceneDescLayout,
-                        CreateInfo.MaterialDescLayout,
+                        Bindless ? CreateInfo.BindlessMaterialDescLayout : CreateInfo.MaterialDescLayout,
+                        Result->OcclusionCull.DrawDescLayout,
                     };
             
-                Result->GBufferPipeline = VkPipelineBuilderEnd(&Builder, RenderState->Device, &RenderState->PipelineManager,
-                                                               Result->GBufferPass.RenderPass, 0, DescriptorLayouts, ArrayCount(DescriptorLayouts));
+                Result->GBufferPipelines[PipelineId] = VkPipelineBuilderEnd(&Builder, RenderState->Device, &RenderState->PipelineManager,
+                                                                            Result->GBufferPass.RenderPass, 0, DescriptorLayouts,
+                                                                            Culled ? ArrayCount(DescriptorLayouts) : ArrayCount(DescriptorLayouts) - 1);
             }
             
             // NOTE: SSAO Pipeline
             {
                 VkDescriptorSetLayout DescriptorLayouts[] =
                     {
-                        Result->TiledDeferredDescLayout,
+                        Result->Tiled.TiledDeferredDescLayout,
                         Result->SsaoDescLayout,
                     };
 
                 VkDescriptorSet Descriptors[] =
                     {
-                        Result->TiledDeferredDescriptor,
+                        Result->Tiled.TiledDeferredDescriptor,
                         Result->SsaoDescriptor,
                     };
 
@@ -316,18 +883,6 @@ inline void TiledDeferredCreate(renderer_create_info CreateInfo, VkDescriptorSet
             }
         }
         
-        // NOTE: Light Cull
-        {
-            VkDescriptorSetLayout Layouts[] =
-                {
-                    Result->TiledDeferredDescLayout,
-                    CreateInfo.SceneDescLayout,
-                };
-            
-            Result->LightCullPipeline = VkPipelineComputeCreate(RenderState->Device, &RenderState->PipelineManager, &DemoState->TempArena,
-                                                                "shader_tiled_deferred_light_culling.spv", "main", Layouts, ArrayCount(Layouts));
-        }
-
         // NOTE: Lighting Pass 
         {
             // NOTE: RT
@@ -370,7 +925,7 @@ inline void TiledDeferredCreate(renderer_create_info CreateInfo, VkDescriptorSet
 
                 VkDescriptorSetLayout DescriptorLayouts[] =
                     {
-                        Result->TiledDeferredDescLayout,
+                        Result->Tiled.TiledDeferredDescLayout,
                         CreateInfo.SceneDescLayout,
                     };
             
@@ -378,6 +933,109 @@ inline void TiledDeferredCreate(renderer_create_info CreateInfo, VkDescriptorSet
                                                                 Result->LightingPass.RenderPass, 0, DescriptorLayouts, ArrayCount(DescriptorLayouts));
             }
         }
+
+        // NOTE: Transparent Pass
+        {
+            // NOTE: RT
+            {
+                render_target_builder Builder = RenderTargetBuilderBegin(&DemoState->Arena, &DemoState->TempArena, CreateInfo.Width, CreateInfo.Height);
+                RenderTargetAddTarget(&Builder, &Result->TransparentAccumEntry, VkClearColorCreate(0, 0, 0, 0));
+                RenderTargetAddTarget(&Builder, &Result->TransparentRevealEntry, VkClearColorCreate(1, 0, 0, 0));
+                RenderTargetAddTarget(&Builder, &Result->DepthEntry, VkClearDepthStencilCreate(0, 0));
+                RenderTargetAddTarget(&Builder, &Result->OutColorEntry, VkClearColorCreate(0, 0, 0, 1));
+                            
+                vk_render_pass_builder RpBuilder = VkRenderPassBuilderBegin(&DemoState->TempArena);
+
+                u32 AccumId = VkRenderPassAttachmentAdd(&RpBuilder, Result->TransparentAccumEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                        VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                u32 RevealId = VkRenderPassAttachmentAdd(&RpBuilder, Result->TransparentRevealEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                         VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                // NOTE: Opaque depth from the GBuffer pass, only tested against
+                u32 DepthId = VkRenderPassAttachmentAdd(&RpBuilder, Result->DepthEntry.Format, VK_ATTACHMENT_LOAD_OP_LOAD,
+                                                        VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+                                                        VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+                u32 OutColorId = VkRenderPassAttachmentAdd(&RpBuilder, Result->OutColorEntry.Format, VK_ATTACHMENT_LOAD_OP_LOAD,
+                                                           VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+                VkRenderPassSubPassBegin(&RpBuilder, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                VkRenderPassColorRefAdd(&RpBuilder, AccumId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+                VkRenderPassColorRefAdd(&RpBuilder, RevealId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+                VkRenderPassDepthRefAdd(&RpBuilder, DepthId, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+                VkRenderPassSubPassEnd(&RpBuilder);
+
+                VkRenderPassDependency(&RpBuilder, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                       VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_INPUT_ATTACHMENT_READ_BIT, VK_DEPENDENCY_BY_REGION_BIT);
+
+                VkRenderPassSubPassBegin(&RpBuilder, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                VkRenderPassInputRefAdd(&RpBuilder, AccumId, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                VkRenderPassInputRefAdd(&RpBuilder, RevealId, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                VkRenderPassColorRefAdd(&RpBuilder, OutColorId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+                VkRenderPassSubPassEnd(&RpBuilder);
+
+                Result->TransparentPass = RenderTargetBuilderEnd(&Builder, VkRenderPassBuilderEnd(&RpBuilder, RenderState->Device));
+            }
+
+            VkDescriptorSetLayout DescriptorLayouts[] =
+                {
+                    Result->Tiled.TiledDeferredDescLayout,
+                    CreateInfo.SceneDescLayout,
+                    CreateInfo.MaterialDescLayout,
+                    Result->TransparentDescLayout,
+                };
+            
+            // NOTE: Transparent Pipeline
+            {
+                vk_pipeline_builder Builder = VkPipelineBuilderBegin(&DemoState->TempArena);
+
+                // NOTE: Shaders
+                VkPipelineShaderAdd(&Builder, "shader_tiled_deferred_transparent_vert.spv", "main", VK_SHADER_STAGE_VERTEX_BIT);
+                VkPipelineShaderAdd(&Builder, "shader_tiled_deferred_transparent_frag.spv", "main", VK_SHADER_STAGE_FRAGMENT_BIT);
+                
+                // NOTE: Specify input vertex data format
+                VkPipelineVertexBindingBegin(&Builder);
+                VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, sizeof(v3));
+                VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, sizeof(v3));
+                VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32_SFLOAT, sizeof(v2));
+                VkPipelineVertexBindingEnd(&Builder);
+
+                VkPipelineInputAssemblyAdd(&Builder, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
+                VkPipelineDepthStateAdd(&Builder, VK_TRUE, VK_FALSE, VK_COMPARE_OP_GREATER);
+
+                // NOTE: Accum adds up, revealage multiplies in (1 - alpha)
+                VkPipelineColorAttachmentAdd(&Builder, VK_TRUE, VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ONE,
+                                             VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ONE);
+                VkPipelineColorAttachmentAdd(&Builder, VK_TRUE, VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ZERO, VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR,
+                                             VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ZERO, VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA);
+
+                Result->TransparentPipeline = VkPipelineBuilderEnd(&Builder, RenderState->Device, &RenderState->PipelineManager,
+                                                                   Result->TransparentPass.RenderPass, 0, DescriptorLayouts, ArrayCount(DescriptorLayouts));
+            }
+
+            // NOTE: Transparent Composite Pipeline
+            {
+                vk_pipeline_builder Builder = VkPipelineBuilderBegin(&DemoState->TempArena);
+
+                // NOTE: Shaders
+                VkPipelineShaderAdd(&Builder, "shader_tiled_deferred_lighting_vert.spv", "main", VK_SHADER_STAGE_VERTEX_BIT);
+                VkPipelineShaderAdd(&Builder, "shader_tiled_deferred_transparent_composite_frag.spv", "main", VK_SHADER_STAGE_FRAGMENT_BIT);
+                
+                // NOTE: Specify input vertex data format
+                VkPipelineVertexBindingBegin(&Builder);
+                VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, 2*sizeof(v3) + sizeof(v2));
+                VkPipelineVertexBindingEnd(&Builder);
+
+                VkPipelineInputAssemblyAdd(&Builder, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
+                VkPipelineColorAttachmentAdd(&Builder, VK_TRUE, VK_BLEND_OP_ADD, VK_BLEND_FACTOR_SRC_ALPHA, VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+                                             VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA);
+
+                Result->TransparentCompositePipeline = VkPipelineBuilderEnd(&Builder, RenderState->Device, &RenderState->PipelineManager,
+                                                                            Result->TransparentPass.RenderPass, 1, DescriptorLayouts,
+                                                                            ArrayCount(DescriptorLayouts));
+            }
+        }
     }
 }
 
@@ -386,50 +1044,70 @@ inline void TiledDeferredAddMeshes(tiled_deferred_state* State, render_mesh* Qua
     State->QuadMesh = QuadMesh;
 }
 
-inline void TiledDeferredRender(vk_commands Commands, tiled_deferred_state* State, render_scene* Scene)
+inline void TiledDeferredFusedLightingRender(vk_commands Commands, tiled_deferred_state* State, render_scene* Scene)
 {
-    // NOTE: Clear images
-    {
-        // NOTE: Clear buffers and upload data
-        VkClearValue ClearColor = VkClearColorCreate(0, 0, 0, 0);
-        VkImageSubresourceRange Range = {};
-        Range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        Range.baseMipLevel = 0;
-        Range.levelCount = 1;
-        Range.baseArrayLayer = 0;
-        Range.layerCount = 1;
-        
-        vkCmdClearColorImage(Commands.Buffer, State->LightGrid_O.Image, VK_IMAGE_LAYOUT_GENERAL, &ClearColor.color, 1, &Range);
-        vkCmdClearColorImage(Commands.Buffer, State->LightGrid_T.Image, VK_IMAGE_LAYOUT_GENERAL, &ClearColor.color, 1, &Range);
-        vkCmdFillBuffer(Commands.Buffer, State->LightIndexCounter_O, 0, sizeof(u32), 0);
-        vkCmdFillBuffer(Commands.Buffer, State->LightIndexCounter_T, 0, sizeof(u32), 0);
-    }
+    // NOTE: Culling and lighting both happen in this dispatch, so its all counted as lighting
+    vkCmdPipelineBarrier(Commands.Buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         VK_DEPENDENCY_BY_REGION_BIT, 0, 0, 0, 0, 0, 0);
+
+    GpuTimerBegin(Commands, &DemoState->GpuTimers, GpuTimer_Lighting);
+    
+    VkBarrierImageAdd(&RenderState->BarrierManager, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                      VK_IMAGE_LAYOUT_UNDEFINED, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_IMAGE_LAYOUT_GENERAL,
+                      VK_IMAGE_ASPECT_COLOR_BIT, State->OutColorImage);
+    VkBarrierManagerFlush(&RenderState->BarrierManager, Commands.Buffer);
+
+    TiledLightDataCoarseCull(Commands, &State->Tiled, Scene);
+    
+    vk_pipeline* Pipeline = State->FusedLightingPipelines + State->Tiled.TileSizeId;
+    vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, Pipeline->Handle);
+    VkDescriptorSet DescriptorSets[] =
+        {
+            State->Tiled.TiledDeferredDescriptor,
+            Scene->SceneDescriptor,
+        };
+    vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, Pipeline->Layout, 0, ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
+    vkCmdDispatch(Commands.Buffer, State->Tiled.NumTilesX, State->Tiled.NumTilesY, 1);
+
+    // NOTE: Copy to swap samples the output next
+    VkBarrierImageAdd(&RenderState->BarrierManager, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_IMAGE_LAYOUT_GENERAL,
+                      VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                      VK_IMAGE_ASPECT_COLOR_BIT, State->OutColorImage);
+    VkBarrierManagerFlush(&RenderState->BarrierManager, Commands.Buffer);
     
-    RenderTargetPassBegin(&State->GBufferPass, Commands, RenderTargetRenderPass_SetViewPort | RenderTargetRenderPass_SetScissor);
-    // NOTE: GBuffer Pass
+    GpuTimerEnd(Commands, &DemoState->GpuTimers, GpuTimer_Lighting);
+}
+
+inline void TiledDeferredTransparentRender(vk_commands Commands, tiled_deferred_state* State, render_scene* Scene)
+{
+    GpuTimerBegin(Commands, &DemoState->GpuTimers, GpuTimer_Transparent);
+    RenderTargetPassBegin(&State->TransparentPass, Commands, 0);
+    TiledDeferredViewportSet(Commands, State->RenderWidth, State->RenderHeight);
+    // NOTE: Transparent Accum Pass
     {
-        vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->GBufferPipeline->Handle);
+        vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->TransparentPipeline->Handle);
         {
             VkDescriptorSet DescriptorSets[] =
                 {
-                    State->TiledDeferredDescriptor,
+                    State->Tiled.TiledDeferredDescriptor,
                     Scene->SceneDescriptor,
                 };
-            vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->GBufferPipeline->Layout, 0,
+            vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->TransparentPipeline->Layout, 0,
                                     ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
         }
 
-        for (u32 InstanceId = 0; InstanceId < Scene->NumOpaqueInstances; ++InstanceId)
+        // NOTE: Submission order doesn't matter for weighted blended OIT, so no sorting here
+        for (u32 InstanceId = 0; InstanceId < Scene->TransparentInstances.NumItems; ++InstanceId)
         {
-            instance_entry* CurrInstance = Scene->OpaqueInstances + InstanceId;
-            render_mesh* CurrMesh = Scene->RenderMeshes + CurrInstance->MeshId;
+            transparent_instance_entry* CurrInstance = SceneTransparentInstanceAt(Scene, InstanceId);
+            render_mesh* CurrMesh = SceneMeshGet(Scene, CurrInstance->Mesh);
 
             {
                 VkDescriptorSet DescriptorSets[] =
                     {
                         CurrMesh->MaterialDescriptor,
                     };
-                vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->GBufferPipeline->Layout, 2,
+                vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->TransparentPipeline->Layout, 2,
                                         ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
             }
             
@@ -440,39 +1118,15 @@ inline void TiledDeferredRender(vk_commands Commands, tiled_deferred_state* Stat
         }
     }
     RenderTargetNextSubPass(Commands);
-    // NOTE: SSAO Pass
-    FullScreenPassRender(Commands, &State->SsaoPass);
-    RenderTargetPassEnd(Commands);
-    
-    // NOTE: Light Culling Pass
-    {
-        vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, State->LightCullPipeline->Handle);
-        VkDescriptorSet DescriptorSets[] =
-            {
-                State->TiledDeferredDescriptor,
-                Scene->SceneDescriptor,
-            };
-        vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_COMPUTE, State->LightCullPipeline->Layout, 0,
-                                ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
-        u32 DispatchX = CeilU32(f32(RenderState->WindowWidth) / f32(TILE_SIZE_IN_PIXELS));
-        u32 DispatchY = CeilU32(f32(RenderState->WindowHeight) / f32(TILE_SIZE_IN_PIXELS));
-        vkCmdDispatch(Commands.Buffer, DispatchX, DispatchY, 1);
-    }
-
-    vkCmdPipelineBarrier(Commands.Buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                         VK_DEPENDENCY_BY_REGION_BIT, 0, 0, 0, 0, 0, 0);
-    
-    RenderTargetPassBegin(&State->LightingPass, Commands, RenderTargetRenderPass_SetViewPort | RenderTargetRenderPass_SetScissor);
-    // NOTE: Lighting Pass
+    // NOTE: Transparent Composite Pass
     {
-        vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->LightingPipeline->Handle);
+        vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->TransparentCompositePipeline->Handle);
         {
             VkDescriptorSet DescriptorSets[] =
                 {
-                    State->TiledDeferredDescriptor,
-                    Scene->SceneDescriptor,
+                    State->TransparentDescriptor,
                 };
-            vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->LightingPipeline->Layout, 0,
+            vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->TransparentCompositePipeline->Layout, 3,
                                     ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
         }
 
@@ -482,4 +1136,209 @@ inline void TiledDeferredRender(vk_commands Commands, tiled_deferred_state* Stat
         vkCmdDrawIndexed(Commands.Buffer, State->QuadMesh->NumIndices, 1, 0, 0, 0);
     }
     RenderTargetPassEnd(Commands);
+    GpuTimerEnd(Commands, &DemoState->GpuTimers, GpuTimer_Transparent);
+}
+
+inline void TiledDeferredGBufferMeshBind(vk_commands Commands, tiled_deferred_state* State, render_mesh* Mesh, u32 BasePipelineId,
+                                         u32* PipelineId)
+{
+    // NOTE: Meshes that have a quantized stream use it, the rest stay on full precision. Layouts match between the permutations so
+    // switching pipelines keeps our descriptor sets bound
+    b32 Quantized = State->QuantizedVertices && Mesh->QuantizedVertexBuffer != VK_NULL_HANDLE;
+    u32 NewPipelineId = BasePipelineId | (Quantized ? TiledDeferredGBuffer_Quantized : 0);
+    vk_pipeline* Pipeline = State->GBufferPipelines[NewPipelineId];
+    if (NewPipelineId != *PipelineId)
+    {
+        *PipelineId = NewPipelineId;
+        vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline->Handle);
+    }
+        
+    if ((BasePipelineId & TiledDeferredGBuffer_Bindless) == 0)
+    {
+        VkDescriptorSet DescriptorSets[] =
+            {
+                Mesh->MaterialDescriptor,
+            };
+        vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline->Layout, 2,
+                                ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
+    }
+        
+    VkDeviceSize Offset = 0;
+    if (Quantized)
+    {
+        vkCmdBindVertexBuffers(Commands.Buffer, 0, 1, &Mesh->QuantizedVertexBuffer, &Offset);
+        vkCmdBindIndexBuffer(Commands.Buffer, Mesh->QuantizedIndexBuffer, 0, Mesh->QuantizedIndexType);
+    }
+    else
+    {
+        vkCmdBindVertexBuffers(Commands.Buffer, 0, 1, &Mesh->VertexBuffer, &Offset);
+        vkCmdBindIndexBuffer(Commands.Buffer, Mesh->IndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    }
+}
+
+inline void TiledDeferredGBufferDraw(vk_commands Commands, tiled_deferred_state* State, render_scene* Scene, occlusion_cull* Cull,
+                                     occlusion_cull_phase Phase)
+{
+    // NOTE: Without culling, runs of instances that share a mesh become one instanced draw. With culling every mesh gets one indirect
+    // draw, and the culling shader decides how many instances it has, see occlusion_cull.h
+    CPU_TIMED_BLOCK("GBufferRecord");
+
+    // NOTE: Bindless draws get their material from the instance data, so all sets are bound once up front
+    b32 Bindless = State->BindlessMaterials && Scene->BindlessMaterialsSupported;
+    u32 BasePipelineId = (Bindless ? TiledDeferredGBuffer_Bindless : 0) | (Cull ? TiledDeferredGBuffer_Culled : 0);
+    u32 PipelineId = BasePipelineId;
+    vk_pipeline* Pipeline = State->GBufferPipelines[PipelineId];
+    vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline->Handle);
+    {
+        VkDescriptorSet DescriptorSets[] =
+            {
+                State->Tiled.TiledDeferredDescriptor,
+                Scene->SceneDescriptor,
+                Scene->BindlessMaterialDescriptor,
+            };
+        vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline->Layout, 0,
+                                Bindless ? ArrayCount(DescriptorSets) : ArrayCount(DescriptorSets) - 1, DescriptorSets, 0, 0);
+    }
+
+    if (Cull)
+    {
+        VkBuffer DrawArgs = Phase == OcclusionCullPhase_Early ? Cull->EarlyDraws.Buffer : Cull->LateDraws.Buffer;
+        u32 PhaseOffset = Phase == OcclusionCullPhase_Early ? 0 : Cull->PhaseVisibleIds;
+        for (u32 BatchId = 0; BatchId < Cull->NumBatches; ++BatchId)
+        {
+            occlusion_batch* Batch = Cull->Batches + BatchId;
+            TiledDeferredGBufferMeshBind(Commands, State, SceneMeshGet(Scene, Batch->Mesh), BasePipelineId, &PipelineId);
+
+            u32 DynamicOffset = u32((PhaseOffset + Batch->VisibleIdOffset) * sizeof(u32));
+            vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->GBufferPipelines[PipelineId]->Layout, 3, 1,
+                                    &Cull->DrawDescriptor, 1, &DynamicOffset);
+            vkCmdDrawIndexedIndirect(Commands.Buffer, DrawArgs, BatchId*sizeof(VkDrawIndexedIndirectCommand), 1,
+                                     sizeof(VkDrawIndexedIndirectCommand));
+        }
+    }
+    else
+    {
+        // NOTE: Direct draws can start at any instance without drawIndirectFirstInstance
+        u32 InstanceId = 0;
+        while (InstanceId < Scene->OpaqueInstances.NumItems)
+        {
+            scene_handle MeshHandle = SceneOpaqueInstanceAt(Scene, InstanceId)->Mesh;
+            u32 NumInstances = 1;
+            while (InstanceId + NumInstances < Scene->OpaqueInstances.NumItems &&
+                   SceneHandleEqual(SceneOpaqueInstanceAt(Scene, InstanceId + NumInstances)->Mesh, MeshHandle))
+            {
+                NumInstances += 1;
+            }
+
+            render_mesh* CurrMesh = SceneMeshGet(Scene, MeshHandle);
+            TiledDeferredGBufferMeshBind(Commands, State, CurrMesh, BasePipelineId, &PipelineId);
+            vkCmdDrawIndexed(Commands.Buffer, CurrMesh->NumIndices, NumInstances, 0, 0, InstanceId);
+            InstanceId += NumInstances;
+        }
+    }
+}
+
+inline void TiledDeferredRender(vk_commands Commands, tiled_deferred_state* State, render_scene* Scene)
+{
+    CPU_TIMED_BLOCK("TiledDeferredRender");
+
+    // NOTE: Fused lighting never builds the transparent light lists, so frames with transparent instances take the split path. It also
+    // never writes LightGrid_O or the index list, so there are no light grid stats to process or copy on fused frames
+    b32 Fused = State->FusedLighting && Scene->TransparentInstances.NumItems == 0;
+    if (!Fused)
+    {
+        LightGridStatsProcess(&State->Tiled.LightGridStats);
+    }
+    TiledLightDataFrameBegin(Commands, &State->Tiled);
+    TiledLightDataClear(Commands, &State->Tiled);
+    
+    GpuTimerBegin(Commands, &DemoState->GpuTimers, GpuTimer_GBuffer);
+    if (State->OcclusionCull.Active)
+    {
+        // NOTE: Two phase occlusion culling, see occlusion_cull.h
+        occlusion_cull* Cull = &State->OcclusionCull;
+        OcclusionCullFrameBegin(Commands, Cull);
+        OcclusionCullDispatch(Commands, Cull, OcclusionCullPhase_Early);
+        
+        RenderTargetPassBegin(&State->GBufferEarlyPass, Commands, 0);
+        TiledDeferredViewportSet(Commands, State->RenderWidth, State->RenderHeight);
+        TiledDeferredGBufferDraw(Commands, State, Scene, Cull, OcclusionCullPhase_Early);
+        RenderTargetNextSubPass(Commands);
+        RenderTargetPassEnd(Commands);
+
+        OcclusionCullHiZBuild(Commands, Cull);
+        OcclusionCullDispatch(Commands, Cull, OcclusionCullPhase_Late);
+
+        RenderTargetPassBegin(&State->GBufferLatePass, Commands, 0);
+        TiledDeferredViewportSet(Commands, State->RenderWidth, State->RenderHeight);
+        TiledDeferredGBufferDraw(Commands, State, Scene, Cull, OcclusionCullPhase_Late);
+        RenderTargetNextSubPass(Commands);
+        // NOTE: SSAO Pass
+        FullScreenPassRender(Commands, &State->SsaoPass);
+        RenderTargetPassEnd(Commands);
+
+        // NOTE: Next frames early phase tests against everything we drew
+        OcclusionCullHiZBuild(Commands, Cull);
+    }
+    else
+    {
+        State->OcclusionCull.HiZValid = false;
+        
+        RenderTargetPassBegin(&State->GBufferPass, Commands, 0);
+        TiledDeferredViewportSet(Commands, State->RenderWidth, State->RenderHeight);
+        // NOTE: GBuffer Pass
+        TiledDeferredGBufferDraw(Commands, State, Scene, 0, OcclusionCullPhase_Early);
+        RenderTargetNextSubPass(Commands);
+        // NOTE: SSAO Pass
+        FullScreenPassRender(Commands, &State->SsaoPass);
+        RenderTargetPassEnd(Commands);
+    }
+    GpuTimerEnd(Commands, &DemoState->GpuTimers, GpuTimer_GBuffer);
+
+    if (Fused)
+    {
+        TiledDeferredFusedLightingRender(Commands, State, Scene);
+    }
+    else
+    {
+        // NOTE: Light Culling Pass
+        TiledLightDataCull(Commands, &State->Tiled, Scene);
+
+        vkCmdPipelineBarrier(Commands.Buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                             VK_DEPENDENCY_BY_REGION_BIT, 0, 0, 0, 0, 0, 0);
+    
+        GpuTimerBegin(Commands, &DemoState->GpuTimers, GpuTimer_Lighting);
+        RenderTargetPassBegin(&State->LightingPass, Commands, 0);
+        TiledDeferredViewportSet(Commands, State->RenderWidth, State->RenderHeight);
+        // NOTE: Lighting Pass
+        {
+            CPU_TIMED_BLOCK("LightingRecord");
+            
+            vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->LightingPipeline->Handle);
+            {
+                VkDescriptorSet DescriptorSets[] =
+                    {
+                        State->Tiled.TiledDeferredDescriptor,
+                        Scene->SceneDescriptor,
+                    };
+                vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, State->LightingPipeline->Layout, 0,
+                                        ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
+            }
+
+            VkDeviceSize Offset = 0;
+            vkCmdBindVertexBuffers(Commands.Buffer, 0, 1, &State->QuadMesh->VertexBuffer, &Offset);
+            vkCmdBindIndexBuffer(Commands.Buffer, State->QuadMesh->IndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+            vkCmdDrawIndexed(Commands.Buffer, State->QuadMesh->NumIndices, 1, 0, 0, 0);
+        }
+        RenderTargetPassEnd(Commands);
+        GpuTimerEnd(Commands, &DemoState->GpuTimers, GpuTimer_Lighting);
+    }
+
+    if (Scene->TransparentInstances.NumItems > 0)
+    {
+        CPU_TIMED_BLOCK("TransparentRecord");
+        TiledDeferredTransparentRender(Commands, State, Scene);
+    }
+
+    LightGridStatsFrameEnd(&State->Tiled.LightGridStats);
 }
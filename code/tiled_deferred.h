@@ -1,8 +1,99 @@
 #pragma once
 
+// NOTE: Defaults, the culling shader gets both as specialization constants so the tile size can change at runtime
 #define TILE_SIZE_IN_PIXELS 8
 #define MAX_LIGHTS_PER_TILE 1024
 
+// NOTE: Readback slots for the light index counters, same double buffering as the light grid stats
+#define TILED_INDEX_COUNTER_NUM_SLOTS 2
+
+// NOTE: Shared memory of the culling shader on top of the per thread group ids and the two light lists (frustum, counters, depth range)
+#define TILED_LIGHT_CULL_SHARED_OVERHEAD 256
+
+// NOTE: Every tile size we may build a light culling pipeline permutation for. Culling runs one thread per pixel of the tile, and the
+// spec only guarantees 128 invocations and 16KB of shared memory per workgroup. Only 8x8 fits everywhere, bigger candidates get checked
+// against the device limits (TileSizeSupported) and skipped when they don't fit
+global u32 TileSizeCandidates[] =
+{
+    8,
+    16,
+    32,
+};
+
+/*
+
+  NOTE: Tiles can store their lights in two ways. The index list is a variable length u32 list per tile, with an offset/count image
+        pointing into it. The bit mask stores one bit per light per tile, and pairs it with a z-bin table that holds the min/max index
+        of the lights that touch each view depth slice. Lights are sorted by view depth in bit mask mode, so the lighting pass only has
+        to walk the words of the tile mask that the pixels z-bin covers.
+
+        Bit masks have bounded memory and culling needs no atomics, but they only scale to a few thousand lights. Frames with more
+        lights than TILED_BIT_MASK_MAX_LIGHTS fall back to the index list.
+  
+ */
+
+#define TILED_LIGHT_LIST_BIT_MASK 0
+#define TILED_BIT_MASK_MAX_LIGHTS 4096
+#define TILED_BIT_MASK_WORDS_PER_TILE (TILED_BIT_MASK_MAX_LIGHTS / 32)
+#define ZBIN_COUNT 1024
+
+/*
+
+  NOTE: Hierarchical culling. A coarse pass culls every light into TILED_COARSE_TILE_SIZE^2 pixel super tiles first, and the index list
+        culling of the fine tiles then only walks the list of the super tile they sit in instead of every light group in the scene.
+        Super tile lists have TILED_COARSE_MAX_LIGHTS_PER_TILE slots each. A super tile that touches more lights still stores its real
+        count and its fine tiles go back to culling every light group.
+
+        Only used with the index list, bit masks are capped at TILED_BIT_MASK_MAX_LIGHTS lights anyway, and only when the fine tiles are
+        smaller than a super tile.
+  
+ */
+
+#define TILED_COARSE_LIGHT_CULLING 0
+#define TILED_COARSE_TILE_SIZE 32
+#define TILED_COARSE_MAX_LIGHTS_PER_TILE 4096
+
+enum tiled_light_list_mode
+{
+    TiledLightListMode_IndexList,
+    TiledLightListMode_BitMask,
+};
+
+/*
+
+  NOTE: Light vs. tile tests. Every mode keeps the same lists, they only differ in how many lights near a tile end up in them by mistake:
+
+    - Frustum: the light sphere against the four side planes of the tile plus the depth range. A sphere outside the frustum near one of
+      its corners is still inside both planes that meet there, so big lights get added to a whole ring of tiles around the ones they
+      touch.
+    - Aabb: the view space box around the tile between its depth bounds, and the distance from the light to that box. Corners are exact
+      and thin depth ranges give thin boxes, but the box grows with the tiles view depth range.
+    - AabbCone: Aabb plus the distance from the light to the cone around the tiles view rays. The cone doesn't grow with depth so it
+      catches what the box lets through on tiles with deep depth ranges.
+
+        Culling gets a bit more expensive per light, the lighting pass saves a BlinnPhongLighting evaluation per pixel for every light we
+        drop. LIGHT_TEST_COMPARE in benchmark.h measures both sides.
+  
+ */
+
+#define TILED_LIGHT_TEST_MODE 0 // NOTE: tiled_light_test_mode
+
+enum tiled_light_test_mode
+{
+    TiledLightTestMode_Frustum,
+    TiledLightTestMode_Aabb,
+    TiledLightTestMode_AabbCone,
+
+    TiledLightTestMode_Count,
+};
+
+global const char* TiledLightTestModeNames[] =
+{
+    "Frustum",
+    "Aabb",
+    "AabbCone",
+};
+
 struct gpu_ssao_inputs
 {
     m4 VPTransform;
@@ -10,6 +101,14 @@ struct gpu_ssao_inputs
     v4 RandomRotations[16]; // NOTE: 4x4
 };
 
+enum tiled_deferred_debug_view
+{
+    TiledDeferredDebugView_Lit,
+    TiledDeferredDebugView_Ao,
+    TiledDeferredDebugView_LightHeatMapOpaque,
+    TiledDeferredDebugView_LightHeatMapTransparent,
+};
+
 struct tiled_deferred_globals
 {
     // TODO: Move to camera?
@@ -17,6 +116,110 @@ struct tiled_deferred_globals
     v2 ScreenSize;
     u32 GridSizeX;
     u32 GridSizeY;
+    u32 LightIndexListCapacity;
+    u32 DebugViewMode;
+    u32 TileSize;
+    u32 MaxLightsPerTile;
+    u32 LightListMode;
+    f32 ZBinScale;
+    u32 LightTestMode;
+    u32 CoarseCulling;
+    u32 CoarseGridSizeX;
+};
+
+/*
+
+  NOTE: Tile data is everything the tiled renderers share: the grid frustums, the per tile light lists and the culling pipelines. Tiled
+        deferred and tiled forward each own one of these.
+  
+ */
+
+struct tiled_light_data
+{
+    u32 TileSize;
+    u32 TileSizeId;
+    u32 MaxLightsPerTile;
+    u32 NumTilesX;
+    u32 NumTilesY;
+
+    // NOTE: Entries in each index list. Starts at MaxLightsPerTile per tile and grows when the read back index counters go past it.
+    // The lists live in the arena the last swap chain change used
+    u32 LightIndexListCapacity;
+    vk_linear_arena* IndexListArena;
+    u32 IndexCounterFrameId;
+    b32 IndexCounterPending[TILED_INDEX_COUNTER_NUM_SLOTS];
+    readback_buffer IndexCounterReadbacks[TILED_INDEX_COUNTER_NUM_SLOTS];
+
+    // NOTE: Screen size of the current globals vs. the one the grid frustums were built for. With dynamic resolution the screen size
+    // changes without the grid getting reallocated
+    u32 ScreenWidth;
+    u32 ScreenHeight;
+    u32 FrustumWidth;
+    u32 FrustumHeight;
+    b32 ImagesInitialized;
+
+    // NOTE: Super tiles of the current globals
+    u32 NumCoarseTilesX;
+    u32 NumCoarseTilesY;
+    
+    VkBuffer TiledDeferredGlobals;
+    VkBuffer GridFrustums;
+    VkBuffer LightIndexList_O;
+    VkBuffer LightIndexCounter_O;
+    vk_image LightGrid_O;
+    VkBuffer LightIndexList_T;
+    VkBuffer LightIndexCounter_T;
+    vk_image LightGrid_T;
+    VkBuffer LightBitMask_O;
+    VkBuffer LightBitMask_T;
+    VkBuffer ZBins;
+    VkBuffer CoarseLightCounts;
+    VkBuffer CoarseLightIndexList;
+    VkDescriptorSetLayout TiledDeferredDescLayout;
+    VkDescriptorSet TiledDeferredDescriptor;
+
+    // NOTE: Mode we want vs. mode the current frame uses, the bit mask falls back to the index list when there are too many lights
+    tiled_light_list_mode LightListMode;
+    tiled_light_list_mode ActiveLightListMode;
+    tiled_light_test_mode LightTestMode;
+
+    // NOTE: Coarse culling we want vs. if the current frame uses it
+    b32 CoarseCulling;
+    b32 CoarseActive;
+    
+    vk_pipeline* GridFrustumPipeline;
+    vk_pipeline* CoarseLightCullPipeline;
+    vk_pipeline LightCullPipelines[ArrayCount(TileSizeCandidates)];
+    vk_pipeline LightCullBitMaskPipelines[ArrayCount(TileSizeCandidates)];
+
+    // NOTE: Debug data
+    u32 DebugViewMode;
+    light_grid_stats LightGridStats;
+};
+
+// NOTE: Cull and shade in one compute dispatch instead of a culling dispatch plus a full screen lighting pass
+#define TILED_DEFERRED_FUSED_LIGHTING 0
+
+// NOTE: GBuffer pass indexes the scenes bindless material arrays instead of binding a material set per draw
+#define TILED_DEFERRED_BINDLESS_MATERIALS 0
+
+// NOTE: GBuffer pass draws meshes from their quantized vertex stream when they have one
+#define TILED_DEFERRED_QUANTIZED_VERTICES 0
+
+enum tiled_deferred_gbuffer_pipeline_flags
+{
+    TiledDeferredGBuffer_Bindless = 1 << 0,
+    TiledDeferredGBuffer_Quantized = 1 << 1,
+    TiledDeferredGBuffer_Culled = 1 << 2, // NOTE: Instance ids come from the occlusion cull batches
+};
+
+// NOTE: Occlusion culling splits the GBuffer pass in two (see occlusion_cull.h). All of them are compatible, so the GBuffer and SSAO
+// pipelines work in each
+enum tiled_deferred_gbuffer_pass_type
+{
+    TiledDeferredGBufferPass_Full,
+    TiledDeferredGBufferPass_Early, // NOTE: Clears the GBuffer, leaves out SSAO
+    TiledDeferredGBufferPass_Late, // NOTE: Draws on top of the early pass, then runs SSAO
 };
 
 struct tiled_deferred_state
@@ -35,27 +238,41 @@ struct tiled_deferred_state
     VkImage OutColorImage;
     render_target_entry OutColorEntry;
     render_target GBufferPass;
+    render_target GBufferEarlyPass;
+    render_target GBufferLatePass;
     render_target LightingPass;
 
+    // NOTE: Transparent pass, weighted blended OIT into accum/revealage and then composited onto the lit output
+    VkImage TransparentAccumImage;
+    render_target_entry TransparentAccumEntry;
+    VkImage TransparentRevealImage;
+    render_target_entry TransparentRevealEntry;
+    render_target TransparentPass;
+    VkDescriptorSetLayout TransparentDescLayout;
+    VkDescriptorSet TransparentDescriptor;
+    vk_pipeline* TransparentPipeline;
+    vk_pipeline* TransparentCompositePipeline;
+
     // NOTE: Global data
-    VkBuffer TiledDeferredGlobals;
-    VkBuffer GridFrustums;
-    VkBuffer LightIndexList_O;
-    VkBuffer LightIndexCounter_O;
-    vk_image LightGrid_O;
-    VkBuffer LightIndexList_T;
-    VkBuffer LightIndexCounter_T;
-    vk_image LightGrid_T;
-    VkDescriptorSetLayout TiledDeferredDescLayout;
-    VkDescriptorSet TiledDeferredDescriptor;
+    tiled_light_data Tiled;
+
+    // NOTE: Sub rectangle of the targets we render into this frame (see dynamic_resolution.h)
+    u32 RenderWidth;
+    u32 RenderHeight;
 
     render_mesh* QuadMesh;
     
-    vk_pipeline* GridFrustumPipeline;
-    vk_pipeline* GBufferPipeline;
-    vk_pipeline* LightCullPipeline;
+    vk_pipeline* GBufferPipelines[8]; // NOTE: Indexed by tiled_deferred_gbuffer_pipeline_flags
     vk_pipeline* LightingPipeline;
 
+    b32 BindlessMaterials;
+    b32 QuantizedVertices;
+
+    b32 FusedLighting;
+    vk_pipeline FusedLightingPipelines[ArrayCount(TileSizeCandidates)];
+
+    occlusion_cull OcclusionCull;
+
     // NOTE: SSAO data
     VkImage SsaoImage;
     render_target_entry SsaoEntry;
@@ -64,4 +281,3 @@ struct tiled_deferred_state
     VkDescriptorSet SsaoDescriptor;
     render_fullscreen_pass SsaoPass;
 };
-
@@ -12,44 +12,303 @@
 
 TILED_DEFERRED_DESCRIPTOR_LAYOUT(0)
 SCENE_DESCRIPTOR_LAYOUT(1)
+#if BINDLESS_MATERIALS
+BINDLESS_MATERIAL_DESCRIPTOR_LAYOUT(2)
+#else
 MATERIAL_DESCRIPTOR_LAYOUT(2)
+#endif
 
 //
 // NOTE: Grid Frustum Shader
 //
 
+frustum TileFrustumCreate(vec2 PixelMin, vec2 PixelMax)
+{
+    // NOTE: Compute four corner points of tile
+    vec3 CameraPos = vec3(0);
+    vec4 BotLeft = vec4(PixelMin.x, PixelMin.y, 0, 1);
+    vec4 BotRight = vec4(PixelMax.x, PixelMin.y, 0, 1);
+    vec4 TopLeft = vec4(PixelMin.x, PixelMax.y, 0, 1);
+    vec4 TopRight = vec4(PixelMax.x, PixelMax.y, 0, 1);
+     
+    // NOTE: Transform corner points to far plane in view space (we assume a counter clock wise winding order)
+    BotLeft = ScreenToView(InverseProjection, ScreenSize, BotLeft);
+    BotRight = ScreenToView(InverseProjection, ScreenSize, BotRight);
+    TopLeft = ScreenToView(InverseProjection, ScreenSize, TopLeft);
+    TopRight = ScreenToView(InverseProjection, ScreenSize, TopRight);
+   
+    // NOTE: Build the frustum planes
+    frustum Result;
+    Result.Planes[0] = PlaneCreate(CameraPos, BotLeft.xyz, TopLeft.xyz);
+    Result.Planes[1] = PlaneCreate(CameraPos, TopRight.xyz, BotRight.xyz);
+    Result.Planes[2] = PlaneCreate(CameraPos, TopLeft.xyz, TopRight.xyz);
+    Result.Planes[3] = PlaneCreate(CameraPos, BotRight.xyz, BotLeft.xyz);
+
+    return Result;
+}
+
 #if GRID_FRUSTUM
 
-layout(local_size_x = TILE_DIM_IN_PIXELS, local_size_y = TILE_DIM_IN_PIXELS, local_size_z = 1) in;
+// NOTE: One thread per tile
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
 
 void main()
 {
     uvec2 GridPos = uvec2(gl_GlobalInvocationID.xy);
     if (GridPos.x < GridSize.x && GridPos.y < GridSize.y)
     {
-        // NOTE: Compute four corner points of tile
-        vec3 CameraPos = vec3(0);
-        vec4 BotLeft = vec4((GridPos + vec2(0, 0)) * vec2(TILE_DIM_IN_PIXELS), 0, 1);
-        vec4 BotRight = vec4((GridPos + vec2(1, 0)) * vec2(TILE_DIM_IN_PIXELS), 0, 1);
-        vec4 TopLeft = vec4((GridPos + vec2(0, 1)) * vec2(TILE_DIM_IN_PIXELS), 0, 1);
-        vec4 TopRight = vec4((GridPos + vec2(1, 1)) * vec2(TILE_DIM_IN_PIXELS), 0, 1);
-     
-        // NOTE: Transform corner points to far plane in view space (we assume a counter clock wise winding order)
-        BotLeft = ScreenToView(InverseProjection, ScreenSize, BotLeft);
-        BotRight = ScreenToView(InverseProjection, ScreenSize, BotRight);
-        TopLeft = ScreenToView(InverseProjection, ScreenSize, TopLeft);
-        TopRight = ScreenToView(InverseProjection, ScreenSize, TopRight);
-   
-        // NOTE: Build the frustum planes and store
-        frustum Frustum;
-        Frustum.Planes[0] = PlaneCreate(CameraPos, BotLeft.xyz, TopLeft.xyz);
-        Frustum.Planes[1] = PlaneCreate(CameraPos, TopRight.xyz, BotRight.xyz);
-        Frustum.Planes[2] = PlaneCreate(CameraPos, TopLeft.xyz, TopRight.xyz);
-        Frustum.Planes[3] = PlaneCreate(CameraPos, BotRight.xyz, BotLeft.xyz);
-        
         // NOTE: Write out to buffer
         uint WriteIndex = GridPos.y * GridSize.x + GridPos.x;
-        GridFrustums[WriteIndex] = Frustum;
+        GridFrustums[WriteIndex] = TileFrustumCreate(vec2(GridPos * TileSize), vec2((GridPos + uvec2(1)) * TileSize));
+    }
+}
+
+#endif
+
+//
+// NOTE: Light Heat Map
+//
+
+#if TILED_DEFERRED_LIGHTING_FRAG || LIGHTING_FUSED
+
+vec3 LightHeatMapColor(uint NumLights)
+{
+    // NOTE: Log scale so that both sparse and overflowing tiles are readable. Black = 0, blue -> green -> red = MaxLightsPerTile,
+    // white = overflowed shared memory
+    if (NumLights == 0)
+    {
+        return vec3(0);
+    }
+    if (NumLights > MaxLightsPerTile)
+    {
+        return vec3(1);
+    }
+
+    float T = log2(float(NumLights)) / log2(float(MaxLightsPerTile));
+    vec3 Result = T < 0.5 ? mix(vec3(0, 0, 1), vec3(0, 1, 0), 2.0*T) : mix(vec3(0, 1, 0), vec3(1, 0, 0), 2.0*T - 1.0);
+    return Result;
+}
+
+#endif
+
+//
+// NOTE: Light vs. Tile Tests
+//
+
+#if LIGHT_CULLING || LIGHTING_FUSED || LIGHT_CULLING_BIT_MASK || LIGHT_CULLING_COARSE
+
+struct tile_bounds
+{
+    frustum Frustum;
+    float NearClipZ;
+    float NearZ; // NOTE: View depth of the nearest surface in the tile
+    float FarZ; // NOTE: View depth of the farthest surface in the tile
+
+    // NOTE: Transparent boxes start at the near clip plane, opaque ones only cover the depth bounds of the tile
+    vec3 AabbMin_T;
+    vec3 AabbMax_T;
+    vec3 AabbMin_O;
+    vec3 AabbMax_O;
+
+    vec3 ConeAxis;
+    float ConeCos;
+    float ConeSin;
+};
+
+tile_bounds TileBoundsCreate(vec2 PixelMin, vec2 PixelMax, frustum Frustum, float NearClipZ, float NearZ, float FarZ)
+{
+    tile_bounds Result;
+    Result.Frustum = Frustum;
+    Result.NearClipZ = NearClipZ;
+    Result.NearZ = NearZ;
+    Result.FarZ = FarZ;
+
+    // NOTE: View rays through the tile corners, scaled so that their z is 1. Edge tiles get clamped to the screen
+    PixelMax = min(PixelMax, ScreenSize);
+    vec3 Rays[4];
+    Rays[0] = ScreenToView(InverseProjection, ScreenSize, vec4(PixelMin.x, PixelMin.y, 1, 1)).xyz;
+    Rays[1] = ScreenToView(InverseProjection, ScreenSize, vec4(PixelMax.x, PixelMin.y, 1, 1)).xyz;
+    Rays[2] = ScreenToView(InverseProjection, ScreenSize, vec4(PixelMin.x, PixelMax.y, 1, 1)).xyz;
+    Rays[3] = ScreenToView(InverseProjection, ScreenSize, vec4(PixelMax.x, PixelMax.y, 1, 1)).xyz;
+
+    // NOTE: Every axis of a point along a ray is linear in its depth, so the corners at both ends of the depth range bound the box
+    Result.AabbMin_T = vec3(1e30f);
+    Result.AabbMax_T = vec3(-1e30f);
+    Result.AabbMin_O = vec3(1e30f);
+    Result.AabbMax_O = vec3(-1e30f);
+    Result.ConeAxis = vec3(0);
+    for (uint CornerId = 0; CornerId < 4; ++CornerId)
+    {
+        vec3 Ray = Rays[CornerId] / Rays[CornerId].z;
+        Result.AabbMin_T = min(Result.AabbMin_T, min(Ray * NearClipZ, Ray * FarZ));
+        Result.AabbMax_T = max(Result.AabbMax_T, max(Ray * NearClipZ, Ray * FarZ));
+        Result.AabbMin_O = min(Result.AabbMin_O, min(Ray * NearZ, Ray * FarZ));
+        Result.AabbMax_O = max(Result.AabbMax_O, max(Ray * NearZ, Ray * FarZ));
+
+        Rays[CornerId] = normalize(Ray);
+        Result.ConeAxis += Rays[CornerId];
+    }
+
+    // NOTE: Cone around the corner rays, its angle is the widest corner away from the axis
+    Result.ConeAxis = normalize(Result.ConeAxis);
+    Result.ConeCos = 1.0f;
+    for (uint CornerId = 0; CornerId < 4; ++CornerId)
+    {
+        Result.ConeCos = min(Result.ConeCos, dot(Result.ConeAxis, Rays[CornerId]));
+    }
+    Result.ConeSin = sqrt(max(1.0f - Result.ConeCos * Result.ConeCos, 0.0f));
+    
+    return Result;
+}
+
+// NOTE: Transparent lists keep every light between the near clip plane and the farthest surface of the tile
+bool TileLightTestTransparent(tile_bounds Tile, vec3 SphereCenter, float SphereRadius)
+{
+    bool Result = false;
+    if (LightTestMode == LIGHT_TEST_MODE_FRUSTUM)
+    {
+        Result = SphereInsideFrustum(SphereCenter, SphereRadius, Tile.Frustum, Tile.NearClipZ, Tile.FarZ);
+    }
+    else
+    {
+        Result = SphereInsideAabb(SphereCenter, SphereRadius, Tile.AabbMin_T, Tile.AabbMax_T);
+        if (Result && LightTestMode == LIGHT_TEST_MODE_AABB_CONE)
+        {
+            Result = SphereInsideCone(SphereCenter, SphereRadius, Tile.ConeAxis, Tile.ConeCos, Tile.ConeSin);
+        }
+    }
+
+    return Result;
+}
+
+// IMPORTANT: Only valid for lights that passed TileLightTestTransparent, the opaque depth range is a part of the transparent one and the
+// cone doesn't depend on depth
+bool TileLightTestOpaque(tile_bounds Tile, vec3 SphereCenter, float SphereRadius)
+{
+    bool Result = false;
+    if (LightTestMode == LIGHT_TEST_MODE_FRUSTUM)
+    {
+        plane MinPlane = { vec3(0, 0, 1), Tile.NearZ };
+        Result = !SphereInsidePlane(SphereCenter, SphereRadius, MinPlane);
+    }
+    else
+    {
+        Result = SphereInsideAabb(SphereCenter, SphereRadius, Tile.AabbMin_O, Tile.AabbMax_O);
+    }
+
+    return Result;
+}
+
+#endif
+
+//
+// NOTE: Coarse Light Culling Shader
+//
+
+#if LIGHT_CULLING_COARSE
+
+/*
+
+  NOTE: First level of the hierarchical culling. One workgroup per super tile culls every light group and light with the transparent
+        test, so the list holds every light any fine tile inside could keep, opaque or transparent. Each thread reduces the depth of a
+        2x2 pixel block.
+  
+ */
+
+#define COARSE_GROUP_DIM (TILED_COARSE_TILE_SIZE / 2)
+
+shared uint SharedMinDepth;
+shared uint SharedMaxDepth;
+shared uint SharedNumLights;
+shared uint SharedNumGroups;
+shared uint SharedGroupIds[COARSE_GROUP_DIM * COARSE_GROUP_DIM];
+
+layout(local_size_x = COARSE_GROUP_DIM, local_size_y = COARSE_GROUP_DIM, local_size_z = 1) in;
+
+void main()
+{
+    uint NumThreadsPerGroup = COARSE_GROUP_DIM * COARSE_GROUP_DIM;
+    uvec2 CoarseTilePos = uvec2(gl_WorkGroupID.xy);
+    uint CoarseTileId = CoarseTilePos.y * CoarseGridSizeX + CoarseTilePos.x;
+
+    if (gl_LocalInvocationIndex == 0)
+    {
+        SharedMinDepth = 0xFFFFFFFF;
+        SharedMaxDepth = 0;
+        SharedNumLights = 0;
+    }
+
+    barrier();
+
+    for (uint SampleId = 0; SampleId < 4; ++SampleId)
+    {
+        uvec2 PixelPos = CoarseTilePos * TILED_COARSE_TILE_SIZE + 2 * uvec2(gl_LocalInvocationID.xy) + uvec2(SampleId & 1, SampleId >> 1);
+        if (PixelPos.x < ScreenSize.x && PixelPos.y < ScreenSize.y)
+        {
+            uint PixelDepth = floatBitsToUint(texelFetch(GBufferDepthTexture, ivec2(PixelPos), 0).x);
+            atomicMin(SharedMinDepth, PixelDepth);
+            atomicMax(SharedMaxDepth, PixelDepth);
+        }
+    }
+
+    barrier();
+
+    // NOTE: Reversed z, the largest depth is the nearest surface
+    float MinDepth = ClipToView(InverseProjection, vec4(0, 0, uintBitsToFloat(SharedMinDepth), 1)).z;
+    float MaxDepth = ClipToView(InverseProjection, vec4(0, 0, uintBitsToFloat(SharedMaxDepth), 1)).z;
+    float NearClipDepth = ClipToView(InverseProjection, vec4(0, 0, 1, 1)).z;
+    vec2 PixelMin = vec2(CoarseTilePos * TILED_COARSE_TILE_SIZE);
+    vec2 PixelMax = vec2((CoarseTilePos + uvec2(1)) * TILED_COARSE_TILE_SIZE);
+    tile_bounds Tile = TileBoundsCreate(PixelMin, PixelMax, TileFrustumCreate(PixelMin, PixelMax), NearClipDepth, MaxDepth, MinDepth);
+
+    uint StartId = CoarseTileId * TILED_COARSE_MAX_LIGHTS_PER_TILE;
+    uint NumLightGroups = (SceneBuffer.NumPointLights + LIGHT_GROUP_SIZE - 1) / LIGHT_GROUP_SIZE;
+    for (uint GroupBatchId = 0; GroupBatchId < NumLightGroups; GroupBatchId += NumThreadsPerGroup)
+    {
+        if (gl_LocalInvocationIndex == 0)
+        {
+            SharedNumGroups = 0;
+        }
+
+        barrier();
+
+        uint GroupId = GroupBatchId + gl_LocalInvocationIndex;
+        if (GroupId < NumLightGroups)
+        {
+            vec4 GroupBounds = PointLightGroupBounds[GroupId];
+            if (TileLightTestTransparent(Tile, GroupBounds.xyz, GroupBounds.w))
+            {
+                SharedGroupIds[atomicAdd(SharedNumGroups, 1)] = GroupId;
+            }
+        }
+
+        barrier();
+
+        for (uint GroupIndex = 0; GroupIndex < SharedNumGroups; ++GroupIndex)
+        {
+            uint StartLightId = SharedGroupIds[GroupIndex] * LIGHT_GROUP_SIZE;
+            uint EndLightId = min(StartLightId + LIGHT_GROUP_SIZE, SceneBuffer.NumPointLights);
+            for (uint LightId = StartLightId + gl_LocalInvocationIndex; LightId < EndLightId; LightId += NumThreadsPerGroup)
+            {
+                point_light Light = PointLights[LightId];
+                if (TileLightTestTransparent(Tile, Light.Pos, Light.MaxDistance))
+                {
+                    // NOTE: Past the end we only keep counting, the fine tiles fall back to every light group
+                    uint WriteId = atomicAdd(SharedNumLights, 1);
+                    if (WriteId < TILED_COARSE_MAX_LIGHTS_PER_TILE)
+                    {
+                        CoarseLightIndexList[StartId + WriteId] = LightId;
+                    }
+                }
+            }
+        }
+
+        barrier();
+    }
+
+    if (gl_LocalInvocationIndex == 0)
+    {
+        CoarseLightCounts[CoarseTileId] = SharedNumLights;
     }
 }
 
@@ -59,74 +318,214 @@ void main()
 // NOTE: Light Culling Shader
 //
 
-#if LIGHT_CULLING
+/*
+
+  NOTE: LIGHTING_FUSED builds the same shader, but instead of writing every tiles list out for a separate lighting pass, each workgroup
+        shades its own pixels straight from the shared list and writes the result to a storage image. Only tiles that overflow shared
+        memory still go through the global index list. The deferred renderer has no transparent geometry so the fused version skips the
+        transparent list.
+  
+ */
+
+#if LIGHT_CULLING || LIGHTING_FUSED
+
+// NOTE: Tile size and the shared light list size are specialization constants so the host can pick them at pipeline creation
+layout(constant_id = 0) const uint TILE_DIM_IN_PIXELS = 8;
+layout(constant_id = 1) const uint MAX_LIGHTS_PER_TILE = 1024;
+
+/*
+
+  NOTE: Culling is coarse to fine. Lights are sorted spatially on the CPU and split into groups of LIGHT_GROUP_SIZE with a bounding
+        sphere per group. Each thread first tests one group, and only lights of the groups that survive get tested individually.
+
+        Light ids get gathered in shared memory. If a tile ends up with more than MAX_LIGHTS_PER_TILE lights, we don't drop the extra
+        ones. Instead we reserve the exact count in the global list and replay the culling, writing the ids straight to global memory.
+        This is slow but only happens for the few tiles that overflow.
+  
+ */
 
 shared frustum SharedFrustum;
 shared uint SharedMinDepth;
 shared uint SharedMaxDepth;
+shared bool SharedReplay;
+
+// NOTE: Light groups that passed the coarse test in the current batch
+shared uint SharedNumGroups;
+shared uint SharedGroupIds[TILE_DIM_IN_PIXELS * TILE_DIM_IN_PIXELS];
 
 // NOTE: Opaque
 shared uint SharedGlobalLightId_O;
 shared uint SharedCurrLightId_O;
-shared uint SharedLightIds_O[1024];
+shared uint SharedReplayLightId_O;
+shared uint SharedLightIds_O[MAX_LIGHTS_PER_TILE];
 
+#if !LIGHTING_FUSED
 // NOTE: Transparent
 shared uint SharedGlobalLightId_T;
 shared uint SharedCurrLightId_T;
-shared uint SharedLightIds_T[1024];
+shared uint SharedReplayLightId_T;
+shared uint SharedLightIds_T[MAX_LIGHTS_PER_TILE];
+#endif
 
 void LightAppendOpaque(uint LightId)
 {
-    uint WriteArrayId = atomicAdd(SharedCurrLightId_O, 1);
-    if (WriteArrayId < 1024)
+    if (!SharedReplay)
     {
-        SharedLightIds_O[WriteArrayId] = LightId;
+        uint WriteArrayId = atomicAdd(SharedCurrLightId_O, 1);
+        if (WriteArrayId < MAX_LIGHTS_PER_TILE)
+        {
+            SharedLightIds_O[WriteArrayId] = LightId;
+        }
+    }
+    else if (SharedCurrLightId_O > MAX_LIGHTS_PER_TILE)
+    {
+        uint WriteArrayId = atomicAdd(SharedReplayLightId_O, 1);
+        if (WriteArrayId < SharedCurrLightId_O)
+        {
+            LightIndexList_O[SharedGlobalLightId_O + WriteArrayId] = LightId;
+        }
     }
 }
 
+#if !LIGHTING_FUSED
 void LightAppendTransparent(uint LightId)
 {
-    uint WriteArrayId = atomicAdd(SharedCurrLightId_T, 1);
-    if (WriteArrayId < 1024)
+    if (!SharedReplay)
     {
-        SharedLightIds_T[WriteArrayId] = LightId;
+        uint WriteArrayId = atomicAdd(SharedCurrLightId_T, 1);
+        if (WriteArrayId < MAX_LIGHTS_PER_TILE)
+        {
+            SharedLightIds_T[WriteArrayId] = LightId;
+        }
+    }
+    else if (SharedCurrLightId_T > MAX_LIGHTS_PER_TILE)
+    {
+        uint WriteArrayId = atomicAdd(SharedReplayLightId_T, 1);
+        if (WriteArrayId < SharedCurrLightId_T)
+        {
+            LightIndexList_T[SharedGlobalLightId_T + WriteArrayId] = LightId;
+        }
     }
 }
+#endif
 
-layout(local_size_x = TILE_DIM_IN_PIXELS, local_size_y = TILE_DIM_IN_PIXELS, local_size_z = 1) in;
+void LightCullTest(tile_bounds Tile, uint LightId)
+{
+    point_light Light = PointLights[LightId];
+    if (TileLightTestTransparent(Tile, Light.Pos, Light.MaxDistance))
+    {
+#if !LIGHTING_FUSED
+        LightAppendTransparent(LightId);
+#endif
+                    
+        if (TileLightTestOpaque(Tile, Light.Pos, Light.MaxDistance))
+        {
+            LightAppendOpaque(LightId);
+        }
+    }
+}
 
-void main()
-{    
+void LightsCull(tile_bounds Tile)
+{
     uint NumThreadsPerGroup = TILE_DIM_IN_PIXELS * TILE_DIM_IN_PIXELS;
 
-    // NOTE: Skip threads that go past the screen
-    if (!(gl_GlobalInvocationID.x < ScreenSize.x && gl_GlobalInvocationID.y < ScreenSize.y))
+    // NOTE: With coarse culling we only walk the list of our super tile, unless it overflowed (see tiled_deferred.h)
+    if (CoarseCulling != 0)
     {
-        return;
+        uvec2 CoarseTilePos = (uvec2(gl_WorkGroupID.xy) * TILE_DIM_IN_PIXELS) / TILED_COARSE_TILE_SIZE;
+        uint CoarseTileId = CoarseTilePos.y * CoarseGridSizeX + CoarseTilePos.x;
+        uint NumCoarseLights = CoarseLightCounts[CoarseTileId];
+        if (NumCoarseLights <= TILED_COARSE_MAX_LIGHTS_PER_TILE)
+        {
+            uint StartId = CoarseTileId * TILED_COARSE_MAX_LIGHTS_PER_TILE;
+            for (uint CoarseLightId = gl_LocalInvocationIndex; CoarseLightId < NumCoarseLights; CoarseLightId += NumThreadsPerGroup)
+            {
+                LightCullTest(Tile, CoarseLightIndexList[StartId + CoarseLightId]);
+            }
+
+            barrier();
+            return;
+        }
     }
     
+    uint NumLightGroups = (SceneBuffer.NumPointLights + LIGHT_GROUP_SIZE - 1) / LIGHT_GROUP_SIZE;
+    
+    for (uint GroupBatchId = 0; GroupBatchId < NumLightGroups; GroupBatchId += NumThreadsPerGroup)
+    {
+        if (gl_LocalInvocationIndex == 0)
+        {
+            SharedNumGroups = 0;
+        }
+
+        barrier();
+        
+        // NOTE: Coarse test, each thread tests the bounds of one light group
+        uint GroupId = GroupBatchId + gl_LocalInvocationIndex;
+        if (GroupId < NumLightGroups)
+        {
+            vec4 GroupBounds = PointLightGroupBounds[GroupId];
+            if (TileLightTestTransparent(Tile, GroupBounds.xyz, GroupBounds.w))
+            {
+                SharedGroupIds[atomicAdd(SharedNumGroups, 1)] = GroupId;
+            }
+        }
+
+        barrier();
+
+        // NOTE: Fine test, each thread tests one light of a surviving group at a time
+        for (uint GroupIndex = 0; GroupIndex < SharedNumGroups; ++GroupIndex)
+        {
+            uint StartLightId = SharedGroupIds[GroupIndex] * LIGHT_GROUP_SIZE;
+            uint EndLightId = min(StartLightId + LIGHT_GROUP_SIZE, SceneBuffer.NumPointLights);
+            for (uint LightId = StartLightId + gl_LocalInvocationIndex; LightId < EndLightId; LightId += NumThreadsPerGroup)
+            {
+                LightCullTest(Tile, LightId);
+            }
+        }
+
+        barrier();
+    }
+}
+
+layout(local_size_x_id = 0, local_size_y_id = 0, local_size_z = 1) in;
+
+void main()
+{    
+    uint NumThreadsPerGroup = TILE_DIM_IN_PIXELS * TILE_DIM_IN_PIXELS;
+
+    // IMPORTANT: Threads that go past the screen can't early out since every thread takes part in the culling and the barriers
+    bool ValidPixel = gl_GlobalInvocationID.x < ScreenSize.x && gl_GlobalInvocationID.y < ScreenSize.y;
+    
     // NOTE: Setup shared variables
     if (gl_LocalInvocationIndex == 0)
     {
         SharedFrustum = GridFrustums[uint(gl_WorkGroupID.y) * GridSize.x + uint(gl_WorkGroupID.x)];
         SharedMinDepth = 0xFFFFFFFF;
         SharedMaxDepth = 0;
+        SharedReplay = false;
         SharedCurrLightId_O = 0;
+        SharedReplayLightId_O = 0;
+#if !LIGHTING_FUSED
         SharedCurrLightId_T = 0;
+        SharedReplayLightId_T = 0;
+#endif
     }
 
     barrier();
     
     // NOTE: Calculate min/max depth in grid tile (since our depth values are between 0 and 1, we can reinterpret them as ints and
     // comparison will still work correctly)
-    ivec2 ReadPixelId = ivec2(gl_GlobalInvocationID.xy);
-    uint PixelDepth = floatBitsToInt(texelFetch(GBufferDepthTexture, ReadPixelId, 0).x);
-    atomicMin(SharedMinDepth, PixelDepth);
-    atomicMax(SharedMaxDepth, PixelDepth);
+    if (ValidPixel)
+    {
+        ivec2 ReadPixelId = ivec2(gl_GlobalInvocationID.xy);
+        uint PixelDepth = floatBitsToInt(texelFetch(GBufferDepthTexture, ReadPixelId, 0).x);
+        atomicMin(SharedMinDepth, PixelDepth);
+        atomicMax(SharedMaxDepth, PixelDepth);
+    }
 
     barrier();
 
-    // NOTE: Convert depth bounds to frustum planes in view space
+    // NOTE: Convert depth bounds to view space
     float MinDepth = uintBitsToFloat(SharedMinDepth);
     float MaxDepth = uintBitsToFloat(SharedMaxDepth);
 
@@ -134,25 +533,78 @@ void main()
     MaxDepth = ClipToView(InverseProjection, vec4(0, 0, MaxDepth, 1)).z;
 
     float NearClipDepth = ClipToView(InverseProjection, vec4(0, 0, 1, 1)).z;
-    plane MinPlane = { vec3(0, 0, 1), MaxDepth };
+
+    // NOTE: Reversed z, the largest depth is the nearest surface
+    uvec2 TilePos = uvec2(gl_WorkGroupID.xy);
+    tile_bounds Tile = TileBoundsCreate(vec2(TilePos * TILE_DIM_IN_PIXELS), vec2((TilePos + uvec2(1)) * TILE_DIM_IN_PIXELS), SharedFrustum,
+                                        NearClipDepth, MaxDepth, MinDepth);
     
-    // NOTE: Cull lights against tiles frustum (each thread culls one light at a time)
-    for (uint LightId = gl_LocalInvocationIndex; LightId < SceneBuffer.NumPointLights; LightId += NumThreadsPerGroup)
+    // NOTE: Cull lights against the tile
+    LightsCull(Tile);
+
+#if LIGHTING_FUSED
+    // NOTE: Only overflowing tiles need space in the global list
+    if (gl_LocalInvocationIndex == 0)
     {
-        point_light Light = PointLights[LightId];
-        if (SphereInsideFrustum(Light.Pos, Light.MaxDistance, SharedFrustum, NearClipDepth, MinDepth))
+        if (SharedCurrLightId_O > MAX_LIGHTS_PER_TILE)
         {
-            LightAppendTransparent(LightId);
-
-            if (!SphereInsidePlane(Light.Pos, Light.MaxDistance, MinPlane))
-            {
-                LightAppendOpaque(LightId);
-            }
+            SharedGlobalLightId_O = atomicAdd(LightIndexCounter_O, SharedCurrLightId_O);
+            SharedCurrLightId_O = min(SharedCurrLightId_O, LightIndexListCapacity - min(SharedGlobalLightId_O, LightIndexListCapacity));
         }
+
+        SharedReplay = SharedCurrLightId_O > MAX_LIGHTS_PER_TILE;
     }
 
     barrier();
 
+    if (SharedReplay)
+    {
+        LightsCull(Tile);
+        memoryBarrierBuffer();
+        barrier();
+    }
+
+    // NOTE: Shade our pixel from the tiles list
+    if (ValidPixel)
+    {
+        ivec2 PixelPos = ivec2(gl_GlobalInvocationID.xy);
+    
+        vec3 SurfacePos = (SceneBuffer.VTransform * vec4(texelFetch(GBufferPositionTexture, PixelPos, 0).xyz, 1)).xyz;
+        vec3 SurfaceNormal = (SceneBuffer.VTransform * vec4(texelFetch(GBufferNormalTexture, PixelPos, 0).xyz, 0)).xyz;
+        vec3 SurfaceColor = texelFetch(GBufferColorTexture, PixelPos, 0).rgb;
+        float Ao = texelFetch(SsaoTexture, PixelPos, 0).x;
+        vec3 View = normalize(-SurfacePos);
+
+        vec3 Color = vec3(0);
+        bool Shared = SharedCurrLightId_O <= MAX_LIGHTS_PER_TILE;
+        for (uint i = 0; i < SharedCurrLightId_O; ++i)
+        {
+            uint LightId = Shared ? SharedLightIds_O[i] : LightIndexList_O[SharedGlobalLightId_O + i];
+            point_light CurrLight = PointLights[LightId];
+            vec3 LightDir = normalize(SurfacePos - CurrLight.Pos);
+            Color += BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, PointLightAttenuate(SurfacePos, CurrLight));
+        }
+
+        // NOTE: Calculate lighting for directional lights
+        {
+            vec3 LightDir = (SceneBuffer.VTransform * vec4(DirectionalLight.Dir, 0)).xyz;
+            Color += BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, DirectionalLight.Color);
+            Color += Ao * DirectionalLight.AmbientLight * SurfaceColor;
+        }
+
+        vec4 OutColor = vec4(Color, 1);
+        if (DebugViewMode == DEBUG_VIEW_AO)
+        {
+            OutColor = vec4(vec3(Ao), 1);
+        }
+        else if (DebugViewMode == DEBUG_VIEW_LIGHT_HEAT_MAP_OPAQUE)
+        {
+            OutColor = vec4(mix(Color, LightHeatMapColor(SharedCurrLightId_O), 0.75), 1);
+        }
+        
+        imageStore(FusedOutColor, PixelPos, OutColor);
+    }
+#else
     // NOTE: Get space and light index lists
     if (gl_LocalInvocationIndex == 0)
     {
@@ -162,27 +614,126 @@ void main()
         if (SharedCurrLightId_O != 0)
         {
             SharedGlobalLightId_O = atomicAdd(LightIndexCounter_O, SharedCurrLightId_O);
+            // NOTE: Clamp to the space left in the global list so we never write out of bounds
+            SharedCurrLightId_O = min(SharedCurrLightId_O, LightIndexListCapacity - min(SharedGlobalLightId_O, LightIndexListCapacity));
             imageStore(LightGrid_O, WritePixelId, ivec4(SharedGlobalLightId_O, SharedCurrLightId_O, 0, 0));
         }
         if (SharedCurrLightId_T != 0)
         {
             SharedGlobalLightId_T = atomicAdd(LightIndexCounter_T, SharedCurrLightId_T);
+            SharedCurrLightId_T = min(SharedCurrLightId_T, LightIndexListCapacity - min(SharedGlobalLightId_T, LightIndexListCapacity));
             imageStore(LightGrid_T, WritePixelId, ivec4(SharedGlobalLightId_T, SharedCurrLightId_T, 0, 0));
         }
+
+        SharedReplay = SharedCurrLightId_O > MAX_LIGHTS_PER_TILE || SharedCurrLightId_T > MAX_LIGHTS_PER_TILE;
     }
 
     barrier();
 
+    // NOTE: Overflowing tiles rerun the culling and write their ids directly to the global lists
+    if (SharedReplay)
+    {
+        LightsCull(Tile);
+    }
+    
     // NOTE: Write opaque
-    for (uint LightId = gl_LocalInvocationIndex; LightId < SharedCurrLightId_O; LightId += NumThreadsPerGroup)
+    if (SharedCurrLightId_O <= MAX_LIGHTS_PER_TILE)
     {
-        LightIndexList_O[SharedGlobalLightId_O + LightId] = SharedLightIds_O[LightId];
+        for (uint LightId = gl_LocalInvocationIndex; LightId < SharedCurrLightId_O; LightId += NumThreadsPerGroup)
+        {
+            LightIndexList_O[SharedGlobalLightId_O + LightId] = SharedLightIds_O[LightId];
+        }
     }
 
     // NOTE: Write transparent
-    for (uint LightId = gl_LocalInvocationIndex; LightId < SharedCurrLightId_T; LightId += NumThreadsPerGroup)
+    if (SharedCurrLightId_T <= MAX_LIGHTS_PER_TILE)
     {
-        LightIndexList_T[SharedGlobalLightId_T + LightId] = SharedLightIds_T[LightId];
+        for (uint LightId = gl_LocalInvocationIndex; LightId < SharedCurrLightId_T; LightId += NumThreadsPerGroup)
+        {
+            LightIndexList_T[SharedGlobalLightId_T + LightId] = SharedLightIds_T[LightId];
+        }
+    }
+#endif
+}
+
+#endif
+
+//
+// NOTE: Light Culling Bit Mask Shader
+//
+
+#if LIGHT_CULLING_BIT_MASK
+
+layout(constant_id = 0) const uint TILE_DIM_IN_PIXELS = 8;
+
+/*
+
+  NOTE: Each thread owns whole words of the tile masks and tests the 32 lights behind a word itself, so building the masks needs no
+        atomics and every word gets written exactly once. Only the first TILED_BIT_MASK_MAX_LIGHTS lights fit, the host falls back to
+        the index list when there are more.
+  
+ */
+
+shared uint SharedMinDepth;
+shared uint SharedMaxDepth;
+
+layout(local_size_x_id = 0, local_size_y_id = 0, local_size_z = 1) in;
+
+void main()
+{
+    uint NumThreadsPerGroup = TILE_DIM_IN_PIXELS * TILE_DIM_IN_PIXELS;
+    uint TileId = uint(gl_WorkGroupID.y) * GridSize.x + uint(gl_WorkGroupID.x);
+    bool ValidPixel = gl_GlobalInvocationID.x < ScreenSize.x && gl_GlobalInvocationID.y < ScreenSize.y;
+
+    if (gl_LocalInvocationIndex == 0)
+    {
+        SharedMinDepth = 0xFFFFFFFF;
+        SharedMaxDepth = 0;
+    }
+
+    barrier();
+
+    // NOTE: Same min/max depth as the index list culling
+    if (ValidPixel)
+    {
+        uint PixelDepth = floatBitsToUint(texelFetch(GBufferDepthTexture, ivec2(gl_GlobalInvocationID.xy), 0).x);
+        atomicMin(SharedMinDepth, PixelDepth);
+        atomicMax(SharedMaxDepth, PixelDepth);
+    }
+
+    barrier();
+
+    float MinDepth = ClipToView(InverseProjection, vec4(0, 0, uintBitsToFloat(SharedMinDepth), 1)).z;
+    float MaxDepth = ClipToView(InverseProjection, vec4(0, 0, uintBitsToFloat(SharedMaxDepth), 1)).z;
+    float NearClipDepth = ClipToView(InverseProjection, vec4(0, 0, 1, 1)).z;
+    uvec2 TilePos = uvec2(gl_WorkGroupID.xy);
+    tile_bounds Tile = TileBoundsCreate(vec2(TilePos * TILE_DIM_IN_PIXELS), vec2((TilePos + uvec2(1)) * TILE_DIM_IN_PIXELS), GridFrustums[TileId],
+                                        NearClipDepth, MaxDepth, MinDepth);
+    
+    uint NumLights = min(SceneBuffer.NumPointLights, TILED_BIT_MASK_MAX_LIGHTS);
+    uint NumWords = (NumLights + 31) / 32;
+    for (uint WordId = gl_LocalInvocationIndex; WordId < NumWords; WordId += NumThreadsPerGroup)
+    {
+        uint Bits_O = 0;
+        uint Bits_T = 0;
+        uint StartLightId = WordId * 32;
+        uint EndLightId = min(StartLightId + 32, NumLights);
+        for (uint LightId = StartLightId; LightId < EndLightId; ++LightId)
+        {
+            point_light Light = PointLights[LightId];
+            if (TileLightTestTransparent(Tile, Light.Pos, Light.MaxDistance))
+            {
+                uint Bit = 1u << (LightId - StartLightId);
+                Bits_T |= Bit;
+                if (TileLightTestOpaque(Tile, Light.Pos, Light.MaxDistance))
+                {
+                    Bits_O |= Bit;
+                }
+            }
+        }
+
+        LightBitMask_O[TileId * TILED_BIT_MASK_WORDS_PER_TILE + WordId] = Bits_O;
+        LightBitMask_T[TileId * TILED_BIT_MASK_WORDS_PER_TILE + WordId] = Bits_T;
     }
 }
 
@@ -194,22 +745,60 @@ void main()
 
 #if GBUFFER_VERT
 
+#if QUANTIZED_VERTICES
+layout(location = 0) in vec4 InQuantizedPos;
+layout(location = 1) in vec2 InOctahedralNormal;
+layout(location = 2) in vec2 InUv;
+
+vec3 OctahedralDecode(vec2 Encoded)
+{
+    vec3 Result = vec3(Encoded, 1.0 - abs(Encoded.x) - abs(Encoded.y));
+    float T = max(-Result.z, 0.0);
+    Result.x += Result.x >= 0.0 ? -T : T;
+    Result.y += Result.y >= 0.0 ? -T : T;
+    return normalize(Result);
+}
+#else
 layout(location = 0) in vec3 InPos;
 layout(location = 1) in vec3 InNormal;
 layout(location = 2) in vec2 InUv;
+#endif
 
 layout(location = 0) out vec3 OutWorldPos;
 layout(location = 1) out vec3 OutWorldNormal;
 layout(location = 2) out vec2 OutUv;
+#if BINDLESS_MATERIALS
+layout(location = 3) flat out uint OutMaterialId;
+#endif
+
+#if OCCLUSION_CULLED
+// NOTE: Bound at the start of the region of our batch, see occlusion_cull.h
+layout(set = 3, binding = 0) buffer visible_ids
+{
+    uint VisibleIds[];
+};
+#endif
 
 void main()
 {
+#if OCCLUSION_CULLED
+    instance_entry Entry = InstanceBuffer[VisibleIds[gl_InstanceIndex]];
+#else
     instance_entry Entry = InstanceBuffer[gl_InstanceIndex];
+#endif
+#if QUANTIZED_VERTICES
+    // NOTE: Positions are unorm inside the mesh bounds
+    vec3 InPos = InQuantizedPos.xyz * Entry.PosScale + Entry.PosBias;
+    vec3 InNormal = OctahedralDecode(InOctahedralNormal);
+#endif
     
     gl_Position = Entry.WVPTransform * vec4(InPos, 1);
     OutWorldPos = (Entry.WTransform * vec4(InPos, 1)).xyz;
     OutWorldNormal = (Entry.WTransform * vec4(InNormal, 0)).xyz;
     OutUv = InUv;
+#if BINDLESS_MATERIALS
+    OutMaterialId = Entry.MaterialId;
+#endif
 }
 
 #endif
@@ -223,6 +812,9 @@ void main()
 layout(location = 0) in vec3 InWorldPos;
 layout(location = 1) in vec3 InWorldNormal;
 layout(location = 2) in vec2 InUv;
+#if BINDLESS_MATERIALS
+layout(location = 3) flat in uint InMaterialId;
+#endif
 
 layout(location = 0) out vec4 OutWorldPos;
 layout(location = 1) out vec4 OutWorldNormal;
@@ -233,7 +825,12 @@ void main()
     OutWorldPos = vec4(InWorldPos, 0);
     // TODO: Add normal mapping
     OutWorldNormal = vec4(normalize(InWorldNormal), 0);
+#if BINDLESS_MATERIALS
+    // NOTE: Every draw is one mesh so the index is dynamically uniform. Merged draws will need nonuniformEXT here
+    OutColor = texture(ColorTextures[InMaterialId], InUv);
+#else
     OutColor = texture(ColorTexture, InUv);
+#endif
 }
 
 #endif
@@ -261,38 +858,223 @@ void main()
 
 layout(location = 0) out vec4 OutColor;
 
+uint TileBitMaskCount(uint TileId, bool Opaque)
+{
+    uint NumWords = (min(SceneBuffer.NumPointLights, TILED_BIT_MASK_MAX_LIGHTS) + 31) / 32;
+    uint Result = 0;
+    for (uint WordId = 0; WordId < NumWords; ++WordId)
+    {
+        uint MaskId = TileId * TILED_BIT_MASK_WORDS_PER_TILE + WordId;
+        Result += bitCount(Opaque ? LightBitMask_O[MaskId] : LightBitMask_T[MaskId]);
+    }
+
+    return Result;
+}
+
 void main()
 {
-    vec3 CameraPos = SceneBuffer.CameraPos;
     ivec2 PixelPos = ivec2(gl_FragCoord.xy);
     
-    vec3 SurfacePos = texelFetch(GBufferPositionTexture, PixelPos, 0).xyz;
-    vec3 SurfaceNormal = texelFetch(GBufferNormalTexture, PixelPos, 0).xyz;
+    // NOTE: The GBuffer is in world space but point lights are stored in view space, so we light in view space
+    vec3 SurfacePos = (SceneBuffer.VTransform * vec4(texelFetch(GBufferPositionTexture, PixelPos, 0).xyz, 1)).xyz;
+    vec3 SurfaceNormal = (SceneBuffer.VTransform * vec4(texelFetch(GBufferNormalTexture, PixelPos, 0).xyz, 0)).xyz;
     vec3 SurfaceColor = texelFetch(GBufferColorTexture, PixelPos, 0).rgb;
     float Ao = texelFetch(SsaoTexture, PixelPos, 0).x;
-    vec3 View = normalize(CameraPos - SurfacePos);
+    vec3 View = normalize(-SurfacePos);
 
     vec3 Color = vec3(0);
 
     // NOTE: Calculate lighting for point lights
-    ivec2 GridPos = PixelPos / ivec2(TILE_DIM_IN_PIXELS);
+    ivec2 GridPos = PixelPos / ivec2(TileSize);
+    uint TileId = uint(GridPos.y) * GridSize.x + uint(GridPos.x);
     uvec2 LightIndexMetaData = imageLoad(LightGrid_O, GridPos).xy; // NOTE: Stores the pointer + # of elements
-    for (int i = 0; i < LightIndexMetaData.y; ++i)
+    if (LightListMode == LIGHT_LIST_MODE_BIT_MASK)
     {
-        uint LightId = LightIndexList_O[LightIndexMetaData.x + i];
-        point_light CurrLight = PointLights[LightId];
-        vec3 LightDir = normalize(SurfacePos - CurrLight.Pos);
-        Color += BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, PointLightAttenuate(SurfacePos, CurrLight));
+        uint ZBinId = uint(max(SurfacePos.z, 0.0f) * ZBinScale);
+        uvec2 ZBinRange = ZBinId < ZBIN_COUNT ? ZBinUnpack(ZBins[ZBinId]) : uvec2(0xFFFF, 0);
+        for (uint WordId = ZBinRange.x / 32; WordId <= ZBinRange.y / 32; ++WordId)
+        {
+            uint Bits = LightBitMask_O[TileId * TILED_BIT_MASK_WORDS_PER_TILE + WordId] & ZBinWordMask(ZBinRange, WordId);
+            while (Bits != 0)
+            {
+                uint LightId = WordId * 32 + findLSB(Bits);
+                Bits &= Bits - 1;
+                
+                point_light CurrLight = PointLights[LightId];
+                vec3 LightDir = normalize(SurfacePos - CurrLight.Pos);
+                Color += BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, PointLightAttenuate(SurfacePos, CurrLight));
+            }
+        }
+    }
+    else
+    {
+        for (int i = 0; i < LightIndexMetaData.y; ++i)
+        {
+            uint LightId = LightIndexList_O[LightIndexMetaData.x + i];
+            point_light CurrLight = PointLights[LightId];
+            vec3 LightDir = normalize(SurfacePos - CurrLight.Pos);
+            Color += BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, PointLightAttenuate(SurfacePos, CurrLight));
+        }
     }
 
     // NOTE: Calculate lighting for directional lights
     {
-        Color += BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, DirectionalLight.Dir, DirectionalLight.Color);
+        vec3 LightDir = (SceneBuffer.VTransform * vec4(DirectionalLight.Dir, 0)).xyz;
+        Color += BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, DirectionalLight.Color);
         Color += Ao * DirectionalLight.AmbientLight * SurfaceColor;
     }
 
     OutColor = vec4(Color, 1);
-    OutColor = vec4(vec3(Ao), 1);
+    if (DebugViewMode == DEBUG_VIEW_AO)
+    {
+        OutColor = vec4(vec3(Ao), 1);
+    }
+    else if (DebugViewMode == DEBUG_VIEW_LIGHT_HEAT_MAP_OPAQUE)
+    {
+        uint NumLights = LightListMode == LIGHT_LIST_MODE_BIT_MASK ? TileBitMaskCount(TileId, true) : LightIndexMetaData.y;
+        OutColor = vec4(mix(Color, LightHeatMapColor(NumLights), 0.75), 1);
+    }
+    else if (DebugViewMode == DEBUG_VIEW_LIGHT_HEAT_MAP_TRANSPARENT)
+    {
+        uint NumLights = LightListMode == LIGHT_LIST_MODE_BIT_MASK ? TileBitMaskCount(TileId, false) : imageLoad(LightGrid_T, GridPos).y;
+        OutColor = vec4(mix(Color, LightHeatMapColor(NumLights), 0.75), 1);
+    }
+}
+
+#endif
+
+//
+// NOTE: Transparent Vertex
+//
+
+#if TRANSPARENT_VERT
+
+layout(location = 0) in vec3 InPos;
+layout(location = 1) in vec3 InNormal;
+layout(location = 2) in vec2 InUv;
+
+layout(location = 0) out vec3 OutViewPos;
+layout(location = 1) out vec3 OutViewNormal;
+layout(location = 2) out vec2 OutUv;
+layout(location = 3) flat out vec4 OutColor;
+
+void main()
+{
+    transparent_instance_entry Entry = TransparentInstanceBuffer[gl_InstanceIndex];
+
+    gl_Position = Entry.WVPTransform * vec4(InPos, 1);
+    OutViewPos = (SceneBuffer.VTransform * Entry.WTransform * vec4(InPos, 1)).xyz;
+    OutViewNormal = (SceneBuffer.VTransform * Entry.WTransform * vec4(InNormal, 0)).xyz;
+    OutUv = InUv;
+    OutColor = Entry.Color;
+}
+
+#endif
+
+//
+// NOTE: Transparent Fragment
+//
+
+#if TRANSPARENT_FRAG
+
+/*
+
+  NOTE: Weighted blended OIT (McGuire and Bavoil 2013). Every fragment adds its premultiplied color scaled by a depth weight into the
+        accumulation target, and multiplies (1 - alpha) into the revealage target. The composite divides the two out, so the result
+        doesn't depend on draw order and we never sort transparent instances.
+  
+ */
+
+layout(location = 0) in vec3 InViewPos;
+layout(location = 1) in vec3 InViewNormal;
+layout(location = 2) in vec2 InUv;
+layout(location = 3) flat in vec4 InColor;
+
+layout(location = 0) out vec4 OutAccum;
+layout(location = 1) out float OutReveal;
+
+void main()
+{
+    vec3 SurfacePos = InViewPos;
+    // NOTE: Glass is lit from both sides
+    vec3 SurfaceNormal = normalize(InViewNormal) * (gl_FrontFacing ? 1.0f : -1.0f);
+    vec4 Texel = texture(ColorTexture, InUv);
+    vec3 SurfaceColor = Texel.rgb * InColor.rgb;
+    float Alpha = Texel.a * InColor.a;
+    vec3 View = normalize(-SurfacePos);
+
+    vec3 Color = vec3(0);
+
+    // NOTE: Transparent lists keep every light between the near plane and the farthest opaque surface of the tile
+    ivec2 GridPos = ivec2(gl_FragCoord.xy) / ivec2(TileSize);
+    if (LightListMode == LIGHT_LIST_MODE_BIT_MASK)
+    {
+        uint TileId = uint(GridPos.y) * GridSize.x + uint(GridPos.x);
+        uint ZBinId = uint(max(SurfacePos.z, 0.0f) * ZBinScale);
+        uvec2 ZBinRange = ZBinId < ZBIN_COUNT ? ZBinUnpack(ZBins[ZBinId]) : uvec2(0xFFFF, 0);
+        for (uint WordId = ZBinRange.x / 32; WordId <= ZBinRange.y / 32; ++WordId)
+        {
+            uint Bits = LightBitMask_T[TileId * TILED_BIT_MASK_WORDS_PER_TILE + WordId] & ZBinWordMask(ZBinRange, WordId);
+            while (Bits != 0)
+            {
+                uint LightId = WordId * 32 + findLSB(Bits);
+                Bits &= Bits - 1;
+                
+                point_light CurrLight = PointLights[LightId];
+                vec3 LightDir = normalize(SurfacePos - CurrLight.Pos);
+                Color += BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, PointLightAttenuate(SurfacePos, CurrLight));
+            }
+        }
+    }
+    else
+    {
+        uvec2 LightIndexMetaData = imageLoad(LightGrid_T, GridPos).xy; // NOTE: Stores the pointer + # of elements
+        for (int i = 0; i < LightIndexMetaData.y; ++i)
+        {
+            uint LightId = LightIndexList_T[LightIndexMetaData.x + i];
+            point_light CurrLight = PointLights[LightId];
+            vec3 LightDir = normalize(SurfacePos - CurrLight.Pos);
+            Color += BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, PointLightAttenuate(SurfacePos, CurrLight));
+        }
+    }
+
+    // NOTE: Calculate lighting for directional lights
+    {
+        vec3 LightDir = (SceneBuffer.VTransform * vec4(DirectionalLight.Dir, 0)).xyz;
+        Color += BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, DirectionalLight.Color);
+        Color += DirectionalLight.AmbientLight * SurfaceColor;
+    }
+
+    // NOTE: Depth weight from equation 10 of the paper, using view depth since we use reverse z
+    float Weight = clamp(0.03f / (1e-5f + pow(SurfacePos.z / 200.0f, 4.0f)), 1e-2f, 3e3f);
+    OutAccum = vec4(Color * Alpha, Alpha) * Weight;
+    OutReveal = Alpha;
+}
+
+#endif
+
+//
+// NOTE: Transparent Composite
+//
+
+#if TRANSPARENT_COMPOSITE_FRAG
+
+layout(set = 3, binding = 0, input_attachment_index = 0) uniform subpassInput AccumInput;
+layout(set = 3, binding = 1, input_attachment_index = 1) uniform subpassInput RevealInput;
+
+layout(location = 0) out vec4 OutColor;
+
+void main()
+{
+    float Reveal = subpassLoad(RevealInput).x;
+    if (Reveal == 1.0f)
+    {
+        // NOTE: No transparent surface covers this pixel
+        discard;
+    }
+    
+    vec4 Accum = subpassLoad(AccumInput);
+    OutColor = vec4(Accum.rgb / clamp(Accum.a, 1e-4f, 5e4f), 1.0f - Reveal);
 }
 
 #endif
@@ -0,0 +1,194 @@
+
+inline void TiledForwardSwapChainChange(tiled_forward_state* State, u32 Width, u32 Height, VkFormat ColorFormat, render_scene* Scene)
+{
+    b32 ReCreate = State->RenderTargetArena.Used != 0;
+    VkArenaClear(&State->RenderTargetArena);
+    MemoryStatsArenaClear(&DemoState->MemoryStats, &State->RenderTargetArena.Used);
+
+    TaggedRenderTargetEntryReCreate("tiled_forward", &State->RenderTargetArena, Width, Height, VK_FORMAT_D32_SFLOAT,
+                                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                    VK_IMAGE_ASPECT_DEPTH_BIT, &State->DepthImage, &State->DepthEntry);
+    TaggedRenderTargetEntryReCreate("tiled_forward", &State->RenderTargetArena, Width, Height, ColorFormat,
+                                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                    VK_IMAGE_ASPECT_COLOR_BIT, &State->OutColorImage, &State->OutColorEntry);
+
+    if (ReCreate)
+    {
+        RenderTargetUpdateEntries(FrameArenaGet(&DemoState->FrameArena), &State->DepthPrePass);
+        RenderTargetUpdateEntries(FrameArenaGet(&DemoState->FrameArena), &State->ForwardPass);
+    }
+
+    // NOTE: Light culling only reads the depth binding out of the GBuffer descriptors
+    VkDescriptorImageWrite(&RenderState->DescriptorManager, State->Tiled.TiledDeferredDescriptor, 11, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                           State->DepthEntry.View, DemoState->PointSampler, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+    
+    TiledLightDataSwapChainChange(&State->Tiled, &State->RenderTargetArena, ReCreate, Width, Height, Scene);
+}
+
+inline void TiledForwardCreate(renderer_create_info CreateInfo, tiled_forward_state* Result)
+{
+    *Result = {};
+
+    u64 HeapSize = MegaBytes(512);
+    Result->RenderTargetArena = VkLinearArenaCreate(VkMemoryAllocate(RenderState->Device, RenderState->LocalMemoryId, HeapSize), HeapSize);
+    MemoryStatsArenaAdd(&DemoState->MemoryStats, "tiled_forward_targets", true, &Result->RenderTargetArena.Used, HeapSize);
+
+    TiledLightDataCreate(CreateInfo, &Result->Tiled);
+    TiledForwardSwapChainChange(Result, CreateInfo.Width, CreateInfo.Height, CreateInfo.ColorFormat, CreateInfo.Scene);
+
+    VkDescriptorSetLayout DescriptorLayouts[] =
+        {
+            Result->Tiled.TiledDeferredDescLayout,
+            CreateInfo.SceneDescLayout,
+            CreateInfo.MaterialDescLayout,
+        };
+    
+    // NOTE: Depth Pre Pass
+    {
+        // NOTE: RT
+        {
+            render_target_builder Builder = RenderTargetBuilderBegin(&DemoState->Arena, &DemoState->TempArena, CreateInfo.Width, CreateInfo.Height);
+            RenderTargetAddTarget(&Builder, &Result->DepthEntry, VkClearDepthStencilCreate(0, 0));
+                            
+            vk_render_pass_builder RpBuilder = VkRenderPassBuilderBegin(&DemoState->TempArena);
+
+            u32 DepthId = VkRenderPassAttachmentAdd(&RpBuilder, Result->DepthEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                    VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+
+            VkRenderPassSubPassBegin(&RpBuilder, VK_PIPELINE_BIND_POINT_GRAPHICS);
+            VkRenderPassDepthRefAdd(&RpBuilder, DepthId, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+            VkRenderPassSubPassEnd(&RpBuilder);
+
+            Result->DepthPrePass = RenderTargetBuilderEnd(&Builder, VkRenderPassBuilderEnd(&RpBuilder, RenderState->Device));
+        }
+
+        // NOTE: Depth only pipeline, no fragment shader
+        {
+            vk_pipeline_builder Builder = VkPipelineBuilderBegin(&DemoState->TempArena);
+
+            VkPipelineShaderAdd(&Builder, "shader_tiled_forward_vert.spv", "main", VK_SHADER_STAGE_VERTEX_BIT);
+                
+            VkPipelineVertexBindingBegin(&Builder);
+            VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, sizeof(v3));
+            VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, sizeof(v3));
+            VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32_SFLOAT, sizeof(v2));
+            VkPipelineVertexBindingEnd(&Builder);
+
+            VkPipelineInputAssemblyAdd(&Builder, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
+            VkPipelineDepthStateAdd(&Builder, VK_TRUE, VK_TRUE, VK_COMPARE_OP_GREATER);
+
+            Result->DepthPrePassPipeline = VkPipelineBuilderEnd(&Builder, RenderState->Device, &RenderState->PipelineManager,
+                                                                Result->DepthPrePass.RenderPass, 0, DescriptorLayouts, ArrayCount(DescriptorLayouts));
+        }
+    }
+
+    // NOTE: Forward Pass
+    {
+        // NOTE: RT
+        {
+            render_target_builder Builder = RenderTargetBuilderBegin(&DemoState->Arena, &DemoState->TempArena, CreateInfo.Width, CreateInfo.Height);
+            RenderTargetAddTarget(&Builder, &Result->OutColorEntry, VkClearColorCreate(0, 0, 0, 1));
+            RenderTargetAddTarget(&Builder, &Result->DepthEntry, VkClearDepthStencilCreate(0, 0));
+                            
+            vk_render_pass_builder RpBuilder = VkRenderPassBuilderBegin(&DemoState->TempArena);
+
+            u32 OutColorId = VkRenderPassAttachmentAdd(&RpBuilder, Result->OutColorEntry.Format, VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                       VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            u32 DepthId = VkRenderPassAttachmentAdd(&RpBuilder, Result->DepthEntry.Format, VK_ATTACHMENT_LOAD_OP_LOAD,
+                                                    VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+                                                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+
+            VkRenderPassDependency(&RpBuilder, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                   VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_DEPENDENCY_BY_REGION_BIT);
+
+            VkRenderPassSubPassBegin(&RpBuilder, VK_PIPELINE_BIND_POINT_GRAPHICS);
+            VkRenderPassColorRefAdd(&RpBuilder, OutColorId, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            VkRenderPassDepthRefAdd(&RpBuilder, DepthId, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+            VkRenderPassSubPassEnd(&RpBuilder);
+
+            Result->ForwardPass = RenderTargetBuilderEnd(&Builder, VkRenderPassBuilderEnd(&RpBuilder, RenderState->Device));
+        }
+
+        {
+            vk_pipeline_builder Builder = VkPipelineBuilderBegin(&DemoState->TempArena);
+
+            // NOTE: Shaders
+            VkPipelineShaderAdd(&Builder, "shader_tiled_forward_vert.spv", "main", VK_SHADER_STAGE_VERTEX_BIT);
+            VkPipelineShaderAdd(&Builder, "shader_tiled_forward_frag.spv", "main", VK_SHADER_STAGE_FRAGMENT_BIT);
+                
+            // NOTE: Specify input vertex data format
+            VkPipelineVertexBindingBegin(&Builder);
+            VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, sizeof(v3));
+            VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32B32_SFLOAT, sizeof(v3));
+            VkPipelineVertexAttributeAdd(&Builder, VK_FORMAT_R32G32_SFLOAT, sizeof(v2));
+            VkPipelineVertexBindingEnd(&Builder);
+
+            VkPipelineInputAssemblyAdd(&Builder, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
+            VkPipelineDepthStateAdd(&Builder, VK_TRUE, VK_FALSE, VK_COMPARE_OP_EQUAL);
+            VkPipelineColorAttachmentAdd(&Builder, VK_FALSE, VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO,
+                                         VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO);
+
+            Result->ForwardPipeline = VkPipelineBuilderEnd(&Builder, RenderState->Device, &RenderState->PipelineManager,
+                                                           Result->ForwardPass.RenderPass, 0, DescriptorLayouts, ArrayCount(DescriptorLayouts));
+        }
+    }
+}
+
+inline void TiledForwardDrawInstances(vk_commands Commands, vk_pipeline* Pipeline, tiled_forward_state* State, render_scene* Scene)
+{
+    vkCmdBindPipeline(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline->Handle);
+    {
+        VkDescriptorSet DescriptorSets[] =
+            {
+                State->Tiled.TiledDeferredDescriptor,
+                Scene->SceneDescriptor,
+            };
+        vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline->Layout, 0,
+                                ArrayCount(DescriptorSets), DescriptorSets, 0, 0);
+    }
+
+    for (u32 InstanceId = 0; InstanceId < Scene->OpaqueInstances.NumItems; ++InstanceId)
+    {
+        instance_entry* CurrInstance = SceneOpaqueInstanceAt(Scene, InstanceId);
+        render_mesh* CurrMesh = SceneMeshGet(Scene, CurrInstance->Mesh);
+
+        vkCmdBindDescriptorSets(Commands.Buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline->Layout, 2, 1,
+                                &CurrMesh->MaterialDescriptor, 0, 0);
+            
+        VkDeviceSize Offset = 0;
+        vkCmdBindVertexBuffers(Commands.Buffer, 0, 1, &CurrMesh->VertexBuffer, &Offset);
+        vkCmdBindIndexBuffer(Commands.Buffer, CurrMesh->IndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+        vkCmdDrawIndexed(Commands.Buffer, CurrMesh->NumIndices, 1, 0, 0, InstanceId);
+    }
+}
+
+inline void TiledForwardRender(vk_commands Commands, tiled_forward_state* State, render_scene* Scene)
+{
+    LightGridStatsProcess(&State->Tiled.LightGridStats);
+    TiledLightDataFrameBegin(Commands, &State->Tiled);
+    TiledLightDataClear(Commands, &State->Tiled);
+
+    // NOTE: Depth Pre Pass
+    GpuTimerBegin(Commands, &DemoState->GpuTimers, GpuTimer_GBuffer);
+    RenderTargetPassBegin(&State->DepthPrePass, Commands, RenderTargetRenderPass_SetViewPort | RenderTargetRenderPass_SetScissor);
+    TiledForwardDrawInstances(Commands, State->DepthPrePassPipeline, State, Scene);
+    RenderTargetPassEnd(Commands);
+    GpuTimerEnd(Commands, &DemoState->GpuTimers, GpuTimer_GBuffer);
+
+    // NOTE: Light Culling Pass
+    TiledLightDataCull(Commands, &State->Tiled, Scene);
+
+    vkCmdPipelineBarrier(Commands.Buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         VK_DEPENDENCY_BY_REGION_BIT, 0, 0, 0, 0, 0, 0);
+    
+    // NOTE: Forward Pass
+    GpuTimerBegin(Commands, &DemoState->GpuTimers, GpuTimer_Lighting);
+    RenderTargetPassBegin(&State->ForwardPass, Commands, RenderTargetRenderPass_SetViewPort | RenderTargetRenderPass_SetScissor);
+    TiledForwardDrawInstances(Commands, State->ForwardPipeline, State, Scene);
+    RenderTargetPassEnd(Commands);
+    GpuTimerEnd(Commands, &DemoState->GpuTimers, GpuTimer_Lighting);
+
+    LightGridStatsFrameEnd(&State->Tiled.LightGridStats);
+}
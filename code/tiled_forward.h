@@ -0,0 +1,25 @@
+#pragma once
+
+/*
+
+  NOTE: Tiled forward (forward+) renderer. A depth prepass feeds the same light culling as tiled deferred, then the forward pass shades
+        each pixel with only the lights in its tile. The forward pass tests depth with EQUAL so we only shade visible fragments.
+  
+ */
+
+struct tiled_forward_state
+{
+    vk_linear_arena RenderTargetArena;
+
+    VkImage DepthImage;
+    render_target_entry DepthEntry;
+    VkImage OutColorImage;
+    render_target_entry OutColorEntry;
+    render_target DepthPrePass;
+    render_target ForwardPass;
+
+    tiled_light_data Tiled;
+    
+    vk_pipeline* DepthPrePassPipeline;
+    vk_pipeline* ForwardPipeline;
+};
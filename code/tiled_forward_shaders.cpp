@@ -0,0 +1,107 @@
+#version 450
+
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_GOOGLE_include_directive : enable
+
+#include "shader_descriptor_layouts.cpp"
+#include "shader_blinn_phong_lighting.cpp"
+
+//
+// NOTE: Descriptor Sets
+//
+
+TILED_DEFERRED_DESCRIPTOR_LAYOUT(0)
+SCENE_DESCRIPTOR_LAYOUT(1)
+MATERIAL_DESCRIPTOR_LAYOUT(2)
+
+//
+// NOTE: Tiled Forward Vertex
+//
+
+#if TILED_FORWARD_VERT
+
+layout(location = 0) in vec3 InPos;
+layout(location = 1) in vec3 InNormal;
+layout(location = 2) in vec2 InUv;
+
+layout(location = 0) out vec3 OutViewPos;
+layout(location = 1) out vec3 OutViewNormal;
+layout(location = 2) out vec2 OutUv;
+
+void main()
+{
+    instance_entry Entry = InstanceBuffer[gl_InstanceIndex];
+
+    gl_Position = Entry.WVPTransform * vec4(InPos, 1);
+    OutViewPos = (SceneBuffer.VTransform * Entry.WTransform * vec4(InPos, 1)).xyz;
+    OutViewNormal = (SceneBuffer.VTransform * Entry.WTransform * vec4(InNormal, 0)).xyz;
+    OutUv = InUv;
+}
+
+#endif
+
+//
+// NOTE: Tiled Forward Fragment
+//
+
+#if TILED_FORWARD_FRAG
+
+layout(location = 0) in vec3 InViewPos;
+layout(location = 1) in vec3 InViewNormal;
+layout(location = 2) in vec2 InUv;
+
+layout(location = 0) out vec4 OutColor;
+
+void main()
+{
+    vec3 SurfacePos = InViewPos;
+    vec3 SurfaceNormal = normalize(InViewNormal);
+    vec3 SurfaceColor = texture(ColorTexture, InUv).rgb;
+    vec3 View = normalize(-SurfacePos);
+
+    vec3 Color = vec3(0);
+
+    // NOTE: Calculate lighting for point lights in this pixels tile
+    ivec2 GridPos = ivec2(gl_FragCoord.xy) / ivec2(TileSize);
+    if (LightListMode == LIGHT_LIST_MODE_BIT_MASK)
+    {
+        uint TileId = uint(GridPos.y) * GridSize.x + uint(GridPos.x);
+        uint ZBinId = uint(max(SurfacePos.z, 0.0f) * ZBinScale);
+        uvec2 ZBinRange = ZBinId < ZBIN_COUNT ? ZBinUnpack(ZBins[ZBinId]) : uvec2(0xFFFF, 0);
+        for (uint WordId = ZBinRange.x / 32; WordId <= ZBinRange.y / 32; ++WordId)
+        {
+            uint Bits = LightBitMask_O[TileId * TILED_BIT_MASK_WORDS_PER_TILE + WordId] & ZBinWordMask(ZBinRange, WordId);
+            while (Bits != 0)
+            {
+                uint LightId = WordId * 32 + findLSB(Bits);
+                Bits &= Bits - 1;
+                
+                point_light CurrLight = PointLights[LightId];
+                vec3 LightDir = normalize(SurfacePos - CurrLight.Pos);
+                Color += BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, PointLightAttenuate(SurfacePos, CurrLight));
+            }
+        }
+    }
+    else
+    {
+        uvec2 LightIndexMetaData = imageLoad(LightGrid_O, GridPos).xy; // NOTE: Stores the pointer + # of elements
+        for (int i = 0; i < LightIndexMetaData.y; ++i)
+        {
+            uint LightId = LightIndexList_O[LightIndexMetaData.x + i];
+            point_light CurrLight = PointLights[LightId];
+            vec3 LightDir = normalize(SurfacePos - CurrLight.Pos);
+            Color += BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, PointLightAttenuate(SurfacePos, CurrLight));
+        }
+    }
+
+    // NOTE: Calculate lighting for directional lights
+    {
+        vec3 LightDir = (SceneBuffer.VTransform * vec4(DirectionalLight.Dir, 0)).xyz;
+        Color += BlinnPhongLighting(View, SurfaceColor, SurfaceNormal, 32, LightDir, DirectionalLight.Color);
+        Color += DirectionalLight.AmbientLight * SurfaceColor;
+    }
+
+    OutColor = vec4(Color, 1);
+}
+
+#endif